@@ -0,0 +1,84 @@
+#include "runtime/core/log/async_log_queue.h"
+
+#include <thread>
+
+MM::LogSystem::AsyncLogQueue::AsyncLogQueue()
+    : slots_(std::make_unique<Slot[]>(kCapacity)) {
+  for (std::uint64_t i = 0; i != kCapacity; ++i) {
+    slots_[i].sequence_.store(i, std::memory_order_relaxed);
+  }
+}
+
+MM::LogSystem::AsyncLogQueue::~AsyncLogQueue() {
+  // Destroy the arguments of the records that were never popped.
+  while (HasRecord()) {
+    Record& record = slots_[pop_index_ & kIndexMask].record_;
+    record.destroy_function_(record.arguments_);
+    ++pop_index_;
+  }
+}
+
+bool MM::LogSystem::AsyncLogQueue::Pop(spdlog::level::level_enum& level,
+                                       spdlog::memory_buf_t& message) {
+  Slot& slot = slots_[pop_index_ & kIndexMask];
+  if (slot.sequence_.load(std::memory_order_acquire) != pop_index_ + 1) {
+    return false;
+  }
+
+  Record& record = slot.record_;
+  level = record.level_;
+  try {
+    record.format_function_(record.arguments_, message);
+  } catch (const std::exception& error) {
+    message.clear();
+    fmt::format_to(fmt::appender(message),
+                   "[Failed to format log message] {}", error.what());
+  }
+  record.destroy_function_(record.arguments_);
+
+  slot.sequence_.store(pop_index_ + kCapacity, std::memory_order_release);
+  ++pop_index_;
+  pop_count_.store(pop_index_, std::memory_order_release);
+
+  return true;
+}
+
+bool MM::LogSystem::AsyncLogQueue::HasRecord() const {
+  return slots_[pop_index_ & kIndexMask].sequence_.load(
+             std::memory_order_acquire) == pop_index_ + 1;
+}
+
+std::uint64_t MM::LogSystem::AsyncLogQueue::GetPushCount() const {
+  return push_index_.load(std::memory_order_acquire);
+}
+
+std::uint64_t MM::LogSystem::AsyncLogQueue::GetPopCount() const {
+  return pop_count_.load(std::memory_order_acquire);
+}
+
+MM::LogSystem::AsyncLogQueue::Slot&
+MM::LogSystem::AsyncLogQueue::AcquireSlot() {
+  std::uint64_t index = push_index_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = slots_[index & kIndexMask];
+    std::uint64_t sequence = slot.sequence_.load(std::memory_order_acquire);
+    if (sequence == index) {
+      if (push_index_.compare_exchange_weak(index, index + 1,
+                                            std::memory_order_relaxed)) {
+        return slot;
+      }
+    } else if (sequence < index) {
+      // The ring is full, wait for the consumer.
+      std::this_thread::yield();
+      index = push_index_.load(std::memory_order_relaxed);
+    } else {
+      index = push_index_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void MM::LogSystem::AsyncLogQueue::PublishSlot(Slot& slot) {
+  // The slot was acquired with sequence == index, index + 1 marks it as ready.
+  slot.sequence_.store(slot.sequence_.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_release);
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <spdlog/common.h>
+#include <spdlog/fmt/fmt.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace MM {
+namespace LogSystem {
+/**
+ * \brief Bounded lock-free multi producer single consumer ring of log records
+ * whose arguments are captured unformatted.
+ * \remark Producers copy the arguments into a fixed size record inside the
+ * ring, strings are copied next to them, so pushing a record never allocates.
+ * Only arithmetic values, enums and strings are captured. Any other argument
+ * may view memory of the caller, a fmt::join or a span for example, so a
+ * record with such an argument is formatted by the producer, and only the
+ * resulting message is queued. The same happens to arguments that do not fit
+ * into a record. The consumer formats the record when it pops it.
+ * \remark A record with a single argument is a plain message, the same as
+ * spdlog treats it. Otherwise the first argument is the format string.
+ * \remark When the ring is full, \ref Push waits until the consumer frees a
+ * record.
+ */
+class AsyncLogQueue {
+ public:
+  static constexpr std::uint64_t kCapacity = 4096;
+  static constexpr std::size_t kArgumentStorageSize = 224;
+
+ public:
+  AsyncLogQueue();
+  ~AsyncLogQueue();
+  AsyncLogQueue(const AsyncLogQueue& other) = delete;
+  AsyncLogQueue(AsyncLogQueue&& other) = delete;
+  AsyncLogQueue& operator=(const AsyncLogQueue& other) = delete;
+  AsyncLogQueue& operator=(AsyncLogQueue&& other) = delete;
+
+ public:
+  template <typename... Args>
+  void Push(spdlog::level::level_enum level, Args&&... args) {
+    static_assert(sizeof...(Args) != 0, "A log record needs a message.");
+
+    if constexpr (CanCapture<Args...>()) {
+      if (GetCaptureSize<Args...>() + GetStringSize(args...) <=
+          kArgumentStorageSize) {
+        Slot& slot = AcquireSlot();
+        Record& record = slot.record_;
+        record.level_ = level;
+        record.format_function_ = &FormatRecord<CaptureTuple<Args...>>;
+        record.destroy_function_ = &DestroyRecord<CaptureTuple<Args...>>;
+        char* string_data =
+            reinterpret_cast<char*>(record.arguments_) +
+            sizeof(CaptureTuple<Args...>);
+        new (record.arguments_) CaptureTuple<Args...>{
+            CaptureArgument(std::forward<Args>(args), string_data)...};
+        PublishSlot(slot);
+        return;
+      }
+    }
+
+    // The arguments cannot be captured or do not fit into a record, format
+    // them here and queue the message only.
+    std::string message;
+    try {
+      message = FormatMessage(std::forward<Args>(args)...);
+    } catch (const std::exception& error) {
+      message = std::string("[Failed to format log message] ") + error.what();
+    }
+    if (sizeof(CaptureTuple<std::string_view>) + message.size() <=
+        kArgumentStorageSize) {
+      Push(level, std::string_view{message});
+      return;
+    }
+
+    Slot& slot = AcquireSlot();
+    Record& record = slot.record_;
+    record.level_ = level;
+    record.format_function_ = &FormatRecord<std::tuple<std::string>>;
+    record.destroy_function_ = &DestroyRecord<std::tuple<std::string>>;
+    new (record.arguments_) std::tuple<std::string>{std::move(message)};
+    PublishSlot(slot);
+  }
+
+  /**
+   * \brief Format the oldest record into \ref message and release it.
+   * \return False if there is no record to pop.
+   * \remark Only the consumer thread may call this.
+   */
+  bool Pop(spdlog::level::level_enum& level, spdlog::memory_buf_t& message);
+
+  /**
+   * \brief Returns true if \ref Pop would pop a record.
+   * \remark Only the consumer thread may call this.
+   */
+  bool HasRecord() const;
+
+  /**
+   * \brief The number of records pushed, including the ones still being
+   * written.
+   */
+  std::uint64_t GetPushCount() const;
+
+  std::uint64_t GetPopCount() const;
+
+ private:
+  using FormatFunction = void (*)(const void* arguments,
+                                  spdlog::memory_buf_t& message);
+  using DestroyFunction = void (*)(void* arguments);
+
+  struct Record {
+    spdlog::level::level_enum level_{spdlog::level::trace};
+    FormatFunction format_function_{nullptr};
+    DestroyFunction destroy_function_{nullptr};
+    alignas(std::max_align_t) std::byte arguments_[kArgumentStorageSize];
+  };
+
+  struct Slot {
+    std::atomic_uint64_t sequence_{0};
+    Record record_{};
+  };
+
+  template <typename Arg>
+  struct IsStringArgument
+      : std::bool_constant<
+            std::is_convertible_v<const std::decay_t<Arg>&, std::string_view>> {
+  };
+
+  // Types that own their whole value, and so are safe to format on another
+  // thread after the caller returns.
+  template <typename Arg>
+  struct IsCapturableArgument
+      : std::bool_constant<IsStringArgument<Arg>::value ||
+                           std::is_arithmetic_v<std::decay_t<Arg>> ||
+                           std::is_enum_v<std::decay_t<Arg>>> {};
+
+  // Strings are captured as views of a copy stored in the record, everything
+  // else by value.
+  template <typename Arg>
+  using CaptureType = std::conditional_t<IsStringArgument<Arg>::value,
+                                         std::string_view, std::decay_t<Arg>>;
+
+  template <typename... Args>
+  using CaptureTuple = std::tuple<CaptureType<Args>...>;
+
+ private:
+  template <typename... Args>
+  static constexpr bool CanCapture() {
+    return (IsCapturableArgument<Args>::value && ...) &&
+           alignof(CaptureTuple<Args...>) <= alignof(std::max_align_t) &&
+           (std::is_constructible_v<CaptureType<Args>, Args&&> && ...);
+  }
+
+  template <typename... Args>
+  static constexpr std::size_t GetCaptureSize() {
+    return sizeof(CaptureTuple<Args...>);
+  }
+
+  template <typename Arg>
+  static std::string_view ToStringView(const Arg& arg) {
+    if constexpr (std::is_pointer_v<std::remove_cv_t<Arg>>) {
+      if (arg == nullptr) {
+        return std::string_view{};
+      }
+    }
+    return std::string_view{arg};
+  }
+
+  template <typename... Args>
+  static std::size_t GetStringSize(const Args&... args) {
+    return (std::size_t{0} + ... + GetStringSizeImp(args));
+  }
+
+  template <typename Arg>
+  static std::size_t GetStringSizeImp(const Arg& arg) {
+    if constexpr (IsStringArgument<Arg>::value) {
+      return ToStringView(arg).size();
+    } else {
+      return 0;
+    }
+  }
+
+  template <typename Arg>
+  static CaptureType<Arg> CaptureArgument(Arg&& arg, char*& string_data) {
+    if constexpr (IsStringArgument<Arg>::value) {
+      std::string_view source = ToStringView(arg);
+      if (!source.empty()) {
+        std::memcpy(string_data, source.data(), source.size());
+      }
+      std::string_view capture{string_data, source.size()};
+      string_data += source.size();
+      return capture;
+    } else {
+      return std::forward<Arg>(arg);
+    }
+  }
+
+  template <typename Arg>
+  static std::string FormatMessage(Arg&& arg) {
+    if constexpr (IsStringArgument<Arg>::value) {
+      return std::string{ToStringView(arg)};
+    } else {
+      return fmt::format("{}", arg);
+    }
+  }
+
+  template <typename FormatString, typename Arg, typename... Args>
+  static std::string FormatMessage(FormatString&& format_string, Arg&& arg,
+                                   Args&&... args) {
+    return fmt::vformat(ToStringView(format_string),
+                        fmt::make_format_args(arg, args...));
+  }
+
+  template <typename Tuple>
+  static void FormatRecord(const void* arguments,
+                           spdlog::memory_buf_t& message) {
+    FormatTuple(*static_cast<const Tuple*>(arguments), message,
+                std::make_index_sequence<std::tuple_size_v<Tuple> - 1>{});
+  }
+
+  template <typename Tuple, std::size_t... Indexes>
+  static void FormatTuple(const Tuple& arguments,
+                          spdlog::memory_buf_t& message,
+                          std::index_sequence<Indexes...>) {
+    if constexpr (sizeof...(Indexes) == 0) {
+      if constexpr (std::is_same_v<std::tuple_element_t<0, Tuple>,
+                                   std::string_view> ||
+                    std::is_same_v<std::tuple_element_t<0, Tuple>,
+                                   std::string>) {
+        std::string_view text{std::get<0>(arguments)};
+        message.append(text.data(), text.data() + text.size());
+      } else {
+        fmt::format_to(fmt::appender(message), "{}", std::get<0>(arguments));
+      }
+    } else {
+      fmt::vformat_to(fmt::appender(message),
+                      fmt::string_view{std::get<0>(arguments).data(),
+                                       std::get<0>(arguments).size()},
+                      fmt::make_format_args(std::get<Indexes + 1>(arguments)...));
+    }
+  }
+
+  template <typename Tuple>
+  static void DestroyRecord(void* arguments) {
+    static_cast<Tuple*>(arguments)->~Tuple();
+  }
+
+  /**
+   * \brief Reserve the next free slot, waiting while the ring is full.
+   */
+  Slot& AcquireSlot();
+
+  /**
+   * \brief Hand a slot filled by \ref AcquireSlot over to the consumer.
+   */
+  static void PublishSlot(Slot& slot);
+
+ private:
+  static constexpr std::uint64_t kIndexMask = kCapacity - 1;
+  static constexpr std::size_t kCacheLineSize = 64;
+
+  static_assert((kCapacity & kIndexMask) == 0,
+                "The capacity must be a power of two.");
+
+  std::unique_ptr<Slot[]> slots_;
+  alignas(kCacheLineSize) std::atomic_uint64_t push_index_{0};
+  alignas(kCacheLineSize) std::atomic_uint64_t pop_count_{0};
+  // Only accessed by the consumer thread.
+  std::uint64_t pop_index_{0};
+};
+}  // namespace LogSystem
+}  // namespace MM
@@ -1,9 +1,20 @@
 #include "runtime/core/log/log_system.h"
 
+#include <chrono>
+#include <cstdlib>
+
 MM::LogSystem::LogSystem* MM::LogSystem::LogSystem::log_system_{nullptr};
 std::mutex MM::LogSystem::LogSystem::sync_flag_{};
 
 MM::LogSystem::LogSystem::~LogSystem() {
+  if (log_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard{log_thread_mutex_};
+      stop_log_thread_ = true;
+    }
+    log_thread_condition_.notify_one();
+    log_thread_.join();
+  }
   logger_->flush();
   spdlog::drop_all();
   log_system_ = nullptr;
@@ -14,7 +25,7 @@ MM::LogSystem::LogSystem* MM::LogSystem::LogSystem::GetInstance() {
   } else {
     std::lock_guard<std::mutex> guard{sync_flag_};
     if (!log_system_) {
-      log_system_ = new LogSystem{};
+      auto* log_system = new LogSystem{};
 
       auto console_sink =
           std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
@@ -23,46 +34,133 @@ MM::LogSystem::LogSystem* MM::LogSystem::LogSystem::GetInstance() {
 
       const spdlog::sinks_init_list sink_list = {console_sink};
 
-      spdlog::init_thread_pool(8192, 1);
+      // Asynchronous logs are formatted by the log thread, the logger itself
+      // stays synchronous.
+      log_system->logger_ = std::make_shared<spdlog::logger>(
+          "muggle_logger", sink_list.begin(), sink_list.end());
+      log_system->SetLevel(LogLevel::TRACE);
+      spdlog::register_logger(log_system->logger_);
+      log_system->log_thread_ =
+          std::thread{[log_system]() { log_system->ProcessAsyncLogs(); }};
 
-      log_system_->logger_ = std::make_shared<spdlog::async_logger>(
-          "muggle_logger", sink_list.begin(), sink_list.end(),
-          spdlog::thread_pool(), spdlog::async_overflow_policy::block);
-      // log_system_->logger_ = std::make_shared<spdlog::logger>(
-      //     "muggle_logger", sink_list.begin(), sink_list.end());
-      log_system_->SetLevel(LogLevel::TRACE);
-      spdlog::register_logger(log_system_->logger_);
+      log_system_ = log_system;
+      // Queued logs are written before the process exits.
+      std::atexit([]() {
+        if (log_system_) {
+          log_system_->Flush();
+        }
+      });
     }
   }
   return log_system_;
 }
 
 void MM::LogSystem::LogSystem::SetLevel(const LogLevel& level) {
+  severity_.store(GetSeverity(level), std::memory_order_relaxed);
+  logger_->set_level(ToSpdlogLevel(level));
+}
+
+MM::LogSystem::LogSystem::LogLevel MM::LogSystem::LogSystem::GetLevel() const {
+  switch (severity_.load(std::memory_order_relaxed)) {
+    case MM_LOG_LEVEL_TRACE:
+      return LogLevel::TRACE;
+    case MM_LOG_LEVEL_DEBUG:
+      return LogLevel::DEBUG;
+    case MM_LOG_LEVEL_INFO:
+      return LogLevel::INFO;
+    case MM_LOG_LEVEL_WARN:
+      return LogLevel::WARN;
+    case MM_LOG_LEVEL_ERROR:
+      return LogLevel::ERROR;
+    default:
+      return LogLevel::FATAL;
+  }
+}
+
+void MM::LogSystem::LogSystem::SetMode(LogMode mode) {
+  mode_.store(mode, std::memory_order_relaxed);
+  if (mode == LogMode::SYNCHRONOUS) {
+    // Logs queued before the switch are written before the ones after it.
+    Flush();
+  }
+}
+
+MM::LogSystem::LogSystem::LogMode MM::LogSystem::LogSystem::GetMode() const {
+  return mode_.load(std::memory_order_relaxed);
+}
+
+void MM::LogSystem::LogSystem::Flush() const {
+  const std::uint64_t push_count = async_log_queue_.GetPushCount();
+  if (async_log_queue_.GetPopCount() < push_count) {
+    WakeUpLogThread();
+    while (async_log_queue_.GetPopCount() < push_count) {
+      std::this_thread::yield();
+    }
+  }
+  logger_->flush();
+}
+
+spdlog::level::level_enum MM::LogSystem::LogSystem::ToSpdlogLevel(
+    LogLevel level) {
   switch (level) {
     case LogLevel::TRACE:
-      logger_->set_level(spdlog::level::trace);
-      break;
+      return spdlog::level::trace;
     case LogLevel::INFO:
-      logger_->set_level(spdlog::level::info);
-      break;
+      return spdlog::level::info;
     case LogLevel::DEBUG:
-      logger_->set_level(spdlog::level::debug);
-      break;
+      return spdlog::level::debug;
     case LogLevel::WARN:
-      logger_->set_level(spdlog::level::warn);
-      break;
+      return spdlog::level::warn;
     case LogLevel::ERROR:
-      logger_->set_level(spdlog::level::err);
-      break;
+      return spdlog::level::err;
     case LogLevel::FATAL:
-      logger_->set_level(spdlog::level::critical);
+      return spdlog::level::critical;
+  }
+  return spdlog::level::critical;
+}
+
+void MM::LogSystem::LogSystem::WakeUpLogThread() const {
+  // Pairs with the fence in ProcessAsyncLogs, either the log thread sees the
+  // new record or this thread sees that the log thread is waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (log_thread_waiting_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> guard{log_thread_mutex_};
+    log_thread_condition_.notify_one();
+  }
+}
+
+void MM::LogSystem::LogSystem::ProcessAsyncLogs() {
+  // The wait is bounded so that a lost wake up only delays logs.
+  constexpr std::chrono::milliseconds kMaxIdleTime{100};
+
+  spdlog::level::level_enum level{spdlog::level::trace};
+  spdlog::memory_buf_t message{};
+  while (true) {
+    while (async_log_queue_.Pop(level, message)) {
+      logger_->log(level, spdlog::string_view_t{message.data(), message.size()});
+      message.clear();
+    }
+
+    std::unique_lock<std::mutex> guard{log_thread_mutex_};
+    if (stop_log_thread_ && !async_log_queue_.HasRecord()) {
       break;
+    }
+    log_thread_waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    log_thread_condition_.wait_for(guard, kMaxIdleTime, [this]() {
+      return stop_log_thread_ || async_log_queue_.HasRecord();
+    });
+    log_thread_waiting_.store(false, std::memory_order_relaxed);
   }
 }
 
 void MM::LogSystem::LogSystem::CheckResult(MM::ErrorCode result,
                                            const std::string& description,
                                            LogLevel log_level) const {
+  if (result == ErrorCode::SUCCESS || !ShouldLog(log_level)) {
+    return;
+  }
+
   switch (result) {
     case ErrorCode::SUCCESS:
       break;
@@ -1,21 +1,45 @@
 #pragma once
 
-#include <spdlog/async.h>
-#include <spdlog/async_logger.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <iostream>
 #include <mutex>
+#include <thread>
 
+#include "runtime/core/log/async_log_queue.h"
 #include "runtime/platform/base/error.h"
 
+#define MM_LOG_LEVEL_TRACE 0
+#define MM_LOG_LEVEL_DEBUG 1
+#define MM_LOG_LEVEL_INFO 2
+#define MM_LOG_LEVEL_WARN 3
+#define MM_LOG_LEVEL_ERROR 4
+#define MM_LOG_LEVEL_FATAL 5
+
+/**
+ * \brief Logs below this level are compiled out, their arguments are never
+ * evaluated. FATAL logs are always kept because they throw.
+ */
+#ifndef MM_LOG_ACTIVE_LEVEL
+#define MM_LOG_ACTIVE_LEVEL MM_LOG_LEVEL_TRACE
+#endif
+
 namespace MM {
 namespace LogSystem {
 class LogSystem {
  public:
   enum class LogLevel : uint8_t { TRACE, INFO, DEBUG, WARN, ERROR, FATAL };
 
+  /**
+   * \brief SYNCHRONOUS formats and writes a log on the calling thread.
+   * ASYNCHRONOUS captures the arguments into an \ref AsyncLogQueue and leaves
+   * formatting and writing to the log thread.
+   */
+  enum class LogMode : uint8_t { SYNCHRONOUS, ASYNCHRONOUS };
+
  public:
   LogSystem(const LogSystem& other) = delete;
   LogSystem(LogSystem&& other) = delete;
@@ -25,63 +49,117 @@ class LogSystem {
  public:
   static LogSystem* GetInstance();
 
-  void SetLevel(const LogLevel& level);
-
-  template <typename... ARGS>
-  void Log(const LogLevel& level, ARGS&&... args) const {
+  /**
+   * \brief The severity of \ref level, higher is more severe.
+   * \remark LogLevel is not declared in severity order.
+   */
+  static constexpr std::uint8_t GetSeverity(LogLevel level) {
     switch (level) {
       case LogLevel::TRACE:
-        LogSystem::logger_->trace(std::forward<ARGS>(args)...);
-        break;
-      case LogLevel::INFO:
-        LogSystem::logger_->info(std::forward<ARGS>(args)...);
-        break;
+        return MM_LOG_LEVEL_TRACE;
       case LogLevel::DEBUG:
-        LogSystem::logger_->debug(std::forward<ARGS>(args)...);
-        break;
+        return MM_LOG_LEVEL_DEBUG;
+      case LogLevel::INFO:
+        return MM_LOG_LEVEL_INFO;
       case LogLevel::WARN:
-        LogSystem::logger_->warn(std::forward<ARGS>(args)...);
-        break;
+        return MM_LOG_LEVEL_WARN;
       case LogLevel::ERROR:
-        LogSystem::logger_->error(std::forward<ARGS>(args)...);
-        break;
+        return MM_LOG_LEVEL_ERROR;
       case LogLevel::FATAL:
-        LogSystem::logger_->critical(std::forward<ARGS>(args)...);
-        FatalCallback(std::forward<ARGS>(args)...);
-        break;
-      default:
-        break;
+        return MM_LOG_LEVEL_FATAL;
     }
+    return MM_LOG_LEVEL_FATAL;
+  }
+
+  /**
+   * \brief Returns false if logs of \ref level are compiled out by
+   * MM_LOG_ACTIVE_LEVEL.
+   */
+  static constexpr bool IsLevelCompiled(LogLevel level) {
+#if MM_LOG_ACTIVE_LEVEL > MM_LOG_LEVEL_TRACE
+    return level == LogLevel::FATAL ||
+           GetSeverity(level) >= MM_LOG_ACTIVE_LEVEL;
+#else
+    // Comparing the unsigned severity with 0 trips -Wtype-limits.
+    (void)level;
+    return true;
+#endif
+  }
+
+  /**
+   * \brief Returns true if a log of \ref level passes the level set by
+   * \ref SetLevel.
+   * \remark The MM_LOG macros check this before evaluating their arguments.
+   */
+  bool ShouldLog(LogLevel level) const {
+    return GetSeverity(level) >= severity_.load(std::memory_order_relaxed);
+  }
+
+  void SetLevel(const LogLevel& level);
+
+  LogLevel GetLevel() const;
+
+  void SetMode(LogMode mode);
+
+  LogMode GetMode() const;
+
+  /**
+   * \brief Wait until every log queued before this call has been written,
+   * then flush the sinks.
+   */
+  void Flush() const;
+
+  template <typename... ARGS>
+  void Log(const LogLevel& level, ARGS&&... args) const {
+    if (!ShouldLog(level)) {
+      return;
+    }
+
+    if (level == LogLevel::FATAL) {
+      LogFatal(std::forward<ARGS>(args)...);
+      return;
+    }
+
+    if (mode_.load(std::memory_order_relaxed) == LogMode::ASYNCHRONOUS) {
+      async_log_queue_.Push(ToSpdlogLevel(level), std::forward<ARGS>(args)...);
+      WakeUpLogThread();
+      return;
+    }
+
+    logger_->log(ToSpdlogLevel(level), std::forward<ARGS>(args)...);
   }
 
   template <typename... ARGS>
   void LogTrace(ARGS&&... args) const {
-    logger_->trace(std::forward<ARGS>(args)...);
+    Log(LogLevel::TRACE, std::forward<ARGS>(args)...);
   }
 
   template <typename... ARGS>
   void LogInfo(ARGS&&... args) const {
-    logger_->info(std::forward<ARGS>(args)...);
+    Log(LogLevel::INFO, std::forward<ARGS>(args)...);
   }
 
   template <typename... ARGS>
   void LogDebug(ARGS&&... args) const {
-    logger_->debug(std::forward<ARGS>(args)...);
+    Log(LogLevel::DEBUG, std::forward<ARGS>(args)...);
   }
 
   template <typename... ARGS>
   void LogWarn(ARGS&&... args) const {
-    logger_->warn(std::forward<ARGS>(args)...);
+    Log(LogLevel::WARN, std::forward<ARGS>(args)...);
   }
 
   template <typename... ARGS>
   void LogError(ARGS&&... args) const {
-    logger_->error(std::forward<ARGS>(args)...);
+    Log(LogLevel::ERROR, std::forward<ARGS>(args)...);
   }
 
   template <typename... ARGS>
   void LogFatal(ARGS&&... args) const {
-    logger_->critical(std::forward<ARGS>(args)...);
+    // Earlier logs are written first, the exception may end the process.
+    Flush();
+    logger_->critical(args...);
+    logger_->flush();
     FatalCallback(std::forward<ARGS>(args)...);
   }
 
@@ -102,6 +180,12 @@ class LogSystem {
    */
   static bool Destroy();
 
+  static spdlog::level::level_enum ToSpdlogLevel(LogLevel level);
+
+  void WakeUpLogThread() const;
+
+  void ProcessAsyncLogs();
+
  protected:
   LogSystem() = default;
   ~LogSystem();
@@ -110,6 +194,17 @@ class LogSystem {
  private:
   static std::mutex sync_flag_;
   std::shared_ptr<spdlog::logger> logger_{nullptr};
+  std::atomic_uint8_t severity_{MM_LOG_LEVEL_TRACE};
+  std::atomic<LogMode> mode_{LogMode::ASYNCHRONOUS};
+
+  // Logging does not change the observable state of the system, so the queue
+  // is written by the const log functions.
+  mutable AsyncLogQueue async_log_queue_{};
+  std::thread log_thread_{};
+  mutable std::mutex log_thread_mutex_{};
+  mutable std::condition_variable log_thread_condition_{};
+  std::atomic_bool log_thread_waiting_{false};
+  bool stop_log_thread_{false};
 };
 
 #define MM_LOG_SYSTEM MM_log_system
@@ -119,7 +214,17 @@ class LogSystem {
     MM::LogSystem::LogSystem::GetInstance()        \
   }
 
-#define MM_LOG(log_level, ...) MM_LOG_SYSTEM->Log(log_level, __VA_ARGS__)
+/**
+ * \brief Log when \ref log_level passes both the compile time and the runtime
+ * level, otherwise the arguments are not evaluated at all.
+ */
+#define MM_LOG(log_level, ...)                                    \
+  do {                                                            \
+    if (MM::LogSystem::LogSystem::IsLevelCompiled(log_level) &&   \
+        MM_LOG_SYSTEM->ShouldLog(log_level)) {                    \
+      MM_LOG_SYSTEM->Log(log_level, __VA_ARGS__);                 \
+    }                                                             \
+  } while (false)
 
 #define MM_LOG_DEBUG(...) \
   MM_LOG(MM::LogSystem::LogSystem::LogLevel::DEBUG, __VA_ARGS__)
@@ -4,6 +4,8 @@
 
 #include "runtime/core/manager//ManagedObjectBase.h"
 
+#include <thread>
+
 namespace MM {
 namespace Manager {
 // ExecuteResult ManagedObjectBase::GetLightCopy(
@@ -17,7 +19,17 @@ namespace Manager {
 // }
 
 ManagedObjectBase::ManagedObjectBase()
-    : MMObject(), object_name_(GetObjectID().ToString()) {}
+    : MMObject(), name_state_(kNameNotGenerated), is_named_(false) {}
+
+ManagedObjectBase::ManagedObjectBase(const ManagedObjectBase& other)
+    : MMObject(other) {
+  AssignName(other);
+}
+
+ManagedObjectBase::ManagedObjectBase(ManagedObjectBase&& other) noexcept
+    : MMObject(std::move(other)) {
+  AssignName(std::move(other));
+}
 
 ManagedObjectBase& ManagedObjectBase::operator=(
     ManagedObjectBase&& other) noexcept {
@@ -26,7 +38,7 @@ ManagedObjectBase& ManagedObjectBase::operator=(
   }
 
   MM::MMObject::operator=(std::move(other));
-  object_name_ = std::move(other.object_name_);
+  AssignName(std::move(other));
 
   return *this;
 }
@@ -35,9 +47,15 @@ ManagedObjectBase::ManagedObjectBase(const std::string& object_name)
     : MMObject(), object_name_(object_name) {}
 
 const std::string& ManagedObjectBase::GetObjectName() const {
+  if (name_state_.load(std::memory_order_acquire) != kNameReady) {
+    GenerateObjectName();
+  }
+
   return object_name_;
 }
 
+bool ManagedObjectBase::IsNamed() const { return is_named_; }
+
 ManagedObjectID ManagedObjectBase::GetObjectID() const { return GetGuid(); }
 ManagedObjectBase& ManagedObjectBase::operator=(
     const ManagedObjectBase& other) {
@@ -46,7 +64,7 @@ ManagedObjectBase& ManagedObjectBase::operator=(
   }
 
   MMObject::operator=(other);
-  object_name_ = other.object_name_;
+  AssignName(other);
 
   return *this;
 }
@@ -60,6 +78,11 @@ void Swap(ManagedObjectBase& lhs, ManagedObjectBase& rhs) noexcept {
 
   swap(dynamic_cast<MMObject&>(lhs), dynamic_cast<MMObject&>(rhs));
   swap(lhs.object_name_, rhs.object_name_);
+  std::uint8_t lhs_name_state = lhs.name_state_.load(std::memory_order_acquire);
+  lhs.name_state_.store(rhs.name_state_.load(std::memory_order_acquire),
+                        std::memory_order_release);
+  rhs.name_state_.store(lhs_name_state, std::memory_order_release);
+  swap(lhs.is_named_, rhs.is_named_);
 }
 
 void swap(ManagedObjectBase& lhs, ManagedObjectBase& rhs) noexcept {
@@ -71,6 +94,11 @@ void swap(ManagedObjectBase& lhs, ManagedObjectBase& rhs) noexcept {
 
   swap(dynamic_cast<MMObject&>(lhs), dynamic_cast<MMObject&>(rhs));
   swap(lhs.object_name_, rhs.object_name_);
+  std::uint8_t lhs_name_state = lhs.name_state_.load(std::memory_order_acquire);
+  lhs.name_state_.store(rhs.name_state_.load(std::memory_order_acquire),
+                        std::memory_order_release);
+  rhs.name_state_.store(lhs_name_state, std::memory_order_release);
+  swap(lhs.is_named_, rhs.is_named_);
 }
 
 bool ManagedObjectBase::LowLevelEqual(const ManagedObjectBase& other) const {
@@ -80,6 +108,45 @@ bool ManagedObjectBase::LowLevelEqual(const ManagedObjectBase& other) const {
 void ManagedObjectBase::Reset() {
   MMObject::Reset();
   object_name_.clear();
+  name_state_.store(kNameReady, std::memory_order_release);
+  is_named_ = true;
+}
+
+void ManagedObjectBase::GenerateObjectName() const {
+  std::uint8_t expected = kNameNotGenerated;
+  if (name_state_.compare_exchange_strong(expected, kNameGenerating,
+                                          std::memory_order_acquire)) {
+    object_name_ = GetObjectID().ToString();
+    name_state_.store(kNameReady, std::memory_order_release);
+    return;
+  }
+
+  // Another thread is building the name.
+  while (name_state_.load(std::memory_order_acquire) != kNameReady) {
+    std::this_thread::yield();
+  }
+}
+
+void ManagedObjectBase::AssignName(const ManagedObjectBase& other) {
+  is_named_ = other.is_named_;
+  if (other.name_state_.load(std::memory_order_acquire) == kNameReady) {
+    object_name_ = other.object_name_;
+    name_state_.store(kNameReady, std::memory_order_release);
+  } else {
+    object_name_.clear();
+    name_state_.store(kNameNotGenerated, std::memory_order_release);
+  }
+}
+
+void ManagedObjectBase::AssignName(ManagedObjectBase&& other) {
+  is_named_ = other.is_named_;
+  if (other.name_state_.load(std::memory_order_acquire) == kNameReady) {
+    object_name_ = std::move(other.object_name_);
+    name_state_.store(kNameReady, std::memory_order_release);
+  } else {
+    object_name_.clear();
+    name_state_.store(kNameNotGenerated, std::memory_order_release);
+  }
 }
 }  // namespace Manager
 }  // namespace MM
\ No newline at end of file
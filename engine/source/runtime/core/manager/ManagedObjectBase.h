@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 
 #include "runtime/platform/base/MMObject.h"
@@ -10,19 +12,31 @@ namespace Manager {
 
 using ManagedObjectID = MM::Utils::GUID;
 
+/**
+ * \brief Base class of every object stored in a manager.
+ * \remark An object constructed without a name is named after its ID. That
+ * name is only built the first time \ref GetObjectName is called, and
+ * managers do not add unnamed objects to their name index.
+ */
 class ManagedObjectBase : public MMObject {
  public:
   ManagedObjectBase();
   virtual ~ManagedObjectBase() = default;
   explicit ManagedObjectBase(const std::string& object_name);
-  ManagedObjectBase(const ManagedObjectBase& other) = default;
-  ManagedObjectBase(ManagedObjectBase&& other) noexcept = default;
+  ManagedObjectBase(const ManagedObjectBase& other);
+  ManagedObjectBase(ManagedObjectBase&& other) noexcept;
   ManagedObjectBase& operator=(const ManagedObjectBase& other);
   ManagedObjectBase& operator=(ManagedObjectBase&& other) noexcept;
 
  public:
   const std::string& GetObjectName() const;
 
+  /**
+   * \brief Whether the object was given a name. An unnamed object is named
+   * after its ID.
+   */
+  bool IsNamed() const;
+
   ManagedObjectID GetObjectID() const;
 
   bool LowLevelEqual(const ManagedObjectBase& other) const;
@@ -45,7 +59,20 @@ class ManagedObjectBase : public MMObject {
   void Reset() override;
 
  private:
-  std::string object_name_{};
+  void GenerateObjectName() const;
+
+  void AssignName(const ManagedObjectBase& other);
+
+  void AssignName(ManagedObjectBase&& other);
+
+ private:
+  static constexpr std::uint8_t kNameNotGenerated = 0;
+  static constexpr std::uint8_t kNameGenerating = 1;
+  static constexpr std::uint8_t kNameReady = 2;
+
+  mutable std::string object_name_{};
+  mutable std::atomic_uint8_t name_state_{kNameReady};
+  bool is_named_{true};
 };
 
 }  // namespace Manager
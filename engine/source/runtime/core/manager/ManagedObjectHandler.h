@@ -388,7 +388,7 @@ class ManagedObjectHandler<ManagedType, ManagedType, HashSetTrait> {
  public:
   const ManagedType& GetObject() const { return *managed_object_; }
 
-  const ManagedType* GetObjectPtr() const { return *managed_object_; }
+  const ManagedType* GetObjectPtr() const { return managed_object_; }
 
   const std::atomic_uint32_t* GetUseCountPtr() const { return use_count_; }
 
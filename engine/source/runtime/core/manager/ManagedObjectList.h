@@ -15,12 +15,14 @@ class ManagedObjectList final
     : public ManagedObjectTableBase<ObjectType, ObjectType, ListTrait> {
  public:
   using ContainerTrait = ListTrait;
-  using ThisType = ManagedObjectList<ObjectType, Allocator>;
+  using ThisType = ManagedObjectList<ObjectType, Equal, Allocator>;
   using BaseType =
       ManagedObjectTableBase<ObjectType, ObjectType, ContainerTrait>;
   using HandlerType = typename BaseType::HandlerType;
   using WrapperType = typename BaseType::WrapperType;
-  using ContainerType = std::list<ManagedObjectWrapper<ObjectType>>;
+  using ContainerType = std::list<
+      WrapperType, typename std::allocator_traits<
+                       Allocator>::template rebind_alloc<WrapperType>>;
 
  public:
   ManagedObjectList();
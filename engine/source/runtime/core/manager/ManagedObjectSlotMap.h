@@ -0,0 +1,354 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+#include "utils/hash_table.h"
+#include "utils/striped_mutex.h"
+
+namespace MM {
+namespace Manager {
+/**
+ * \brief 32-bit slot index plus 32-bit generation of an object in a
+ * \ref ManagedObjectSlotMap.
+ * \remark A generation is odd while the slot holds an object, so a default
+ * constructed handle never refers to anything.
+ */
+struct ManagedObjectGenerationalHandle {
+  static constexpr std::uint32_t kInvalidIndex =
+      std::numeric_limits<std::uint32_t>::max();
+
+  std::uint32_t index_{kInvalidIndex};
+  std::uint32_t generation_{0};
+
+  bool IsValid() const { return (generation_ & 1) != 0; }
+
+  std::uint64_t Pack() const {
+    return (static_cast<std::uint64_t>(generation_) << 32) | index_;
+  }
+
+  static ManagedObjectGenerationalHandle Unpack(std::uint64_t packed_handle) {
+    return ManagedObjectGenerationalHandle{
+        static_cast<std::uint32_t>(packed_handle),
+        static_cast<std::uint32_t>(packed_handle >> 32)};
+  }
+
+  friend bool operator==(const ManagedObjectGenerationalHandle& lhs,
+                         const ManagedObjectGenerationalHandle& rhs) {
+    return lhs.index_ == rhs.index_ && lhs.generation_ == rhs.generation_;
+  }
+
+  friend bool operator!=(const ManagedObjectGenerationalHandle& lhs,
+                         const ManagedObjectGenerationalHandle& rhs) {
+    return !(lhs == rhs);
+  }
+};
+
+/**
+ * \brief Maps generational handles to reference counted objects in O(1).
+ * \remark \ref IsAlive and \ref Acquire take no lock and do no hashing: slots
+ * live in chunks that never move, and a lookup only compares the generation
+ * stored in the slot with the one in the handle.
+ * \remark The key to slot mapping is striped by the hash of the key, every
+ * stripe has its own mutex and index. Insert and erase only lock the stripe of
+ * their key, free slots and new chunks are claimed atomically, so objects with
+ * different keys are registered in parallel. \ref GetHandle only takes the
+ * stripe shared.
+ * \remark The slot map does not own the objects. It records the use count of
+ * every object, and \ref Acquire only hands an object out after raising that
+ * use count, so the object can not be freed while it is used. \ref Erase must
+ * be called before an object is freed, it waits for the \ref Acquire calls
+ * that are still reading the slot.
+ */
+template <typename KeyType, typename ObjectType,
+          typename Hash = std::hash<KeyType>>
+class ManagedObjectSlotMap {
+ public:
+  using HandleType = ManagedObjectGenerationalHandle;
+
+ public:
+  ManagedObjectSlotMap()
+      : chunks_(std::make_unique<std::atomic<Slot*>[]>(kMaxChunkCount)),
+        stripes_(std::make_unique<Stripe[]>(kStripeCount)) {}
+  ~ManagedObjectSlotMap() {
+    for (std::uint32_t i = 0; i != kMaxChunkCount; ++i) {
+      delete[] chunks_[i].load(std::memory_order_relaxed);
+    }
+  }
+  ManagedObjectSlotMap(const ManagedObjectSlotMap& other) = delete;
+  ManagedObjectSlotMap(ManagedObjectSlotMap&& other) = delete;
+  ManagedObjectSlotMap& operator=(const ManagedObjectSlotMap& other) = delete;
+  ManagedObjectSlotMap& operator=(ManagedObjectSlotMap&& other) = delete;
+
+ public:
+  std::uint64_t GetSize() const {
+    return size_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * \brief Add \ref object under \ref key.
+   * \param key The key stored next to \ref object, it has to live as long as
+   * the object.
+   * \param use_count The use count of \ref object. The object is freed once it
+   * drops to zero.
+   * \return The handle of the object, or an invalid handle if \ref key is
+   * already present or every slot is in use.
+   */
+  HandleType Insert(const KeyType& key, ObjectType* object,
+                    std::atomic_uint32_t* use_count) {
+    Stripe& stripe = ChooseStripe(key);
+    std::unique_lock<std::shared_mutex> guard{stripe.mutex_};
+    if (stripe.key_to_index_.Contains(key)) {
+      return HandleType{};
+    }
+
+    std::uint32_t index = PopFreeSlot();
+    if (index == HandleType::kInvalidIndex) {
+      index = AllocateSlot();
+      if (index == HandleType::kInvalidIndex) {
+        return HandleType{};
+      }
+    }
+
+    Slot& slot = GetSlot(index);
+    std::uint32_t generation =
+        slot.generation_.load(std::memory_order_relaxed) + 1;
+    slot.key_.store(&key, std::memory_order_relaxed);
+    slot.object_.store(object, std::memory_order_relaxed);
+    slot.use_count_.store(use_count, std::memory_order_relaxed);
+    slot.generation_.store(generation, std::memory_order_release);
+    stripe.key_to_index_.Emplace(key, index);
+    size_.fetch_add(1, std::memory_order_acq_rel);
+
+    return HandleType{index, generation};
+  }
+
+  /**
+   * \brief Remove the object stored under \ref key, every handle to it becomes
+   * stale.
+   * \remark Returns once no \ref Acquire reads the slot any more, so the
+   * object can be freed afterwards.
+   */
+  bool Erase(const KeyType& key) {
+    Stripe& stripe = ChooseStripe(key);
+    std::unique_lock<std::shared_mutex> guard{stripe.mutex_};
+    auto* key_and_index = stripe.key_to_index_.Find(key);
+    if (key_and_index == nullptr) {
+      return false;
+    }
+
+    std::uint32_t index = key_and_index->second;
+    stripe.key_to_index_.Erase(key);
+    Slot& slot = GetSlot(index);
+    // Sequentially consistent together with the visitor count of Acquire:
+    // either Acquire sees the new generation, or this sees its visit.
+    slot.generation_.store(slot.generation_.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_seq_cst);
+    while (slot.visitor_count_.load(std::memory_order_seq_cst) != 0) {
+      std::this_thread::yield();
+    }
+    slot.key_.store(nullptr, std::memory_order_relaxed);
+    slot.object_.store(nullptr, std::memory_order_relaxed);
+    slot.use_count_.store(nullptr, std::memory_order_relaxed);
+    PushFreeSlot(index);
+    size_.fetch_sub(1, std::memory_order_acq_rel);
+
+    return true;
+  }
+
+  /**
+   * \brief Resolve \ref key to its handle.
+   * \remark This hashes \ref key and takes its stripe shared. It is meant to
+   * be called once, lookups through the handle afterwards use \ref Acquire.
+   */
+  HandleType GetHandle(const KeyType& key) const {
+    Stripe& stripe = ChooseStripe(key);
+    std::shared_lock<std::shared_mutex> guard{stripe.mutex_};
+    const auto* key_and_index = stripe.key_to_index_.Find(key);
+    if (key_and_index == nullptr) {
+      return HandleType{};
+    }
+
+    return HandleType{
+        key_and_index->second,
+        GetSlot(key_and_index->second)
+            .generation_.load(std::memory_order_relaxed)};
+  }
+
+  bool IsAlive(HandleType handle) const {
+    const Slot* slot = FindSlot(handle);
+    return slot != nullptr &&
+           slot->generation_.load(std::memory_order_acquire) ==
+               handle.generation_;
+  }
+
+  /**
+   * \brief Call \ref function with the key, the object and the use count of
+   * \ref handle while holding one use count of the object.
+   * \remark \ref function must take its own use count, for example by
+   * building a handler, the one held by this call is dropped when
+   * \ref function returns. An object whose use count already dropped to zero
+   * is being removed and is not handed out.
+   * \return True if \ref function was called, false if \ref handle is stale.
+   */
+  template <typename Function>
+  bool Acquire(HandleType handle, Function&& function) const {
+    const Slot* slot = FindSlot(handle);
+    if (slot == nullptr) {
+      return false;
+    }
+
+    slot->visitor_count_.fetch_add(1, std::memory_order_seq_cst);
+    bool is_acquired = false;
+    if (slot->generation_.load(std::memory_order_seq_cst) ==
+        handle.generation_) {
+      std::atomic_uint32_t* use_count =
+          slot->use_count_.load(std::memory_order_relaxed);
+      std::uint32_t count = use_count->load(std::memory_order_acquire);
+      while (count != 0 && !use_count->compare_exchange_weak(
+                               count, count + 1, std::memory_order_acq_rel,
+                               std::memory_order_acquire)) {
+      }
+      if (count != 0) {
+        function(*slot->key_.load(std::memory_order_relaxed),
+                 *slot->object_.load(std::memory_order_relaxed), *use_count);
+        use_count->fetch_sub(1, std::memory_order_acq_rel);
+        is_acquired = true;
+      }
+    }
+    slot->visitor_count_.fetch_sub(1, std::memory_order_release);
+
+    return is_acquired;
+  }
+
+ private:
+  struct Slot {
+    std::atomic_uint32_t generation_{0};
+    std::atomic<const KeyType*> key_{nullptr};
+    std::atomic<ObjectType*> object_{nullptr};
+    std::atomic<std::atomic_uint32_t*> use_count_{nullptr};
+    // The number of Acquire calls reading the slot.
+    mutable std::atomic_uint32_t visitor_count_{0};
+    // Only meaningful while the slot is in the free list.
+    std::atomic_uint32_t next_free_index_{HandleType::kInvalidIndex};
+  };
+
+  struct alignas(Utils::StripedMutex<std::mutex>::kCacheLineSize) Stripe {
+    std::shared_mutex mutex_{};
+    Utils::HashMap<KeyType, std::uint32_t, Hash> key_to_index_{};
+  };
+
+ private:
+  Stripe& ChooseStripe(const KeyType& key) const {
+    return stripes_[Utils::HashMix64(Hash{}(key)) & (kStripeCount - 1)];
+  }
+
+  /**
+   * \brief Pop a slot from the free list.
+   * \remark The head packs the slot index with a tag that changes on every
+   * update, so a head that was popped and pushed again in between is not
+   * mistaken for an unchanged one.
+   * \return The index of the slot, or \ref HandleType::kInvalidIndex if the
+   * list is empty.
+   */
+  std::uint32_t PopFreeSlot() {
+    std::uint64_t head = free_head_.load(std::memory_order_acquire);
+    while (static_cast<std::uint32_t>(head) != HandleType::kInvalidIndex) {
+      std::uint32_t index = static_cast<std::uint32_t>(head);
+      std::uint32_t next_index =
+          GetSlot(index).next_free_index_.load(std::memory_order_relaxed);
+      if (free_head_.compare_exchange_weak(head, PackFreeHead(next_index, head),
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+        return index;
+      }
+    }
+
+    return HandleType::kInvalidIndex;
+  }
+
+  void PushFreeSlot(std::uint32_t index) {
+    std::atomic_uint32_t& next_free_index = GetSlot(index).next_free_index_;
+    std::uint64_t head = free_head_.load(std::memory_order_relaxed);
+    do {
+      next_free_index.store(static_cast<std::uint32_t>(head),
+                            std::memory_order_relaxed);
+    } while (!free_head_.compare_exchange_weak(head, PackFreeHead(index, head),
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+  }
+
+  static std::uint64_t PackFreeHead(std::uint32_t index,
+                                    std::uint64_t old_head) {
+    return ((old_head >> 32) + 1) << 32 | index;
+  }
+
+  /**
+   * \brief Claim a never used slot, the chunk holding it is created by the
+   * first thread that needs it.
+   * \return The index of the slot, or \ref HandleType::kInvalidIndex if every
+   * slot is in use.
+   */
+  std::uint32_t AllocateSlot() {
+    std::uint32_t index = slot_count_.load(std::memory_order_relaxed);
+    do {
+      if (index == kMaxChunkCount * kChunkSlotCount) {
+        return HandleType::kInvalidIndex;
+      }
+    } while (!slot_count_.compare_exchange_weak(index, index + 1,
+                                                std::memory_order_relaxed));
+
+    std::atomic<Slot*>& chunk = chunks_[index / kChunkSlotCount];
+    if (chunk.load(std::memory_order_acquire) == nullptr) {
+      Slot* new_chunk = new Slot[kChunkSlotCount]{};
+      Slot* expected = nullptr;
+      if (!chunk.compare_exchange_strong(expected, new_chunk,
+                                         std::memory_order_acq_rel)) {
+        delete[] new_chunk;
+      }
+    }
+
+    return index;
+  }
+
+  Slot& GetSlot(std::uint32_t index) const {
+    return chunks_[index / kChunkSlotCount].load(
+        std::memory_order_acquire)[index % kChunkSlotCount];
+  }
+
+  const Slot* FindSlot(HandleType handle) const {
+    if (!handle.IsValid() ||
+        handle.index_ / kChunkSlotCount >= kMaxChunkCount) {
+      return nullptr;
+    }
+
+    const Slot* chunk = chunks_[handle.index_ / kChunkSlotCount].load(
+        std::memory_order_acquire);
+    if (chunk == nullptr) {
+      return nullptr;
+    }
+
+    return &chunk[handle.index_ % kChunkSlotCount];
+  }
+
+ private:
+  static constexpr std::uint32_t kChunkSlotCount = 1024;
+  static constexpr std::uint32_t kMaxChunkCount = 4096;
+  static constexpr std::uint64_t kStripeCount =
+      Utils::StripedMutex<std::mutex>::kDefaultStripeCount;
+
+  std::unique_ptr<std::atomic<Slot*>[]> chunks_;
+  std::atomic_uint32_t slot_count_{0};
+  std::atomic_uint64_t free_head_{HandleType::kInvalidIndex};
+  std::atomic_uint64_t size_{0};
+
+  std::unique_ptr<Stripe[]> stripes_;
+};
+}  // namespace Manager
+}  // namespace MM
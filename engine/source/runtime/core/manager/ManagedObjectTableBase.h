@@ -1,6 +1,9 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
 #include <mutex>
 #include <shared_mutex>
 #include <vector>
@@ -30,6 +33,16 @@ using CannotMoved = Utils::FalseType;
 template <typename KeyType, typename ManagedType, typename ContainerTrait>
 class ManagedObjectHandler;
 
+/**
+ * \brief Stores a managed object together with its use count.
+ * \remark Both live inline in the wrapper, and the wrapper lives in the node of
+ * its container, so adding an object does not allocate anything besides that
+ * node. Handlers keep pointers into the wrapper, therefore it must not be moved
+ * once a handler refers to it. Every manager container is node based and only
+ * moves a wrapper while inserting it.
+ * \remark Moving a wrapper that has a nonzero use count is a fatal error in
+ * every build, the handlers would otherwise point at the moved from object.
+ */
 template <typename ManagedType>
 class ManagedObjectWrapper {
  public:
@@ -44,32 +57,32 @@ class ManagedObjectWrapper {
  public:
   friend bool operator<(const ManagedObjectWrapper& lhs,
                         const ManagedObjectWrapper& rhs) {
-    return *(lhs.managed_object_) < *(rhs.managed_object_);
+    return lhs.managed_object_ < rhs.managed_object_;
   }
 
   friend bool operator<(const ManagedObjectWrapper& lhs,
                         const ManagedType& rhs) {
-    return *(lhs.managed_object_) < rhs;
+    return lhs.managed_object_ < rhs;
   }
 
   friend bool operator<(const ManagedType& lhs,
                         const ManagedObjectWrapper& rhs) {
-    return lhs < *(rhs.managed_object_);
+    return lhs < rhs.managed_object_;
   }
 
   friend bool operator==(const ManagedObjectWrapper<ManagedType>& lhs,
                          const ManagedObjectWrapper<ManagedType>& rhs) {
-    return *(lhs.managed_object_) == *(rhs.managed_object_);
+    return lhs.managed_object_ == rhs.managed_object_;
   }
 
   friend bool operator==(const ManagedObjectWrapper<ManagedType>& lhs,
                          const ManagedType& rhs) {
-    return *(lhs.managed_object_) == rhs;
+    return lhs.managed_object_ == rhs;
   }
 
   friend bool operator==(const ManagedType& lhs,
                          const ManagedObjectWrapper<ManagedType>& rhs) {
-    return lhs == *(rhs.managed_object_);
+    return lhs == rhs.managed_object_;
   }
 
  public:
@@ -141,8 +154,9 @@ class ManagedObjectWrapper {
   std::atomic_uint32_t* GetUseCountPtr() const;
 
  private:
-  std::unique_ptr<ManagedType> managed_object_;
-  std::unique_ptr<std::atomic_uint32_t> use_count_{nullptr};
+  ManagedType managed_object_;
+  // Handlers change the use count through const containers (std::set keys).
+  mutable std::atomic_uint32_t use_count_{0};
 };
 
 template <typename ManagedType>
@@ -150,7 +164,7 @@ template <typename Less>
 template <typename K>
 bool ManagedObjectWrapper<ManagedType>::LessWrapperObject<Less>::operator()(
     const ManagedObjectWrapper<ManagedType>& lhs, const K& rhs) const {
-  return Less{}(*(lhs.managed_object_), rhs);
+  return Less{}(lhs.managed_object_, rhs);
 }
 
 template <typename ManagedType>
@@ -158,7 +172,7 @@ template <typename Less>
 template <typename K>
 bool ManagedObjectWrapper<ManagedType>::LessWrapperObject<Less>::operator()(
     const K& lhs, const ManagedObjectWrapper<ManagedType>& rhs) const {
-  return Less{}(lhs, *(rhs.managed_object_));
+  return Less{}(lhs, rhs.managed_object_);
 }
 
 template <typename ManagedType>
@@ -175,7 +189,7 @@ template <typename Equal>
 template <typename K>
 bool ManagedObjectWrapper<ManagedType>::EqualWrapperObject<Equal>::operator()(
     const K& lhs, const ManagedObjectWrapper<ManagedType>& rhs) const {
-  return Equal{}(lhs, *(rhs.managed_object_));
+  return Equal{}(lhs, rhs.managed_object_);
 }
 
 template <typename ManagedType>
@@ -183,7 +197,7 @@ template <typename Equal>
 template <typename K>
 bool ManagedObjectWrapper<ManagedType>::EqualWrapperObject<Equal>::operator()(
     const ManagedObjectWrapper<ManagedType>& lhs, const K& rhs) const {
-  return Equal{}(*(lhs.managed_object_), rhs);
+  return Equal{}(lhs.managed_object_, rhs);
 }
 
 template <typename ManagedType>
@@ -191,7 +205,7 @@ template <typename Hash>
 std::uint64_t
 ManagedObjectWrapper<ManagedType>::HashWrapperObject<Hash>::operator()(
     const ManagedObjectWrapper<ManagedType>& object_wrapper) const {
-  return Hash{}(*(object_wrapper.managed_object_));
+  return Hash{}(object_wrapper.managed_object_);
 }
 
 template <typename ManagedType>
@@ -199,7 +213,7 @@ template <typename Equal>
 bool ManagedObjectWrapper<ManagedType>::EqualWrapperObject<Equal>::operator()(
     const ManagedObjectWrapper<ManagedType>& lhs,
     const ManagedObjectWrapper<ManagedType>& rhs) const {
-  return Equal{}(*(lhs.managed_object_), *(rhs.managed_object_));
+  return Equal{}(lhs.managed_object_, rhs.managed_object_);
 }
 
 template <typename ManagedType>
@@ -207,56 +221,60 @@ template <typename Less>
 bool ManagedObjectWrapper<ManagedType>::LessWrapperObject<Less>::operator()(
     const ManagedObjectWrapper<ManagedType>& lhs,
     const ManagedObjectWrapper<ManagedType>& rhs) const {
-  return Less{}(*(lhs.managed_object_), *(rhs.managed_object_));
+  return Less{}(lhs.managed_object_, rhs.managed_object_);
 }
 
 template <typename ManagedType>
 ManagedObjectWrapper<ManagedType>::ManagedObjectWrapper(
     ManagedObjectWrapper&& other) noexcept
     : managed_object_(std::move(other.managed_object_)),
-      use_count_(std::move(other.use_count_)) {}
+      use_count_(0) {
+  if (other.use_count_.load(std::memory_order_acquire) != 0) {
+    MM_LOG_FATAL("A managed object was moved while handlers refer to it.");
+    std::abort();
+  }
+}
 
 template <typename ManagedType>
 std::atomic_uint32_t* ManagedObjectWrapper<ManagedType>::GetUseCountPtr()
     const {
-  return use_count_.get();
+  return &use_count_;
 }
 
 template <typename ManagedType>
 std::atomic_uint32_t* ManagedObjectWrapper<ManagedType>::GetUseCountPtr() {
-  return use_count_.get();
+  return &use_count_;
 }
 
 template <typename ManagedType>
 const ManagedType* ManagedObjectWrapper<ManagedType>::GetObjectPtr() const {
-  return managed_object_.get();
+  return &managed_object_;
 }
 
 template <typename ManagedType>
 ManagedType* ManagedObjectWrapper<ManagedType>::GetObjectPtr() {
-  return managed_object_.get();
+  return &managed_object_;
 }
 
 template <typename ManagedType>
 ManagedType& ManagedObjectWrapper<ManagedType>::GetObject() {
-  return *managed_object_;
+  return managed_object_;
 }
 
 template <typename ManagedType>
 const ManagedType& ManagedObjectWrapper<ManagedType>::GetObject() const {
-  return *managed_object_;
+  return managed_object_;
 }
 
 template <typename ManagedType>
 std::uint32_t ManagedObjectWrapper<ManagedType>::GetUseCount() const {
-  return *use_count_;
+  return use_count_.load(std::memory_order_acquire);
 }
 
 template <typename ManagedType>
 ManagedObjectWrapper<ManagedType>::ManagedObjectWrapper(
     ManagedType&& managed_object)
-    : managed_object_(std::make_unique<ManagedType>(std::move(managed_object))),
-      use_count_(std::make_unique<std::atomic_uint32_t>(0)) {}
+    : managed_object_(std::move(managed_object)), use_count_(0) {}
 
 template <typename ManagedType>
 ManagedObjectWrapper<ManagedType>& ManagedObjectWrapper<ManagedType>::operator=(
@@ -265,8 +283,12 @@ ManagedObjectWrapper<ManagedType>& ManagedObjectWrapper<ManagedType>::operator=(
     return *this;
   }
 
+  if (use_count_.load(std::memory_order_acquire) != 0 ||
+      other.use_count_.load(std::memory_order_acquire) != 0) {
+    MM_LOG_FATAL("A managed object was moved while handlers refer to it.");
+    std::abort();
+  }
   managed_object_ = std::move(other.managed_object_);
-  use_count_ = std::move(other.use_count_);
 
   return *this;
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
+#include <vector>
 
 #include "runtime/core/manager/ManagedObjectHandler.h"
 #include "runtime/core/manager/utils.h"
@@ -29,6 +32,8 @@ class ManagedObjectUnorderedMap final
       KeyType, WrapperType, typename WrapperType::template HashWrapperKey<Hash>,
       typename WrapperType::template EqualWrapperKey<Equal>, Allocator>;
   using ContainerReturnType = std::pair<const KeyType, WrapperType>;
+  using RemoveCallbackType =
+      std::function<void(const KeyType& key, ValueType& object)>;
 
   friend struct LockAll<ThisType>;
   template <typename ManagedObjectTable>
@@ -50,14 +55,19 @@ class ManagedObjectUnorderedMap final
           "access error.");
     }
   }
-  explicit ManagedObjectUnorderedMap(std::uint64_t size)
+  explicit ManagedObjectUnorderedMap(
+      std::uint64_t size,
+      std::uint64_t stripe_count =
+          Utils::StripedMutex<std::shared_mutex>::kDefaultStripeCount)
       : ManagedObjectTableBase<KeyType, ValueType, HashMapTrait>(this),
-        data_(size) {
+        data_(size),
+        data_mutexes_(stripe_count) {
     // Prevent automatic rehash.
     data_.SetLoadFactor(50.0f);
   }
   ManagedObjectUnorderedMap(const ManagedObjectUnorderedMap& other) = delete;
-  ManagedObjectUnorderedMap(ManagedObjectUnorderedMap&& other) noexcept {
+  ManagedObjectUnorderedMap(ManagedObjectUnorderedMap&& other) noexcept
+      : data_mutexes_(other.data_mutexes_.StripeCount()) {
     static_assert(std::is_same_v<CanMovedTrait, CanMoved>,
                   "The move operation can only be used if the template "
                   "parameter 'IsCanMoved' is marked as 'MM::Utils::TrueType'.");
@@ -80,16 +90,8 @@ class ManagedObjectUnorderedMap final
       return *this;
     }
 
-    std::lock(data_mutex0_, data_mutex1_, data_mutex2_, data_mutex3_,
-              data_mutex4_, data_mutex5_, data_mutex6_, data_mutex7_,
-              data_mutex8_, data_mutex9_, data_mutex10_, data_mutex11_,
-              data_mutex12_, data_mutex13_, data_mutex14_, data_mutex15_,
-              other.data_mutex0_, other.data_mutex1_, other.data_mutex2_,
-              other.data_mutex3_, other.data_mutex4_, other.data_mutex5_,
-              other.data_mutex6_, other.data_mutex7_, other.data_mutex8_,
-              other.data_mutex9_, other.data_mutex10_, other.data_mutex11_,
-              other.data_mutex12_, other.data_mutex13_, other.data_mutex14_,
-              other.data_mutex15_);
+    Utils::StripedMutex<std::shared_mutex>::LockAllPair(
+        data_mutexes_, other.data_mutexes_);
     if (size_.load(std::memory_order_acquire) != 0) {
       MM_LOG_ERROR(
           "If there is data in the original container but it is reassigned, an "
@@ -112,6 +114,16 @@ class ManagedObjectUnorderedMap final
     return size_.load(std::memory_order_relaxed);
   }
 
+  /**
+   * \brief Set the function called right before an object is removed because
+   * its last handler was released.
+   * \remark The callback runs while the stripe of \ref key is locked, so it
+   * must not access this container. It is not transferred by a move.
+   */
+  void SetRemoveCallback(RemoveCallbackType remove_callback) {
+    remove_callback_ = std::move(remove_callback);
+  }
+
   void Reserve(std::uint64_t new_size) {
     LockAll guard(*this);
     data_.ReHash(new_size);
@@ -171,20 +183,78 @@ class ManagedObjectUnorderedMap final
     std::pair<ContainerReturnType&, bool> insert_result =
         data_.Emplace(key, std::move(managed_object));
 
-    if (!insert_result.second) {
-      return Result<HandlerType, ErrorResult>(
-          st_execute_error, ErrorCode::OPERATION_NOT_SUPPORTED);
-    }
+    return GetAddObjectResult(&(insert_result.first), insert_result.second);
+  }
+
+  /**
+   * \brief Adds every object of \ref managed_objects. The container grows at
+   * most once, the objects are grouped by stripe and every stripe is locked
+   * once for its whole group.
+   * \return The result of every object, in the order of \ref managed_objects.
+   */
+  std::vector<MM::Result<HandlerType, ErrorResult>> AddObjectBatch(
+      std::vector<std::pair<KeyType, ValueType>>&& managed_objects) {
+    std::vector<Result<HandlerType, ErrorResult>> results(
+        managed_objects.size(),
+        Result<HandlerType, ErrorResult>(st_execute_error,
+                                         ErrorCode::OBJECT_IS_INVALID));
+    if (!ThisType::TestMovedWhenAddObject()) {
+      return results;
+    }
+
+    // All stripes are locked while the container grows, so InsertBatch below
+    // finds room for its group and never rehashes under a single stripe lock.
+    ResizeWhenNeeded(managed_objects.size());
+
+    std::vector<std::pair<std::shared_mutex*, std::uint64_t>> stripe_order =
+        SortByStripe(managed_objects.size(),
+                     [&managed_objects](std::uint64_t i) -> const KeyType& {
+                       return managed_objects[i].first;
+                     });
+    std::vector<std::uint64_t> retry_indexes;
+    std::vector<std::uint64_t> group_indexes;
+    std::vector<ContainerReturnType> group_objects;
+    for (auto group_begin = stripe_order.begin();
+         group_begin != stripe_order.end();) {
+      std::shared_mutex* mutex = group_begin->first;
+      auto group_end = std::find_if(
+          group_begin, stripe_order.end(),
+          [mutex](const std::pair<std::shared_mutex*, std::uint64_t>& element) {
+            return element.first != mutex;
+          });
+
+      std::unique_lock<std::shared_mutex> guard{*mutex};
+      group_indexes.clear();
+      group_objects.clear();
+      for (auto iter = group_begin; iter != group_end; ++iter) {
+        std::pair<KeyType, ValueType>& managed_object =
+            managed_objects[iter->second];
+        // The container was resized after the keys were sorted.
+        if (&ChooseMutexIn(managed_object.first) != mutex) {
+          retry_indexes.emplace_back(iter->second);
+          continue;
+        }
+        group_indexes.emplace_back(iter->second);
+        group_objects.emplace_back(managed_object.first,
+                                   std::move(managed_object.second));
+      }
 
-    Result<HandlerType, ErrorResult> result{
-        st_execute_success, BaseType::GetThisPtrPtr(),
-        &(insert_result.first.first),
-        const_cast<ValueType*>(insert_result.first.second.GetObjectPtr()),
-        insert_result.first.second.GetUseCountPtr()};
+      std::vector<std::pair<ContainerReturnType*, bool>> insert_results =
+          data_.InsertBatch(std::move(group_objects));
+      for (std::uint64_t i = 0; i != insert_results.size(); ++i) {
+        results[group_indexes[i]] = GetAddObjectResult(
+            insert_results[i].first, insert_results[i].second);
+      }
 
-    size_.fetch_add(1, std::memory_order_acq_rel);
+      group_begin = group_end;
+    }
 
-    return result;
+    for (std::uint64_t index : retry_indexes) {
+      results[index] = AddObject(managed_objects[index].first,
+                                 std::move(managed_objects[index].second));
+    }
+
+    return results;
   }
 
   MM::Result<HandlerType, ErrorResult> GetObject(const KeyType& key) const {
@@ -203,18 +273,66 @@ class ManagedObjectUnorderedMap final
       }
     }
 
-    const ContainerReturnType* iter = data_.Find(key);
+    return GetGetObjectResult(data_.Find(key));
+  }
 
-    if (iter == nullptr) {
-      return Result<HandlerType, ErrorResult>(
-          st_execute_error,
-          ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+  /**
+   * \brief Gets the object of every key, every stripe is locked once for all
+   * keys it guards.
+   * \return The result of every key, in the order of \ref keys.
+   */
+  std::vector<MM::Result<HandlerType, ErrorResult>> GetObjectBatch(
+      const std::vector<KeyType>& keys) const {
+    std::vector<Result<HandlerType, ErrorResult>> results(
+        keys.size(), Result<HandlerType, ErrorResult>(
+                         st_execute_error, ErrorCode::OBJECT_IS_INVALID));
+    if (!ThisType::TestMovedWhenGetObject()) {
+      return results;
+    }
+
+    std::vector<std::pair<std::shared_mutex*, std::uint64_t>> stripe_order =
+        SortByStripe(keys.size(), [&keys](std::uint64_t i) -> const KeyType& {
+          return keys[i];
+        });
+    std::vector<std::uint64_t> retry_indexes;
+    std::vector<std::uint64_t> group_indexes;
+    std::vector<KeyType> group_keys;
+    for (auto group_begin = stripe_order.begin();
+         group_begin != stripe_order.end();) {
+      std::shared_mutex* mutex = group_begin->first;
+      auto group_end = std::find_if(
+          group_begin, stripe_order.end(),
+          [mutex](const std::pair<std::shared_mutex*, std::uint64_t>& element) {
+            return element.first != mutex;
+          });
+
+      std::shared_lock<std::shared_mutex> guard{*mutex};
+      group_indexes.clear();
+      group_keys.clear();
+      for (auto iter = group_begin; iter != group_end; ++iter) {
+        // The container was resized after the keys were sorted.
+        if (&ChooseMutexIn(keys[iter->second]) != mutex) {
+          retry_indexes.emplace_back(iter->second);
+          continue;
+        }
+        group_indexes.emplace_back(iter->second);
+        group_keys.emplace_back(keys[iter->second]);
+      }
+
+      std::vector<const ContainerReturnType*> find_results =
+          data_.FindBatch(group_keys);
+      for (std::uint64_t i = 0; i != find_results.size(); ++i) {
+        results[group_indexes[i]] = GetGetObjectResult(find_results[i]);
+      }
+
+      group_begin = group_end;
     }
 
-    return Result<HandlerType, ErrorResult>(
-        st_execute_success, BaseType::GetThisPtrPtr(), &(iter->first),
-        const_cast<ValueType*>(iter->second.GetObjectPtr()),
-        iter->second.GetUseCountPtr());
+    for (std::uint64_t index : retry_indexes) {
+      results[index] = GetObject(keys[index]);
+    }
+
+    return results;
   }
 
   uint32_t GetUseCount(const KeyType& key) const {
@@ -269,6 +387,9 @@ class ManagedObjectUnorderedMap final
     }
 
     if (iter->second.GetUseCount() == 0) {
+      if (remove_callback_) {
+        remove_callback_(iter->first, iter->second.GetObject());
+      }
       data_.Erase(iter);
 
       size_.fetch_sub(1, std::memory_order_acq_rel);
@@ -278,9 +399,12 @@ class ManagedObjectUnorderedMap final
   }
 
  private:
-  void ResizeWhenNeeded() {
-    if (data_.BucketCount() - size_.load(std::memory_order_acquire) < 128) {
-      std::uint64_t new_size = data_.BucketCount() * 2;
+  void ResizeWhenNeeded(std::uint64_t add_count = 1) {
+    const std::uint64_t need_size =
+        size_.load(std::memory_order_acquire) + add_count - 1;
+    if (data_.BucketCount() < need_size + 128) {
+      std::uint64_t new_size =
+          std::max(data_.BucketCount() * 2, need_size + 128);
       if (new_size < 2048) {
         new_size = 2048;
       }
@@ -288,6 +412,61 @@ class ManagedObjectUnorderedMap final
     }
   }
 
+  MM::Result<HandlerType, ErrorResult> GetAddObjectResult(
+      ContainerReturnType* insert_object, bool is_inserted) {
+    if (!is_inserted) {
+      return Result<HandlerType, ErrorResult>(
+          st_execute_error, ErrorCode::OPERATION_NOT_SUPPORTED);
+    }
+
+    Result<HandlerType, ErrorResult> result{
+        st_execute_success, BaseType::GetThisPtrPtr(), &(insert_object->first),
+        const_cast<ValueType*>(insert_object->second.GetObjectPtr()),
+        insert_object->second.GetUseCountPtr()};
+
+    size_.fetch_add(1, std::memory_order_acq_rel);
+
+    return result;
+  }
+
+  MM::Result<HandlerType, ErrorResult> GetGetObjectResult(
+      const ContainerReturnType* object) const {
+    if (object == nullptr) {
+      return Result<HandlerType, ErrorResult>(
+          st_execute_error,
+          ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+    }
+
+    return Result<HandlerType, ErrorResult>(
+        st_execute_success, BaseType::GetThisPtrPtr(), &(object->first),
+        const_cast<ValueType*>(object->second.GetObjectPtr()),
+        object->second.GetUseCountPtr());
+  }
+
+  /**
+   * \brief Orders the indexes 0 .. \ref count by the stripe of their keys, so
+   * that a batch locks every stripe once.
+   */
+  template <typename KeyGetter>
+  std::vector<std::pair<std::shared_mutex*, std::uint64_t>> SortByStripe(
+      std::uint64_t count, KeyGetter&& get_key) const {
+    std::vector<std::pair<std::shared_mutex*, std::uint64_t>> stripe_order;
+    stripe_order.reserve(count);
+    for (std::uint64_t i = 0; i != count; ++i) {
+      stripe_order.emplace_back(&ChooseMutexIn(get_key(i)), i);
+    }
+    std::sort(stripe_order.begin(), stripe_order.end(),
+              [](const std::pair<std::shared_mutex*, std::uint64_t>& lhs,
+                 const std::pair<std::shared_mutex*, std::uint64_t>& rhs) {
+                if (lhs.first != rhs.first) {
+                  return std::less<std::shared_mutex*>{}(lhs.first, rhs.first);
+                }
+                return lhs.second < rhs.second;
+              });
+
+    return stripe_order;
+  }
+
   std::shared_mutex& ChooseMutexIn(const KeyType& key) const {
     // return data_mutex0_;
     return ChooseMutex(*this, Hash{}(key), data_.BucketCount());
@@ -297,22 +476,9 @@ class ManagedObjectUnorderedMap final
   ContainerType data_{};
   std::atomic_uint64_t size_{0};
 
-  mutable std::shared_mutex data_mutex0_{};
-  mutable std::shared_mutex data_mutex1_{};
-  mutable std::shared_mutex data_mutex2_{};
-  mutable std::shared_mutex data_mutex3_{};
-  mutable std::shared_mutex data_mutex4_{};
-  mutable std::shared_mutex data_mutex5_{};
-  mutable std::shared_mutex data_mutex6_{};
-  mutable std::shared_mutex data_mutex7_{};
-  mutable std::shared_mutex data_mutex8_{};
-  mutable std::shared_mutex data_mutex9_{};
-  mutable std::shared_mutex data_mutex10_{};
-  mutable std::shared_mutex data_mutex11_{};
-  mutable std::shared_mutex data_mutex12_{};
-  mutable std::shared_mutex data_mutex13_{};
-  mutable std::shared_mutex data_mutex14_{};
-  mutable std::shared_mutex data_mutex15_{};
+  Utils::StripedMutex<std::shared_mutex> data_mutexes_{};
+
+  RemoveCallbackType remove_callback_{};
 };
 
 template <
@@ -358,16 +524,21 @@ class ManagedObjectUnorderedMultiMap
           "access error.");
     }
   }
-  explicit ManagedObjectUnorderedMultiMap(std::uint64_t size)
+  explicit ManagedObjectUnorderedMultiMap(
+      std::uint64_t size,
+      std::uint64_t stripe_count =
+          Utils::StripedMutex<std::shared_mutex>::kDefaultStripeCount)
       : ManagedObjectTableBase<KeyType, ValueType, HashMapTrait>(this),
-        data_(size) {
+        data_(size),
+        data_mutexes_(stripe_count) {
     // Prevent automatic rehash.
     data_.SetLoadFactor(50.0f);
   }
   ManagedObjectUnorderedMultiMap(const ManagedObjectUnorderedMultiMap& other) =
       delete;
   ManagedObjectUnorderedMultiMap(
-      ManagedObjectUnorderedMultiMap&& other) noexcept {
+      ManagedObjectUnorderedMultiMap&& other) noexcept
+      : data_mutexes_(other.data_mutexes_.StripeCount()) {
     static_assert(std::is_same_v<CanMovedTrait, CanMoved>,
                   "The move operation can only be used if the template "
                   "parameter 'IsCanMoved' is marked as 'MM::Utils::TrueType'.");
@@ -390,16 +561,8 @@ class ManagedObjectUnorderedMultiMap
       return *this;
     }
 
-    std::lock(data_mutex0_, data_mutex1_, data_mutex2_, data_mutex3_,
-              data_mutex4_, data_mutex5_, data_mutex6_, data_mutex7_,
-              data_mutex8_, data_mutex9_, data_mutex10_, data_mutex11_,
-              data_mutex12_, data_mutex13_, data_mutex14_, data_mutex15_,
-              other.data_mutex0_, other.data_mutex1_, other.data_mutex2_,
-              other.data_mutex3_, other.data_mutex4_, other.data_mutex5_,
-              other.data_mutex6_, other.data_mutex7_, other.data_mutex8_,
-              other.data_mutex9_, other.data_mutex10_, other.data_mutex11_,
-              other.data_mutex12_, other.data_mutex13_, other.data_mutex14_,
-              other.data_mutex15_);
+    Utils::StripedMutex<std::shared_mutex>::LockAllPair(
+        data_mutexes_, other.data_mutexes_);
     if (size_.load(std::memory_order_acquire) != 0) {
       MM_LOG_ERROR(
           "If there is data in the original container but it is reassigned, an "
@@ -793,22 +956,7 @@ class ManagedObjectUnorderedMultiMap
   ContainerType data_;
   std::atomic_uint64_t size_{0};
 
-  mutable std::shared_mutex data_mutex0_{};
-  mutable std::shared_mutex data_mutex1_{};
-  mutable std::shared_mutex data_mutex2_{};
-  mutable std::shared_mutex data_mutex3_{};
-  mutable std::shared_mutex data_mutex4_{};
-  mutable std::shared_mutex data_mutex5_{};
-  mutable std::shared_mutex data_mutex6_{};
-  mutable std::shared_mutex data_mutex7_{};
-  mutable std::shared_mutex data_mutex8_{};
-  mutable std::shared_mutex data_mutex9_{};
-  mutable std::shared_mutex data_mutex10_{};
-  mutable std::shared_mutex data_mutex11_{};
-  mutable std::shared_mutex data_mutex12_{};
-  mutable std::shared_mutex data_mutex13_{};
-  mutable std::shared_mutex data_mutex14_{};
-  mutable std::shared_mutex data_mutex15_{};
+  Utils::StripedMutex<std::shared_mutex> data_mutexes_{};
 };
 
 }  // namespace Manager
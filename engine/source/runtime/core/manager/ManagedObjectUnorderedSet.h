@@ -52,14 +52,19 @@ class ManagedObjectUnorderedSet final
           "access error.");
     }
   }
-  explicit ManagedObjectUnorderedSet(std::uint32_t size)
+  explicit ManagedObjectUnorderedSet(
+      std::uint32_t size,
+      std::uint64_t stripe_count =
+          Utils::StripedMutex<std::shared_mutex>::kDefaultStripeCount)
       : ManagedObjectTableBase<ObjectType, ObjectType, ListTrait>(this),
-        data_(size) {
+        data_(size),
+        data_mutexes_(stripe_count) {
     // Prevent automatic rehash.
     data_.SetLoadFactor(50.0f);
   }
   ManagedObjectUnorderedSet(const ManagedObjectUnorderedSet& other) = delete;
-  ManagedObjectUnorderedSet(ManagedObjectUnorderedSet&& other) noexcept {
+  ManagedObjectUnorderedSet(ManagedObjectUnorderedSet&& other) noexcept
+      : data_mutexes_(other.data_mutexes_.StripeCount()) {
     static_assert(std::is_same_v<CanMovedTrait, CanMoved>,
                   "The move operation can only be used if the template "
                   "parameter 'IsCanMoved' is marked as 'MM::Utils::TrueType'.");
@@ -84,16 +89,8 @@ class ManagedObjectUnorderedSet final
       return *this;
     }
 
-    std::lock(data_mutex0_, data_mutex1_, data_mutex2_, data_mutex3_,
-              data_mutex4_, data_mutex5_, data_mutex6_, data_mutex7_,
-              data_mutex8_, data_mutex9_, data_mutex10_, data_mutex11_,
-              data_mutex12_, data_mutex13_, data_mutex14_, data_mutex15_,
-              other.data_mutex0_, other.data_mutex1_, other.data_mutex2_,
-              other.data_mutex3_, other.data_mutex4_, other.data_mutex5_,
-              other.data_mutex6_, other.data_mutex7_, other.data_mutex8_,
-              other.data_mutex9_, other.data_mutex10_, other.data_mutex11_,
-              other.data_mutex12_, other.data_mutex13_, other.data_mutex14_,
-              other.data_mutex15_);
+    Utils::StripedMutex<std::shared_mutex>::LockAllPair(
+        data_mutexes_, other.data_mutexes_);
     if (size_.load(std::memory_order_acquire) != 0) {
       MM_LOG_ERROR(
           "If there is data in the original container but it is reassigned, an "
@@ -300,22 +297,7 @@ class ManagedObjectUnorderedSet final
   ContainerType data_{};
   std::atomic_uint64_t size_{0};
 
-  mutable std::shared_mutex data_mutex0_{};
-  mutable std::shared_mutex data_mutex1_{};
-  mutable std::shared_mutex data_mutex2_{};
-  mutable std::shared_mutex data_mutex3_{};
-  mutable std::shared_mutex data_mutex4_{};
-  mutable std::shared_mutex data_mutex5_{};
-  mutable std::shared_mutex data_mutex6_{};
-  mutable std::shared_mutex data_mutex7_{};
-  mutable std::shared_mutex data_mutex8_{};
-  mutable std::shared_mutex data_mutex9_{};
-  mutable std::shared_mutex data_mutex10_{};
-  mutable std::shared_mutex data_mutex11_{};
-  mutable std::shared_mutex data_mutex12_{};
-  mutable std::shared_mutex data_mutex13_{};
-  mutable std::shared_mutex data_mutex14_{};
-  mutable std::shared_mutex data_mutex15_{};
+  Utils::StripedMutex<std::shared_mutex> data_mutexes_{};
 };
 
 template <typename ObjectType, typename Hash = std::hash<ObjectType>,
@@ -359,16 +341,21 @@ class ManagedObjectUnorderedMultiSet
           "access error.");
     }
   }
-  explicit ManagedObjectUnorderedMultiSet(std::uint32_t size)
+  explicit ManagedObjectUnorderedMultiSet(
+      std::uint32_t size,
+      std::uint64_t stripe_count =
+          Utils::StripedMutex<std::shared_mutex>::kDefaultStripeCount)
       : ManagedObjectTableBase<ObjectType, ObjectType, ListTrait>(this),
-        data_(size) {
+        data_(size),
+        data_mutexes_(stripe_count) {
     // Prevent automatic rehash.
     data_.SetLoadFactor(50.0f);
   }
   ManagedObjectUnorderedMultiSet(const ManagedObjectUnorderedMultiSet& other) =
       delete;
   ManagedObjectUnorderedMultiSet(
-      ManagedObjectUnorderedMultiSet&& other) noexcept {
+      ManagedObjectUnorderedMultiSet&& other) noexcept
+      : data_mutexes_(other.data_mutexes_.StripeCount()) {
     static_assert(std::is_same_v<CanMovedTrait, CanMoved>,
                   "The move operation can only be used if the template "
                   "parameter 'IsCanMoved' is marked as 'MM::Utils::TrueType'.");
@@ -391,16 +378,8 @@ class ManagedObjectUnorderedMultiSet
       return *this;
     }
 
-    std::lock(data_mutex0_, data_mutex1_, data_mutex2_, data_mutex3_,
-              data_mutex4_, data_mutex5_, data_mutex6_, data_mutex7_,
-              data_mutex8_, data_mutex9_, data_mutex10_, data_mutex11_,
-              data_mutex12_, data_mutex13_, data_mutex14_, data_mutex15_,
-              other.data_mutex0_, other.data_mutex1_, other.data_mutex2_,
-              other.data_mutex3_, other.data_mutex4_, other.data_mutex5_,
-              other.data_mutex6_, other.data_mutex7_, other.data_mutex8_,
-              other.data_mutex9_, other.data_mutex10_, other.data_mutex11_,
-              other.data_mutex12_, other.data_mutex13_, other.data_mutex14_,
-              other.data_mutex15_);
+    Utils::StripedMutex<std::shared_mutex>::LockAllPair(
+        data_mutexes_, other.data_mutexes_);
     if (size_.load(std::memory_order_acquire) != 0) {
       MM_LOG_ERROR(
           "If there is data in the original container but it is reassigned, an "
@@ -721,22 +700,7 @@ class ManagedObjectUnorderedMultiSet
   ContainerType data_;
   std::atomic_uint64_t size_{0};
 
-  mutable std::shared_mutex data_mutex0_{};
-  mutable std::shared_mutex data_mutex1_{};
-  mutable std::shared_mutex data_mutex2_{};
-  mutable std::shared_mutex data_mutex3_{};
-  mutable std::shared_mutex data_mutex4_{};
-  mutable std::shared_mutex data_mutex5_{};
-  mutable std::shared_mutex data_mutex6_{};
-  mutable std::shared_mutex data_mutex7_{};
-  mutable std::shared_mutex data_mutex8_{};
-  mutable std::shared_mutex data_mutex9_{};
-  mutable std::shared_mutex data_mutex10_{};
-  mutable std::shared_mutex data_mutex11_{};
-  mutable std::shared_mutex data_mutex12_{};
-  mutable std::shared_mutex data_mutex13_{};
-  mutable std::shared_mutex data_mutex14_{};
-  mutable std::shared_mutex data_mutex15_{};
+  Utils::StripedMutex<std::shared_mutex> data_mutexes_{};
 };
 }  // namespace Manager
 }  // namespace MM
@@ -2,9 +2,12 @@
 
 #include <atomic>
 #include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "runtime/core/manager/ManagedObjectBase.h"
+#include "runtime/core/manager/ManagedObjectSlotMap.h"
 #include "runtime/core/manager/ManagedObjectUnorderedMap.h"
 
 namespace MM {
@@ -12,17 +15,34 @@ namespace Manager {
 using ManagedObjectIsSmartPoint = Utils::TrueType;
 using ManagedObjectIsNotSmartPoint = Utils::FalseType;
 
-template <typename ManagedType, typename ManagedTypeIsSmartPointType>
+/**
+ * \brief Base class of every manager.
+ * \remark \ref Allocator is rebound for the name and object containers. Pass
+ * \ref Utils::SlabAllocator to keep the managed objects in slabs instead of
+ * allocating each of them separately, with a tag type of the manager's own if
+ * it should not share the pool with other managers.
+ */
+template <typename ManagedType, typename ManagedTypeIsSmartPointType,
+          typename Allocator = std::allocator<ManagedType>>
 class ManagerBaseImp {
  public:
   class BaseHandler;
 
-  using ThisType = ManagerBaseImp<ManagedType, ManagedTypeIsSmartPointType>;
-  using BaseNameToIDContainer =
-      ManagedObjectUnorderedMultiMap<std::string, ManagedObjectID>;
-  using BaseIDToObjectContainer =
-      ManagedObjectUnorderedMap<ManagedObjectID, ManagedType>;
+  using ThisType =
+      ManagerBaseImp<ManagedType, ManagedTypeIsSmartPointType, Allocator>;
+  using BaseNameToIDContainer = ManagedObjectUnorderedMultiMap<
+      std::string, ManagedObjectID, std::hash<std::string>,
+      std::equal_to<std::string>,
+      typename std::allocator_traits<Allocator>::template rebind_alloc<
+          std::pair<std::string, ManagedObjectWrapper<ManagedObjectID>>>>;
+  using BaseIDToObjectContainer = ManagedObjectUnorderedMap<
+      ManagedObjectID, ManagedType, std::hash<ManagedObjectID>,
+      std::equal_to<ManagedObjectID>,
+      typename std::allocator_traits<Allocator>::template rebind_alloc<
+          std::pair<ManagedObjectID, ManagedObjectWrapper<ManagedType>>>>;
   using HandlerType = BaseHandler;
+  using GenerationalHandleType = ManagedObjectGenerationalHandle;
+  using SlotMapType = ManagedObjectSlotMap<ManagedObjectID, ManagedType>;
 
  public:
   class BaseHandler {
@@ -61,10 +81,16 @@ class ManagerBaseImp {
     virtual bool IsValid() const { return ID_to_object_handler_.IsValid(); }
 
     ManagedObjectID GetObjectID() const {
-      return name_to_ID_handler_.GetObject();
+      return ID_to_object_handler_.GetKey();
     }
 
     const std::string& GetObjectName() const {
+      // Unnamed objects are not in the name index.
+      if (!name_to_ID_handler_.IsValid()) {
+        return GetManagedObjectBase(ID_to_object_handler_.GetObject())
+            .GetObjectName();
+      }
+
       return name_to_ID_handler_.GetKey();
     }
 
@@ -148,18 +174,25 @@ class ManagerBaseImp {
     auto name_to_ID_handlers =
         name_to_ID_container_.GetObject(object_name, st_get_multiply_object)
             .Exception();
-    if (!name_to_ID_handlers.IsSuccess()) {
+    std::vector<ManagedObjectID> IDs;
+    if (name_to_ID_handlers.IsSuccess()) {
+      IDs.reserve(name_to_ID_handlers.GetResult().size() + 1);
+      for (const auto& handler : name_to_ID_handlers.GetResult()) {
+        IDs.emplace_back(handler.GetObject());
+      }
+    }
+
+    auto unnamed_object_handler = GetUnnamedObjectByName(object_name);
+    if (unnamed_object_handler.IsSuccess()) {
+      IDs.emplace_back(unnamed_object_handler.GetResult().GetKey());
+    }
+
+    if (IDs.empty()) {
       return Result<std::vector<ManagedObjectID>, ErrorResult>(
           st_execute_error,
           ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
     }
 
-    std::vector<ManagedObjectID> IDs;
-    IDs.reserve(name_to_ID_handlers.GetResult().size());
-    for (const auto& handler : name_to_ID_handlers.GetResult()) {
-      IDs.emplace_back(handler.GetObject());
-    }
-
     return Result<std::vector<ManagedObjectID>, ErrorResult>(st_execute_success,
                                                              std::move(IDs));
   }
@@ -170,9 +203,15 @@ class ManagerBaseImp {
         name_to_ID_container_.GetObject(object_name, st_get_one_object)
             .Exception();
     if (!name_to_ID_handler.IsSuccess()) {
+      auto unnamed_object_handler = GetUnnamedObjectByName(object_name);
+      if (!unnamed_object_handler.IsSuccess()) {
+        return Result<ManagedObjectID, ErrorResult>(
+            st_execute_error,
+            ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+      }
+
       return Result<ManagedObjectID, ErrorResult>(
-          st_execute_error,
-          ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+          st_execute_success, unnamed_object_handler.GetResult().GetKey());
     }
 
     return Result<ManagedObjectID, ErrorResult>(
@@ -189,6 +228,59 @@ class ManagerBaseImp {
     ID_to_object_container_.Reserve(ID_to_object_size);
   }
 
+  /**
+   * \brief Get the generational handle of the object with \ref object_ID.
+   * \remark The lookup hashes \ref object_ID once. Keep the handle and use
+   * \ref IsAlive and \ref GetObjectByHandle afterwards, they take no lock and
+   * cost one array access.
+   */
+  Result<GenerationalHandleType, ErrorResult> GetGenerationalHandle(
+      ManagedObjectID object_ID) const {
+    GenerationalHandleType handle = slot_map_.GetHandle(object_ID);
+    if (!handle.IsValid()) {
+      return Result<GenerationalHandleType, ErrorResult>(
+          st_execute_error,
+          ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+    }
+
+    return Result<GenerationalHandleType, ErrorResult>(st_execute_success,
+                                                       handle);
+  }
+
+  bool IsAlive(GenerationalHandleType handle) const {
+    return slot_map_.IsAlive(handle);
+  }
+
+  /**
+   * \brief Get a handler of the object of \ref handle.
+   * \remark The handler holds a use count of the object, like the handlers
+   * returned by the other getters. It does not hold the name index entry of
+   * the object, so a lookup by name can fail once every other handler is
+   * released.
+   * \return The handler, or an error if the object has been removed.
+   */
+  Result<HandlerType, ErrorResult> GetObjectByHandle(
+      GenerationalHandleType handle) const {
+    typename BaseIDToObjectContainer::HandlerType ID_to_object_handler{};
+    slot_map_.Acquire(handle, [this, &ID_to_object_handler](
+                                  const ManagedObjectID& object_ID,
+                                  ManagedType& object,
+                                  std::atomic_uint32_t& use_count) {
+      ID_to_object_handler = typename BaseIDToObjectContainer::HandlerType{
+          ID_to_object_container_.GetThisPtrPtr(), &object_ID, &object,
+          &use_count};
+    });
+    if (!ID_to_object_handler.IsValid()) {
+      return Result<HandlerType, ErrorResult>(
+          st_execute_error,
+          ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+    }
+
+    return Result<HandlerType, ErrorResult>(
+        st_execute_success, typename BaseNameToIDContainer::HandlerType{},
+        std::move(ID_to_object_handler));
+  }
+
  protected:
   Result<typename BaseIDToObjectContainer::HandlerType, ErrorResult>
   GetIDToObjectHandler(ManagedObjectID object_ID) const {
@@ -200,6 +292,74 @@ class ManagerBaseImp {
                             ManagedTypeIsSmartPointType{});
   }
 
+  /**
+   * \brief Add every object of \ref managed_objects. The objects are inserted
+   * into the ID index with one batch, so the index grows at most once.
+   * \return The result of every object, in the order of \ref managed_objects.
+   */
+  std::vector<Result<HandlerType, ErrorResult>> AddObjectBatchBase(
+      std::vector<ManagedType>&& managed_objects) {
+    std::vector<Result<HandlerType, ErrorResult>> results(
+        managed_objects.size(),
+        Result<HandlerType, ErrorResult>(st_execute_error,
+                                         ErrorCode::OBJECT_IS_INVALID));
+    std::vector<typename BaseNameToIDContainer::HandlerType> name_ID_handlers(
+        managed_objects.size());
+    std::vector<std::pair<ManagedObjectID, ManagedType>> ID_objects;
+    std::vector<std::uint64_t> object_indexes;
+    ID_objects.reserve(managed_objects.size());
+    object_indexes.reserve(managed_objects.size());
+    for (std::uint64_t i = 0; i != managed_objects.size(); ++i) {
+      const ManagedObjectBase& managed_object_base =
+          GetManagedObjectBase(managed_objects[i]);
+      if (managed_object_base.IsNamed()) {
+        ManagedObjectID copy_ID = managed_object_base.GetObjectID();
+        auto name_ID_handler =
+            name_to_ID_container_
+                .AddObject(managed_object_base.GetObjectName(),
+                           std::move(copy_ID))
+                .Exception();
+        if (!name_ID_handler.IsSuccess()) {
+          results[i] = Result<HandlerType, ErrorResult>(
+              st_execute_error, name_ID_handler.GetError().GetErrorCode());
+          continue;
+        }
+        name_ID_handlers[i] = std::move(name_ID_handler.GetResult());
+      }
+
+      ManagedObjectID object_ID = managed_object_base.GetObjectID();
+      ID_objects.emplace_back(std::move(object_ID),
+                              std::move(managed_objects[i]));
+      object_indexes.emplace_back(i);
+    }
+
+    std::vector<Result<typename BaseIDToObjectContainer::HandlerType,
+                       ErrorResult>>
+        ID_to_object_handlers =
+            ID_to_object_container_.AddObjectBatch(std::move(ID_objects));
+    for (std::uint64_t i = 0; i != ID_to_object_handlers.size(); ++i) {
+      const std::uint64_t index = object_indexes[i];
+      auto& ID_to_object_handler = ID_to_object_handlers[i].Exception();
+      if (!ID_to_object_handler.IsSuccess()) {
+        results[index] = Result<HandlerType, ErrorResult>(
+            st_execute_error, ID_to_object_handler.GetError().GetErrorCode());
+        continue;
+      }
+      if (!RegisterInSlotMap(ID_to_object_handler.GetResult())) {
+        // Every slot is in use. Dropping the handlers removes the object again.
+        results[index] = Result<HandlerType, ErrorResult>(
+            st_execute_error, ErrorCode::NO_AVAILABLE_ELEMENT);
+        continue;
+      }
+
+      results[index] = Result<HandlerType, ErrorResult>(
+          st_execute_success, std::move(name_ID_handlers[index]),
+          std::move(ID_to_object_handler.GetResult()));
+    }
+
+    return results;
+  }
+
   Result<HandlerType, ErrorResult> GetObjectByIDBase(
       ManagedObjectID object_ID) const {
     return GetObjectByIDBaseImp(object_ID, ManagedTypeIsSmartPointType{});
@@ -211,9 +371,16 @@ class ManagerBaseImp {
         name_to_ID_container_.GetObject(object_name, st_get_one_object)
             .Exception();
     if (!name_ID_handler.IsSuccess()) {
-      return Result<std::vector<HandlerType>, ErrorResult>(
-          st_execute_error,
-          ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+      auto unnamed_object_handler = GetUnnamedObjectByName(object_name);
+      if (!unnamed_object_handler.IsSuccess()) {
+        return Result<HandlerType, ErrorResult>(
+            st_execute_error,
+            ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+      }
+
+      return Result<HandlerType, ErrorResult>(
+          st_execute_success, typename BaseNameToIDContainer::HandlerType{},
+          std::move(unnamed_object_handler.GetResult()));
     }
 
     auto id_object_handler =
@@ -221,14 +388,14 @@ class ManagerBaseImp {
             .GetObject(name_ID_handler.GetResult().GetObject())
             .Exception();
     if (!id_object_handler.IsSuccess()) {
-      return Result<std::vector<HandlerType>, ErrorResult>(
+      return Result<HandlerType, ErrorResult>(
           st_execute_error,
           ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
     }
 
     return Result<HandlerType, ErrorResult>(
-        st_execute_success,
-        HandlerType{std::move(name_ID_handler), std::move(id_object_handler)});
+        st_execute_success, std::move(name_ID_handler.GetResult()),
+        std::move(id_object_handler.GetResult()));
   }
 
   Result<std::vector<HandlerType>, ErrorResult> GetObjectByNameBase(
@@ -236,23 +403,25 @@ class ManagerBaseImp {
     auto name_ID_handlers =
         name_to_ID_container_.GetObject(object_name, st_get_multiply_object)
             .Exception();
-    if (!name_ID_handlers.IsSuccess()) {
-      return Result<std::vector<HandlerType>, ErrorResult>(
-          st_execute_error,
-          ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
-    }
-
     std::vector<HandlerType> handlers;
-    for (auto& name_ID_handler : name_ID_handlers.GetResult()) {
-      auto id_object_handler =
-          ID_to_object_container_.GetObject(name_ID_handler.GetObject())
-              .Exception();
-      if (!id_object_handler.IsSuccess()) {
-        continue;
+    if (name_ID_handlers.IsSuccess()) {
+      for (auto& name_ID_handler : name_ID_handlers.GetResult()) {
+        auto id_object_handler =
+            ID_to_object_container_.GetObject(name_ID_handler.GetObject())
+                .Exception();
+        if (!id_object_handler.IsSuccess()) {
+          continue;
+        }
+
+        handlers.emplace_back(std::move(name_ID_handler),
+                              std::move(id_object_handler.GetResult()));
       }
+    }
 
-      handlers.emplace_back(std::move(name_ID_handler),
-                            std::move(id_object_handler.GetResult()));
+    auto unnamed_object_handler = GetUnnamedObjectByName(object_name);
+    if (unnamed_object_handler.IsSuccess()) {
+      handlers.emplace_back(typename BaseNameToIDContainer::HandlerType{},
+                            std::move(unnamed_object_handler.GetResult()));
     }
 
     if (handlers.empty()) {
@@ -277,12 +446,91 @@ class ManagerBaseImp {
   //                                HandlerType& handler) const;
 
  protected:
-  ManagerBaseImp() = default;
+  ManagerBaseImp() { SetSlotMapRemoveCallback(); }
   explicit ManagerBaseImp(std::uint64_t size)
-      : name_to_ID_container_(size), ID_to_object_container_(size) {}
+      : name_to_ID_container_(size), ID_to_object_container_(size) {
+    SetSlotMapRemoveCallback();
+  }
   virtual ~ManagerBaseImp() = default;
 
  private:
+  static const ManagedObjectBase& GetManagedObjectBase(
+      const ManagedType& managed_object) {
+    if constexpr (std::is_same_v<ManagedTypeIsSmartPointType,
+                                 ManagedObjectIsSmartPoint>) {
+      return *managed_object;
+    } else {
+      return managed_object;
+    }
+  }
+
+  /**
+   * \brief Find an unnamed object by the name built from its ID.
+   * \remark Unnamed objects are not in the name index, so a name lookup that
+   * misses the index falls back to parsing the name as an ID.
+   */
+  Result<typename BaseIDToObjectContainer::HandlerType, ErrorResult>
+  GetUnnamedObjectByName(const std::string& object_name) const {
+    ManagedObjectID object_ID{Utils::UUID::UUIDEmptyInit{}};
+    if (!Utils::UUID::FromString(object_name, object_ID)) {
+      return Result<typename BaseIDToObjectContainer::HandlerType, ErrorResult>(
+          st_execute_error,
+          ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+    }
+
+    auto ID_to_object_handler =
+        ID_to_object_container_.GetObject(object_ID).Exception();
+    if (!ID_to_object_handler.IsSuccess() ||
+        GetManagedObjectBase(ID_to_object_handler.GetResult().GetObject())
+            .IsNamed()) {
+      return Result<typename BaseIDToObjectContainer::HandlerType, ErrorResult>(
+          st_execute_error,
+          ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+    }
+
+    return ID_to_object_handler.Move();
+  }
+
+  Result<HandlerType, ErrorResult> AddUnnamedObjectBase(
+      ManagedType&& managed_object) {
+    ManagedObjectID object_ID =
+        GetManagedObjectBase(managed_object).GetObjectID();
+    auto ID_to_object_handler =
+        ID_to_object_container_
+            .AddObject(std::move(object_ID), std::move(managed_object))
+            .Exception();
+    if (!ID_to_object_handler.IsSuccess()) {
+      return Result<HandlerType, ErrorResult>(
+          st_execute_error, ID_to_object_handler.GetError().GetErrorCode());
+    }
+    if (!RegisterInSlotMap(ID_to_object_handler.GetResult())) {
+      // Every slot is in use. Dropping the handlers removes the object again.
+      return Result<HandlerType, ErrorResult>(st_execute_error,
+                                              ErrorCode::NO_AVAILABLE_ELEMENT);
+    }
+
+    return Result<HandlerType, ErrorResult>(
+        st_execute_success, typename BaseNameToIDContainer::HandlerType{},
+        std::move(ID_to_object_handler.GetResult()));
+  }
+
+  bool RegisterInSlotMap(
+      typename BaseIDToObjectContainer::HandlerType& ID_to_object_handler) {
+    return slot_map_
+        .Insert(ID_to_object_handler.GetKey(),
+                ID_to_object_handler.GetObjectPtr(),
+                const_cast<std::atomic_uint32_t*>(
+                    ID_to_object_handler.GetUseCountPtr()))
+        .IsValid();
+  }
+
+  void SetSlotMapRemoveCallback() {
+    ID_to_object_container_.SetRemoveCallback(
+        [this](const ManagedObjectID& object_ID, ManagedType&) {
+          slot_map_.Erase(object_ID);
+        });
+  }
+
   Result<std::string, ErrorResult> GetNameByIDImp(
       ManagedObjectID managed_object_ID, ManagedObjectIsNotSmartPoint) const {
     auto handler =
@@ -313,6 +561,10 @@ class ManagerBaseImp {
 
   Result<HandlerType, ErrorResult> AddObjectBaseImp(
       ManagedType&& managed_object, ManagedObjectIsNotSmartPoint) {
+    if (!managed_object.IsNamed()) {
+      return AddUnnamedObjectBase(std::move(managed_object));
+    }
+
     ManagedObjectID copy_ID = managed_object.GetObjectID();
     auto name_ID_handler =
         name_to_ID_container_
@@ -330,6 +582,12 @@ class ManagerBaseImp {
       return Result<HandlerType, ErrorResult>(
           st_execute_error, ID_to_object_handler.GetError().GetErrorCode());
     }
+    // The returned handler keeps the object alive until it is registered.
+    if (!RegisterInSlotMap(ID_to_object_handler.GetResult())) {
+      // Every slot is in use. Dropping the handlers removes the object again.
+      return Result<HandlerType, ErrorResult>(st_execute_error,
+                                              ErrorCode::NO_AVAILABLE_ELEMENT);
+    }
 
     return Result<HandlerType, ErrorResult>(
         st_execute_success, std::move(name_ID_handler.GetResult()),
@@ -338,6 +596,10 @@ class ManagerBaseImp {
 
   Result<HandlerType, ErrorResult> AddObjectBaseImp(
       ManagedType&& managed_object, ManagedObjectIsSmartPoint) {
+    if (!managed_object->IsNamed()) {
+      return AddUnnamedObjectBase(std::move(managed_object));
+    }
+
     ManagedObjectID copy_ID = managed_object->GetObjectID();
     auto name_ID_handler =
         name_to_ID_container_
@@ -355,6 +617,12 @@ class ManagerBaseImp {
       return Result<HandlerType, ErrorResult>(
           st_execute_error, ID_to_object_handler.GetError().GetErrorCode());
     }
+    // The returned handler keeps the object alive until it is registered.
+    if (!RegisterInSlotMap(ID_to_object_handler.GetResult())) {
+      // Every slot is in use. Dropping the handlers removes the object again.
+      return Result<HandlerType, ErrorResult>(st_execute_error,
+                                              ErrorCode::NO_AVAILABLE_ELEMENT);
+    }
 
     return Result<HandlerType, ErrorResult>(
         st_execute_success, std::move(name_ID_handler.GetResult()),
@@ -369,6 +637,11 @@ class ManagerBaseImp {
       return Result<HandlerType, ErrorResult>(
           st_execute_error, ID_to_object_handler.GetError().GetErrorCode());
     }
+    if (!ID_to_object_handler.GetResult().GetObject().IsNamed()) {
+      return Result<HandlerType, ErrorResult>(
+          st_execute_success, typename BaseNameToIDContainer::HandlerType{},
+          std::move(ID_to_object_handler.GetResult()));
+    }
     auto name_ID_handlers =
         name_to_ID_container_
             .GetObject(
@@ -401,6 +674,11 @@ class ManagerBaseImp {
       return Result<HandlerType, ErrorResult>(
           st_execute_error, ID_to_object_handler.GetError().GetErrorCode());
     }
+    if (!ID_to_object_handler.GetResult().GetObject()->IsNamed()) {
+      return Result<HandlerType, ErrorResult>(
+          st_execute_success, typename BaseNameToIDContainer::HandlerType{},
+          std::move(ID_to_object_handler.GetResult()));
+    }
     auto name_ID_handlers =
         name_to_ID_container_
             .GetObject(
@@ -426,32 +704,38 @@ class ManagerBaseImp {
   }
 
  private:
+  // Declared first so that it outlives the containers that report removals to
+  // it.
+  SlotMapType slot_map_{};
   BaseNameToIDContainer name_to_ID_container_{};
   BaseIDToObjectContainer ID_to_object_container_{};
 };
 
-template <typename ManagedType, typename ManagedTypeIsSmartPointType>
+template <typename ManagedType, typename ManagedTypeIsSmartPointType,
+          typename Allocator>
 struct ManagedBaseValidate;
 
-template <typename ManagedType>
-struct ManagedBaseValidate<ManagedType, ManagedObjectIsSmartPoint> {
+template <typename ManagedType, typename Allocator>
+struct ManagedBaseValidate<ManagedType, ManagedObjectIsSmartPoint, Allocator> {
   using Type = std::enable_if_t<
       std::is_base_of_v<ManagedObjectBase, typename ManagedType::element_type>,
-      ManagerBaseImp<ManagedType, ManagedObjectIsSmartPoint>>;
+      ManagerBaseImp<ManagedType, ManagedObjectIsSmartPoint, Allocator>>;
 };
 
-template <typename ManagedType>
-struct ManagedBaseValidate<ManagedType, ManagedObjectIsNotSmartPoint> {
+template <typename ManagedType, typename Allocator>
+struct ManagedBaseValidate<ManagedType, ManagedObjectIsNotSmartPoint,
+                           Allocator> {
   using Type = std::enable_if_t<
       std::is_base_of_v<ManagedObjectBase, ManagedType>,
-      ManagerBaseImp<ManagedType, ManagedObjectIsNotSmartPoint>>;
+      ManagerBaseImp<ManagedType, ManagedObjectIsNotSmartPoint, Allocator>>;
   ;
 };
 
 template <typename ManagedType,
-          typename ManagedTypeIsSmartPointType = ManagedObjectIsNotSmartPoint>
+          typename ManagedTypeIsSmartPointType = ManagedObjectIsNotSmartPoint,
+          typename Allocator = std::allocator<ManagedType>>
 using ManagerBase =
-    typename ManagedBaseValidate<ManagedType,
-                                 ManagedTypeIsSmartPointType>::Type;
+    typename ManagedBaseValidate<ManagedType, ManagedTypeIsSmartPointType,
+                                 Allocator>::Type;
 };  // namespace Manager
 }  // namespace MM
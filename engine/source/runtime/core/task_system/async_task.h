@@ -0,0 +1,395 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "runtime/core/task_system/task_system.h"
+
+namespace MM {
+namespace TaskSystem {
+template <typename T>
+class AsyncTask;
+
+template <typename T>
+class AsyncTaskPromise;
+
+template <typename T>
+struct IsAsyncTask : std::false_type {};
+
+template <typename T>
+struct IsAsyncTask<AsyncTask<T>> : std::true_type {};
+
+/**
+ * \brief Shared state of an \ref AsyncTask and its \ref AsyncTaskPromise.
+ * \remark The state becomes ready with either a value or an exception.
+ */
+template <typename T>
+class AsyncTaskState {
+ public:
+  using ValueType = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+ public:
+  AsyncTaskState() = default;
+  ~AsyncTaskState() = default;
+  AsyncTaskState(const AsyncTaskState& other) = delete;
+  AsyncTaskState(AsyncTaskState&& other) = delete;
+  AsyncTaskState& operator=(const AsyncTaskState& other) = delete;
+  AsyncTaskState& operator=(AsyncTaskState&& other) = delete;
+
+ public:
+  bool IsReady() const { return is_ready_.load(std::memory_order_acquire); }
+
+  void SetValue(ValueType&& value) {
+    SetReady([this, &value]() { value_.emplace(std::move(value)); });
+  }
+
+  void SetException(std::exception_ptr exception) {
+    SetReady([this, &exception]() { exception_ = std::move(exception); });
+  }
+
+  /**
+   * \brief Call \ref continuation once the value is set, or right away if it
+   * already is.
+   */
+  void AddContinuation(std::function<void()>&& continuation) {
+    {
+      std::lock_guard<std::mutex> guard{mutex_};
+      if (!is_ready_.load(std::memory_order_relaxed)) {
+        continuations_.emplace_back(std::move(continuation));
+        return;
+      }
+    }
+
+    continuation();
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> guard{mutex_};
+    condition_variable_.wait(
+        guard, [this]() { return is_ready_.load(std::memory_order_relaxed); });
+  }
+
+  /**
+   * \remark Only meaningful once the state is ready.
+   */
+  bool HasException() const { return exception_ != nullptr; }
+
+  const std::exception_ptr& GetException() const { return exception_; }
+
+  /**
+   * \remark Rethrows the exception if the state holds one.
+   */
+  ValueType& GetValue() {
+    if (exception_ != nullptr) {
+      std::rethrow_exception(exception_);
+    }
+
+    return *value_;
+  }
+
+ private:
+  template <typename SetResultFunction>
+  void SetReady(SetResultFunction&& set_result) {
+    std::vector<std::function<void()>> continuations;
+    {
+      std::lock_guard<std::mutex> guard{mutex_};
+      set_result();
+      is_ready_.store(true, std::memory_order_release);
+      continuations.swap(continuations_);
+    }
+    condition_variable_.notify_all();
+
+    for (std::function<void()>& continuation : continuations) {
+      continuation();
+    }
+  }
+
+ private:
+  std::mutex mutex_{};
+  std::condition_variable condition_variable_{};
+  std::atomic_bool is_ready_{false};
+  std::optional<ValueType> value_{};
+  std::exception_ptr exception_{nullptr};
+  std::vector<std::function<void()>> continuations_{};
+};
+
+/**
+ * \brief The eventual result of an asynchronous job.
+ * \remark Instead of blocking a worker until the result is ready, chain the
+ * next step with \ref Then. The step is queued in the lane of its \ref TaskType
+ * only once the result is ready, so a long pipeline (read, decode, upload,
+ * register) holds no worker while one of its steps waits for I/O or the GPU.
+ * A step returning another \ref AsyncTask is flattened, the next step waits for
+ * the inner task.
+ * \remark This is the C++17 form of an awaitable task, \ref Then plays the role
+ * of co_await.
+ * \remark Like std::future, the result can be taken once: \ref Get and
+ * \ref Then invalidate the task. An exception thrown by a step is stored in
+ * place of its result, skips the steps chained after it and is rethrown by
+ * \ref Get.
+ */
+template <typename T>
+class AsyncTask {
+  friend class AsyncTaskPromise<T>;
+
+  template <typename OtherType>
+  friend class AsyncTask;
+
+ public:
+  using ValueType = typename AsyncTaskState<T>::ValueType;
+
+ public:
+  AsyncTask() = default;
+  ~AsyncTask() = default;
+  AsyncTask(const AsyncTask& other) = delete;
+  AsyncTask(AsyncTask&& other) noexcept = default;
+  AsyncTask& operator=(const AsyncTask& other) = delete;
+  AsyncTask& operator=(AsyncTask&& other) noexcept = default;
+
+ public:
+  bool IsValid() const { return state_ != nullptr; }
+
+  bool IsReady() const { return state_ != nullptr && state_->IsReady(); }
+
+  /**
+   * \brief Wait for the result.
+   * \remark A worker of \ref TaskSystem keeps running other tasks while it
+   * waits, any other thread blocks.
+   */
+  void Wait() const {
+    assert(IsValid());
+    if (state_->IsReady()) {
+      return;
+    }
+
+    TaskSystem* task_system = TaskSystem::GetInstance();
+    if (task_system->ThisWorkerId(TaskType::Total) >= 0) {
+      task_system->LoopUntil(TaskType::Total,
+                             [state = state_.get()]() { return state->IsReady(); });
+      return;
+    }
+
+    state_->Wait();
+  }
+
+  /**
+   * \brief Wait for the result and take it.
+   * \remark Rethrows the exception of the task if it has one.
+   */
+  T Get() {
+    Wait();
+    std::shared_ptr<AsyncTaskState<T>> state = std::move(state_);
+    if constexpr (!std::is_void_v<T>) {
+      return std::move(state->GetValue());
+    }
+  }
+
+  /**
+   * \brief Run \ref continuation with the result in the lane of \ref task_type
+   * once the result is ready.
+   * \return The task of the result of \ref continuation.
+   */
+  template <typename F>
+  auto Then(const TaskType& task_type, F&& continuation);
+
+ private:
+  explicit AsyncTask(std::shared_ptr<AsyncTaskState<T>> state)
+      : state_(std::move(state)) {}
+
+ private:
+  std::shared_ptr<AsyncTaskState<T>> state_{nullptr};
+};
+
+/**
+ * \brief Producer side of an \ref AsyncTask, used to wrap callbacks and
+ * other futures.
+ */
+template <typename T>
+class AsyncTaskPromise {
+ public:
+  using ValueType = typename AsyncTaskState<T>::ValueType;
+
+ public:
+  AsyncTaskPromise() : state_(std::make_shared<AsyncTaskState<T>>()) {}
+  ~AsyncTaskPromise() = default;
+  AsyncTaskPromise(const AsyncTaskPromise& other) = default;
+  AsyncTaskPromise(AsyncTaskPromise&& other) noexcept = default;
+  AsyncTaskPromise& operator=(const AsyncTaskPromise& other) = default;
+  AsyncTaskPromise& operator=(AsyncTaskPromise&& other) noexcept = default;
+
+ public:
+  AsyncTask<T> GetAsyncTask() const { return AsyncTask<T>{state_}; }
+
+  template <typename... Args>
+  void SetValue(Args&&... args) const {
+    state_->SetValue(ValueType(std::forward<Args>(args)...));
+  }
+
+  void SetException(std::exception_ptr exception) const {
+    state_->SetException(std::move(exception));
+  }
+
+  /**
+   * \brief Call \ref function and set its result, waiting for it first if it
+   * is an \ref AsyncTask.
+   * \remark If \ref function throws, the exception is set instead, so that
+   * nothing waits for a result that never comes.
+   */
+  template <typename F, typename... Args>
+  void SetResultOf(F&& function, Args&&... args) const;
+
+ private:
+  std::shared_ptr<AsyncTaskState<T>> state_;
+};
+
+template <typename F, typename... Args>
+struct AsyncTaskResult {
+  using InvokeResultType = std::invoke_result_t<F, Args...>;
+
+  template <typename ResultType>
+  struct Unwrap {
+    using Type = ResultType;
+  };
+
+  template <typename ResultType>
+  struct Unwrap<AsyncTask<ResultType>> {
+    using Type = ResultType;
+  };
+
+  using Type = typename Unwrap<InvokeResultType>::Type;
+};
+
+template <typename T, typename F>
+struct AsyncTaskContinuationResult {
+  using Type = typename AsyncTaskResult<F, T>::Type;
+};
+
+template <typename F>
+struct AsyncTaskContinuationResult<void, F> {
+  using Type = typename AsyncTaskResult<F>::Type;
+};
+
+template <typename T>
+template <typename F, typename... Args>
+void AsyncTaskPromise<T>::SetResultOf(F&& function, Args&&... args) const {
+  using InvokeResultType = std::invoke_result_t<F, Args...>;
+
+  // Only the call is guarded, a continuation run by setting the result must
+  // not set it a second time.
+  if constexpr (IsAsyncTask<InvokeResultType>::value) {
+    InvokeResultType inner_task{};
+    try {
+      inner_task =
+          std::invoke(std::forward<F>(function), std::forward<Args>(args)...);
+    } catch (...) {
+      SetException(std::current_exception());
+      return;
+    }
+    assert(inner_task.IsValid());
+    AsyncTaskState<T>* inner_state = inner_task.state_.get();
+    inner_state->AddContinuation(
+        [promise = *this, inner_state = std::move(inner_task.state_)]() {
+          if (inner_state->HasException()) {
+            promise.SetException(inner_state->GetException());
+            return;
+          }
+          promise.state_->SetValue(std::move(inner_state->GetValue()));
+        });
+  } else if constexpr (std::is_void_v<InvokeResultType>) {
+    try {
+      std::invoke(std::forward<F>(function), std::forward<Args>(args)...);
+    } catch (...) {
+      SetException(std::current_exception());
+      return;
+    }
+    SetValue();
+  } else {
+    std::optional<ValueType> result{};
+    try {
+      result.emplace(
+          std::invoke(std::forward<F>(function), std::forward<Args>(args)...));
+    } catch (...) {
+      SetException(std::current_exception());
+      return;
+    }
+    SetValue(std::move(*result));
+  }
+}
+
+template <typename T>
+template <typename F>
+auto AsyncTask<T>::Then(const TaskType& task_type, F&& continuation) {
+  assert(IsValid());
+
+  using ResultType = typename AsyncTaskContinuationResult<T, F>::Type;
+
+  AsyncTaskPromise<ResultType> promise{};
+  AsyncTask<ResultType> result = promise.GetAsyncTask();
+  AsyncTaskState<T>* state = state_.get();
+  state->AddContinuation([task_type, promise, state = std::move(state_),
+                          continuation =
+                              std::forward<F>(continuation)]() mutable {
+    TaskSystem::GetInstance()->SilentAsync(
+        task_type, [promise, state, continuation]() mutable {
+          if (state->HasException()) {
+            promise.SetException(state->GetException());
+            return;
+          }
+          if constexpr (std::is_void_v<T>) {
+            promise.SetResultOf(continuation);
+          } else {
+            promise.SetResultOf(continuation, std::move(state->GetValue()));
+          }
+        });
+  });
+
+  return result;
+}
+
+/**
+ * \brief Run \ref function with \ref args in the lane of \ref task_type.
+ * \return The task of the result of \ref function, flattened if it is an
+ * \ref AsyncTask itself.
+ */
+template <typename F, typename... Args>
+auto RunAsyncTask(const TaskType& task_type, F&& function, Args&&... args) {
+  using ResultType = typename AsyncTaskResult<F, Args...>::Type;
+
+  AsyncTaskPromise<ResultType> promise{};
+  AsyncTask<ResultType> result = promise.GetAsyncTask();
+  TaskSystem::GetInstance()->SilentAsync(
+      task_type,
+      [promise, function = std::forward<F>(function), args...]() mutable {
+        promise.SetResultOf(function, args...);
+      });
+
+  return result;
+}
+
+/**
+ * \brief Make a task whose result is already set.
+ */
+template <typename T>
+AsyncTask<std::decay_t<T>> MakeReadyAsyncTask(T&& value) {
+  AsyncTaskPromise<std::decay_t<T>> promise{};
+  promise.SetValue(std::forward<T>(value));
+  return promise.GetAsyncTask();
+}
+
+inline AsyncTask<void> MakeReadyAsyncTask() {
+  AsyncTaskPromise<void> promise{};
+  promise.SetValue();
+  return promise.GetAsyncTask();
+}
+}  // namespace TaskSystem
+}  // namespace MM
@@ -0,0 +1,52 @@
+#include "runtime/core/task_system/frame_scheduler.h"
+
+MM::TaskSystem::FrameScheduler::FrameScheduler(std::uint32_t phase_count)
+    : phase_count_(phase_count) {
+  ResetFrame();
+}
+
+MM::TaskSystem::FrameScheduler::~FrameScheduler() { Wait(); }
+
+std::uint32_t MM::TaskSystem::FrameScheduler::GetPhaseCount() const {
+  return phase_count_;
+}
+
+std::uint64_t MM::TaskSystem::FrameScheduler::GetFrameIndex() const {
+  return frame_index_;
+}
+
+void MM::TaskSystem::FrameScheduler::BeginFrame() {
+  Wait();
+  ResetFrame();
+  ++frame_index_;
+}
+
+void MM::TaskSystem::FrameScheduler::Submit() {
+  if (is_submitted_) {
+    return;
+  }
+
+  is_submitted_ = true;
+  // Run on the executor directly, TaskSystem::Run would override the lanes
+  // of the jobs.
+  frame_future_ = TaskSystem::GetInstance()->GetExecutor().run(frame_flow_);
+}
+
+void MM::TaskSystem::FrameScheduler::Wait() {
+  if (is_submitted_ && frame_future_.valid()) {
+    frame_future_.wait();
+  }
+}
+
+void MM::TaskSystem::FrameScheduler::ResetFrame() {
+  frame_flow_.clear();
+  phase_barriers_.clear();
+  phase_barriers_.reserve(phase_count_ + 1);
+  for (std::uint32_t i = 0; i != phase_count_ + 1; ++i) {
+    phase_barriers_.emplace_back(frame_flow_.placeholder());
+    if (i != 0) {
+      phase_barriers_[i - 1].precede(phase_barriers_.back());
+    }
+  }
+  is_submitted_ = false;
+}
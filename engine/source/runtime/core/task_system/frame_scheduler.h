@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "runtime/core/task_system/task_system.h"
+
+namespace MM {
+namespace TaskSystem {
+/**
+ * \brief Collects the jobs of one frame in phases and runs them on the
+ * executor of \ref TaskSystem.
+ * \remark Jobs of a phase start only after every job of the previous phase has
+ * finished. Jobs of the same phase run in parallel unless they are linked with
+ * \ref Task::precede, and each job is queued in the priority lane of its
+ * \ref TaskType.
+ * \remark One frame is in flight at a time, \ref BeginFrame waits for the
+ * previous frame before its jobs are cleared.
+ */
+class FrameScheduler {
+ public:
+  explicit FrameScheduler(std::uint32_t phase_count);
+  ~FrameScheduler();
+  FrameScheduler(const FrameScheduler& other) = delete;
+  FrameScheduler(FrameScheduler&& other) = delete;
+  FrameScheduler& operator=(const FrameScheduler& other) = delete;
+  FrameScheduler& operator=(FrameScheduler&& other) = delete;
+
+ public:
+  std::uint32_t GetPhaseCount() const;
+
+  std::uint64_t GetFrameIndex() const;
+
+  /**
+   * \brief Wait for the previous frame and start collecting the jobs of the
+   * next one.
+   */
+  void BeginFrame();
+
+  /**
+   * \brief Add \ref job to the phase \ref phase_index of the current frame.
+   * \return The task of the job, or an empty task if \ref phase_index is out
+   * of range or the frame is already submitted.
+   */
+  template <typename F>
+  Task AddJob(std::uint32_t phase_index, const TaskType& task_type,
+              const std::string& job_name, F&& job);
+
+  /**
+   * \brief Run the jobs of the current frame, submitting a frame twice does
+   * nothing.
+   */
+  void Submit();
+
+  /**
+   * \brief Wait for the submitted frame to finish.
+   */
+  void Wait();
+
+ private:
+  void ResetFrame();
+
+ private:
+  std::uint32_t phase_count_;
+  std::uint64_t frame_index_{0};
+  bool is_submitted_{false};
+
+  Taskflow frame_flow_{};
+  // phase_barriers_[i] precedes the jobs of phase i and follows the jobs of
+  // phase i - 1, the last one follows the jobs of the last phase.
+  std::vector<Task> phase_barriers_{};
+  Future<void> frame_future_{};
+};
+
+template <typename F>
+Task FrameScheduler::AddJob(std::uint32_t phase_index,
+                            const TaskType& task_type,
+                            const std::string& job_name, F&& job) {
+  if (phase_index >= phase_count_ || is_submitted_) {
+    return Task{};
+  }
+
+  Task task = frame_flow_.emplace(std::forward<F>(job));
+  task.name(job_name);
+  TaskSystem::GetInstance()->AssignTaskType(task, task_type);
+  phase_barriers_[phase_index].precede(task);
+  task.precede(phase_barriers_[phase_index + 1]);
+
+  return task;
+}
+}  // namespace TaskSystem
+}  // namespace MM
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <taskflow/algorithm/sort.hpp>
 #include <taskflow/taskflow.hpp>
 
 namespace MM {
 namespace TaskSystem {
 using namespace tf;
+
+enum class TaskType { Total, Common, Render, Physical };
 }
 }
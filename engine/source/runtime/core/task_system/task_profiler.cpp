@@ -0,0 +1,402 @@
+#include "runtime/core/task_system/task_profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace {
+const char* GetTaskTypeName(MM::TaskSystem::TaskType task_type) {
+  switch (task_type) {
+    case MM::TaskSystem::TaskType::Total:
+      return "Total";
+    case MM::TaskSystem::TaskType::Common:
+      return "Common";
+    case MM::TaskSystem::TaskType::Render:
+      return "Render";
+    case MM::TaskSystem::TaskType::Physical:
+      return "Physical";
+  }
+
+  return "Total";
+}
+
+const char* GetLaneName(std::uint32_t lane) {
+  if (lane == MM::TaskSystem::TaskProfileStats::kUnknownLane) {
+    return "Unknown";
+  }
+
+  return GetTaskTypeName(static_cast<MM::TaskSystem::TaskType>(lane));
+}
+
+std::uint32_t GetRecordLane(const MM::TaskSystem::TaskProfileRecord& record) {
+  return record.is_lane_known_
+             ? static_cast<std::uint32_t>(record.task_type_)
+             : MM::TaskSystem::TaskProfileStats::kUnknownLane;
+}
+
+void WriteJsonString(std::ostream& output, const std::string& value) {
+  output << '"';
+  for (char character : value) {
+    switch (character) {
+      case '"':
+        output << "\\\"";
+        break;
+      case '\\':
+        output << "\\\\";
+        break;
+      case '\n':
+        output << "\\n";
+        break;
+      case '\t':
+        output << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(character) < 0x20) {
+          output << ' ';
+        } else {
+          output << character;
+        }
+    }
+  }
+  output << '"';
+}
+}  // namespace
+
+std::uint64_t MM::TaskSystem::TaskProfileStats::GetTaskCount(
+    const TaskType& task_type) const {
+  return task_count_[static_cast<std::uint32_t>(task_type)];
+}
+
+std::uint64_t MM::TaskSystem::TaskProfileStats::GetBusyTime(
+    const TaskType& task_type) const {
+  return busy_time_[static_cast<std::uint32_t>(task_type)];
+}
+
+double MM::TaskSystem::TaskProfileStats::Utilization(
+    const TaskType& task_type) const {
+  return LaneUtilization(static_cast<std::uint32_t>(task_type));
+}
+
+std::uint64_t MM::TaskSystem::TaskProfileStats::GetUnknownTaskCount() const {
+  return task_count_[kUnknownLane];
+}
+
+std::uint64_t MM::TaskSystem::TaskProfileStats::GetUnknownBusyTime() const {
+  return busy_time_[kUnknownLane];
+}
+
+double MM::TaskSystem::TaskProfileStats::UnknownUtilization() const {
+  return LaneUtilization(kUnknownLane);
+}
+
+double MM::TaskSystem::TaskProfileStats::LaneUtilization(
+    std::uint32_t lane) const {
+  if (worker_count_ == 0 || profiled_time_ == 0) {
+    return 0.0;
+  }
+
+  return static_cast<double>(busy_time_[lane]) /
+         (static_cast<double>(profiled_time_) *
+          static_cast<double>(worker_count_));
+}
+
+MM::TaskSystem::TaskProfiler::TaskProfiler(
+    std::uint64_t record_capacity_per_worker)
+    : record_capacity_per_worker_(
+          std::max<std::uint64_t>(1, record_capacity_per_worker)),
+      origin_time_(std::chrono::steady_clock::now()),
+      lane_table_(std::make_unique<LaneEntry[]>(kLaneTableSize)) {}
+
+MM::TaskSystem::TaskProfiler::~TaskProfiler() = default;
+
+void MM::TaskSystem::TaskProfiler::Start() {
+  if (is_enabled_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  ClearLaneTable();
+  enable_time_.store(GetTime(), std::memory_order_relaxed);
+  is_enabled_.store(true, std::memory_order_release);
+}
+
+void MM::TaskSystem::TaskProfiler::Stop() {
+  if (!is_enabled_.exchange(false, std::memory_order_acq_rel)) {
+    return;
+  }
+
+  profiled_time_.fetch_add(
+      GetTime() - enable_time_.load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
+}
+
+bool MM::TaskSystem::TaskProfiler::IsEnabled() const {
+  return is_enabled_.load(std::memory_order_acquire);
+}
+
+void MM::TaskSystem::TaskProfiler::RegisterTask(std::size_t task_hash,
+                                                const TaskType& task_type) {
+  std::uint32_t index = GetLaneIndex(task_hash);
+  for (std::uint32_t probe = 0; probe != kMaxLaneProbeCount; ++probe) {
+    LaneEntry& entry = lane_table_[(index + probe) & (kLaneTableSize - 1)];
+    std::size_t entry_hash = entry.task_hash_.load(std::memory_order_acquire);
+    if (entry_hash == 0 &&
+        entry.task_hash_.compare_exchange_strong(entry_hash, task_hash,
+                                                 std::memory_order_acq_rel)) {
+      entry_hash = task_hash;
+    }
+    if (entry_hash == task_hash) {
+      entry.task_type_.store(static_cast<std::uint32_t>(task_type),
+                             std::memory_order_release);
+      return;
+    }
+  }
+}
+
+void MM::TaskSystem::TaskProfiler::SetRunningTaskType(
+    int worker_id, const TaskType& task_type) {
+  if (worker_id < 0 ||
+      static_cast<std::uint64_t>(worker_id) >= worker_count_) {
+    return;
+  }
+
+  WorkerBuffer& worker_buffer = worker_buffers_[worker_id];
+  std::uint32_t entry_depth = worker_buffer.entry_depth_;
+  if (entry_depth == 0 || entry_depth > kMaxEntryDepth) {
+    return;
+  }
+  worker_buffer.entry_lanes_[entry_depth - 1] =
+      static_cast<std::uint32_t>(task_type);
+}
+
+std::vector<MM::TaskSystem::TaskProfileRecord>
+MM::TaskSystem::TaskProfiler::GetRecords() const {
+  std::vector<TaskProfileRecord> records;
+  for (std::uint64_t worker_id = 0; worker_id != worker_count_; ++worker_id) {
+    const WorkerBuffer& worker_buffer = worker_buffers_[worker_id];
+    std::uint64_t write_index =
+        worker_buffer.write_index_.load(std::memory_order_acquire);
+    std::uint64_t first_index = write_index > record_capacity_per_worker_
+                                    ? write_index - record_capacity_per_worker_
+                                    : 0;
+    for (std::uint64_t index = first_index; index != write_index; ++index) {
+      const Record& record =
+          worker_buffer.records_[index % record_capacity_per_worker_];
+      std::uint64_t sequence = record.sequence_.load(std::memory_order_acquire);
+      if (sequence != index * 2 + 2) {
+        continue;
+      }
+
+      TaskProfileRecord result;
+      result.begin_time_ = record.begin_time_.load(std::memory_order_relaxed);
+      result.end_time_ = record.end_time_.load(std::memory_order_relaxed);
+      result.worker_id_ = static_cast<std::uint32_t>(worker_id);
+      const std::uint32_t lane = record.lane_.load(std::memory_order_relaxed);
+      result.is_lane_known_ = lane != TaskProfileStats::kUnknownLane;
+      if (result.is_lane_known_) {
+        result.task_type_ = static_cast<TaskType>(lane);
+      }
+      char name[kNameWordCount * sizeof(std::uint64_t) + 1]{};
+      for (std::uint32_t i = 0; i != kNameWordCount; ++i) {
+        std::uint64_t name_word =
+            record.name_words_[i].load(std::memory_order_relaxed);
+        std::memcpy(name + i * sizeof(std::uint64_t), &name_word,
+                    sizeof(std::uint64_t));
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // The record was overwritten while it was read.
+      if (record.sequence_.load(std::memory_order_relaxed) != sequence) {
+        continue;
+      }
+      result.task_name_ = name;
+      records.emplace_back(std::move(result));
+    }
+  }
+
+  std::sort(records.begin(), records.end(),
+            [](const TaskProfileRecord& lhs, const TaskProfileRecord& rhs) {
+              return lhs.begin_time_ < rhs.begin_time_;
+            });
+
+  return records;
+}
+
+MM::TaskSystem::TaskProfileStats MM::TaskSystem::TaskProfiler::GetStats()
+    const {
+  TaskProfileStats stats;
+  stats.worker_count_ = worker_count_;
+  stats.profiled_time_ = profiled_time_.load(std::memory_order_relaxed);
+  if (is_enabled_.load(std::memory_order_acquire)) {
+    stats.profiled_time_ +=
+        GetTime() - enable_time_.load(std::memory_order_relaxed);
+  }
+  for (std::uint64_t worker_id = 0; worker_id != worker_count_; ++worker_id) {
+    const WorkerBuffer& worker_buffer = worker_buffers_[worker_id];
+    for (std::uint32_t i = 0; i != TaskProfileStats::kLaneCount; ++i) {
+      stats.task_count_[i] +=
+          worker_buffer.task_count_[i].load(std::memory_order_relaxed);
+      stats.busy_time_[i] +=
+          worker_buffer.busy_time_[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  return stats;
+}
+
+void MM::TaskSystem::TaskProfiler::DumpChromeTrace(
+    std::ostream& output) const {
+  std::vector<TaskProfileRecord> records = GetRecords();
+  TaskProfileStats stats = GetStats();
+
+  output << "{\"traceEvents\":[";
+  bool is_first = true;
+  for (std::uint64_t worker_id = 0; worker_id != worker_count_; ++worker_id) {
+    output << (is_first ? "" : ",")
+           << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+           << worker_id << ",\"args\":{\"name\":\"worker " << worker_id
+           << "\"}}";
+    is_first = false;
+  }
+  for (const TaskProfileRecord& record : records) {
+    output << (is_first ? "" : ",") << "\n{\"name\":";
+    const char* lane_name = GetLaneName(GetRecordLane(record));
+    WriteJsonString(output,
+                    record.task_name_.empty() ? lane_name : record.task_name_);
+    // Chrome trace timestamps are in microseconds.
+    output << ",\"cat\":\"" << lane_name
+           << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << record.worker_id_
+           << ",\"ts\":" << static_cast<double>(record.begin_time_) / 1000.0
+           << ",\"dur\":"
+           << static_cast<double>(record.end_time_ - record.begin_time_) /
+                  1000.0
+           << "}";
+    is_first = false;
+  }
+  output << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"worker_count\":"
+         << stats.worker_count_
+         << ",\"profiled_time_ns\":" << stats.profiled_time_;
+  for (std::uint32_t i = 0; i != TaskProfileStats::kLaneCount; ++i) {
+    const char* lane_name = GetLaneName(i);
+    output << ",\"" << lane_name << "_task_count\":" << stats.task_count_[i]
+           << ",\"" << lane_name << "_busy_time_ns\":" << stats.busy_time_[i]
+           << ",\"" << lane_name << "_utilization\":"
+           << (i == TaskProfileStats::kUnknownLane
+                   ? stats.UnknownUtilization()
+                   : stats.Utilization(static_cast<TaskType>(i)));
+  }
+  output << "}}\n";
+}
+
+std::string MM::TaskSystem::TaskProfiler::DumpChromeTrace() const {
+  std::ostringstream output;
+  DumpChromeTrace(output);
+  return output.str();
+}
+
+void MM::TaskSystem::TaskProfiler::set_up(size_t num_workers) {
+  worker_count_ = num_workers;
+  worker_buffers_ = std::make_unique<WorkerBuffer[]>(num_workers);
+  for (std::uint64_t i = 0; i != num_workers; ++i) {
+    worker_buffers_[i].records_ =
+        std::make_unique<Record[]>(record_capacity_per_worker_);
+  }
+}
+
+void MM::TaskSystem::TaskProfiler::on_entry(WorkerView worker_view,
+                                            TaskView) {
+  WorkerBuffer& worker_buffer = worker_buffers_[worker_view.id()];
+  std::uint32_t entry_depth = worker_buffer.entry_depth_++;
+  if (entry_depth < kMaxEntryDepth) {
+    worker_buffer.entry_times_[entry_depth] =
+        is_enabled_.load(std::memory_order_acquire) ? GetTime() : kNoEntryTime;
+    worker_buffer.nested_times_[entry_depth] = 0;
+    worker_buffer.entry_lanes_[entry_depth] = TaskProfileStats::kUnknownLane;
+  }
+}
+
+void MM::TaskSystem::TaskProfiler::on_exit(WorkerView worker_view,
+                                           TaskView task_view) {
+  WorkerBuffer& worker_buffer = worker_buffers_[worker_view.id()];
+  if (worker_buffer.entry_depth_ == 0) {
+    return;
+  }
+  std::uint32_t entry_depth = --worker_buffer.entry_depth_;
+  if (entry_depth >= kMaxEntryDepth ||
+      worker_buffer.entry_times_[entry_depth] == kNoEntryTime) {
+    return;
+  }
+
+  std::uint64_t entry_time = worker_buffer.entry_times_[entry_depth];
+  std::uint64_t end_time = GetTime();
+  if (entry_depth != 0) {
+    worker_buffer.nested_times_[entry_depth - 1] += end_time - entry_time;
+  }
+  std::uint32_t lane = worker_buffer.entry_lanes_[entry_depth];
+  if (lane == TaskProfileStats::kUnknownLane) {
+    lane = FindLane(task_view.hash_value());
+  }
+  worker_buffer.task_count_[lane].fetch_add(1, std::memory_order_relaxed);
+  worker_buffer.busy_time_[lane].fetch_add(
+      end_time - entry_time - worker_buffer.nested_times_[entry_depth],
+      std::memory_order_relaxed);
+
+  std::uint64_t name_words[kNameWordCount]{};
+  const std::string& task_name = task_view.name();
+  std::memcpy(name_words, task_name.data(),
+              std::min(task_name.size(), sizeof(name_words)));
+
+  // Only this worker writes the buffer, the sequence number tells readers
+  // whether a record is complete.
+  std::uint64_t index =
+      worker_buffer.write_index_.load(std::memory_order_relaxed);
+  Record& record = worker_buffer.records_[index % record_capacity_per_worker_];
+  record.sequence_.store(index * 2 + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  record.begin_time_.store(entry_time, std::memory_order_relaxed);
+  record.end_time_.store(end_time, std::memory_order_relaxed);
+  record.lane_.store(lane, std::memory_order_relaxed);
+  for (std::uint32_t i = 0; i != kNameWordCount; ++i) {
+    record.name_words_[i].store(name_words[i], std::memory_order_relaxed);
+  }
+  record.sequence_.store(index * 2 + 2, std::memory_order_release);
+  worker_buffer.write_index_.store(index + 1, std::memory_order_release);
+}
+
+std::uint32_t MM::TaskSystem::TaskProfiler::GetLaneIndex(
+    std::size_t task_hash) {
+  // Task hashes are node addresses, mix the bits so that aligned addresses
+  // spread over the table.
+  return static_cast<std::uint32_t>(
+      (static_cast<std::uint64_t>(task_hash) * 0x9E3779B97F4A7C15ull) >> 48);
+}
+
+std::uint64_t MM::TaskSystem::TaskProfiler::GetTime() const {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - origin_time_)
+          .count());
+}
+
+std::uint32_t MM::TaskSystem::TaskProfiler::FindLane(
+    std::size_t task_hash) const {
+  std::uint32_t index = GetLaneIndex(task_hash);
+  for (std::uint32_t probe = 0; probe != kMaxLaneProbeCount; ++probe) {
+    const LaneEntry& entry =
+        lane_table_[(index + probe) & (kLaneTableSize - 1)];
+    std::size_t entry_hash = entry.task_hash_.load(std::memory_order_acquire);
+    if (entry_hash == task_hash) {
+      return entry.task_type_.load(std::memory_order_acquire);
+    }
+    if (entry_hash == 0) {
+      break;
+    }
+  }
+
+  return TaskProfileStats::kUnknownLane;
+}
+
+void MM::TaskSystem::TaskProfiler::ClearLaneTable() {
+  for (std::uint32_t i = 0; i != kLaneTableSize; ++i) {
+    lane_table_[i].task_hash_.store(0, std::memory_order_relaxed);
+    lane_table_[i].task_type_.store(0, std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "runtime/core/task_system/pre_header.h"
+
+namespace MM {
+namespace TaskSystem {
+struct TaskProfileRecord {
+  std::string task_name_{};
+  // Nanoseconds since the profiler was created.
+  std::uint64_t begin_time_{0};
+  std::uint64_t end_time_{0};
+  std::uint32_t worker_id_{0};
+  // Only meaningful if the lane is known.
+  TaskType task_type_{TaskType::Total};
+  bool is_lane_known_{false};
+};
+
+struct TaskProfileStats {
+  static constexpr std::uint32_t kTaskTypeCount = 4;
+  // The lane of tasks that were never registered with the profiler.
+  static constexpr std::uint32_t kUnknownLane = kTaskTypeCount;
+  static constexpr std::uint32_t kLaneCount = kTaskTypeCount + 1;
+
+  std::uint64_t worker_count_{0};
+  // Nanoseconds the profiler has been enabled.
+  std::uint64_t profiled_time_{0};
+  // Indexed by TaskType, then kUnknownLane.
+  std::uint64_t task_count_[kLaneCount]{};
+  std::uint64_t busy_time_[kLaneCount]{};
+
+  std::uint64_t GetTaskCount(const TaskType& task_type) const;
+
+  std::uint64_t GetBusyTime(const TaskType& task_type) const;
+
+  /**
+   * \brief The fraction of the worker time spent on tasks of \ref task_type
+   * while the profiler was enabled.
+   */
+  double Utilization(const TaskType& task_type) const;
+
+  std::uint64_t GetUnknownTaskCount() const;
+
+  std::uint64_t GetUnknownBusyTime() const;
+
+  double UnknownUtilization() const;
+
+ private:
+  double LaneUtilization(std::uint32_t lane) const;
+};
+
+/**
+ * \brief Records the begin and end time, worker, lane and name of every task
+ * run by the executor of \ref TaskSystem.
+ * \remark Each worker writes to a ring buffer of its own, records are
+ * published with a sequence number so readers never block the workers. Only
+ * the last \ref record_capacity_per_worker records of a worker are kept, the
+ * per lane counters of \ref GetStats cover every task.
+ * \remark The lane of a task is known for tasks whose priority is set by
+ * \ref TaskSystem while the profiler is enabled, and for asynchronous jobs of
+ * \ref TaskSystem started while it is enabled. Other tasks, such as the ones
+ * created before \ref Start or spawned in a subflow without a lane, are
+ * reported in an unknown lane. \ref Start forgets the lanes of the previous
+ * run, task nodes are reused and their hashes with them.
+ * \remark The profiler is installed when the executor is created, it costs
+ * one atomic load per task while it is disabled.
+ */
+class TaskProfiler : public ObserverInterface {
+ public:
+  explicit TaskProfiler(std::uint64_t record_capacity_per_worker =
+                            kDefaultRecordCapacityPerWorker);
+  ~TaskProfiler() override;
+  TaskProfiler(const TaskProfiler& other) = delete;
+  TaskProfiler(TaskProfiler&& other) = delete;
+  TaskProfiler& operator=(const TaskProfiler& other) = delete;
+  TaskProfiler& operator=(TaskProfiler&& other) = delete;
+
+ public:
+  void Start();
+
+  void Stop();
+
+  bool IsEnabled() const;
+
+  /**
+   * \brief Remember the lane of the task identified by \ref task_hash
+   * (tf::Task::hash_value).
+   */
+  void RegisterTask(std::size_t task_hash, const TaskType& task_type);
+
+  /**
+   * \brief Report the task that worker \ref worker_id is running in the lane
+   * of \ref task_type. Asynchronous jobs have no task handle to register, so
+   * they report themselves when they start.
+   */
+  void SetRunningTaskType(int worker_id, const TaskType& task_type);
+
+  /**
+   * \brief Get the records currently held by the ring buffers, sorted by begin
+   * time.
+   */
+  std::vector<TaskProfileRecord> GetRecords() const;
+
+  TaskProfileStats GetStats() const;
+
+  /**
+   * \brief Write the records and the per lane utilization in the Chrome trace
+   * event format, which chrome://tracing and Perfetto can open.
+   */
+  void DumpChromeTrace(std::ostream& output) const;
+
+  std::string DumpChromeTrace() const;
+
+ public:
+  void set_up(size_t num_workers) override;
+
+  void on_entry(WorkerView worker_view, TaskView task_view) override;
+
+  void on_exit(WorkerView worker_view, TaskView task_view) override;
+
+ private:
+  static constexpr std::uint64_t kDefaultRecordCapacityPerWorker = 4096;
+  static constexpr std::uint32_t kNameWordCount = 4;
+  static constexpr std::uint32_t kLaneTableSize = 1 << 16;
+  static constexpr std::uint32_t kMaxLaneProbeCount = 64;
+  static constexpr std::size_t kCacheLineSize = 64;
+  static constexpr std::uint32_t kMaxEntryDepth = 32;
+  // Marks an entry made while the profiler was disabled.
+  static constexpr std::uint64_t kNoEntryTime = ~std::uint64_t{0};
+
+  struct Record {
+    std::atomic_uint64_t sequence_{0};
+    std::atomic_uint64_t begin_time_{0};
+    std::atomic_uint64_t end_time_{0};
+    std::atomic_uint32_t lane_{0};
+    // The first characters of the task name.
+    std::atomic_uint64_t name_words_[kNameWordCount]{};
+  };
+
+  struct alignas(kCacheLineSize) WorkerBuffer {
+    // Only touched by the worker itself. A worker that waits for a subflow
+    // runs other tasks inside the waiting one, so entries nest.
+    std::uint32_t entry_depth_{0};
+    std::uint64_t entry_times_[kMaxEntryDepth]{};
+    // Time spent in the tasks nested in each entry, busy times exclude it.
+    std::uint64_t nested_times_[kMaxEntryDepth]{};
+    // Lanes reported by the running tasks themselves.
+    std::uint32_t entry_lanes_[kMaxEntryDepth]{};
+    std::atomic_uint64_t write_index_{0};
+    std::atomic_uint64_t task_count_[TaskProfileStats::kLaneCount]{};
+    std::atomic_uint64_t busy_time_[TaskProfileStats::kLaneCount]{};
+    std::unique_ptr<Record[]> records_{};
+  };
+
+  struct LaneEntry {
+    std::atomic_size_t task_hash_{0};
+    std::atomic_uint32_t task_type_{0};
+  };
+
+ private:
+  static std::uint32_t GetLaneIndex(std::size_t task_hash);
+
+  std::uint64_t GetTime() const;
+
+  /**
+   * \return The TaskType of the task as an index, or
+   * TaskProfileStats::kUnknownLane if it was not registered.
+   */
+  std::uint32_t FindLane(std::size_t task_hash) const;
+
+  void ClearLaneTable();
+
+ private:
+  const std::uint64_t record_capacity_per_worker_;
+  const std::chrono::steady_clock::time_point origin_time_;
+
+  std::atomic_bool is_enabled_{false};
+  std::atomic_uint64_t enable_time_{0};
+  std::atomic_uint64_t profiled_time_{0};
+
+  std::uint64_t worker_count_{0};
+  std::unique_ptr<WorkerBuffer[]> worker_buffers_{};
+  // Open addressing table from task hash to lane, entries are overwritten when
+  // a task node is reused and only removed by Start.
+  std::unique_ptr<LaneEntry[]> lane_table_;
+};
+}  // namespace TaskSystem
+}  // namespace MM
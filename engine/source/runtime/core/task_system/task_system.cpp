@@ -1,5 +1,9 @@
 #include "runtime/core/task_system/task_system.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
 MM::TaskSystem::TaskSystem* MM::TaskSystem::TaskSystem::task_system_{nullptr};
 std::mutex MM::TaskSystem::TaskSystem::sync_flag_{};
 
@@ -9,6 +13,9 @@ MM::TaskSystem::TaskSystem* MM::TaskSystem::TaskSystem::GetInstance() {
     std::lock_guard<std::mutex> guard{sync_flag_};
     if (!task_system_) {
       task_system_ = new TaskSystem{};
+      // Join the workers before the static node pool of Taskflow is
+      // destroyed, a worker may still be tearing down a finished taskflow.
+      std::atexit([]() { Destroy(); });
 
       return task_system_;
     }
@@ -16,26 +23,45 @@ MM::TaskSystem::TaskSystem* MM::TaskSystem::TaskSystem::GetInstance() {
   return task_system_;
 }
 
+MM::TaskSystem::TaskPriority MM::TaskSystem::ChooseTaskPriority(
+    const TaskType& task_type) {
+  switch (task_type) {
+    case TaskType::Render:
+      return TaskPriority::HIGH;
+    case TaskType::Physical:
+    case TaskType::Total:
+      return TaskPriority::NORMAL;
+    case TaskType::Common:
+      return TaskPriority::LOW;
+  }
+
+  return TaskPriority::NORMAL;
+}
+
 tf::Future<void> MM::TaskSystem::TaskSystem::Run(
     const MM::TaskSystem::TaskType& task_type, Taskflow& task_flow) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run(task_flow);
 }
 
 tf::Future<void> MM::TaskSystem::TaskSystem::Run(
     const MM::TaskSystem::TaskType& task_type, Taskflow&& task_flow) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run(std::move(task_flow));
 }
 
 tf::Future<void> MM::TaskSystem::TaskSystem::RunN(
     const MM::TaskSystem::TaskType& task_type, Taskflow& task_flow, size_t N) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run_n(task_flow, N);
 }
 
 tf::Future<void> MM::TaskSystem::TaskSystem::RunN(
     const MM::TaskSystem::TaskType& task_type, Taskflow&& task_flow, size_t N) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run_n(std::move(task_flow), N);
 }
@@ -86,40 +112,90 @@ bool MM::TaskSystem::TaskSystem::Destroy() {
   return true;
 }
 
+tf::Executor& MM::TaskSystem::TaskSystem::GetExecutor() { return executor_; }
+
+const tf::Executor& MM::TaskSystem::TaskSystem::GetExecutor() const {
+  return executor_;
+}
+
 tf::Executor& MM::TaskSystem::TaskSystem::ChooseExecutor(
-    const TaskType& task_type) {
-  switch (task_type) {
-    case TaskType::Common:
-      return logic_executor_;
-    case TaskType::Render:
-      return render_executor_;
-    case TaskType::Physical:
-      return physical_executor_;
-    case TaskType::Total:
-      return total_executor_;
+    const TaskType&) {
+  return executor_;
+}
+
+const tf::Executor& MM::TaskSystem::TaskSystem::ChooseExecutor(
+    const TaskType&) const {
+  return executor_;
+}
+
+void MM::TaskSystem::TaskSystem::AssignTaskType(Task task,
+                                                const TaskType& task_type) {
+  task.priority(ChooseTaskPriority(task_type));
+  if (profiler_->IsEnabled()) {
+    profiler_->RegisterTask(task.hash_value(), task_type);
   }
+}
 
-  return total_executor_;
+MM::TaskSystem::TaskProfiler& MM::TaskSystem::TaskSystem::GetProfiler() {
+  return *profiler_;
 }
 
-const tf::Executor& MM::TaskSystem::TaskSystem::ChooseExecutor(
-    const TaskType& task_type) const {
-  switch (task_type) {
-    case TaskType::Common:
-      return logic_executor_;
-    case TaskType::Render:
-      return render_executor_;
-    case TaskType::Physical:
-      return physical_executor_;
-    case TaskType::Total:
-      return total_executor_;
+const MM::TaskSystem::TaskProfiler& MM::TaskSystem::TaskSystem::GetProfiler()
+    const {
+  return *profiler_;
+}
+
+void MM::TaskSystem::TaskSystem::SetTaskflowPriority(const TaskType& task_type,
+                                                     Taskflow& task_flow) {
+  task_flow.for_each_task(
+      [this, &task_type](Task task) { AssignTaskType(task, task_type); });
+}
+
+void MM::TaskSystem::TaskSystem::SetRunningTaskType(const TaskType& task_type) {
+  if (profiler_->IsEnabled()) {
+    profiler_->SetRunningTaskType(executor_.this_worker_id(), task_type);
+  }
+}
+
+MM::TaskSystem::TaskSystem::ParallelRange::ParallelRange(
+    std::size_t first, std::size_t last, std::size_t grain_size,
+    std::size_t chunk_task_count)
+    : next_index_(first),
+      last_index_(last),
+      grain_size_(std::max<std::size_t>(1, grain_size)),
+      chunk_task_count_(std::max<std::size_t>(1, chunk_task_count)) {}
+
+std::size_t MM::TaskSystem::TaskSystem::ParallelRange::GetChunkTaskCount(
+    std::size_t first, std::size_t last, std::size_t grain_size,
+    std::size_t worker_count) {
+  if (first >= last) {
+    return 0;
+  }
+
+  grain_size = std::max<std::size_t>(1, grain_size);
+  std::size_t chunk_count = (last - first + grain_size - 1) / grain_size;
+  return std::min(chunk_count, std::max<std::size_t>(1, worker_count));
+}
+
+bool MM::TaskSystem::TaskSystem::ParallelRange::ClaimChunk(
+    std::size_t& chunk_first, std::size_t& chunk_last) {
+  std::size_t next_index = next_index_.load(std::memory_order_relaxed);
+  while (next_index < last_index_) {
+    std::size_t remain_count = last_index_ - next_index;
+    std::size_t chunk_size = std::min(
+        remain_count,
+        std::max(grain_size_, remain_count / (chunk_task_count_ * 2)));
+    if (next_index_.compare_exchange_weak(next_index, next_index + chunk_size,
+                                          std::memory_order_relaxed)) {
+      chunk_first = next_index;
+      chunk_last = next_index + chunk_size;
+      return true;
+    }
   }
 
-  return total_executor_;
+  return false;
 }
 
 MM::TaskSystem::TaskSystem::TaskSystem()
-    : total_executor_(3),
-      logic_executor_(4),
-      render_executor_(4),
-      physical_executor_(4) {}
\ No newline at end of file
+    : executor_(std::max<size_t>(1, std::thread::hardware_concurrency())),
+      profiler_(executor_.make_observer<TaskProfiler>()) {}
@@ -1,14 +1,42 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "runtime/core/task_system/pre_header.h"
+#include "runtime/core/task_system/task_profiler.h"
 
 namespace MM {
 namespace TaskSystem {
-enum class TaskType { Total, Common, Render, Physical };
-
+/**
+ * \brief Get the priority lane of \ref task_type.
+ * \remark Render jobs are scheduled first, then physical and total jobs, and
+ * common jobs (asset loading and other background work) last.
+ */
+TaskPriority ChooseTaskPriority(const TaskType& task_type);
+
+/**
+ * \brief Runs every job of the engine on one work-stealing executor.
+ * \remark The executor has one worker per hardware thread. \ref TaskType no
+ * longer selects a thread pool, it selects the priority lane the tasks are
+ * queued in, so idle workers steal any job while queued render jobs are always
+ * taken before queued background jobs.
+ * \remark \ref Run sets the priority of every task of the taskflow, so a
+ * taskflow must not be changed or run again while it is running. Tasks
+ * spawned by a subflow keep the default (highest) priority.
+ * \remark \ref WaitForAll, \ref NumTopologies and the other executor queries
+ * see every lane, \ref task_type is kept for compatibility.
+ */
 class TaskSystem {
  public:
   TaskSystem(const TaskSystem& other) = delete;
@@ -61,6 +89,11 @@ class TaskSystem {
   tf::Future<void> RunUntil(const TaskType& task_type, Taskflow&& task_flow,
                             P&& pred, C&& callable);
 
+  /**
+   * \brief Run \ref target and wait for it.
+   * \remark Called from a worker, the worker keeps running other tasks while
+   * it waits. Called from any other thread, \ref target must be a Taskflow.
+   */
   template <typename T>
   void RunAndWait(const TaskType& task_type, T& target);
 
@@ -77,6 +110,17 @@ class TaskSystem {
 
   int ThisWorkerId(const TaskType& task_type) const;
 
+  /**
+   * \brief Run \ref f with \ref args on the executor.
+   * \return A std::future holding the result of \ref f.
+   * \remark \ref f and \ref args are decay-copied or moved into the job and
+   * the arguments are passed as rvalues, as with std::async, so both may be
+   * move-only.
+   * \remark Asynchronous jobs are queued directly on the executor, without a
+   * taskflow, so they are taken with the highest priority whatever
+   * \ref task_type is. Use \ref Run with a taskflow for work that must stay
+   * in its priority lane.
+   */
   template <typename F, typename... ArgsT>
   auto Async(const TaskType& task_type, F&& f, ArgsT&&... args);
 
@@ -91,6 +135,69 @@ class TaskSystem {
   void NamedSilentAsync(const TaskType& task_type, const std::string& name,
                         F&& f, ArgsT&&... args);
 
+  /**
+   * \brief Call \ref function with every index in [\ref first, \ref last).
+   * \remark Workers claim chunks of at least \ref grain_size indexes. Chunks
+   * shrink as the range runs out (guided scheduling), so uneven work is still
+   * balanced across the workers.
+   * \remark Waiting on the future blocks the calling thread, tasks should use
+   * \ref EmplaceParallelFor and \ref RunAndWait instead.
+   * \remark The parallel algorithms all return a std::future, only it can
+   * carry the result of \ref ParallelReduce.
+   */
+  template <typename F>
+  std::future<void> ParallelFor(const TaskType& task_type, std::size_t first,
+                                std::size_t last, std::size_t grain_size,
+                                F&& function);
+
+  /**
+   * \brief Reduce \ref map(index) of every index in [\ref first, \ref last)
+   * with \ref reduce, starting from \ref init.
+   * \remark The chunks are reduced in parallel and their results are
+   * combined in index order, so \ref reduce must be associative but need not
+   * be commutative. \ref init is the leftmost operand.
+   */
+  template <typename T, typename M, typename R>
+  std::future<T> ParallelReduce(const TaskType& task_type, std::size_t first,
+                                std::size_t last, std::size_t grain_size,
+                                T init, M&& map, R&& reduce);
+
+  /**
+   * \brief Sort [\ref first, \ref last) with \ref compare.
+   * \remark The range must stay valid until the future is ready.
+   */
+  template <typename I, typename C = std::less<>>
+  std::future<void> ParallelSort(const TaskType& task_type, I first, I last,
+                                 C&& compare = C{});
+
+  /**
+   * \brief Add a task running \ref ParallelFor to \ref task_flow, so it can be
+   * chained with other tasks.
+   */
+  template <typename F>
+  Task EmplaceParallelFor(const TaskType& task_type, Taskflow& task_flow,
+                          std::size_t first, std::size_t last,
+                          std::size_t grain_size, F&& function);
+
+  /**
+   * \brief Add a task running \ref ParallelReduce to \ref task_flow, the
+   * result is reduced into \ref result.
+   */
+  template <typename T, typename M, typename R>
+  Task EmplaceParallelReduce(const TaskType& task_type, Taskflow& task_flow,
+                             std::size_t first, std::size_t last,
+                             std::size_t grain_size, T& result, M&& map,
+                             R&& reduce);
+
+  /**
+   * \brief Add a task running \ref ParallelSort to \ref task_flow.
+   * \remark The sort spawns its tasks itself, they keep the default (highest)
+   * priority.
+   */
+  template <typename I, typename C = std::less<>>
+  Task EmplaceParallelSort(const TaskType& task_type, Taskflow& task_flow,
+                           I first, I last, C&& compare = C{});
+
   template <typename Observer, typename... ArgsT>
   std::shared_ptr<Observer> MakeObserver(const TaskType& task_type,
                                          ArgsT&&... args);
@@ -101,6 +208,27 @@ class TaskSystem {
 
   size_t NumObservers(const TaskType& task_type) const noexcept;
 
+  /**
+   * \brief Get the executor shared by every lane.
+   * \remark Taskflows run on it directly keep the priorities of their tasks.
+   */
+  Executor& GetExecutor();
+
+  const Executor& GetExecutor() const;
+
+  /**
+   * \brief Queue \ref task in the lane of \ref task_type.
+   */
+  void AssignTaskType(Task task, const TaskType& task_type);
+
+  /**
+   * \brief Get the profiler observing every task of the executor, it records
+   * nothing until \ref TaskProfiler::Start is called.
+   */
+  TaskProfiler& GetProfiler();
+
+  const TaskProfiler& GetProfiler() const;
+
  private:
   ~TaskSystem() = default;
 
@@ -110,6 +238,36 @@ class TaskSystem {
 
   const Executor& ChooseExecutor(const TaskType& task_type) const;
 
+  void SetTaskflowPriority(const TaskType& task_type, Taskflow& task_flow);
+
+  /**
+   * \brief Report the lane of the asynchronous job running on this worker to
+   * the profiler.
+   */
+  void SetRunningTaskType(const TaskType& task_type);
+
+  /**
+   * \brief Hands out the chunks of a parallel loop.
+   */
+  class ParallelRange {
+   public:
+    ParallelRange(std::size_t first, std::size_t last, std::size_t grain_size,
+                  std::size_t chunk_task_count);
+
+   public:
+    static std::size_t GetChunkTaskCount(std::size_t first, std::size_t last,
+                                         std::size_t grain_size,
+                                         std::size_t worker_count);
+
+    bool ClaimChunk(std::size_t& chunk_first, std::size_t& chunk_last);
+
+   private:
+    std::atomic_size_t next_index_;
+    const std::size_t last_index_;
+    const std::size_t grain_size_;
+    const std::size_t chunk_task_count_;
+  };
+
  protected:
   TaskSystem();
   static TaskSystem* task_system_;
@@ -117,15 +275,14 @@ class TaskSystem {
  private:
   static std::mutex sync_flag_;
 
-  Executor total_executor_;
-  Executor logic_executor_;
-  Executor render_executor_;
-  Executor physical_executor_;
+  Executor executor_;
+  std::shared_ptr<TaskProfiler> profiler_;
 };
 
 template <typename C>
 tf::Future<void> TaskSystem::Run(const TaskType& task_type, Taskflow& task_flow,
                                  C&& callable) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run(task_flow, std::forward<C>(callable));
 }
@@ -133,6 +290,7 @@ tf::Future<void> TaskSystem::Run(const TaskType& task_type, Taskflow& task_flow,
 template <typename C>
 tf::Future<void> TaskSystem::Run(const TaskType& task_type,
                                  Taskflow&& task_flow, C&& callable) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run(std::move(task_flow), std::forward<C>(callable));
 }
@@ -140,6 +298,7 @@ tf::Future<void> TaskSystem::Run(const TaskType& task_type,
 template <typename C>
 tf::Future<void> TaskSystem::RunN(const TaskType& task_type,
                                   Taskflow& task_flow, size_t N, C&& callable) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run_n(task_flow, N, std::forward<C>(callable));
 }
@@ -148,6 +307,7 @@ template <typename C>
 tf::Future<void> TaskSystem::RunN(const TaskType& task_type,
                                   Taskflow&& task_flow, size_t N,
                                   C&& callable) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run_n(std::move(task_flow), N, std::forward<C>(callable));
 }
@@ -155,6 +315,7 @@ tf::Future<void> TaskSystem::RunN(const TaskType& task_type,
 template <typename P>
 tf::Future<void> TaskSystem::RunUntil(const TaskType& task_type,
                                       Taskflow& task_flow, P&& pred) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run_until(task_flow, std::forward<P>(pred));
 }
@@ -162,6 +323,7 @@ tf::Future<void> TaskSystem::RunUntil(const TaskType& task_type,
 template <typename P>
 tf::Future<void> TaskSystem::RunUntil(const TaskType& task_type,
                                       Taskflow&& task_flow, P&& pred) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run_until(std::move(task_flow), std::forward<P>(pred));
 }
@@ -170,6 +332,7 @@ template <typename P, typename C>
 tf::Future<void> TaskSystem::RunUntil(const TaskType& task_type,
                                       Taskflow& task_flow, P&& pred,
                                       C&& callable) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run_until(task_flow, std::forward<P>(pred),
                             std::forward<C>(callable));
@@ -179,6 +342,7 @@ template <typename P, typename C>
 tf::Future<void> TaskSystem::RunUntil(const TaskType& task_type,
                                       Taskflow&& task_flow, P&& pred,
                                       C&& callable) {
+  SetTaskflowPriority(task_type, task_flow);
   auto& executor = ChooseExecutor(task_type);
   return executor.run_until(std::move(task_flow), std::forward<P>(pred),
                             std::forward<C>(callable));
@@ -187,6 +351,13 @@ tf::Future<void> TaskSystem::RunUntil(const TaskType& task_type,
 template <typename T>
 void TaskSystem::RunAndWait(const TaskType& task_type, T& target) {
   auto& executor = ChooseExecutor(task_type);
+  if constexpr (std::is_same_v<T, Taskflow>) {
+    SetTaskflowPriority(task_type, target);
+    if (executor.this_worker_id() < 0) {
+      executor.run(target).wait();
+      return;
+    }
+  }
   executor.run_and_wait(target);
 }
 
@@ -198,23 +369,38 @@ void TaskSystem::LoopUntil(const TaskType& task_type, P&& predicate) {
 
 template <typename F, typename... ArgsT>
 auto TaskSystem::Async(const TaskType& task_type, F&& f, ArgsT&&... args) {
-  auto& executor = ChooseExecutor(task_type);
-  return executor.async(std::forward<F>(f), std::forward<ArgsT>(args)...);
+  return NamedAsync(task_type, "", std::forward<F>(f),
+                    std::forward<ArgsT>(args)...);
 }
 
 template <typename F, typename... ArgsT>
 auto TaskSystem::NamedAsync(const TaskType& task_type, const std::string& name,
                             F&& f, ArgsT&&... args) {
-  auto& executor = ChooseExecutor(task_type);
-  return executor.named_async(name, std::forward<F>(f),
-                              std::forward<ArgsT>(args)...);
+  using ResultType =
+      std::invoke_result_t<std::decay_t<F>&, std::decay_t<ArgsT>...>;
+
+  auto promise = std::make_shared<std::promise<ResultType>>();
+  std::future<ResultType> future = promise->get_future();
+  NamedSilentAsync(
+      task_type, name,
+      [promise, f = std::forward<F>(f),
+       arguments = std::make_tuple(std::forward<ArgsT>(args)...)]() mutable {
+        if constexpr (std::is_void_v<ResultType>) {
+          std::apply(f, std::move(arguments));
+          promise->set_value();
+        } else {
+          promise->set_value(std::apply(f, std::move(arguments)));
+        }
+      });
+
+  return future;
 }
 
 template <typename F, typename... ArgsT>
 void TaskSystem::SilentAsync(const TaskType& task_type, F&& f,
                              ArgsT&&... args) {
-  auto& executor = ChooseExecutor(task_type);
-  executor.silent_async(std::forward<F>(f), std::forward<ArgsT>(args)...);
+  NamedSilentAsync(task_type, "", std::forward<F>(f),
+                   std::forward<ArgsT>(args)...);
 }
 
 template <typename F, typename... ArgsT>
@@ -222,8 +408,160 @@ void TaskSystem::NamedSilentAsync(const TaskType& task_type,
                                   const std::string& name, F&& f,
                                   ArgsT&&... args) {
   auto& executor = ChooseExecutor(task_type);
-  executor.named_silent_async(name, std::forward<F>(f),
-                              std::forward<ArgsT>(args)...);
+  // The executor stores the job in a std::function, which must be copyable, so
+  // a job with move-only captures is kept behind a shared pointer.
+  auto job = [f = std::forward<F>(f),
+              arguments =
+                  std::make_tuple(std::forward<ArgsT>(args)...)]() mutable {
+    std::apply(f, std::move(arguments));
+  };
+  executor.named_silent_async(
+      name, [this, task_type,
+             job = std::make_shared<decltype(job)>(std::move(job))]() {
+        SetRunningTaskType(task_type);
+        (*job)();
+      });
+}
+
+template <typename F>
+std::future<void> TaskSystem::ParallelFor(const TaskType& task_type,
+                                          std::size_t first, std::size_t last,
+                                          std::size_t grain_size,
+                                          F&& function) {
+  Taskflow task_flow{};
+  EmplaceParallelFor(task_type, task_flow, first, last, grain_size,
+                     std::forward<F>(function));
+  return Run(task_type, std::move(task_flow));
+}
+
+template <typename T, typename M, typename R>
+std::future<T> TaskSystem::ParallelReduce(const TaskType& task_type,
+                                          std::size_t first, std::size_t last,
+                                          std::size_t grain_size, T init,
+                                          M&& map, R&& reduce) {
+  auto result = std::make_shared<T>(std::move(init));
+  auto promise = std::make_shared<std::promise<T>>();
+  std::future<T> future = promise->get_future();
+
+  Taskflow task_flow{};
+  Task reduce_task =
+      EmplaceParallelReduce(task_type, task_flow, first, last, grain_size,
+                            *result, std::forward<M>(map),
+                            std::forward<R>(reduce));
+  Task finish_task = task_flow.emplace([result, promise]() {
+    promise->set_value(std::move(*result));
+  });
+  reduce_task.precede(finish_task);
+  Run(task_type, std::move(task_flow));
+
+  return future;
+}
+
+template <typename I, typename C>
+std::future<void> TaskSystem::ParallelSort(const TaskType& task_type, I first,
+                                           I last, C&& compare) {
+  Taskflow task_flow{};
+  EmplaceParallelSort(task_type, task_flow, first, last,
+                      std::forward<C>(compare));
+  return Run(task_type, std::move(task_flow));
+}
+
+template <typename F>
+Task TaskSystem::EmplaceParallelFor(const TaskType& task_type,
+                                    Taskflow& task_flow, std::size_t first,
+                                    std::size_t last, std::size_t grain_size,
+                                    F&& function) {
+  Task task = task_flow.emplace(
+      [this, task_type, first, last, grain_size,
+       function = std::forward<F>(function)](Subflow& subflow) {
+        std::size_t chunk_task_count = ParallelRange::GetChunkTaskCount(
+            first, last, grain_size, executor_.num_workers());
+        ParallelRange range{first, last, grain_size, chunk_task_count};
+        for (std::size_t i = 0; i != chunk_task_count; ++i) {
+          AssignTaskType(subflow.emplace([&range, &function]() {
+            std::size_t chunk_first, chunk_last;
+            while (range.ClaimChunk(chunk_first, chunk_last)) {
+              for (std::size_t index = chunk_first; index != chunk_last;
+                   ++index) {
+                function(index);
+              }
+            }
+          }),
+                         task_type);
+        }
+        // Join here, the chunk tasks use the locals of this task.
+        subflow.join();
+      });
+  AssignTaskType(task, task_type);
+
+  return task;
+}
+
+template <typename T, typename M, typename R>
+Task TaskSystem::EmplaceParallelReduce(const TaskType& task_type,
+                                       Taskflow& task_flow, std::size_t first,
+                                       std::size_t last,
+                                       std::size_t grain_size, T& result,
+                                       M&& map, R&& reduce) {
+  Task task = task_flow.emplace([this, task_type, first, last, grain_size,
+                                 &result, map = std::forward<M>(map),
+                                 reduce = std::forward<R>(reduce)](
+                                    Subflow& subflow) {
+    std::size_t chunk_task_count = ParallelRange::GetChunkTaskCount(
+        first, last, grain_size, executor_.num_workers());
+    ParallelRange range{first, last, grain_size, chunk_task_count};
+    // Every chunk gets its own partial result keyed by its first index, a task
+    // claims chunks out of order and must not fold them together.
+    using ChunkResults = std::vector<std::pair<std::size_t, T>>;
+    std::vector<ChunkResults> chunk_results(chunk_task_count);
+    for (std::size_t i = 0; i != chunk_task_count; ++i) {
+      AssignTaskType(
+          subflow.emplace([&range, &map, &reduce,
+                           &task_chunk_results = chunk_results[i]]() {
+            std::size_t chunk_first, chunk_last;
+            while (range.ClaimChunk(chunk_first, chunk_last)) {
+              T partial_result = map(chunk_first);
+              for (std::size_t index = chunk_first + 1; index != chunk_last;
+                   ++index) {
+                partial_result =
+                    reduce(std::move(partial_result), map(index));
+              }
+              task_chunk_results.emplace_back(chunk_first,
+                                              std::move(partial_result));
+            }
+          }),
+          task_type);
+    }
+    // Join here, the chunk tasks use the locals of this task.
+    subflow.join();
+
+    std::vector<std::pair<std::size_t, T*>> ordered_results;
+    for (ChunkResults& task_chunk_results : chunk_results) {
+      for (auto& [chunk_first, partial_result] : task_chunk_results) {
+        ordered_results.emplace_back(chunk_first, &partial_result);
+      }
+    }
+    std::sort(ordered_results.begin(), ordered_results.end(),
+              [](const auto& lhs, const auto& rhs) {
+                return lhs.first < rhs.first;
+              });
+    for (auto& [chunk_first, partial_result] : ordered_results) {
+      result = reduce(std::move(result), std::move(*partial_result));
+    }
+  });
+  AssignTaskType(task, task_type);
+
+  return task;
+}
+
+template <typename I, typename C>
+Task TaskSystem::EmplaceParallelSort(const TaskType& task_type,
+                                     Taskflow& task_flow, I first, I last,
+                                     C&& compare) {
+  Task task = task_flow.sort(first, last, std::forward<C>(compare));
+  AssignTaskType(task, task_type);
+
+  return task;
 }
 
 template <typename Observer, typename... ArgsT>
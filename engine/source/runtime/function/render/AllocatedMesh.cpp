@@ -43,8 +43,7 @@ MM::RenderSystem::AllocatedMesh::AllocatedMesh(
   }
   const AssetSystem::AssetType::Mesh& mesh =
       static_cast<AssetSystem::AssetType::Mesh&>(mesh_asset.GetAsset());
-  const VkDeviceSize vertex_buffer_size = mesh.GetVerticesCount() *
-                                    sizeof(AssetSystem::AssetType::Vertex),
+  const VkDeviceSize vertex_buffer_size = mesh.GetVertexData().size(),
                index_buffer_size = mesh.GetIndexesCount() * sizeof(VertexIndex);
 
   if (auto if_result = mesh_buffer_manager_->AllocateMeshBuffer(vertex_buffer_size,
@@ -99,11 +98,13 @@ MM::RenderSystem::AllocatedMesh::AllocatedMesh(AllocatedMesh&& other) noexcept
       mesh_buffer_manager_(other.mesh_buffer_manager_),
       sub_vertex_buffer_info_ptr_(other.sub_vertex_buffer_info_ptr_),
       sub_index_buffer_info_ptr_(other.sub_index_buffer_info_ptr_),
-      index_count_(other.index_count_) {
+      index_count_(other.index_count_),
+      vertex_layout_(other.vertex_layout_) {
   other.mesh_buffer_manager_ = nullptr;
   other.sub_vertex_buffer_info_ptr_ = nullptr;
   other.sub_index_buffer_info_ptr_ = nullptr;
   other.index_count_ = 0;
+  other.vertex_layout_.Reset();
 }
 
 MM::RenderSystem::AllocatedMesh& MM::RenderSystem::AllocatedMesh::operator=(
@@ -118,11 +119,13 @@ MM::RenderSystem::AllocatedMesh& MM::RenderSystem::AllocatedMesh::operator=(
   mesh_buffer_manager_ = other.mesh_buffer_manager_;
   sub_vertex_buffer_info_ptr_ = other.sub_vertex_buffer_info_ptr_;
   sub_index_buffer_info_ptr_ = other.sub_index_buffer_info_ptr_;
+  vertex_layout_ = other.vertex_layout_;
 
   other.mesh_buffer_manager_ = nullptr;
   other.sub_vertex_buffer_info_ptr_ = nullptr;
   other.sub_index_buffer_info_ptr_ = nullptr;
   other.index_count_ = 0;
+  other.vertex_layout_.Reset();
 
   return *this;
 }
@@ -207,6 +210,11 @@ MM::RenderSystem::AllocatedMesh::GetIndexQueueIndex() const {
   return sub_index_buffer_info_ptr_->GetQueueIndex();
 }
 
+const MM::AssetSystem::AssetType::VertexLayout&
+MM::RenderSystem::AllocatedMesh::GetVertexLayout() const {
+  return vertex_layout_;
+}
+
 MM::Result<MM::Nil> MM::RenderSystem::AllocatedMesh::CopyAssetDataToBuffer(
     AssetSystem::AssetManager::HandlerType asset_handler) {
   if (!IsValid() && !asset_handler.IsValid()) {
@@ -231,8 +239,7 @@ MM::Result<MM::Nil> MM::RenderSystem::AllocatedMesh::CopyAssetDataToBuffer(
 
   const VkDeviceSize buffer_vertex_size = GetVertexSize(),
                buffer_index_size = GetIndexSize();
-  VkDeviceSize asset_vertex_size = asset_mesh.GetVerticesCount() *
-                                   sizeof(AssetSystem::AssetType::Vertex),
+  VkDeviceSize asset_vertex_size = asset_mesh.GetVertexData().size(),
                asset_index_size =
                    asset_mesh.GetIndexesCount() * sizeof(VertexIndex);
   if ((asset_vertex_size > buffer_vertex_size) ||
@@ -256,7 +263,7 @@ MM::Result<MM::Nil> MM::RenderSystem::AllocatedMesh::CopyAssetDataToBuffer(
   void* stage_data_void{nullptr};
   vmaMapMemory(stage_buffer.GetAllocator(), stage_buffer.GetAllocation(),
                &stage_data_void);
-  memcpy(stage_data_void, asset_mesh.GetVertices().data(), asset_vertex_size);
+  memcpy(stage_data_void, asset_mesh.GetVertexData().data(), asset_vertex_size);
   memcpy(static_cast<char*>(stage_data_void) + asset_vertex_size,
          asset_mesh.GetIndexes().data(), asset_index_size);
   vmaUnmapMemory(stage_buffer.GetAllocator(), stage_buffer.GetAllocation());
@@ -347,6 +354,7 @@ MM::Result<MM::Nil> MM::RenderSystem::AllocatedMesh::CopyAssetDataToBuffer(
   }
 
   index_count_ = asset_mesh.GetIndexesCount();
+  vertex_layout_ = asset_mesh.GetVertexLayout();
 
   return ResultS<Nil>{};
 }
@@ -385,5 +393,6 @@ void MM::RenderSystem::AllocatedMesh::Release() {
     sub_vertex_buffer_info_ptr_ = nullptr;
     sub_index_buffer_info_ptr_ = nullptr;
     index_count_ = 0;
+    vertex_layout_.Reset();
   }
 }
@@ -55,6 +55,17 @@ class AllocatedMesh : public RenderResourceDataBase {
 
   QueueIndex GetIndexQueueIndex() const;
 
+  /**
+   * \brief Get the layout of the vertices copied from the mesh asset.
+   * \remark The layout is invalid if no asset data has been copied.
+   */
+  const AssetSystem::AssetType::VertexLayout& GetVertexLayout() const;
+
+  /**
+   * \brief Copy the vertices and indexes of \ref asset_handler to the buffer.
+   * \remark The vertices are copied as they are encoded in the asset, \ref
+   * GetVertexLayout describes them.
+   */
   Result<Nil> CopyAssetDataToBuffer(
       AssetSystem::AssetManager::HandlerType asset_handler);
 
@@ -76,6 +87,7 @@ class AllocatedMesh : public RenderResourceDataBase {
   BufferSubResourceAttribute* sub_index_buffer_info_ptr_{nullptr};
 
   std::uint32_t index_count_{0};
+  AssetSystem::AssetType::VertexLayout vertex_layout_{};
 };
 }  // namespace RenderSystem
 }  // namespace MM
@@ -59,11 +59,15 @@ AllocatedMeshBuffer::AllocatedMeshBuffer(RenderEngine *render_engine,
     return;
   }
 
-  const std::uint64_t vertex_buffer_size =
-      vertex_count * sizeof(AssetSystem::AssetType::Vertex);
+  // Sized for meshes that have every attribute.
+  const std::uint64_t vertex_stride =
+      AssetSystem::AssetType::VertexLayout{
+          AssetSystem::AssetType::VertexAttribute::ALL,
+          AssetSystem::AssetType::Mesh::kDefaultVertexFormat}
+          .GetStride();
+  const std::uint64_t vertex_buffer_size = vertex_count * vertex_stride;
   const std::uint64_t index_buffer_size =
-      vertex_buffer_size * sizeof(AssetSystem::AssetType::Vertex) /
-      sizeof(std::uint32_t) * 4;
+      vertex_buffer_size * vertex_stride / sizeof(std::uint32_t) * 4;
   InitMeshBuffer(vertex_buffer_size, index_buffer_size);
 }
 
@@ -42,7 +42,35 @@ bool MM::RenderSystem::RenderFuture::RenderFutureStateManager::IsValid() const {
 void MM::RenderSystem::RenderFuture::RenderFutureStateManager::Notify() {
   assert(IsValid());
 
+  std::vector<std::function<void(RenderFutureState)>> completion_callbacks;
+  {
+    std::lock_guard<std::mutex> guard{cvm_->mutex_};
+    cvm_->is_notified_ = true;
+    completion_callbacks.swap(cvm_->completion_callbacks_);
+  }
   cvm_->condition_variable_.notify_one();
+
+  RenderFutureState state = GetState();
+  for (auto& completion_callback : completion_callbacks) {
+    completion_callback(state);
+  }
+}
+
+void MM::RenderSystem::RenderFuture::RenderFutureStateManager::
+    AddCompletionCallback(std::function<void(RenderFutureState)>&& callback) {
+  assert(IsValid());
+
+  {
+    std::lock_guard<std::mutex> guard{cvm_->mutex_};
+    RenderFutureState state = state_.load(std::memory_order_acquire);
+    if (!cvm_->is_notified_ && (state == RenderFutureState::WAIT ||
+                                state == RenderFutureState::RUNNING)) {
+      cvm_->completion_callbacks_.emplace_back(std::move(callback));
+      return;
+    }
+  }
+
+  callback(GetState());
 }
 
 void MM::RenderSystem::RenderFuture::RenderFutureStateManager::SetState(
@@ -121,6 +149,21 @@ bool MM::RenderSystem::RenderFuture::IsValid() const {
   return command_executor_ != nullptr && state_manager_ != nullptr;
 }
 
+MM::TaskSystem::AsyncTask<MM::RenderSystem::RenderFutureState>
+MM::RenderSystem::RenderFuture::GetAsyncTask() {
+  assert(IsValid());
+
+  TaskSystem::AsyncTaskPromise<RenderFutureState> promise{};
+  TaskSystem::AsyncTask<RenderFutureState> async_task = promise.GetAsyncTask();
+  if (state_manager_->GetState() == RenderFutureState::WAIT) {
+    AddToWaitList();
+  }
+  state_manager_->AddCompletionCallback(
+      [promise](RenderFutureState state) { promise.SetValue(state); });
+
+  return async_task;
+}
+
 MM::RenderSystem::RenderFuture::RenderFuture(
     CommandExecutor* command_executor, CommandTaskFlowID command_task_flow_ID,
     RenderFutureStateManagerRef state_manager)
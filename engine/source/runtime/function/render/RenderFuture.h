@@ -5,9 +5,12 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
+#include "runtime/core/task_system/async_task.h"
 #include "runtime/function/render/RenderFuture.h"
 #include "runtime/function/render/vk_command_pre.h"
 #include "runtime/function/render/vk_enum.h"
@@ -22,6 +25,9 @@ class RenderFuture {
   struct RenderFutureCVM {
     std::mutex mutex_;
     std::condition_variable condition_variable_;
+    // Guarded by mutex_.
+    bool is_notified_{false};
+    std::vector<std::function<void(RenderFutureState)>> completion_callbacks_;
   };
 
   class RenderFutureStateManager {
@@ -48,6 +54,13 @@ class RenderFuture {
 
     void Wait();
 
+    /**
+     * \brief Call \ref callback with the final state once the task flow
+     * completes, or right away if it already has.
+     */
+    void AddCompletionCallback(
+        std::function<void(RenderFutureState)>&& callback);
+
     template <class Rep, class Period>
     bool WaitFor(const std::chrono::duration<Rep, Period>& rel_time) {
       std::unique_lock<std::mutex> um{cvm_->mutex_};
@@ -146,6 +159,14 @@ class RenderFuture {
 
   bool IsValid() const;
 
+  /**
+   * \brief Get a task that becomes ready with the final state of the task
+   * flow.
+   * \remark Unlike \ref Wait, this blocks no thread. Chain the next step with
+   * TaskSystem::AsyncTask::Then.
+   */
+  TaskSystem::AsyncTask<RenderFutureState> GetAsyncTask();
+
  private:
   CommandExecutor* command_executor_{nullptr};
   CommandTaskFlowID command_task_flow_ID_{0};
@@ -19,9 +19,14 @@ class RenderPassAttachmentDescription {
   class RenderPassAttachmentDescriptionWrapper;
 
  public:
-  using RenderPassContainerType =
-      MM::Utils::ConcurrentMap<RenderPassID,
-                               RenderPassAttachmentDescriptionWrapper>;
+  // Power of two buckets let the container grow incrementally instead of
+  // stopping every render thread for a rehash.
+  using RenderPassContainerType = MM::Utils::ConcurrentMap<
+      RenderPassID, RenderPassAttachmentDescriptionWrapper,
+      std::hash<RenderPassID>, std::equal_to<>,
+      std::allocator<
+          std::pair<const RenderPassID, RenderPassAttachmentDescriptionWrapper>>,
+      MM::Utils::PowerOfTwoBucket>;
 
  public:
   RenderPassAttachmentDescription() = default;
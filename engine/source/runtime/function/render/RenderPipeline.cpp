@@ -315,40 +315,15 @@ MM::Result<MM::Nil> MM::RenderSystem::GraphicsPipeline::CheckInitParametes(
   }
 
   if (vk_graphics_pipeline_create_info.pVertexInputState == nullptr ||
-      vk_graphics_pipeline_create_info.pVertexInputState
-              ->vertexBindingDescriptionCount < 1 ||
-      vk_graphics_pipeline_create_info.pVertexInputState
-              ->vertexAttributeDescriptionCount < 5 ||
-      !MM::RenderSystem::VkVertexInputBindingDescriptionIsEqual(
+      !VertexInputStateDescription::IsSupported(
           vk_graphics_pipeline_create_info.pVertexInputState
-              ->pVertexBindingDescriptions[0],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_bind_description_) ||
-      !MM::RenderSystem::VkVertexInputAttributeDescriptionIsEqual(
+              ->pVertexBindingDescriptions,
           vk_graphics_pipeline_create_info.pVertexInputState
-              ->pVertexAttributeDescriptions[0],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_attribute_descriptions_[0]) ||
-      !MM::RenderSystem::VkVertexInputAttributeDescriptionIsEqual(
+              ->vertexBindingDescriptionCount,
           vk_graphics_pipeline_create_info.pVertexInputState
-              ->pVertexAttributeDescriptions[1],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_attribute_descriptions_[1]) ||
-      !MM::RenderSystem::VkVertexInputAttributeDescriptionIsEqual(
+              ->pVertexAttributeDescriptions,
           vk_graphics_pipeline_create_info.pVertexInputState
-              ->pVertexAttributeDescriptions[2],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_attribute_descriptions_[2]) ||
-      !MM::RenderSystem::VkVertexInputAttributeDescriptionIsEqual(
-          vk_graphics_pipeline_create_info.pVertexInputState
-              ->pVertexAttributeDescriptions[3],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_attribute_descriptions_[3]) ||
-      !MM::RenderSystem::VkVertexInputAttributeDescriptionIsEqual(
-          vk_graphics_pipeline_create_info.pVertexInputState
-              ->pVertexAttributeDescriptions[4],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_attribute_descriptions_[4])) {
+              ->vertexAttributeDescriptionCount)) {
     MM_LOG_ERROR(
         "The input parametes vk_graphics_pipeline_create_info is error.");
     return ResultE<>{ErrorCode::INITIALIZATION_FAILED};
@@ -380,40 +355,15 @@ MM::Result<MM::Nil> MM::RenderSystem::GraphicsPipeline::CheckInitParametes(
     return ResultE<>{ErrorCode::INITIALIZATION_FAILED};
   }
 
-  if (graphics_pipeline_data_info.vertex_input_state_
-          .vertex_binding_description_.empty() ||
-      graphics_pipeline_data_info.vertex_input_state_
-              .vertex_attribute_descriptions_.size() < 5 ||
-      !MM::RenderSystem::VkVertexInputBindingDescriptionIsEqual(
-          graphics_pipeline_data_info.vertex_input_state_
-              .vertex_binding_description_[0],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_bind_description_) ||
-      !MM::RenderSystem::VkVertexInputAttributeDescriptionIsEqual(
-          graphics_pipeline_data_info.vertex_input_state_
-              .vertex_attribute_descriptions_[0],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_attribute_descriptions_[0]) ||
-      !MM::RenderSystem::VkVertexInputAttributeDescriptionIsEqual(
+  if (!VertexInputStateDescription::IsSupported(
           graphics_pipeline_data_info.vertex_input_state_
-              .vertex_attribute_descriptions_[1],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_attribute_descriptions_[1]) ||
-      !MM::RenderSystem::VkVertexInputAttributeDescriptionIsEqual(
+              .vertex_binding_description_.data(),
           graphics_pipeline_data_info.vertex_input_state_
-              .vertex_attribute_descriptions_[2],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_attribute_descriptions_[2]) ||
-      !MM::RenderSystem::VkVertexInputAttributeDescriptionIsEqual(
+              .vertex_binding_description_.size(),
           graphics_pipeline_data_info.vertex_input_state_
-              .vertex_attribute_descriptions_[3],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_attribute_descriptions_[3]) ||
-      !MM::RenderSystem::VkVertexInputAttributeDescriptionIsEqual(
+              .vertex_attribute_descriptions_.data(),
           graphics_pipeline_data_info.vertex_input_state_
-              .vertex_attribute_descriptions_[4],
-          DefaultVertexInputStateDescription::
-              vertex_input_state_attribute_descriptions_[4])) {
+              .vertex_attribute_descriptions_.size())) {
     MM_LOG_ERROR("The input parametes graphics_pipeline_data_info is error.");
     return ResultE<>{ErrorCode::INITIALIZATION_FAILED};
   }
@@ -27,6 +27,7 @@ class RenderResourceDataManagerImp : public Manager::ManagerBase<ManagedType> {
   using RenderResourceDataIDToObjectIDContainerType =
       Manager::ManagedObjectUnorderedMultiMap<RenderResourceDataID,
                                               Manager::ManagedObjectID>;
+  using RenderResourceHandleType = Manager::ManagedObjectGenerationalHandle;
 
  public:
   RenderResourceDataManagerImp() = default;
@@ -178,6 +179,24 @@ class RenderResourceDataManagerImp : public Manager::ManagerBase<ManagedType> {
     return ResultS{std::move(handler)};
   }
 
+  Result<RenderResourceHandleType> GetRenderResourceDataHandleByID(
+      const Manager::ManagedObjectID& object_ID) const {
+    return BaseManagerType::GetGenerationalHandle(object_ID);
+  }
+
+  /**
+   * \brief Resolve \ref render_resource_handle without hashing or locking.
+   * \return A handler that keeps the render resource data alive, or an error
+   * if the data has been removed.
+   * \remark The handler does not hold the render resource data ID index entry,
+   * use \ref GetRenderResourceDataByID when a \ref RenderResourceHandler is
+   * needed.
+   */
+  Result<BaseHandlerType> GetRenderResourceDataByHandle(
+      RenderResourceHandleType render_resource_handle) const {
+    return BaseManagerType::GetObjectByHandle(render_resource_handle);
+  }
+
   Result<HandlerType> GetRenderResourceDataByID(
       const Manager::ManagedObjectID& object_ID) const {
     return GetRenderResourceDataByID(object_ID, StaticTrait::read_and_write);
@@ -76,8 +76,19 @@ std::uint32_t MM::RenderSystem::RenderResourceMesh::GetIndexOffset() const {
 
 std::int32_t MM::RenderSystem::RenderResourceMesh::GetVertexOffset() const {
   assert(IsValid());
-  return allocated_mesh_->GetVertexOffset() /
-         sizeof(AssetSystem::AssetType::Vertex);
+  return 0;
+}
+
+VkDeviceSize MM::RenderSystem::RenderResourceMesh::GetVertexBufferOffset()
+    const {
+  assert(IsValid());
+  return allocated_mesh_->GetVertexOffset();
+}
+
+const MM::AssetSystem::AssetType::VertexLayout&
+MM::RenderSystem::RenderResourceMesh::GetVertexLayout() const {
+  assert(IsValid());
+  return allocated_mesh_->GetVertexLayout();
 }
 
 bool MM::RenderSystem::RenderResourceMesh::IsValid() const {
@@ -35,8 +35,21 @@ class RenderResourceMesh {
 
   std::uint32_t GetIndexOffset() const;
 
+  /**
+   * \brief Get the vertexOffset of the draw.
+   * \remark Meshes with different vertex layouts share the vertex buffer, so
+   * a mesh does not start at a multiple of its stride. Bind the vertex buffer
+   * at \ref GetVertexBufferOffset, the vertex offset is always 0.
+   */
   std::int32_t GetVertexOffset() const;
 
+  /**
+   * \brief Get the offset to bind the vertex buffer at, in bytes.
+   */
+  VkDeviceSize GetVertexBufferOffset() const;
+
+  const AssetSystem::AssetType::VertexLayout& GetVertexLayout() const;
+
   bool IsValid() const;
 
   void Reset();
@@ -2431,28 +2431,30 @@ void MM::RenderSystem::RenderEngine::FindSupportStorageImageFormat() {
 }
 
 void MM::RenderSystem::RenderEngine::InitPipelineCache() {
-  std::vector<char> cache_data;
+  FileSystem::MappedFile cache_file;
   bool valid = true;
   FileSystem::Path pipeline_cache_path =
       MM_FILE_SYSTEM->GetAssetDirCache() + "./.pipeline_cache";
-  if (auto if_result = MM_FILE_SYSTEM->ReadFile(pipeline_cache_path, 0);
+  if (auto if_result = MM_FILE_SYSTEM->MapFile(pipeline_cache_path);
     if_result.IgnoreException().IsError()) {
     valid = false;
   } else {
-    cache_data = std::move(if_result.GetResult());
+    cache_file = std::move(if_result.GetResult());
   }
   if (valid) {
     valid &= IsValidPipelineCacheData(
-        pipeline_cache_path.String(), cache_data.data(), cache_data.size(),
-        GetPhysicalDeviceProperties());
+        pipeline_cache_path.String(), cache_file.GetData(),
+        cache_file.GetSize(), GetPhysicalDeviceProperties());
   }
 
+  // The driver reads the cache straight from the mapped file.
   VkPipelineCacheCreateInfo pipeline_cache_create_info{};
   pipeline_cache_create_info.sType =
       VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
   pipeline_cache_create_info.pNext = nullptr;
-  pipeline_cache_create_info.initialDataSize = valid ? cache_data.size() : 0;
-  pipeline_cache_create_info.pInitialData = valid ? cache_data.data() : nullptr;
+  pipeline_cache_create_info.initialDataSize = valid ? cache_file.GetSize() : 0;
+  pipeline_cache_create_info.pInitialData =
+      valid ? cache_file.GetData() : nullptr;
 
   if (auto if_result = ConvertVkResultToMMResult(vkCreatePipelineCache(GetDevice(), &pipeline_cache_create_info,
                                     nullptr, &pipeline_cache_));
@@ -1399,8 +1399,7 @@ VkImageView MM::RenderSystem::ImageView::GetVkImageView() {
   return image_view_wrapper_.image_view_;
 }
 
-MM::Utils::ConcurrentMap<MM::RenderSystem::RenderSamplerAttributeID,
-                         MM::RenderSystem::Sampler::SamplerWrapper>
+MM::RenderSystem::Sampler::SamplerContainerType
     MM::RenderSystem::Sampler::sampler_container_(512);
 
 MM::RenderSystem::Sampler::Sampler(
@@ -3544,25 +3543,124 @@ VkPipelineDynamicStateCreateInfo MM::RenderSystem::
       static_cast<uint32_t>(dynamic_state_.size()), dynamic_state_.data()};
 }
 
-const std::array<VkVertexInputAttributeDescription, 5>
+MM::RenderSystem::VertexInputStateDescription::VertexInputStateDescription(
+    const AssetSystem::AssetType::VertexLayout& vertex_layout)
+    : vertex_input_state_bind_description_{0, vertex_layout.GetStride(),
+                                           VK_VERTEX_INPUT_RATE_VERTEX} {
+  using AssetSystem::AssetType::VertexAttribute;
+  const bool is_packed = vertex_layout.GetFormat() ==
+                         AssetSystem::AssetType::VertexFormat::PACKED;
+  vertex_input_state_attribute_descriptions_.push_back(
+      VkVertexInputAttributeDescription{0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0});
+  if (vertex_layout.HaveAttribute(VertexAttribute::TEXTURE_COORD)) {
+    vertex_input_state_attribute_descriptions_.push_back(
+        VkVertexInputAttributeDescription{
+            1, 0,
+            is_packed ? VK_FORMAT_R16G16_SFLOAT : VK_FORMAT_R32G32_SFLOAT,
+            vertex_layout.GetOffset(VertexAttribute::TEXTURE_COORD)});
+  }
+  if (vertex_layout.HaveAttribute(VertexAttribute::NORMAL)) {
+    vertex_input_state_attribute_descriptions_.push_back(
+        VkVertexInputAttributeDescription{
+            2, 0,
+            is_packed ? VK_FORMAT_R16G16_SNORM : VK_FORMAT_R32G32B32_SFLOAT,
+            vertex_layout.GetOffset(VertexAttribute::NORMAL)});
+  }
+  if (vertex_layout.HaveAttribute(VertexAttribute::TANGENT)) {
+    vertex_input_state_attribute_descriptions_.push_back(
+        VkVertexInputAttributeDescription{
+            3, 0,
+            is_packed ? VK_FORMAT_R16G16B16A16_SNORM
+                      : VK_FORMAT_R32G32B32A32_SFLOAT,
+            vertex_layout.GetOffset(VertexAttribute::TANGENT)});
+  }
+}
+
+MM::RenderSystem::PipelineVertexInputStateCreateInfo
+MM::RenderSystem::VertexInputStateDescription::
+    GetPipelineVertexInputStateCreateInfo() const {
+  return PipelineVertexInputStateCreateInfo{
+      0,
+      std::vector<VkVertexInputBindingDescription>{
+          vertex_input_state_bind_description_},
+      vertex_input_state_attribute_descriptions_};
+}
+
+bool MM::RenderSystem::VertexInputStateDescription::IsSupported(
+    const VkVertexInputBindingDescription* binding_descriptions,
+    std::uint32_t binding_description_count,
+    const VkVertexInputAttributeDescription* attribute_descriptions,
+    std::uint32_t attribute_description_count) {
+  using AssetSystem::AssetType::VertexAttribute;
+  using AssetSystem::AssetType::VertexFormat;
+  using AssetSystem::AssetType::VertexLayout;
+  if (binding_descriptions == nullptr || binding_description_count < 1 ||
+      attribute_descriptions == nullptr) {
+    return false;
+  }
+
+  for (VertexFormat format : {VertexFormat::FP32, VertexFormat::PACKED}) {
+    for (std::uint32_t attributes = 0;
+         attributes <= static_cast<std::uint32_t>(VertexAttribute::ALL);
+         ++attributes) {
+      const VertexLayout vertex_layout{static_cast<VertexAttribute>(attributes),
+                                       format};
+      // Every layout is visited once.
+      if (static_cast<std::uint32_t>(vertex_layout.GetAttributes()) !=
+          attributes) {
+        continue;
+      }
+      const VertexInputStateDescription description{vertex_layout};
+      if (attribute_description_count <
+              description.vertex_input_state_attribute_descriptions_.size() ||
+          !VkVertexInputBindingDescriptionIsEqual(
+              binding_descriptions[0],
+              description.vertex_input_state_bind_description_)) {
+        continue;
+      }
+      bool is_equal = true;
+      for (std::size_t i = 0;
+           i != description.vertex_input_state_attribute_descriptions_.size();
+           ++i) {
+        if (!VkVertexInputAttributeDescriptionIsEqual(
+                attribute_descriptions[i],
+                description.vertex_input_state_attribute_descriptions_[i])) {
+          is_equal = false;
+          break;
+        }
+      }
+      if (is_equal) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+namespace {
+const MM::RenderSystem::VertexInputStateDescription
+    kDefaultVertexInputStateDescription{MM::AssetSystem::AssetType::VertexLayout{
+        MM::AssetSystem::AssetType::VertexAttribute::ALL,
+        MM::AssetSystem::AssetType::Mesh::kDefaultVertexFormat}};
+}  // namespace
+
+const VkVertexInputBindingDescription MM::RenderSystem::
+    DefaultVertexInputStateDescription::vertex_input_state_bind_description_{
+        kDefaultVertexInputStateDescription
+            .vertex_input_state_bind_description_};
+
+const std::array<VkVertexInputAttributeDescription, 4>
     MM::RenderSystem::DefaultVertexInputStateDescription::
         vertex_input_state_attribute_descriptions_{
-            VkVertexInputAttributeDescription{
-                0, 0, VK_FORMAT_R32G32B32_SFLOAT,
-                AssetSystem::AssetType::Vertex::GetOffsetOfPosition()},
-            VkVertexInputAttributeDescription{
-                1, 0, VK_FORMAT_R32G32_SFLOAT,
-                AssetSystem::AssetType::Vertex::GetOffsetOfTextureCoord()},
-            VkVertexInputAttributeDescription{
-                2, 0, VK_FORMAT_R32G32B32_SFLOAT,
-                AssetSystem::AssetType::Vertex::GetOffsetOfNormal()},
-            VkVertexInputAttributeDescription{
-                3, 0, VK_FORMAT_R32G32B32_SFLOAT,
-                AssetSystem::AssetType::Vertex::GetOffsetOfTangent()},
-            VkVertexInputAttributeDescription{
-                4, 0, VK_FORMAT_R32G32B32_SFLOAT,
-                AssetSystem::AssetType::Vertex::GetOffsetOfBiTangent()},
-        };
+            kDefaultVertexInputStateDescription
+                .vertex_input_state_attribute_descriptions_[0],
+            kDefaultVertexInputStateDescription
+                .vertex_input_state_attribute_descriptions_[1],
+            kDefaultVertexInputStateDescription
+                .vertex_input_state_attribute_descriptions_[2],
+            kDefaultVertexInputStateDescription
+                .vertex_input_state_attribute_descriptions_[3]};
 
 VkViewport MM::RenderSystem::DefaultViewportState::default_viewport_{0, 0, 0,
                                                                      0, 0, 1};
@@ -800,9 +800,16 @@ class Sampler {
   SamplerCreateInfo sampler_create_info_{};
   SamplerWrapper* sampler_wrapper_{nullptr};
 
+  // Power of two buckets let the container grow incrementally instead of
+  // stopping every render thread for a rehash.
+  using SamplerContainerType = Utils::ConcurrentMap<
+      RenderSamplerAttributeID, SamplerWrapper,
+      std::hash<RenderSamplerAttributeID>, std::equal_to<>,
+      std::allocator<std::pair<const RenderSamplerAttributeID, SamplerWrapper>>,
+      Utils::PowerOfTwoBucket>;
+
   // TODO render_engine recovery
-  static Utils::ConcurrentMap<RenderSamplerAttributeID, SamplerWrapper>
-      sampler_container_;
+  static SamplerContainerType sampler_container_;
 };
 
 class ImageBindData {
@@ -1335,12 +1342,43 @@ struct PushData16 {
   std::uint64_t slot16_;
 };
 
+/**
+ * \brief The vertex input state that reads the vertices of a vertex layout
+ * from binding 0.
+ * \remark The locations are 0 position, 1 texture coord, 2 normal and 3
+ * tangent with the bitangent sign in w. The attributes that the layout does
+ * not store have no description.
+ */
+struct VertexInputStateDescription {
+  VertexInputStateDescription() = default;
+  explicit VertexInputStateDescription(
+      const AssetSystem::AssetType::VertexLayout& vertex_layout);
+
+  VkVertexInputBindingDescription vertex_input_state_bind_description_{};
+  std::vector<VkVertexInputAttributeDescription>
+      vertex_input_state_attribute_descriptions_{};
+
+  PipelineVertexInputStateCreateInfo GetPipelineVertexInputStateCreateInfo()
+      const;
+
+  /**
+   * \brief Check whether the first binding and attributes read the vertices of
+   * a vertex layout that a mesh can have.
+   */
+  static bool IsSupported(
+      const VkVertexInputBindingDescription* binding_descriptions,
+      std::uint32_t binding_description_count,
+      const VkVertexInputAttributeDescription* attribute_descriptions,
+      std::uint32_t attribute_description_count);
+};
+
+/**
+ * \brief The vertex input state of the meshes that have every attribute.
+ */
 struct DefaultVertexInputStateDescription {
-  constexpr static VkVertexInputBindingDescription
-      vertex_input_state_bind_description_{
-          0, sizeof(AssetSystem::AssetType::Vertex),
-          VK_VERTEX_INPUT_RATE_VERTEX};
-  static const std::array<VkVertexInputAttributeDescription, 5>
+  static const VkVertexInputBindingDescription
+      vertex_input_state_bind_description_;
+  static const std::array<VkVertexInputAttributeDescription, 4>
       vertex_input_state_attribute_descriptions_;
 };
 
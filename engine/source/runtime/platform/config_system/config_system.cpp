@@ -1,69 +1,186 @@
 #include "runtime/platform/config_system/config_system.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "runtime/platform/config_system/ini_parser.h"
+#include "utils/epoch.h"
+
+namespace {
+/**
+ * \brief A setting with its value parsed once for every type it can be read
+ * as.
+ */
+struct ConfigValue {
+  std::string string_value_{};
+  bool is_integer_{false};
+  std::int64_t integer_value_{0};
+  bool is_unsigned_{false};
+  std::uint64_t unsigned_value_{0};
+  bool is_floating_{false};
+  long double floating_value_{0};
+};
+
+// Numbers are parsed the same way std::stoll and std::stold do, leading white
+// space is skipped and trailing characters are ignored.
+ConfigValue ParseConfigValue(const std::string& value) {
+  ConfigValue config_value;
+  config_value.string_value_ = value;
+  const char* begin = value.c_str();
+  char* end = nullptr;
+
+  errno = 0;
+  const long long integer_value = std::strtoll(begin, &end, 10);
+  if (end != begin && errno != ERANGE) {
+    config_value.is_integer_ = true;
+    config_value.integer_value_ = integer_value;
+  }
+
+  // strtoull accepts negative numbers and wraps them.
+  const std::size_t first_not_space = value.find_first_not_of(" \t\n\v\f\r");
+  if (first_not_space != std::string::npos && value[first_not_space] != '-') {
+    errno = 0;
+    const unsigned long long unsigned_value = std::strtoull(begin, &end, 10);
+    if (end != begin && errno != ERANGE) {
+      config_value.is_unsigned_ = true;
+      config_value.unsigned_value_ = unsigned_value;
+    }
+  }
+
+  errno = 0;
+  const long double floating_value = std::strtold(begin, &end);
+  if (end != begin && errno != ERANGE) {
+    config_value.is_floating_ = true;
+    config_value.floating_value_ = floating_value;
+  }
+
+  return config_value;
+}
+
+MM::Result<MM::Nil, MM::ErrorResult> ConvertConfigValue(
+    const ConfigValue& config_value, std::string& get_data) {
+  get_data = config_value.string_value_;
+  return MM::Result<MM::Nil, MM::ErrorResult>{MM::st_execute_success};
+}
+
+template <typename ValueType>
+MM::Result<MM::Nil, MM::ErrorResult> ConvertConfigValue(
+    const ConfigValue& config_value, ValueType& get_data) {
+  if constexpr (std::is_floating_point_v<ValueType>) {
+    if (config_value.is_floating_) {
+      get_data = static_cast<ValueType>(config_value.floating_value_);
+      return MM::Result<MM::Nil, MM::ErrorResult>{MM::st_execute_success};
+    }
+  } else if constexpr (std::is_signed_v<ValueType>) {
+    if (config_value.is_integer_ &&
+        config_value.integer_value_ >= std::numeric_limits<ValueType>::min() &&
+        config_value.integer_value_ <= std::numeric_limits<ValueType>::max()) {
+      get_data = static_cast<ValueType>(config_value.integer_value_);
+      return MM::Result<MM::Nil, MM::ErrorResult>{MM::st_execute_success};
+    }
+  } else {
+    if (config_value.is_unsigned_ &&
+        config_value.unsigned_value_ <= std::numeric_limits<ValueType>::max()) {
+      get_data = static_cast<ValueType>(config_value.unsigned_value_);
+      return MM::Result<MM::Nil, MM::ErrorResult>{MM::st_execute_success};
+    }
+  }
+
+  return MM::Result<MM::Nil, MM::ErrorResult>{
+      MM::st_execute_error, MM::ErrorCode::TYPE_CONVERSION_FAILED};
+}
+}  // namespace
+
+/**
+ * \remark Snapshots share what did not change: the key index is shared until a
+ * key is added or removed, and every value until it is set again. Publishing
+ * one setting copies the value pointers only.
+ */
+struct MM::ConfigSystem::ConfigSystem::ConfigSnapshot {
+  std::shared_ptr<const std::unordered_map<std::string, std::uint32_t>>
+      key_indexes_{};
+  // Indexed by the index of a ConfigKey, nullptr for keys without a value.
+  std::vector<std::shared_ptr<const ConfigValue>> values_{};
+};
+
 std::mutex MM::ConfigSystem::ConfigSystem::sync_flag_{std::mutex()};
+std::mutex MM::ConfigSystem::ConfigSystem::config_mutex_{};
 MM::ConfigSystem::ConfigSystem* MM::ConfigSystem::ConfigSystem::config_system_{
     nullptr};
 std::unordered_map<std::string, std::string>
     MM::ConfigSystem::ConfigSystem::config_data_base_{};
+std::unordered_map<std::string, std::uint32_t>
+    MM::ConfigSystem::ConfigSystem::config_key_indexes_{};
+std::atomic<const MM::ConfigSystem::ConfigSystem::ConfigSnapshot*>
+    MM::ConfigSystem::ConfigSystem::snapshot_{nullptr};
+
+MM::ConfigSystem::ConfigKey::ConfigKey(std::uint32_t index) : index_(index) {}
+
+bool MM::ConfigSystem::ConfigKey::IsValid() const {
+  return index_ != UINT32_MAX;
+}
 
 std::string MM::ConfigSystem::LoadOneConfigFromIni(
     const MM::FileSystem::Path& file_path, const std::string& key) {
-  std::fstream config_file{file_path.String()};
-  if (config_file.is_open()) {
-    std::string line;
-    while (std::getline(config_file, line)) {
-      if (line.length() == 0) {
-        continue;
-      }
-      if (line[0] == '[' && line[line.size() - 1] == ']') {
-        continue;
-      }
-      if (key == line.substr(0, line.find('='))) {
-        const size_t semicolon_position{
-            line.substr(line.find('=') + 1, line.size() - line.find('=') - 1)
-                .find(';')};
-        if (semicolon_position == std::string::npos) {
-          config_file.close();
-          return std::string(line.substr(line.find('=') + 1,
-                                         line.size() - line.find('=') - 1));
-        }
-        config_file.close();
-        return std::string(line.substr(line.find('=') + 1, semicolon_position));
-      }
-    }
-    config_file.close();
+  std::unordered_map<std::string, std::string> result =
+      LoadConfigFromIni(file_path, std::vector<std::string>{key});
+  auto config = result.find(key);
+  if (config == result.end()) {
+    return std::string{};
   }
-  return std::string{};
+
+  return std::move(config->second);
 }
 
 std::unordered_map<std::string, std::string>
 MM::ConfigSystem::LoadConfigFromIni(const MM::FileSystem::Path& file_path) {
-  std::fstream config_file{file_path.String()};
   std::unordered_map<std::string, std::string> result;
-  if (config_file.is_open()) {
-    std::string line;
-    while (std::getline(config_file, line)) {
-      if (line.length() == 0) {
-        continue;
-      }
-      if (line[0] == '[' && line[line.size() - 1] == ']') {
-        continue;
-      }
-      const size_t semicolon_position{
-          line.substr(line.find('=') + 1, line.size() - line.find('=') - 1)
-              .find(';')};
-      if (semicolon_position == std::string::npos) {
-        result.emplace(
-            line.substr(0, line.find('=')),
-            line.substr(line.find('=') + 1, line.size() - line.find('=') - 1));
-      } else {
-        result.emplace(line.substr(0, line.find('=')),
-                       line.substr(line.find('=') + 1, semicolon_position));
-      }
-    }
-    config_file.close();
+  Result<FileSystem::MappedFile, ErrorResult> config_file =
+      FileSystem::FileSystem::GetInstance()->MapFile(file_path);
+  if (!config_file.IsSuccess()) {
+    return result;
+  }
+
+  ParseIni(config_file.GetResult().GetStringView(),
+           [&result](std::string_view key, std::string_view value) {
+             // The first occurrence of a key wins.
+             result.try_emplace(std::string{key}, value);
+           });
+  return result;
+}
+
+std::unordered_map<std::string, std::string>
+MM::ConfigSystem::LoadConfigFromIni(const MM::FileSystem::Path& file_path,
+                                    const std::vector<std::string>& keys) {
+  std::unordered_map<std::string, std::string> result;
+  Result<FileSystem::MappedFile, ErrorResult> config_file =
+      FileSystem::FileSystem::GetInstance()->MapFile(file_path);
+  if (!config_file.IsSuccess() || keys.empty()) {
     return result;
   }
+
+  std::unordered_map<std::string_view, bool> wanted_keys;
+  wanted_keys.reserve(keys.size());
+  for (const std::string& key : keys) {
+    wanted_keys.emplace(key, false);
+  }
+  std::size_t remaining_count = wanted_keys.size();
+  ParseIni(config_file.GetResult().GetStringView(),
+           [&](std::string_view key, std::string_view value) {
+             auto wanted_key = wanted_keys.find(key);
+             if (wanted_key == wanted_keys.end() || wanted_key->second) {
+               return true;
+             }
+             wanted_key->second = true;
+             result.emplace(std::string{key}, value);
+             // Stop as soon as every key has been found.
+             return --remaining_count != 0;
+           });
   return result;
 }
 
@@ -77,11 +194,10 @@ MM::ConfigSystem::ConfigSystem* MM::ConfigSystem::ConfigSystem::GetInstance() {
       config_system_ = new ConfigSystem{};
       auto config_dir =
           FileSystem::Path(MM_STR(MM_RELATIVE_CONFIG_DIR)).String();
-      config_data_base_["config_dir"] =
-          FileSystem::Path(MM_STR(MM_RELATIVE_CONFIG_DIR)).String();
+      config_system_->SetConfig("config_dir", config_dir);
       Result<Nil, ErrorResult> load_result =
           config_system_->LoadConfigFromIni(FileSystem::Path(
-              config_data_base_["config_dir"] + "/init_config.ini")).Exception([](){
+              config_dir + "/init_config.ini")).Exception([](){
               std::cout << "!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!\n"
                         << "!!!!!!!!!!!! Failed to read init config !!!!!!!!!!!!\n"
                         << "!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!"
@@ -95,74 +211,93 @@ MM::ConfigSystem::ConfigSystem* MM::ConfigSystem::ConfigSystem::GetInstance() {
 }
 
 bool MM::ConfigSystem::ConfigSystem::Have(const std::string& key) const {
-  return config_data_base_.find(key) != config_data_base_.end();
+  Utils::EpochGuard guard;
+  const ConfigSnapshot* snapshot = snapshot_.load(std::memory_order_acquire);
+  return snapshot != nullptr &&
+         snapshot->key_indexes_->find(key) != snapshot->key_indexes_->end();
 }
 
 bool MM::ConfigSystem::ConfigSystem::LoadOneConfigFromIni(
     const MM::FileSystem::Path& file_path, const std::string& key) {
-  std::fstream config_file{file_path.String()};
-  if (config_file.is_open()) {
-    std::string line;
-    while (std::getline(config_file, line)) {
-      if (line.length() == 0) {
-        continue;
-      }
-      if (line[0] == '[' && line[line.size() - 1] == ']') {
-        continue;
-      }
-      if (key == line.substr(0, line.find('='))) {
-        const size_t semicolon_position{
-            line.substr(line.find('=') + 1, line.size() - line.find('=') - 1)
-                .find(';')};
-        if (semicolon_position == std::string::npos) {
-          config_data_base_[key] = std::string(line.substr(
-              line.find('=') + 1, line.size() - line.find('=') - 1));
-        }
-        config_data_base_[key] =
-            std::string(line.substr(line.find('=') + 1, semicolon_position));
-        config_file.close();
-        return true;
-      }
-    }
-    config_file.close();
-    return false;
-  }
-  return false;
+  return LoadConfigFromIni(file_path, std::vector<std::string>{key})
+      .IsSuccess();
 }
 
 MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::LoadConfigFromIni(
     const MM::FileSystem::Path& file_path) {
-  std::fstream config_file{file_path.String()};
-  if (config_file.is_open()) {
-    std::string line;
-    while (std::getline(config_file, line)) {
-      if (line.length() == 0) {
-        continue;
-      }
-      if (line[0] == '[' && line[line.size() - 1] == ']') {
-        continue;
-      }
-      const size_t semicolon_position{
-          line.substr(line.find('=') + 1, line.size() - line.find('=') - 1)
-              .find(';')};
-      if (semicolon_position == std::string::npos) {
-        config_data_base_.emplace(
-            line.substr(0, line.find('=')),
-            line.substr(line.find('=') + 1, line.size() - line.find('=') - 1));
-      } else {
-        config_data_base_.emplace(
-            line.substr(0, line.find('=')),
-            line.substr(line.find('=') + 1, semicolon_position));
-      }
+  Result<FileSystem::MappedFile, ErrorResult> config_file =
+      FileSystem::FileSystem::GetInstance()->MapFile(file_path);
+  if (!config_file.IsSuccess()) {
+    return Result<Nil, ErrorResult>{st_execute_error,
+                                    ErrorCode::FILE_IS_NOT_EXIST};
+  }
+
+  std::lock_guard<std::mutex> guard{config_mutex_};
+  ParseIni(config_file.GetResult().GetStringView(),
+           [](std::string_view key, std::string_view value) {
+             // Settings that are loaded already are kept.
+             config_data_base_.try_emplace(std::string{key}, value);
+           });
+  PublishSnapshot();
+
+  return Result<Nil, ErrorResult>{st_execute_success};
+}
+
+MM::Result<MM::Nil, MM::ErrorResult>
+MM::ConfigSystem::ConfigSystem::LoadConfigFromIni(
+    const MM::FileSystem::Path& file_path,
+    const std::vector<std::string>& keys) {
+  if (!file_path.IsExists()) {
+    return Result<Nil, ErrorResult>{st_execute_error,
+                                    ErrorCode::FILE_IS_NOT_EXIST};
+  }
+  std::unordered_map<std::string, std::string> config_data =
+      MM::ConfigSystem::LoadConfigFromIni(file_path, keys);
+  const bool all_found = std::all_of(
+      keys.begin(), keys.end(), [&config_data](const std::string& key) {
+        return config_data.find(key) != config_data.end();
+      });
+
+  if (!config_data.empty()) {
+    std::lock_guard<std::mutex> guard{config_mutex_};
+    for (auto& config : config_data) {
+      config_data_base_[config.first] = std::move(config.second);
     }
-    config_file.close();
-     return Result<Nil, ErrorResult>{st_execute_success};
+    PublishSnapshot();
+  }
+
+  if (!all_found) {
+    return Result<Nil, ErrorResult>{st_execute_error,
+                                    ErrorCode::NO_SUCH_CONFIG};
+  }
+  return Result<Nil, ErrorResult>{st_execute_success};
+}
+
+MM::Result<MM::Nil, MM::ErrorResult>
+MM::ConfigSystem::ConfigSystem::ReloadConfigFromIni(
+    const MM::FileSystem::Path& file_path) {
+  if (!file_path.IsExists()) {
+    return Result<Nil, ErrorResult>{st_execute_error,
+                                    ErrorCode::FILE_IS_NOT_EXIST};
+  }
+  std::unordered_map<std::string, std::string> config_data =
+      MM::ConfigSystem::LoadConfigFromIni(file_path);
+
+  std::lock_guard<std::mutex> guard{config_mutex_};
+  for (auto& config : config_data) {
+    config_data_base_[config.first] = std::move(config.second);
   }
+  // One snapshot for the whole file.
+  PublishSnapshot();
 
-    return Result<Nil, ErrorResult>{st_execute_error, ErrorCode::FILE_IS_NOT_EXIST};
+  return Result<Nil, ErrorResult>{st_execute_success};
 }
 
-void MM::ConfigSystem::ConfigSystem::Clear() { config_data_base_.clear(); }
+void MM::ConfigSystem::ConfigSystem::Clear() {
+  std::lock_guard<std::mutex> guard{config_mutex_};
+  config_data_base_.clear();
+  PublishSnapshot();
+}
 
 const std::unordered_map<std::string, std::string>&
 MM::ConfigSystem::ConfigSystem::GetAllConfig() const {
@@ -170,14 +305,133 @@ MM::ConfigSystem::ConfigSystem::GetAllConfig() const {
 }
 
 std::size_t MM::ConfigSystem::ConfigSystem::Size() {
+  std::lock_guard<std::mutex> guard{config_mutex_};
   return config_data_base_.size();
 }
 
+MM::ConfigSystem::ConfigKey MM::ConfigSystem::ConfigSystem::GetConfigKey(
+    const std::string& key) const {
+  std::lock_guard<std::mutex> guard{config_mutex_};
+  auto key_index = config_key_indexes_.emplace(
+      key, static_cast<std::uint32_t>(config_key_indexes_.size()));
+  return ConfigKey{key_index.first->second};
+}
+
+void MM::ConfigSystem::ConfigSystem::PublishSnapshot() {
+  const ConfigSnapshot* old_snapshot =
+      snapshot_.load(std::memory_order_relaxed);
+  auto new_snapshot = std::make_unique<ConfigSnapshot>();
+  auto key_indexes =
+      std::make_shared<std::unordered_map<std::string, std::uint32_t>>();
+  key_indexes->reserve(config_data_base_.size());
+  for (const auto& config : config_data_base_) {
+    const std::uint32_t index =
+        config_key_indexes_
+            .emplace(config.first,
+                     static_cast<std::uint32_t>(config_key_indexes_.size()))
+            .first->second;
+    key_indexes->emplace(config.first, index);
+    if (index >= new_snapshot->values_.size()) {
+      new_snapshot->values_.resize(index + 1);
+    }
+
+    // Values that did not change are shared, not parsed again.
+    if (old_snapshot != nullptr && index < old_snapshot->values_.size() &&
+        old_snapshot->values_[index] != nullptr &&
+        old_snapshot->values_[index]->string_value_ == config.second) {
+      new_snapshot->values_[index] = old_snapshot->values_[index];
+    } else {
+      new_snapshot->values_[index] =
+          std::make_shared<const ConfigValue>(ParseConfigValue(config.second));
+    }
+  }
+  new_snapshot->key_indexes_ = std::move(key_indexes);
+
+  ReplaceSnapshot(std::move(new_snapshot));
+}
+
+void MM::ConfigSystem::ConfigSystem::PublishConfig(const std::string& key) {
+  const ConfigSnapshot* old_snapshot =
+      snapshot_.load(std::memory_order_relaxed);
+  // Copies the key index pointer and the value pointers, not the settings.
+  auto new_snapshot = old_snapshot != nullptr
+                          ? std::make_unique<ConfigSnapshot>(*old_snapshot)
+                          : std::make_unique<ConfigSnapshot>();
+  const std::uint32_t index =
+      config_key_indexes_
+          .emplace(key, static_cast<std::uint32_t>(config_key_indexes_.size()))
+          .first->second;
+  // The key index is only copied when a new key is added.
+  if (new_snapshot->key_indexes_ == nullptr ||
+      new_snapshot->key_indexes_->find(key) ==
+          new_snapshot->key_indexes_->end()) {
+    auto key_indexes =
+        new_snapshot->key_indexes_ != nullptr
+            ? std::make_shared<std::unordered_map<std::string, std::uint32_t>>(
+                  *new_snapshot->key_indexes_)
+            : std::make_shared<
+                  std::unordered_map<std::string, std::uint32_t>>();
+    key_indexes->emplace(key, index);
+    new_snapshot->key_indexes_ = std::move(key_indexes);
+  }
+  if (index >= new_snapshot->values_.size()) {
+    new_snapshot->values_.resize(index + 1);
+  }
+  new_snapshot->values_[index] = std::make_shared<const ConfigValue>(
+      ParseConfigValue(config_data_base_.at(key)));
+
+  ReplaceSnapshot(std::move(new_snapshot));
+}
+
+void MM::ConfigSystem::ConfigSystem::ReplaceSnapshot(
+    std::unique_ptr<ConfigSnapshot>&& new_snapshot) {
+  const ConfigSnapshot* old_snapshot =
+      snapshot_.exchange(new_snapshot.release(), std::memory_order_acq_rel);
+  if (old_snapshot != nullptr) {
+    Utils::EpochDomain::GetInstance()->Retire(
+        const_cast<ConfigSnapshot*>(old_snapshot));
+  }
+}
+
+template <typename ValueType>
+MM::Result<MM::Nil, MM::ErrorResult>
+MM::ConfigSystem::ConfigSystem::GetConfigValue(const std::string& key,
+                                               ValueType& get_data) {
+  Utils::EpochGuard guard;
+  const ConfigSnapshot* snapshot = snapshot_.load(std::memory_order_acquire);
+  if (snapshot == nullptr) {
+    return Result<Nil, ErrorResult>{st_execute_error,
+                                    ErrorCode::NO_SUCH_CONFIG};
+  }
+  auto key_index = snapshot->key_indexes_->find(key);
+  if (key_index == snapshot->key_indexes_->end()) {
+    return Result<Nil, ErrorResult>{st_execute_error,
+                                    ErrorCode::NO_SUCH_CONFIG};
+  }
+
+  return ConvertConfigValue(*snapshot->values_[key_index->second], get_data);
+}
+
+template <typename ValueType>
+MM::Result<MM::Nil, MM::ErrorResult>
+MM::ConfigSystem::ConfigSystem::GetConfigValue(ConfigKey key,
+                                               ValueType& get_data) {
+  Utils::EpochGuard guard;
+  const ConfigSnapshot* snapshot = snapshot_.load(std::memory_order_acquire);
+  if (snapshot == nullptr || key.index_ >= snapshot->values_.size() ||
+      snapshot->values_[key.index_] == nullptr) {
+    return Result<Nil, ErrorResult>{st_execute_error,
+                                    ErrorCode::NO_SUCH_CONFIG};
+  }
+
+  return ConvertConfigValue(*snapshot->values_[key.index_], get_data);
+}
+
 MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::Destroy() {
   std::lock_guard<std::mutex> guard{sync_flag_};
   if (config_system_) {
+    Clear();
     delete config_system_;
-    config_data_base_.clear();
     config_system_ = nullptr;
 
       return Result<Nil, ErrorResult>{st_execute_success};
@@ -194,6 +448,7 @@ void MM::ConfigSystem::ConfigSystem::CheckInit() {
 }
 
 bool MM::ConfigSystem::ConfigSystem::CheckAllNeedConfigLoaded() {
+  std::lock_guard<std::mutex> guard{config_mutex_};
   if (config_data_base_.size() < 16) {
     return false;
   }
@@ -257,123 +512,150 @@ bool MM::ConfigSystem::ConfigSystem::CheckAllNeedConfigLoaded() {
 
 void MM::ConfigSystem::ConfigSystem::SetConfig(const std::string& key,
                                                const std::string& data) {
+  std::lock_guard<std::mutex> guard{config_mutex_};
   config_data_base_[key] = data;
+  PublishConfig(key);
 }
 
 void MM::ConfigSystem::ConfigSystem::SetConfig(const std::string& key,
                                                const int& data) {
-  ConfigSystem::config_data_base_[key] = std::to_string(data);
+  std::lock_guard<std::mutex> guard{config_mutex_};
+  config_data_base_[key] = std::to_string(data);
+  PublishConfig(key);
 }
 
 void MM::ConfigSystem::ConfigSystem::SetConfig(const std::string& key,
                                                const long& data) {
+  std::lock_guard<std::mutex> guard{config_mutex_};
   config_data_base_[key] = std::to_string(data);
+  PublishConfig(key);
 }
 
 void MM::ConfigSystem::ConfigSystem::SetConfig(const std::string& key,
                                                const long long& data) {
+  std::lock_guard<std::mutex> guard{config_mutex_};
   config_data_base_[key] = std::to_string(data);
+  PublishConfig(key);
 }
 
 void MM::ConfigSystem::ConfigSystem::SetConfig(const std::string& key,
                                                const float& data) {
+  std::lock_guard<std::mutex> guard{config_mutex_};
   config_data_base_[key] = std::to_string(data);
+  PublishConfig(key);
 }
 
 void MM::ConfigSystem::ConfigSystem::SetConfig(const std::string& key,
                                                const double& data) {
+  std::lock_guard<std::mutex> guard{config_mutex_};
   config_data_base_[key] = std::to_string(data);
+  PublishConfig(key);
 }
 
 void MM::ConfigSystem::ConfigSystem::SetConfig(const std::string& key,
                                                const long double& data) {
+  std::lock_guard<std::mutex> guard{config_mutex_};
   config_data_base_[key] = std::to_string(data);
+  PublishConfig(key);
 }
 
 void MM::ConfigSystem::ConfigSystem::SetConfig(const std::string& key,
                                                const unsigned int& data) {
+  std::lock_guard<std::mutex> guard{config_mutex_};
   config_data_base_[key] = std::to_string(data);
+  PublishConfig(key);
 }
 
 void MM::ConfigSystem::ConfigSystem::SetConfig(const std::string& key,
                                                const unsigned long& data) {
+  std::lock_guard<std::mutex> guard{config_mutex_};
   config_data_base_[key] = std::to_string(data);
+  PublishConfig(key);
 }
 
 void MM::ConfigSystem::ConfigSystem::SetConfig(const std::string& key,
                                                const unsigned long long& data) {
+  std::lock_guard<std::mutex> guard{config_mutex_};
   config_data_base_[key] = std::to_string(data);
+  PublishConfig(key);
 }
 
 MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
     const std::string& key, std::string& get_data) const {
-  if (Have(key)) {
-    get_data = config_data_base_[key];
-      return Result<Nil, ErrorResult>{st_execute_success};
-  }
-    return Result<Nil, ErrorResult>{st_execute_error, ErrorCode::NO_SUCH_CONFIG};
+  return GetConfigValue(key, get_data);
 }
 
 MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
     const std::string& key, std::int32_t& get_data) const {
-  if (Have(key)) {
-    get_data = std::stoi(config_data_base_[key]);
-      return Result<Nil, ErrorResult>{st_execute_success};
-  }
-
-  return Result<Nil, ErrorResult>{st_execute_error, ErrorCode::NO_SUCH_CONFIG};
+  return GetConfigValue(key, get_data);
 }
 
 MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
     const std::string& key, std::uint32_t& get_data) const {
-  if (Have(key)) {
-    get_data = static_cast<unsigned int>(std::stol(config_data_base_[key]));
-      return Result<Nil, ErrorResult>{st_execute_success};
-  }
-  return Result<Nil, ErrorResult>{st_execute_error, ErrorCode::NO_SUCH_CONFIG};
+  return GetConfigValue(key, get_data);
 }
 
 MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
     const std::string& key, float& get_data) const {
-  if (Have((key))) {
-    get_data = std::stof(config_data_base_[key]);
-      return Result<Nil, ErrorResult>{st_execute_success};
-  }
-    return Result<Nil, ErrorResult>{st_execute_error, ErrorCode::NO_SUCH_CONFIG};
+  return GetConfigValue(key, get_data);
 }
 
 MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
     const std::string& key, double& get_data) const {
-  if (Have((key))) {
-    get_data = std::stod(config_data_base_[key]);
-      return Result<Nil, ErrorResult>{st_execute_success};
-  }
-    return Result<Nil, ErrorResult>{st_execute_error, ErrorCode::NO_SUCH_CONFIG};
+  return GetConfigValue(key, get_data);
 }
 
 MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
     const std::string& key, long double& get_data) const {
-  if (Have((key))) {
-    get_data = std::stold(config_data_base_[key]);
-      return Result<Nil, ErrorResult>{st_execute_success};
-  }
-    return Result<Nil, ErrorResult>{st_execute_error, ErrorCode::NO_SUCH_CONFIG};
+  return GetConfigValue(key, get_data);
 }
 
 MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
     const std::string& key, std::int64_t& get_data) const {
-  if (Have((key))) {
-    get_data = std::stoull(config_data_base_[key]);
-      return Result<Nil, ErrorResult>{st_execute_success};
-  }
-    return Result<Nil, ErrorResult>{st_execute_error, ErrorCode::NO_SUCH_CONFIG};
+  return GetConfigValue(key, get_data);
 }
 
 MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
     const std::string& key, std::uint64_t& get_data) const {
-  if (Have((key))) {
-    get_data = std::stoull(config_data_base_[key]);
-      return Result<Nil, ErrorResult>{st_execute_success};
-  }
-    return Result<Nil, ErrorResult>{st_execute_error, ErrorCode::NO_SUCH_CONFIG};
+  return GetConfigValue(key, get_data);
+}
+
+MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
+    ConfigKey key, std::string& get_data) const {
+  return GetConfigValue(key, get_data);
+}
+
+MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
+    ConfigKey key, std::int32_t& get_data) const {
+  return GetConfigValue(key, get_data);
+}
+
+MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
+    ConfigKey key, std::uint32_t& get_data) const {
+  return GetConfigValue(key, get_data);
+}
+
+MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
+    ConfigKey key, float& get_data) const {
+  return GetConfigValue(key, get_data);
+}
+
+MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
+    ConfigKey key, double& get_data) const {
+  return GetConfigValue(key, get_data);
+}
+
+MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
+    ConfigKey key, long double& get_data) const {
+  return GetConfigValue(key, get_data);
+}
+
+MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
+    ConfigKey key, std::int64_t& get_data) const {
+  return GetConfigValue(key, get_data);
+}
+
+MM::Result<MM::Nil, MM::ErrorResult> MM::ConfigSystem::ConfigSystem::GetConfig(
+    ConfigKey key, std::uint64_t& get_data) const {
+  return GetConfigValue(key, get_data);
 }
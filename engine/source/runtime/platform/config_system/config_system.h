@@ -1,9 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "runtime/platform/file_system/file_system.h"
 #include "utils/marco.h"
@@ -16,6 +20,47 @@ std::string LoadOneConfigFromIni(const MM::FileSystem::Path& file_path,
 std::unordered_map<std::string, std::string> LoadConfigFromIni(
     const MM::FileSystem::Path& file_path);
 
+/**
+ * \brief Get several settings from a ini file in one pass.
+ * \param file_path The path of the ini file.
+ * \param keys The names of the settings you want to get.
+ * \return The settings that were found.
+ */
+std::unordered_map<std::string, std::string> LoadConfigFromIni(
+    const MM::FileSystem::Path& file_path,
+    const std::vector<std::string>& keys);
+
+class ConfigSystem;
+
+/**
+ * \brief Stable handle of a setting, see \ref ConfigSystem::GetConfigKey.
+ * \remark A handle stays valid for the lifetime of the process, across
+ * reloads and \ref ConfigSystem::Clear.
+ */
+class ConfigKey {
+  friend class ConfigSystem;
+
+ public:
+  ConfigKey() = default;
+
+ public:
+  bool IsValid() const;
+
+ private:
+  explicit ConfigKey(std::uint32_t index);
+
+ private:
+  std::uint32_t index_{UINT32_MAX};
+};
+
+/**
+ * \brief Global settings.
+ * \remark Readers look values up in an immutable snapshot in which every value
+ * has been parsed once. Writers publish a new snapshot and retire the old one
+ * through Utils::EpochDomain, so reads never lock and can run on any thread.
+ * \remark Resolve the settings that are read often to a \ref ConfigKey once,
+ * reading through a key neither hashes the name nor parses the value.
+ */
 class ConfigSystem {
   friend std::shared_ptr<ConfigSystem>;
 
@@ -68,6 +113,30 @@ class ConfigSystem {
   Result<Nil, ErrorResult> GetConfig(const std::string& key, long double& get_data) const;
   // void SetConfig(std::string key, std::string data);
 
+  /**
+   * \brief Resolve the name of a setting to a handle. The setting does not
+   * need to exist yet.
+   * \param key Name of the setting.
+   * \return The handle of the setting.
+   */
+  ConfigKey GetConfigKey(const std::string& key) const;
+
+  /**
+   * \brief Get the value through a handle returned by \ref GetConfigKey.
+   * \param key The handle of the setting.
+   * \param get_data A reference that returns a specific value.
+   * \return NO_SUCH_CONFIG if the setting does not exist,
+   * TYPE_CONVERSION_FAILED if the value is not of the requested type.
+   */
+  Result<Nil, ErrorResult> GetConfig(ConfigKey key, std::string& get_data) const;
+  Result<Nil, ErrorResult> GetConfig(ConfigKey key, std::int32_t& get_data) const;
+  Result<Nil, ErrorResult> GetConfig(ConfigKey key, std::uint32_t& get_data) const;
+  Result<Nil, ErrorResult> GetConfig(ConfigKey key, std::int64_t& get_data) const;
+  Result<Nil, ErrorResult> GetConfig(ConfigKey key, std::uint64_t& get_data) const;
+  Result<Nil, ErrorResult> GetConfig(ConfigKey key, float& get_data) const;
+  Result<Nil, ErrorResult> GetConfig(ConfigKey key, double& get_data) const;
+  Result<Nil, ErrorResult> GetConfig(ConfigKey key, long double& get_data) const;
+
   /**
    * \brief Judge whether a setting item exists.
    * \param key The name of the setting you want to know if it exists.
@@ -93,6 +162,28 @@ class ConfigSystem {
    */
   Result<Nil, ErrorResult> LoadConfigFromIni(const MM::FileSystem::Path& file_path);
 
+  /**
+   * \brief Get several settings from a ini file in one pass. The values of the
+   * file replace the loaded ones.
+   * \param file_path The path of the ini file.
+   * \param keys The names of the settings you want to get.
+   * \return NO_SUCH_CONFIG if a setting is missing from the file, the ones
+   * that were found are loaded anyway.
+   */
+  Result<Nil, ErrorResult> LoadConfigFromIni(
+      const MM::FileSystem::Path& file_path,
+      const std::vector<std::string>& keys);
+
+  /**
+   * \brief Reload the settings of a ini file. Unlike \ref LoadConfigFromIni,
+   * the values of the file replace the loaded ones.
+   * \param file_path The path of the ini file.
+   * \return Return error code.
+   * \remark Readers see either none or all of the new values.
+   */
+  Result<Nil, ErrorResult> ReloadConfigFromIni(
+      const MM::FileSystem::Path& file_path);
+
   /**
    * \brief Clear all settings.
    */
@@ -101,6 +192,7 @@ class ConfigSystem {
   /**
    * \brief Get constant references of all settings.
    * \return Constant reference of all settings.
+   * \remark Must not be used while other threads modify the settings.
    */
   const std::unordered_map<std::string, std::string>& GetAllConfig() const;
 
@@ -137,9 +229,41 @@ class ConfigSystem {
 
   static bool CheckAllNeedConfigLoaded();
 
+  struct ConfigSnapshot;
+
+  template <typename ValueType>
+  static Result<Nil, ErrorResult> GetConfigValue(const std::string& key,
+                                                 ValueType& get_data);
+
+  template <typename ValueType>
+  static Result<Nil, ErrorResult> GetConfigValue(ConfigKey key,
+                                                 ValueType& get_data);
+
+  /**
+   * \brief Publish the current settings as a new snapshot. Must be called with
+   * config_mutex_ held.
+   * \remark Rebuilds the whole snapshot, call it once per batch of changes.
+   */
+  static void PublishSnapshot();
+
+  /**
+   * \brief Publish a copy of the current snapshot in which only the setting
+   * \ref key is updated. Must be called with config_mutex_ held.
+   * \remark The copy shares the key index and the other values with the
+   * current snapshot.
+   */
+  static void PublishConfig(const std::string& key);
+
+  static void ReplaceSnapshot(std::unique_ptr<ConfigSnapshot>&& new_snapshot);
+
  private:
   static std::mutex sync_flag_;
+  // Guards the fields below, readers only use snapshot_.
+  static std::mutex config_mutex_;
   static std::unordered_map<std::string, std::string> config_data_base_;
+  // Never shrinks, so a ConfigKey always refers to the same name.
+  static std::unordered_map<std::string, std::uint32_t> config_key_indexes_;
+  static std::atomic<const ConfigSnapshot*> snapshot_;
 };
 
 #define MM_CONFIG_SYSTEM MM_config_system
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace MM {
+namespace ConfigSystem {
+/**
+ * \brief Parse ini text in a single pass without copying it.
+ * \param text The content of the ini file.
+ * \param callback Called with the key and the value of every setting, both
+ * are views of \ref text. If it returns bool, returning false stops the
+ * parsing.
+ * \remark A setting is a line "key=value", the value ends at the first ';'.
+ * Keys and values are not trimmed. Sections, empty lines and lines without
+ * '=' are skipped.
+ */
+template <typename Callback>
+void ParseIni(std::string_view text, Callback&& callback) {
+  const char* line_begin = text.data();
+  const char* const text_end = text.data() + text.size();
+  while (line_begin < text_end) {
+    const char* line_end = static_cast<const char*>(
+        std::memchr(line_begin, '\n', text_end - line_begin));
+    if (line_end == nullptr) {
+      line_end = text_end;
+    }
+    std::string_view line{line_begin, static_cast<std::size_t>(line_end - line_begin)};
+    line_begin = line_end + 1;
+
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    if (line.empty() || (line.front() == '[' && line.back() == ']')) {
+      continue;
+    }
+    const std::size_t equal_position = line.find('=');
+    if (equal_position == std::string_view::npos) {
+      continue;
+    }
+
+    std::string_view key = line.substr(0, equal_position);
+    std::string_view value = line.substr(equal_position + 1);
+    value = value.substr(0, value.find(';'));
+    if constexpr (std::is_same_v<std::invoke_result_t<Callback, std::string_view,
+                                                      std::string_view>,
+                                 bool>) {
+      if (!callback(key, value)) {
+        return;
+      }
+    } else {
+      callback(key, value);
+    }
+  }
+}
+}  // namespace ConfigSystem
+}  // namespace MM
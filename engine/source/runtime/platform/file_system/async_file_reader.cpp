@@ -0,0 +1,540 @@
+#include "runtime/platform/file_system/async_file_reader.h"
+
+#include <algorithm>
+
+#ifdef MM_ASYNC_FILE_READER_IO_URING
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace {
+/**
+ * \brief Compute the number of bytes a request reads, with the same range rules
+ * as FileSystem::MapFile.
+ * \return False if the range is outside the file.
+ */
+bool GetReadSize(std::size_t file_size, std::size_t offset,
+                 std::size_t read_size, std::size_t& need_size) {
+  if (offset > file_size ||
+      (read_size != UINT64_MAX && read_size > file_size - offset)) {
+    return false;
+  }
+
+  need_size = read_size == UINT64_MAX ? file_size - offset : read_size;
+  return true;
+}
+
+#ifdef MM_ASYNC_FILE_READER_IO_URING
+// The length of one read operation is 32 bits, longer reads are split.
+constexpr std::size_t kMaxReadOperationSize = std::size_t{1} << 30;
+
+int IoUringEnter(int ring_file_descriptor, unsigned submit_count,
+                 unsigned min_complete_count, unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_file_descriptor,
+                                  submit_count, min_complete_count, flags,
+                                  nullptr, 0));
+}
+#endif
+}  // namespace
+
+MM::FileSystem::AsyncFileReader::AsyncFileReader(
+    AsyncFileReaderBackend preferred_backend, std::uint32_t queue_depth,
+    std::uint32_t thread_count) {
+  queue_depth = std::max<std::uint32_t>(1, queue_depth);
+#ifdef MM_ASYNC_FILE_READER_IO_URING
+  if (preferred_backend == AsyncFileReaderBackend::IO_URING &&
+      InitIoUring(queue_depth)) {
+    backend_ = AsyncFileReaderBackend::IO_URING;
+    completion_thread_ = std::thread{[this]() { ProcessIoUringCompletions(); }};
+    return;
+  }
+#else
+  (void)preferred_backend;
+#endif
+
+  backend_ = AsyncFileReaderBackend::THREAD_POOL;
+  if (thread_count == 0) {
+    thread_count = std::max(1U, std::thread::hardware_concurrency());
+  }
+  thread_count = std::min(thread_count, queue_depth);
+  for (std::uint32_t i = 0; i != thread_count; ++i) {
+    thread_pool_.emplace_back([this]() { ProcessThreadPoolReads(); });
+  }
+}
+
+MM::FileSystem::AsyncFileReader::~AsyncFileReader() {
+#ifdef MM_ASYNC_FILE_READER_IO_URING
+  if (backend_ == AsyncFileReaderBackend::IO_URING) {
+    {
+      std::unique_lock<std::mutex> guard{io_uring_mutex_};
+      io_uring_condition_.wait(guard, [this]() {
+        return in_flight_count_ == 0 && waiting_operations_.empty();
+      });
+      // A no-op without an operation stops the completion thread.
+      QueueReadOperation(nullptr);
+      SubmitQueuedOperations();
+    }
+    completion_thread_.join();
+    ReleaseIoUring();
+    return;
+  }
+#endif
+
+  {
+    std::lock_guard<std::mutex> guard{thread_pool_mutex_};
+    stop_thread_pool_ = true;
+  }
+  thread_pool_condition_.notify_all();
+  for (std::thread& thread : thread_pool_) {
+    thread.join();
+  }
+}
+
+MM::FileSystem::AsyncFileReaderBackend
+MM::FileSystem::AsyncFileReader::GetBackend() const {
+  return backend_;
+}
+
+void MM::FileSystem::AsyncFileReader::ReadFiles(
+    std::vector<FileReadRequest> requests, ReadCallback callback) {
+  if (requests.empty()) {
+    return;
+  }
+
+  auto batch = std::make_shared<ReadBatch>(
+      ReadBatch{std::move(requests), std::move(callback)});
+#ifdef MM_ASYNC_FILE_READER_IO_URING
+  if (backend_ == AsyncFileReaderBackend::IO_URING) {
+    std::vector<std::unique_ptr<ReadOperation>> read_operations;
+    read_operations.reserve(batch->requests_.size());
+    for (std::size_t i = 0; i != batch->requests_.size(); ++i) {
+      auto read_operation = std::make_unique<ReadOperation>();
+      read_operation->batch_ = batch;
+      read_operation->request_index_ = i;
+      read_operation->file_offset_ = batch->requests_[i].offset_;
+      read_operations.emplace_back(std::move(read_operation));
+    }
+
+    std::lock_guard<std::mutex> guard{io_uring_mutex_};
+    for (std::unique_ptr<ReadOperation>& read_operation : read_operations) {
+      waiting_operations_.push_back(read_operation.release());
+    }
+    QueueWaitingOperations();
+    // The whole batch goes to the kernel with one system call.
+    SubmitQueuedOperations();
+    return;
+  }
+#endif
+
+  ReadFilesWithThreadPool(batch);
+}
+
+MM::FileSystem::AsyncFileReader::ReadResult
+MM::FileSystem::AsyncFileReader::ReadFileRange(const FileReadRequest& request) {
+  std::ifstream file(request.path_.CStr(), std::ios::ate | std::ios::binary);
+  if (!file.is_open()) {
+    return ResultE<>{request.path_.IsExists() ? ErrorCode::FILE_OPERATION_ERROR
+                                              : ErrorCode::FILE_IS_NOT_EXIST};
+  }
+
+  std::size_t need_size = 0;
+  if (!GetReadSize(static_cast<std::size_t>(file.tellg()), request.offset_,
+                   request.read_size_, need_size)) {
+    return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+
+  std::vector<char> data(need_size);
+  file.seekg(request.offset_);
+  file.read(data.data(), need_size);
+  if (!file) {
+    return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+
+  return ReadResult{st_execute_success, std::move(data)};
+}
+
+void MM::FileSystem::AsyncFileReader::ReadFilesWithThreadPool(
+    const std::shared_ptr<ReadBatch>& batch) {
+  {
+    std::lock_guard<std::mutex> guard{thread_pool_mutex_};
+    for (std::size_t i = 0; i != batch->requests_.size(); ++i) {
+      thread_pool_reads_.emplace_back(batch, i);
+    }
+  }
+  thread_pool_condition_.notify_all();
+}
+
+void MM::FileSystem::AsyncFileReader::ProcessThreadPoolReads() {
+  while (true) {
+    std::unique_lock<std::mutex> guard{thread_pool_mutex_};
+    thread_pool_condition_.wait(guard, [this]() {
+      return stop_thread_pool_ || !thread_pool_reads_.empty();
+    });
+    if (thread_pool_reads_.empty()) {
+      return;
+    }
+
+    std::pair<std::shared_ptr<ReadBatch>, std::size_t> read =
+        std::move(thread_pool_reads_.front());
+    thread_pool_reads_.pop_front();
+    guard.unlock();
+
+    read.first->callback_(read.second,
+                          ReadFileRange(read.first->requests_[read.second]));
+  }
+}
+
+#ifdef MM_ASYNC_FILE_READER_IO_URING
+bool MM::FileSystem::AsyncFileReader::InitIoUring(std::uint32_t queue_depth) {
+  io_uring_params params{};
+  int ring_file_descriptor =
+      static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+  // Kernels without io_uring, or sandboxes that forbid it, use the thread
+  // pool.
+  if (ring_file_descriptor < 0) {
+    return false;
+  }
+  io_uring_.ring_file_descriptor_ = ring_file_descriptor;
+
+  io_uring_.submission_ring_size_ =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  io_uring_.completion_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    io_uring_.submission_ring_size_ = std::max(
+        io_uring_.submission_ring_size_, io_uring_.completion_ring_size_);
+    io_uring_.completion_ring_size_ = 0;
+  }
+
+  void* submission_ring =
+      mmap(nullptr, io_uring_.submission_ring_size_, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, ring_file_descriptor, IORING_OFF_SQ_RING);
+  if (submission_ring == MAP_FAILED) {
+    ReleaseIoUring();
+    return false;
+  }
+  io_uring_.submission_ring_ = submission_ring;
+
+  void* completion_ring = submission_ring;
+  if (!single_mmap) {
+    completion_ring = mmap(nullptr, io_uring_.completion_ring_size_,
+                           PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ring_file_descriptor, IORING_OFF_CQ_RING);
+    if (completion_ring == MAP_FAILED) {
+      ReleaseIoUring();
+      return false;
+    }
+    io_uring_.completion_ring_ = completion_ring;
+  }
+
+  io_uring_.submission_entries_size_ =
+      params.sq_entries * sizeof(io_uring_sqe);
+  void* submission_entries =
+      mmap(nullptr, io_uring_.submission_entries_size_, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, ring_file_descriptor, IORING_OFF_SQES);
+  if (submission_entries == MAP_FAILED) {
+    ReleaseIoUring();
+    return false;
+  }
+  io_uring_.submission_entries_ = submission_entries;
+
+  auto* submission_bytes = static_cast<char*>(submission_ring);
+  auto* completion_bytes = static_cast<char*>(completion_ring);
+  io_uring_.submission_head_ =
+      reinterpret_cast<unsigned*>(submission_bytes + params.sq_off.head);
+  io_uring_.submission_tail_ =
+      reinterpret_cast<unsigned*>(submission_bytes + params.sq_off.tail);
+  io_uring_.submission_mask_ =
+      *reinterpret_cast<unsigned*>(submission_bytes + params.sq_off.ring_mask);
+  io_uring_.submission_array_ =
+      reinterpret_cast<unsigned*>(submission_bytes + params.sq_off.array);
+  io_uring_.completion_head_ =
+      reinterpret_cast<unsigned*>(completion_bytes + params.cq_off.head);
+  io_uring_.completion_tail_ =
+      reinterpret_cast<unsigned*>(completion_bytes + params.cq_off.tail);
+  io_uring_.completion_mask_ =
+      *reinterpret_cast<unsigned*>(completion_bytes + params.cq_off.ring_mask);
+  io_uring_.completion_entries_ = completion_bytes + params.cq_off.cqes;
+  io_uring_.submission_entry_count_ = params.sq_entries;
+
+  // IORING_OP_OPENAT, IORING_OP_STATX and IORING_OP_READ need Linux 5.6, older
+  // kernels use the thread pool.
+  constexpr unsigned kProbeOperationCount = 256;
+  auto* probe = static_cast<io_uring_probe*>(std::calloc(
+      1, sizeof(io_uring_probe) +
+             kProbeOperationCount * sizeof(io_uring_probe_op)));
+  int probe_result = static_cast<int>(
+      syscall(__NR_io_uring_register, ring_file_descriptor,
+              IORING_REGISTER_PROBE, probe, kProbeOperationCount));
+  auto is_supported = [probe, probe_result](unsigned operation) {
+    return probe_result >= 0 && probe->last_op >= operation &&
+           (probe->ops[operation].flags & IO_URING_OP_SUPPORTED) != 0;
+  };
+  bool operations_supported = is_supported(IORING_OP_OPENAT) &&
+                              is_supported(IORING_OP_STATX) &&
+                              is_supported(IORING_OP_READ);
+  std::free(probe);
+  if (!operations_supported) {
+    ReleaseIoUring();
+    return false;
+  }
+
+  // Every read in flight must have room in the completion ring.
+  max_in_flight_count_ = std::min(queue_depth, params.cq_entries);
+
+  return true;
+}
+
+void MM::FileSystem::AsyncFileReader::ReleaseIoUring() {
+  if (io_uring_.submission_entries_ != nullptr) {
+    munmap(io_uring_.submission_entries_, io_uring_.submission_entries_size_);
+  }
+  if (io_uring_.completion_ring_ != nullptr) {
+    munmap(io_uring_.completion_ring_, io_uring_.completion_ring_size_);
+  }
+  if (io_uring_.submission_ring_ != nullptr) {
+    munmap(io_uring_.submission_ring_, io_uring_.submission_ring_size_);
+  }
+  if (io_uring_.ring_file_descriptor_ != -1) {
+    close(io_uring_.ring_file_descriptor_);
+  }
+  io_uring_ = IoUring{};
+}
+
+void MM::FileSystem::AsyncFileReader::QueueReadOperation(
+    ReadOperation* read_operation) {
+  if (queued_count_ == io_uring_.submission_entry_count_) {
+    SubmitQueuedOperations();
+  }
+
+  // Only this thread writes the tail while io_uring_mutex_ is held.
+  unsigned tail = *io_uring_.submission_tail_;
+  unsigned index = tail & io_uring_.submission_mask_;
+  io_uring_sqe& submission_entry =
+      static_cast<io_uring_sqe*>(io_uring_.submission_entries_)[index];
+  std::memset(&submission_entry, 0, sizeof(io_uring_sqe));
+  if (read_operation == nullptr) {
+    submission_entry.opcode = IORING_OP_NOP;
+  } else if (read_operation->stage_ == ReadOperationStage::OPEN) {
+    const FileReadRequest& request =
+        read_operation->batch_->requests_[read_operation->request_index_];
+    submission_entry.opcode = IORING_OP_OPENAT;
+    submission_entry.fd = AT_FDCWD;
+    submission_entry.addr =
+        reinterpret_cast<std::uint64_t>(request.path_.CStr());
+    submission_entry.open_flags = O_RDONLY | O_CLOEXEC;
+    submission_entry.user_data =
+        reinterpret_cast<std::uint64_t>(read_operation);
+  } else if (read_operation->stage_ == ReadOperationStage::STAT) {
+    // Stat the opened file itself, so the size belongs to the file that is
+    // read even if the path is replaced meanwhile.
+    submission_entry.opcode = IORING_OP_STATX;
+    submission_entry.fd = read_operation->file_descriptor_;
+    submission_entry.addr = reinterpret_cast<std::uint64_t>("");
+    submission_entry.len = STATX_TYPE | STATX_SIZE;
+    submission_entry.off =
+        reinterpret_cast<std::uint64_t>(&read_operation->file_statx_);
+    submission_entry.statx_flags = AT_EMPTY_PATH;
+    submission_entry.user_data =
+        reinterpret_cast<std::uint64_t>(read_operation);
+  } else {
+    std::size_t remaining_size =
+        read_operation->data_.size() - read_operation->read_bytes_;
+    submission_entry.opcode = IORING_OP_READ;
+    submission_entry.fd = read_operation->file_descriptor_;
+    submission_entry.addr = reinterpret_cast<std::uint64_t>(
+        read_operation->data_.data() + read_operation->read_bytes_);
+    submission_entry.len = static_cast<std::uint32_t>(
+        std::min(remaining_size, kMaxReadOperationSize));
+    submission_entry.off =
+        read_operation->file_offset_ + read_operation->read_bytes_;
+    submission_entry.user_data =
+        reinterpret_cast<std::uint64_t>(read_operation);
+  }
+  io_uring_.submission_array_[index] = index;
+  __atomic_store_n(io_uring_.submission_tail_, tail + 1, __ATOMIC_RELEASE);
+  ++queued_count_;
+}
+
+void MM::FileSystem::AsyncFileReader::QueueWaitingOperations() {
+  while (in_flight_count_ < max_in_flight_count_ &&
+         !waiting_operations_.empty()) {
+    ++in_flight_count_;
+    QueueReadOperation(waiting_operations_.front());
+    waiting_operations_.pop_front();
+  }
+}
+
+void MM::FileSystem::AsyncFileReader::SubmitQueuedOperations() {
+  while (queued_count_ != 0) {
+    int submit_count =
+        IoUringEnter(io_uring_.ring_file_descriptor_, queued_count_, 0, 0);
+    if (submit_count < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        std::this_thread::yield();
+        continue;
+      }
+      // The entries stay in the ring and go with the next submission.
+      return;
+    }
+    queued_count_ -= static_cast<std::uint32_t>(submit_count);
+  }
+}
+
+void MM::FileSystem::AsyncFileReader::ProcessIoUringCompletions() {
+  std::vector<std::pair<ReadOperation*, int>> completions;
+  std::vector<ReadOperation*> next_operations;
+  std::vector<std::pair<ReadOperation*, ReadResult>> finished_operations;
+  bool stop = false;
+  while (!stop) {
+    // Only this thread moves the head of the completion ring.
+    unsigned head = *io_uring_.completion_head_;
+    unsigned tail =
+        __atomic_load_n(io_uring_.completion_tail_, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      IoUringEnter(io_uring_.ring_file_descriptor_, 0, 1,
+                   IORING_ENTER_GETEVENTS);
+      continue;
+    }
+
+    for (; head != tail; ++head) {
+      const io_uring_cqe& completion_entry = static_cast<const io_uring_cqe*>(
+          io_uring_.completion_entries_)[head & io_uring_.completion_mask_];
+      completions.emplace_back(
+          reinterpret_cast<ReadOperation*>(completion_entry.user_data),
+          completion_entry.res);
+    }
+    __atomic_store_n(io_uring_.completion_head_, head, __ATOMIC_RELEASE);
+
+    {
+      // The operations were handed over through the kernel, which the memory
+      // model does not see. Taking the lock the submitters held orders their
+      // writes before the reads below.
+      std::lock_guard<std::mutex> guard{io_uring_mutex_};
+    }
+    for (auto [read_operation, result] : completions) {
+      if (read_operation == nullptr) {
+        stop = true;
+        continue;
+      }
+
+      if (result == -EINTR || result == -EAGAIN) {
+        next_operations.push_back(read_operation);
+        continue;
+      }
+      AdvanceReadOperation(read_operation, result, next_operations,
+                           finished_operations);
+    }
+    completions.clear();
+
+    {
+      std::lock_guard<std::mutex> guard{io_uring_mutex_};
+      for (ReadOperation* read_operation : next_operations) {
+        QueueReadOperation(read_operation);
+      }
+      // Finished operations make room for the waiting ones before the
+      // callbacks run.
+      in_flight_count_ -=
+          static_cast<std::uint32_t>(finished_operations.size());
+      QueueWaitingOperations();
+      SubmitQueuedOperations();
+    }
+    next_operations.clear();
+
+    if (finished_operations.empty()) {
+      continue;
+    }
+    io_uring_condition_.notify_all();
+    for (auto& [read_operation, read_result] : finished_operations) {
+      CompleteReadOperation(read_operation, std::move(read_result));
+    }
+    finished_operations.clear();
+  }
+}
+
+void MM::FileSystem::AsyncFileReader::AdvanceReadOperation(
+    ReadOperation* read_operation, int result,
+    std::vector<ReadOperation*>& next_operations,
+    std::vector<std::pair<ReadOperation*, ReadResult>>& finished_operations) {
+  switch (read_operation->stage_) {
+    case ReadOperationStage::OPEN:
+      if (result < 0) {
+        finished_operations.emplace_back(
+            read_operation,
+            ResultE<>{result == -ENOENT ? ErrorCode::FILE_IS_NOT_EXIST
+                                        : ErrorCode::FILE_OPERATION_ERROR});
+        return;
+      }
+      read_operation->file_descriptor_ = result;
+      read_operation->stage_ = ReadOperationStage::STAT;
+      next_operations.push_back(read_operation);
+      return;
+    case ReadOperationStage::STAT: {
+      const FileReadRequest& request =
+          read_operation->batch_->requests_[read_operation->request_index_];
+      const struct statx& file_statx = read_operation->file_statx_;
+      std::size_t need_size = 0;
+      if (result < 0 ||
+          (file_statx.stx_mask & (STATX_TYPE | STATX_SIZE)) !=
+              (STATX_TYPE | STATX_SIZE) ||
+          !S_ISREG(file_statx.stx_mode) ||
+          !GetReadSize(static_cast<std::size_t>(file_statx.stx_size),
+                       request.offset_, request.read_size_, need_size)) {
+        finished_operations.emplace_back(
+            read_operation, ResultE<>{ErrorCode::FILE_OPERATION_ERROR});
+        return;
+      }
+
+      if (need_size == 0) {
+        finished_operations.emplace_back(
+            read_operation,
+            ReadResult{st_execute_success, std::vector<char>{}});
+        return;
+      }
+      read_operation->data_.resize(need_size);
+      read_operation->stage_ = ReadOperationStage::READ;
+      next_operations.push_back(read_operation);
+      return;
+    }
+    case ReadOperationStage::READ:
+      // A read of 0 bytes means that the file was truncated after it was
+      // opened.
+      if (result <= 0) {
+        finished_operations.emplace_back(
+            read_operation, ResultE<>{ErrorCode::FILE_OPERATION_ERROR});
+        return;
+      }
+
+      read_operation->read_bytes_ += static_cast<std::size_t>(result);
+      if (read_operation->read_bytes_ < read_operation->data_.size()) {
+        // Short read, queue the rest.
+        next_operations.push_back(read_operation);
+        return;
+      }
+
+      finished_operations.emplace_back(
+          read_operation,
+          ReadResult{st_execute_success, std::move(read_operation->data_)});
+      return;
+  }
+}
+
+void MM::FileSystem::AsyncFileReader::CompleteReadOperation(
+    ReadOperation* read_operation, ReadResult&& read_result) {
+  std::unique_ptr<ReadOperation> operation_owner{read_operation};
+  if (read_operation->file_descriptor_ != -1) {
+    close(read_operation->file_descriptor_);
+  }
+  read_operation->batch_->callback_(read_operation->request_index_,
+                                    std::move(read_result));
+}
+#endif
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "runtime/platform/file_system/file_system.h"
+
+#if defined(MM_PLATFORM_IS_LINUX) && __has_include(<linux/io_uring.h>)
+#define MM_ASYNC_FILE_READER_IO_URING
+#include <linux/stat.h>
+#endif
+
+namespace MM {
+namespace FileSystem {
+struct FileReadRequest {
+  Path path_{};
+  std::size_t offset_{0};
+  // UINT64_MAX reads the rest of the file.
+  std::size_t read_size_{UINT64_MAX};
+};
+
+enum class AsyncFileReaderBackend { IO_URING, THREAD_POOL };
+
+/**
+ * \brief Reads batches of files asynchronously.
+ * \remark With the IO_URING backend the open, stat and read of every request
+ * go through the ring: a batch is queued into one io_uring submission and a
+ * single thread reaps the completions and queues the next step of each
+ * request. Where io_uring is not available the reader falls back to a pool of
+ * threads that read the files one by one.
+ * \remark \ref ReadFiles never blocks and makes no file system calls. Requests
+ * beyond the queue depth wait in a queue of the reader and are submitted as
+ * earlier ones finish, so it may also be called from a callback.
+ * \remark The callback is called once per request, on an I/O thread.
+ * Callbacks should only hand the data over, everything else delays the reads
+ * behind them.
+ */
+class AsyncFileReader {
+ public:
+  using ReadResult = Result<std::vector<char>, ErrorResult>;
+  using ReadCallback =
+      std::function<void(std::size_t request_index, ReadResult&& read_result)>;
+
+  static constexpr std::uint32_t kDefaultQueueDepth = 256;
+
+ public:
+  /**
+   * \param preferred_backend IO_URING falls back to THREAD_POOL if io_uring
+   * is not supported.
+   * \param queue_depth The maximum number of requests in flight, the others
+   * are queued.
+   * \param thread_count The number of threads of the THREAD_POOL backend, 0
+   * uses the hardware concurrency.
+   */
+  explicit AsyncFileReader(
+      AsyncFileReaderBackend preferred_backend = AsyncFileReaderBackend::IO_URING,
+      std::uint32_t queue_depth = kDefaultQueueDepth,
+      std::uint32_t thread_count = 0);
+  /**
+   * \brief Waits for the requests in flight and the queued ones.
+   */
+  ~AsyncFileReader();
+  AsyncFileReader(const AsyncFileReader& other) = delete;
+  AsyncFileReader(AsyncFileReader&& other) = delete;
+  AsyncFileReader& operator=(const AsyncFileReader& other) = delete;
+  AsyncFileReader& operator=(AsyncFileReader&& other) = delete;
+
+ public:
+  AsyncFileReaderBackend GetBackend() const;
+
+  /**
+   * \brief Read every request of \ref requests, \ref callback receives the
+   * index of the request and its data.
+   * \remark The offset and size of a request follow \ref FileSystem::MapFile.
+   */
+  void ReadFiles(std::vector<FileReadRequest> requests, ReadCallback callback);
+
+ private:
+  struct ReadBatch {
+    std::vector<FileReadRequest> requests_;
+    ReadCallback callback_;
+  };
+
+#ifdef MM_ASYNC_FILE_READER_IO_URING
+  // The step of a request that is in the ring.
+  enum class ReadOperationStage { OPEN, STAT, READ };
+#endif
+
+  struct ReadOperation {
+    std::shared_ptr<ReadBatch> batch_{};
+    std::size_t request_index_{0};
+    int file_descriptor_{-1};
+    std::size_t file_offset_{0};
+    std::size_t read_bytes_{0};
+    std::vector<char> data_{};
+#ifdef MM_ASYNC_FILE_READER_IO_URING
+    ReadOperationStage stage_{ReadOperationStage::OPEN};
+    struct statx file_statx_ {};
+#endif
+  };
+
+ private:
+  static ReadResult ReadFileRange(const FileReadRequest& request);
+
+  void ReadFilesWithThreadPool(const std::shared_ptr<ReadBatch>& batch);
+
+  void ProcessThreadPoolReads();
+
+#ifdef MM_ASYNC_FILE_READER_IO_URING
+  bool InitIoUring(std::uint32_t queue_depth);
+
+  void ReleaseIoUring();
+
+  // Must be called with io_uring_mutex_ held.
+  void QueueReadOperation(ReadOperation* read_operation);
+
+  /**
+   * \brief Queue waiting operations while there is room in the ring. Must be
+   * called with io_uring_mutex_ held.
+   */
+  void QueueWaitingOperations();
+
+  // Must be called with io_uring_mutex_ held.
+  void SubmitQueuedOperations();
+
+  void ProcessIoUringCompletions();
+
+  /**
+   * \brief Handle the completion of the current step of \ref read_operation,
+   * whose result is \ref result. The operation goes either to
+   * \ref next_operations for its next step or to \ref finished_operations.
+   */
+  static void AdvanceReadOperation(
+      ReadOperation* read_operation, int result,
+      std::vector<ReadOperation*>& next_operations,
+      std::vector<std::pair<ReadOperation*, ReadResult>>& finished_operations);
+
+  /**
+   * \brief Close the file, hand the result to the callback and free the
+   * operation. The caller updates the in flight count.
+   */
+  void CompleteReadOperation(ReadOperation* read_operation,
+                             ReadResult&& read_result);
+#endif
+
+ private:
+  AsyncFileReaderBackend backend_{AsyncFileReaderBackend::THREAD_POOL};
+
+  std::mutex thread_pool_mutex_{};
+  std::condition_variable thread_pool_condition_{};
+  std::deque<std::pair<std::shared_ptr<ReadBatch>, std::size_t>>
+      thread_pool_reads_{};
+  std::vector<std::thread> thread_pool_{};
+  bool stop_thread_pool_{false};
+
+#ifdef MM_ASYNC_FILE_READER_IO_URING
+  struct IoUring {
+    int ring_file_descriptor_{-1};
+    void* submission_ring_{nullptr};
+    std::size_t submission_ring_size_{0};
+    void* completion_ring_{nullptr};
+    std::size_t completion_ring_size_{0};
+    void* submission_entries_{nullptr};
+    std::size_t submission_entries_size_{0};
+
+    unsigned* submission_tail_{nullptr};
+    unsigned* submission_head_{nullptr};
+    unsigned submission_mask_{0};
+    unsigned* submission_array_{nullptr};
+    unsigned* completion_head_{nullptr};
+    unsigned* completion_tail_{nullptr};
+    unsigned completion_mask_{0};
+    void* completion_entries_{nullptr};
+    unsigned submission_entry_count_{0};
+  };
+
+  IoUring io_uring_{};
+  // Guards the submission ring, the in flight count and the waiting
+  // operations.
+  std::mutex io_uring_mutex_{};
+  std::condition_variable io_uring_condition_{};
+  std::deque<ReadOperation*> waiting_operations_{};
+  std::uint32_t in_flight_count_{0};
+  std::uint32_t max_in_flight_count_{0};
+  std::uint32_t queued_count_{0};
+  std::thread completion_thread_{};
+#endif
+};
+}  // namespace FileSystem
+}  // namespace MM
@@ -0,0 +1,460 @@
+#include "runtime/platform/file_system/file_metadata_index.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "runtime/core/log/log_system.h"
+
+#ifdef MM_PLATFORM_IS_LINUX
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+MM_IMPORT_LOG_SYSTEM;
+
+namespace {
+/**
+ * \brief Read the metadata of a regular file or directory.
+ * \return False if the entry does not exist or is of another type.
+ */
+bool ReadMetadata(const std::filesystem::directory_entry& entry,
+                  MM::FileSystem::FileMetadata& metadata) {
+  std::error_code error_code;
+  if (entry.is_regular_file(error_code)) {
+    metadata.type_ = MM::FileSystem::FileType::FILE;
+    metadata.size_ = entry.file_size(error_code);
+  } else if (!error_code && entry.is_directory(error_code)) {
+    metadata.type_ = MM::FileSystem::FileType::DIRECTORY;
+    metadata.size_ = 0;
+  } else {
+    return false;
+  }
+  if (error_code) {
+    return false;
+  }
+
+  metadata.last_write_time_ = entry.last_write_time(error_code);
+  return !error_code;
+}
+
+#ifdef MM_PLATFORM_IS_LINUX
+constexpr std::uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MODIFY |
+                                     IN_CLOSE_WRITE | IN_ATTRIB |
+                                     IN_MOVED_FROM | IN_MOVED_TO |
+                                     IN_DELETE_SELF | IN_MOVE_SELF |
+                                     IN_ONLYDIR;
+#endif
+}  // namespace
+
+MM::FileSystem::FileMetadataIndex::FileMetadataIndex() {
+#ifdef MM_PLATFORM_IS_LINUX
+  inotify_file_descriptor_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_file_descriptor_ < 0) {
+    return;
+  }
+  stop_file_descriptor_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (stop_file_descriptor_ < 0) {
+    close(inotify_file_descriptor_);
+    inotify_file_descriptor_ = -1;
+    return;
+  }
+
+  watch_thread_ = std::thread{[this]() { WatchEvents(); }};
+#endif
+}
+
+MM::FileSystem::FileMetadataIndex::~FileMetadataIndex() {
+#ifdef MM_PLATFORM_IS_LINUX
+  if (watch_thread_.joinable()) {
+    const std::uint64_t stop = 1;
+    [[maybe_unused]] ssize_t write_size =
+        write(stop_file_descriptor_, &stop, sizeof(stop));
+    watch_thread_.join();
+  }
+  if (stop_file_descriptor_ >= 0) {
+    close(stop_file_descriptor_);
+  }
+  if (inotify_file_descriptor_ >= 0) {
+    close(inotify_file_descriptor_);
+  }
+#endif
+}
+
+MM::Result<MM::Nil, MM::ErrorResult> MM::FileSystem::FileMetadataIndex::AddRoot(
+    const Path& root_path) {
+#ifdef MM_PLATFORM_IS_LINUX
+  if (inotify_file_descriptor_ < 0) {
+    return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+  if (!root_path.IsExists()) {
+    return ResultE<>{ErrorCode::FILE_IS_NOT_EXIST};
+  }
+  if (!root_path.IsDirectory()) {
+    return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+
+  std::string root{GetKey(root_path)};
+  std::unique_lock<std::shared_mutex> guard{mutex_};
+  for (const std::string& indexed_root : roots_) {
+    if (IsUnder(root, indexed_root)) {
+      return ResultS<Nil>{Nil()};
+    }
+  }
+  // A new root that contains indexed roots replaces them.
+  roots_.erase(std::remove_if(roots_.begin(), roots_.end(),
+                              [&root](const std::string& indexed_root) {
+                                return IsUnder(indexed_root, root);
+                              }),
+               roots_.end());
+  roots_.push_back(root);
+  ScanDirectory(root);
+
+  return ResultS<Nil>{Nil()};
+#else
+  (void)root_path;
+  return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+#endif
+}
+
+bool MM::FileSystem::FileMetadataIndex::IsIndexed(const Path& path) const {
+  std::string_view key = GetKey(path);
+  std::shared_lock<std::shared_mutex> guard{mutex_};
+  for (const std::string& unwatched_dir : unwatched_dirs_) {
+    if (IsUnder(key, unwatched_dir) || IsUnder(unwatched_dir, key)) {
+      return false;
+    }
+  }
+  for (const std::string& root : roots_) {
+    if (IsUnder(key, root)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+MM::Result<MM::FileSystem::FileMetadata, MM::ErrorResult>
+MM::FileSystem::FileMetadataIndex::GetMetadata(const Path& path) const {
+  std::shared_lock<std::shared_mutex> guard{mutex_};
+  auto entry = FindEntry(GetKey(path));
+  if (entry == entries_.end()) {
+    return ResultE<>{ErrorCode::FILE_IS_NOT_EXIST};
+  }
+
+  return Result<FileMetadata, ErrorResult>{st_execute_success, entry->second};
+}
+
+MM::Result<std::vector<MM::FileSystem::Path>, MM::ErrorResult>
+MM::FileSystem::FileMetadataIndex::GetChildren(const Path& dir_path,
+                                               bool include_files,
+                                               bool include_directories) const {
+  std::string_view key = GetKey(dir_path);
+  std::shared_lock<std::shared_mutex> guard{mutex_};
+  auto dir_entry = FindEntry(key);
+  if (dir_entry == entries_.end()) {
+    return ResultE<>{ErrorCode::FILE_IS_NOT_EXIST};
+  }
+  if (dir_entry->second.type_ != FileType::DIRECTORY) {
+    return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+
+  std::vector<Path> children;
+  for (auto entry = GetFirstChild(key);
+       entry != entries_.end() && IsUnder(entry->first, key); ++entry) {
+    if (entry->second.type_ == FileType::FILE ? include_files
+                                              : include_directories) {
+      children.emplace_back(entry->first);
+    }
+  }
+
+  return Result<std::vector<Path>, ErrorResult>{st_execute_success,
+                                                std::move(children)};
+}
+
+MM::Result<std::size_t, MM::ErrorResult>
+MM::FileSystem::FileMetadataIndex::GetDirectorySize(const Path& dir_path) const {
+  std::string_view key = GetKey(dir_path);
+  std::shared_lock<std::shared_mutex> guard{mutex_};
+  auto dir_entry = FindEntry(key);
+  if (dir_entry == entries_.end()) {
+    return ResultE<>{ErrorCode::FILE_IS_NOT_EXIST};
+  }
+  if (dir_entry->second.type_ != FileType::DIRECTORY) {
+    return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+
+  std::size_t directory_size = 0;
+  for (auto entry = GetFirstChild(key);
+       entry != entries_.end() && IsUnder(entry->first, key); ++entry) {
+    directory_size += entry->second.size_;
+  }
+
+  return Result<std::size_t, ErrorResult>{st_execute_success, directory_size};
+}
+
+void MM::FileSystem::FileMetadataIndex::Refresh(const Path& path) {
+  if (!IsIndexed(path)) {
+    return;
+  }
+
+  std::unique_lock<std::shared_mutex> guard{mutex_};
+  RefreshEntry(std::string{GetKey(path)});
+}
+
+void MM::FileSystem::FileMetadataIndex::Synchronize() {
+  std::unique_lock<std::shared_mutex> guard{mutex_};
+  ProcessEvents();
+}
+
+std::size_t MM::FileSystem::FileMetadataIndex::GetEntryCount() const {
+  std::shared_lock<std::shared_mutex> guard{mutex_};
+  return entries_.size();
+}
+
+std::string_view MM::FileSystem::FileMetadataIndex::GetKey(const Path& path) {
+  std::string_view key = path.StringView();
+  while (key.size() > 1 && key.back() == '/') {
+    key.remove_suffix(1);
+  }
+
+  return key;
+}
+
+bool MM::FileSystem::FileMetadataIndex::IsUnder(std::string_view path,
+                                                std::string_view dir_path) {
+  if (path.size() < dir_path.size() ||
+      path.compare(0, dir_path.size(), dir_path) != 0) {
+    return false;
+  }
+
+  return path.size() == dir_path.size() || dir_path.back() == '/' ||
+         path[dir_path.size()] == '/';
+}
+
+MM::FileSystem::FileMetadataIndex::EntryMap::const_iterator
+MM::FileSystem::FileMetadataIndex::FindEntry(std::string_view path) const {
+  auto entry = entry_lookup_.find(path);
+  if (entry == entry_lookup_.end()) {
+    return entries_.end();
+  }
+
+  return entry->second;
+}
+
+MM::FileSystem::FileMetadataIndex::EntryMap::const_iterator
+MM::FileSystem::FileMetadataIndex::GetFirstChild(
+    std::string_view dir_path) const {
+  // "dir-a" sorts between "dir" and "dir/a", so the children start at "dir/".
+  if (!dir_path.empty() && dir_path.back() == '/') {
+    return entries_.lower_bound(dir_path);
+  }
+  std::string child_prefix{dir_path};
+  child_prefix.push_back('/');
+  return entries_.lower_bound(child_prefix);
+}
+
+void MM::FileSystem::FileMetadataIndex::InsertEntry(
+    const std::string& path, const FileMetadata& metadata) {
+  auto [entry, inserted] = entries_.insert_or_assign(path, metadata);
+  if (inserted) {
+    entry_lookup_.emplace(entry->first, entry);
+  }
+}
+
+void MM::FileSystem::FileMetadataIndex::EraseEntries(std::string_view path) {
+  auto entry = entry_lookup_.find(path);
+  if (entry != entry_lookup_.end()) {
+    entries_.erase(entry->second);
+    entry_lookup_.erase(entry);
+  }
+  for (auto child = GetFirstChild(path);
+       child != entries_.end() && IsUnder(child->first, path);) {
+    entry_lookup_.erase(child->first);
+    child = entries_.erase(child);
+  }
+  unwatched_dirs_.erase(
+      std::remove_if(unwatched_dirs_.begin(), unwatched_dirs_.end(),
+                     [path](const std::string& unwatched_dir) {
+                       return IsUnder(unwatched_dir, path);
+                     }),
+      unwatched_dirs_.end());
+
+#ifdef MM_PLATFORM_IS_LINUX
+  for (auto watch = watch_paths_.begin(); watch != watch_paths_.end();) {
+    if (IsUnder(watch->second, path)) {
+      inotify_rm_watch(inotify_file_descriptor_, watch->first);
+      watch = watch_paths_.erase(watch);
+      continue;
+    }
+    ++watch;
+  }
+#endif
+}
+
+void MM::FileSystem::FileMetadataIndex::ScanDirectory(
+    const std::string& dir_path) {
+#ifdef MM_PLATFORM_IS_LINUX
+  EraseEntries(dir_path);
+
+  FileMetadata metadata;
+  std::error_code error_code;
+  if (!ReadMetadata(std::filesystem::directory_entry{dir_path, error_code},
+                    metadata) ||
+      metadata.type_ != FileType::DIRECTORY) {
+    return;
+  }
+  // Watch before reading, so that nothing created during the scan is missed.
+  if (!WatchDirectory(dir_path)) {
+    return;
+  }
+  InsertEntry(dir_path, metadata);
+
+  auto directory_or_files = std::filesystem::recursive_directory_iterator(
+      dir_path, std::filesystem::directory_options::skip_permission_denied,
+      error_code);
+  if (error_code) {
+    return;
+  }
+  for (auto directory_or_file = std::filesystem::begin(directory_or_files);
+       directory_or_file != std::filesystem::end(directory_or_files);
+       directory_or_file.increment(error_code)) {
+    if (error_code) {
+      break;
+    }
+    if (!ReadMetadata(*directory_or_file, metadata)) {
+      continue;
+    }
+
+    std::string path = directory_or_file->path().string();
+    // The iterator does not enter directory symlinks, neither does the index.
+    if (metadata.type_ == FileType::DIRECTORY &&
+        !directory_or_file->is_symlink(error_code) && !WatchDirectory(path)) {
+      directory_or_file.disable_recursion_pending();
+      continue;
+    }
+    InsertEntry(path, metadata);
+  }
+#else
+  (void)dir_path;
+#endif
+}
+
+bool MM::FileSystem::FileMetadataIndex::WatchDirectory(
+    const std::string& dir_path) {
+#ifdef MM_PLATFORM_IS_LINUX
+  int watch_descriptor = inotify_add_watch(inotify_file_descriptor_,
+                                           dir_path.c_str(), kWatchMask);
+  if (watch_descriptor >= 0) {
+    watch_paths_[watch_descriptor] = dir_path;
+    return true;
+  }
+
+  // Most likely ENOSPC, the user's inotify watch limit is reached.
+  const int error_number = errno;
+  MM_LOG_WARN("Failed to watch {}, it is not indexed.(detail:{})", dir_path,
+              std::strerror(error_number));
+  unwatched_dirs_.push_back(dir_path);
+  return false;
+#else
+  (void)dir_path;
+  return false;
+#endif
+}
+
+void MM::FileSystem::FileMetadataIndex::RefreshEntry(const std::string& path) {
+  FileMetadata metadata;
+  std::error_code error_code;
+  if (!ReadMetadata(std::filesystem::directory_entry{path, error_code},
+                    metadata)) {
+    EraseEntries(path);
+    return;
+  }
+
+  if (metadata.type_ == FileType::DIRECTORY) {
+    ScanDirectory(path);
+    return;
+  }
+  InsertEntry(path, metadata);
+}
+
+void MM::FileSystem::FileMetadataIndex::ProcessEvents() {
+#ifdef MM_PLATFORM_IS_LINUX
+  if (inotify_file_descriptor_ < 0) {
+    return;
+  }
+
+  alignas(inotify_event) char buffer[64 * 1024];
+  while (true) {
+    ssize_t read_size =
+        read(inotify_file_descriptor_, buffer, sizeof(buffer));
+    if (read_size <= 0) {
+      if (read_size < 0 && errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+
+    for (ssize_t offset = 0; offset < read_size;) {
+      const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        // Events were dropped, nothing can be trusted any more.
+        std::vector<std::string> roots = roots_;
+        for (const std::string& root : roots) {
+          ScanDirectory(root);
+        }
+        continue;
+      }
+
+      auto watch = watch_paths_.find(event->wd);
+      if (watch == watch_paths_.end()) {
+        continue;
+      }
+      if (event->mask & IN_IGNORED) {
+        watch_paths_.erase(watch);
+        continue;
+      }
+      std::string path = watch->second;
+      if (event->len != 0) {
+        path.push_back('/');
+        path.append(event->name);
+      }
+
+      if (event->mask & (IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF |
+                         IN_MOVE_SELF)) {
+        EraseEntries(path);
+        continue;
+      }
+      RefreshEntry(path);
+    }
+  }
+#endif
+}
+
+void MM::FileSystem::FileMetadataIndex::WatchEvents() {
+#ifdef MM_PLATFORM_IS_LINUX
+  pollfd poll_file_descriptors[2]{{inotify_file_descriptor_, POLLIN, 0},
+                                  {stop_file_descriptor_, POLLIN, 0}};
+  while (true) {
+    int result = poll(poll_file_descriptors, 2, -1);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    if (poll_file_descriptors[1].revents != 0) {
+      return;
+    }
+
+    std::unique_lock<std::shared_mutex> guard{mutex_};
+    ProcessEvents();
+  }
+#endif
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "runtime/platform/file_system/file_system.h"
+
+namespace MM {
+namespace FileSystem {
+enum class FileType { FILE, DIRECTORY };
+
+struct FileMetadata {
+  FileType type_{FileType::FILE};
+  // 0 for directories.
+  std::size_t size_{0};
+  LastWriteTime last_write_time_{};
+};
+
+/**
+ * \brief In-memory index of the type, size and last write time of every file
+ * and directory under a set of root directories.
+ * \remark A root is walked once when it is added. After that the index is
+ * kept up to date by inotify, a watcher thread applies the changes as they
+ * are reported, so queries never touch the file system.
+ * \remark Changes made by other processes become visible once the watcher has
+ * processed them. Call \ref Synchronize to apply the pending changes at once,
+ * and \ref Refresh after writing a path that must be visible immediately.
+ * \remark A directory that cannot be watched, for example because the
+ * inotify watch limit is reached, is logged and left out of the index together
+ * with everything under it. Queries that involve it go to the file system.
+ * \remark inotify is only available on Linux. On other platforms no root is
+ * indexed and \ref IsIndexed always returns false.
+ */
+class FileMetadataIndex {
+ public:
+  FileMetadataIndex();
+  ~FileMetadataIndex();
+  FileMetadataIndex(const FileMetadataIndex& other) = delete;
+  FileMetadataIndex(FileMetadataIndex&& other) = delete;
+  FileMetadataIndex& operator=(const FileMetadataIndex& other) = delete;
+  FileMetadataIndex& operator=(FileMetadataIndex&& other) = delete;
+
+ public:
+  /**
+   * \brief Index \ref root_path and everything under it.
+   * \param root_path An existing directory.
+   * \return Return error code.
+   */
+  Result<Nil, ErrorResult> AddRoot(const Path& root_path);
+
+  /**
+   * \brief Check whether \ref path is under an indexed root and neither it
+   * nor anything under it has been left out of the index. Queries for paths
+   * that are not indexed must go to the file system.
+   */
+  bool IsIndexed(const Path& path) const;
+
+  /**
+   * \brief Get the metadata of an indexed path.
+   * \return The metadata, or FILE_IS_NOT_EXIST.
+   */
+  Result<FileMetadata, ErrorResult> GetMetadata(const Path& path) const;
+
+  /**
+   * \brief Get every indexed path under \ref dir_path recursively, in
+   * lexicographical order, the same set \ref FileSystem::GetAll returns.
+   * \param include_files Include the regular files.
+   * \param include_directories Include the directories.
+   * \return The paths or error.
+   */
+  Result<std::vector<Path>, ErrorResult> GetChildren(
+      const Path& dir_path, bool include_files,
+      bool include_directories) const;
+
+  /**
+   * \brief Get the total size of the files under \ref dir_path.
+   * \return The size or error.
+   */
+  Result<std::size_t, ErrorResult> GetDirectorySize(const Path& dir_path) const;
+
+  /**
+   * \brief Re-read \ref path, and everything under it if it is a directory.
+   * Paths that are not indexed are ignored.
+   */
+  void Refresh(const Path& path);
+
+  /**
+   * \brief Apply the changes that inotify has reported but the watcher has not
+   * processed yet.
+   */
+  void Synchronize();
+
+  std::size_t GetEntryCount() const;
+
+ private:
+  using EntryMap = std::map<std::string, FileMetadata, std::less<>>;
+
+ private:
+  static std::string_view GetKey(const Path& path);
+
+  static bool IsUnder(std::string_view path, std::string_view dir_path);
+
+  // The functions below must be called with mutex_ held, exclusively for the
+  // ones that modify the index.
+
+  EntryMap::const_iterator FindEntry(std::string_view path) const;
+
+  /**
+   * \brief The first entry under \ref dir_path, the children of a directory
+   * are consecutive.
+   */
+  EntryMap::const_iterator GetFirstChild(std::string_view dir_path) const;
+
+  void InsertEntry(const std::string& path, const FileMetadata& metadata);
+
+  /**
+   * \brief Remove \ref path and everything under it.
+   */
+  void EraseEntries(std::string_view path);
+
+  /**
+   * \brief Watch and index \ref dir_path and everything under it. A directory
+   * that cannot be watched is recorded in unwatched_dirs_ instead.
+   */
+  void ScanDirectory(const std::string& dir_path);
+
+  /**
+   * \brief Add an inotify watch on \ref dir_path.
+   * \return False if the watch failed and the directory is recorded as
+   * unwatched.
+   */
+  bool WatchDirectory(const std::string& dir_path);
+
+  void RefreshEntry(const std::string& path);
+
+  void ProcessEvents();
+
+  void WatchEvents();
+
+ private:
+  mutable std::shared_mutex mutex_{};
+  std::vector<std::string> roots_{};
+  EntryMap entries_{};
+  // Point lookups go through the hash of the path, the ordered map serves the
+  // directory queries. The keys view the strings of entries_.
+  std::unordered_map<std::string_view, EntryMap::iterator> entry_lookup_{};
+
+  int inotify_file_descriptor_{-1};
+  int stop_file_descriptor_{-1};
+  std::unordered_map<int, std::string> watch_paths_{};
+  // Directories whose watch failed. Their subtrees are not indexed, they are
+  // scanned again when their parent reports a change to them.
+  std::vector<std::string> unwatched_dirs_{};
+  std::thread watch_thread_{};
+};
+}  // namespace FileSystem
+}  // namespace MM
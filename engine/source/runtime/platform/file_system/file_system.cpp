@@ -1,5 +1,17 @@
 #include <runtime/platform/file_system/file_system.h>
 
+#include "runtime/platform/file_system/async_file_reader.h"
+#include "runtime/platform/file_system/file_metadata_index.h"
+
+#ifndef MM_PLATFORM_IS_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
 std::mutex MM::FileSystem::FileSystem::sync_flag_{};
 MM::FileSystem::FileSystem* MM::FileSystem::FileSystem::file_system_{nullptr};
 
@@ -303,6 +315,15 @@ bool MM::FileSystem::FileSystem::IsDirectory(const Path& path) const {
 
 MM::Result<std::size_t, MM::ErrorResult>
 MM::FileSystem::FileSystem::DirectorySize(const Path& dir_path) const {
+  const FileMetadataIndex& file_metadata_index = GetFileMetadataIndex();
+  if (file_metadata_index.IsIndexed(dir_path)) {
+    Result<std::size_t, ErrorResult> directory_size =
+        file_metadata_index.GetDirectorySize(dir_path);
+    if (directory_size.IsSuccess()) {
+      return directory_size;
+    }
+  }
+
   Result<std::vector<Path>, ErrorResult> get_files_result =
       GetFiles(dir_path).Exception();
   if (!get_files_result.IsSuccess()) {
@@ -333,6 +354,7 @@ MM::Result<MM::Nil, MM::ErrorResult>
 MM::FileSystem::FileSystem::CreateDirectory(const Path& dir_path) const {
   std::error_code error_code;
   if (std::filesystem::create_directory(dir_path.path_, error_code)) {
+    GetFileMetadataIndex().Refresh(dir_path);
     return Result<Nil, ErrorResult>{st_execute_success};
   }
 
@@ -349,6 +371,7 @@ MM::Result<MM::Nil, MM::ErrorResult>
 MM::FileSystem::FileSystem::DeleteDirectory(const Path& dir_path) const {
   std::error_code error_code;
   if (std::filesystem::remove_all(dir_path.path_, error_code)) {
+    GetFileMetadataIndex().Refresh(dir_path);
     return Result<Nil, ErrorResult>{st_execute_success};
   }
 
@@ -376,6 +399,7 @@ MM::Result<MM::Nil, MM::ErrorResult> MM::FileSystem::FileSystem::CopyDirectory(
                                     ErrorCode::FILE_OPERATION_ERROR};
   }
 
+  GetFileMetadataIndex().Refresh(dest_dir);
   return Result<Nil, ErrorResult>{st_execute_success};
 }
 
@@ -399,6 +423,8 @@ MM::FileSystem::FileSystem::RenameDirectory(const Path& dir_path,
                                     ErrorCode::FILE_OPERATION_ERROR};
   }
 
+  GetFileMetadataIndex().Refresh(dir_path);
+  GetFileMetadataIndex().Refresh(Path{new_name});
   return Result<Nil, ErrorResult>{st_execute_success};
 }
 
@@ -408,6 +434,15 @@ bool MM::FileSystem::FileSystem::DirectoryIsEmpty(const Path& dir_path) const {
 
 MM::Result<std::vector<MM::FileSystem::Path>, MM::ErrorResult>
 MM::FileSystem::FileSystem::GetDirectories(const Path& dir_path) const {
+  const FileMetadataIndex& file_metadata_index = GetFileMetadataIndex();
+  if (file_metadata_index.IsIndexed(dir_path)) {
+    Result<std::vector<Path>, ErrorResult> children =
+        file_metadata_index.GetChildren(dir_path, false, true);
+    if (children.IsSuccess()) {
+      return children;
+    }
+  }
+
   std::error_code error_code;
 
   auto directory_or_files =
@@ -437,6 +472,21 @@ MM::FileSystem::FileSystem::GetDirectories(const Path& dir_path) const {
 
 MM::Result<std::size_t, MM::ErrorResult> MM::FileSystem::FileSystem::FileSize(
     const Path& file_path) const {
+  const FileMetadataIndex& file_metadata_index = GetFileMetadataIndex();
+  if (file_metadata_index.IsIndexed(file_path)) {
+    Result<FileMetadata, ErrorResult> metadata =
+        file_metadata_index.GetMetadata(file_path);
+    if (metadata.IsSuccess()) {
+      if (metadata.GetResult().type_ != FileType::FILE) {
+        return Result<std::size_t, ErrorResult>{
+            st_execute_error, ErrorCode::FILE_OPERATION_ERROR};
+      }
+
+      return Result<std::size_t, ErrorResult>{st_execute_success,
+                                              metadata.GetResult().size_};
+    }
+  }
+
   std::error_code error_code;
   std::size_t file_size =
       std::filesystem::file_size(file_path.path_, error_code);
@@ -465,6 +515,7 @@ MM::Result<MM::Nil, MM::ErrorResult> MM::FileSystem::FileSystem::CreateFile(
   create_file.open(file_path.String(), std::ios_base::app);
   if (create_file.is_open()) {
     create_file.close();
+    GetFileMetadataIndex().Refresh(file_path);
     return Result<Nil, ErrorResult>{st_execute_success};
   }
   return Result<Nil, ErrorResult>{st_execute_error,
@@ -475,6 +526,7 @@ MM::Result<MM::Nil, MM::ErrorResult> MM::FileSystem::FileSystem::DeleteFile(
     const Path& file_path) const {
   std::error_code error_code;
   if (std::filesystem::remove(file_path.path_, error_code)) {
+    GetFileMetadataIndex().Refresh(file_path);
     return Result<Nil, ErrorResult>{st_execute_success};
   }
 
@@ -486,6 +538,7 @@ MM::Result<MM::Nil, MM::ErrorResult> MM::FileSystem::FileSystem::CopyFile(
     const Path& file_path, const Path& dest_dir) const {
   std::error_code error_code;
   if (std::filesystem::copy_file(file_path.path_, dest_dir.path_, error_code)) {
+    GetFileMetadataIndex().Refresh(dest_dir);
     return Result<Nil, ErrorResult>{st_execute_success};
   }
 
@@ -517,6 +570,8 @@ MM::Result<MM::Nil, MM::ErrorResult> MM::FileSystem::FileSystem::RenameFile(
                                     ErrorCode::FILE_OPERATION_ERROR};
   }
 
+  GetFileMetadataIndex().Refresh(file_path);
+  GetFileMetadataIndex().Refresh(Path{new_name});
   return Result<Nil, ErrorResult>{st_execute_success};
 }
 
@@ -526,6 +581,15 @@ bool MM::FileSystem::FileSystem::FileIsEmpty(const Path& file_path) const {
 
 MM::Result<std::vector<MM::FileSystem::Path>, MM::ErrorResult>
 MM::FileSystem::FileSystem::GetFiles(const Path& dir_path) const {
+  const FileMetadataIndex& file_metadata_index = GetFileMetadataIndex();
+  if (file_metadata_index.IsIndexed(dir_path)) {
+    Result<std::vector<Path>, ErrorResult> children =
+        file_metadata_index.GetChildren(dir_path, true, false);
+    if (children.IsSuccess()) {
+      return children;
+    }
+  }
+
   std::error_code error_code;
 
   auto directory_or_files =
@@ -610,6 +674,15 @@ MM::Result<std::size_t, MM::ErrorResult> MM::FileSystem::FileSystem::Size(
 
 MM::Result<std::vector<MM::FileSystem::Path>, MM::ErrorResult>
 MM::FileSystem::FileSystem::GetAll(const Path& path) const {
+  const FileMetadataIndex& file_metadata_index = GetFileMetadataIndex();
+  if (file_metadata_index.IsIndexed(path)) {
+    Result<std::vector<Path>, ErrorResult> children =
+        file_metadata_index.GetChildren(path, true, true);
+    if (children.IsSuccess()) {
+      return children;
+    }
+  }
+
   std::error_code error_code;
 
   auto directory_or_files =
@@ -670,6 +743,135 @@ MM::FileSystem::FileSystem::ReadFile(const MM::FileSystem::Path& path, std::size
                                                 std::move(output_data)};
 }
 
+MM::Result<MM::FileSystem::MappedFile, MM::ErrorResult>
+MM::FileSystem::FileSystem::MapFile(const MM::FileSystem::Path& path,
+                                    FileAccessPattern access_pattern,
+                                    std::size_t offset,
+                                    std::size_t map_size) const {
+  MappedFile mapped_file{};
+#ifdef MM_PLATFORM_IS_WINDOWS
+  (void)access_pattern;
+  std::ifstream file(path.CStr(), std::ios::ate | std::ios::binary);
+  if (!file.is_open()) {
+    return ResultE<>{path.IsExists() ? ErrorCode::FILE_OPERATION_ERROR
+                                     : ErrorCode::FILE_IS_NOT_EXIST};
+  }
+
+  std::size_t file_size = static_cast<std::size_t>(file.tellg());
+  if (offset > file_size ||
+      (map_size != UINT64_MAX && map_size > file_size - offset)) {
+    return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+  std::size_t need_size =
+      map_size == UINT64_MAX ? file_size - offset : map_size;
+
+  mapped_file.buffer_.resize(need_size);
+  file.seekg(offset);
+  file.read(mapped_file.buffer_.data(), need_size);
+  if (!file) {
+    return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+  static const char empty_data[1]{};
+  mapped_file.data_ = need_size == 0 ? empty_data : mapped_file.buffer_.data();
+  mapped_file.size_ = need_size;
+#else
+  int file_descriptor = open(path.CStr(), O_RDONLY | O_CLOEXEC);
+  if (file_descriptor == -1) {
+    return ResultE<>{errno == ENOENT ? ErrorCode::FILE_IS_NOT_EXIST
+                                     : ErrorCode::FILE_OPERATION_ERROR};
+  }
+
+  struct stat file_stat {};
+  if (fstat(file_descriptor, &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+    close(file_descriptor);
+    return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+
+  std::size_t file_size = static_cast<std::size_t>(file_stat.st_size);
+  if (offset > file_size ||
+      (map_size != UINT64_MAX && map_size > file_size - offset)) {
+    close(file_descriptor);
+    return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+  std::size_t need_size =
+      map_size == UINT64_MAX ? file_size - offset : map_size;
+
+  if (need_size == 0) {
+    // mmap rejects empty mappings, an empty file is an empty view.
+    close(file_descriptor);
+    static const char empty_data[1]{};
+    mapped_file.data_ = empty_data;
+    return Result<MappedFile, ErrorResult>{st_execute_success,
+                                           std::move(mapped_file)};
+  }
+
+  // The offset of a mapping must be a multiple of the page size.
+  const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  const std::size_t mapping_offset = offset / page_size * page_size;
+  const std::size_t mapping_size = need_size + (offset - mapping_offset);
+  void* mapping_address =
+      mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, file_descriptor,
+           static_cast<off_t>(mapping_offset));
+  // The mapping keeps the file alive.
+  close(file_descriptor);
+  if (mapping_address == MAP_FAILED) {
+    return ResultE<>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+
+  int advice = MADV_NORMAL;
+  switch (access_pattern) {
+    case FileAccessPattern::NORMAL:
+      advice = MADV_NORMAL;
+      break;
+    case FileAccessPattern::SEQUENTIAL:
+      advice = MADV_SEQUENTIAL;
+      break;
+    case FileAccessPattern::RANDOM:
+      advice = MADV_RANDOM;
+      break;
+    case FileAccessPattern::WILL_NEED:
+      advice = MADV_WILLNEED;
+      break;
+  }
+  // Only a hint, the mapping works without it.
+  madvise(mapping_address, mapping_size, advice);
+
+  mapped_file.mapping_address_ = mapping_address;
+  mapped_file.mapping_size_ = mapping_size;
+  mapped_file.data_ =
+      static_cast<const char*>(mapping_address) + (offset - mapping_offset);
+  mapped_file.size_ = need_size;
+#endif
+
+  return Result<MappedFile, ErrorResult>{st_execute_success,
+                                         std::move(mapped_file)};
+}
+
+void MM::FileSystem::FileSystem::ReadFilesAsync(
+    std::vector<FileReadRequest> requests,
+    std::function<void(std::size_t, Result<std::vector<char>, ErrorResult>&&)>
+        callback) const {
+  GetAsyncFileReader().ReadFiles(std::move(requests), std::move(callback));
+}
+
+MM::FileSystem::AsyncFileReader&
+MM::FileSystem::FileSystem::GetAsyncFileReader() const {
+  static AsyncFileReader async_file_reader{};
+
+  return async_file_reader;
+}
+
+MM::FileSystem::FileMetadataIndex&
+MM::FileSystem::FileSystem::GetFileMetadataIndex() const {
+  static FileMetadataIndex file_metadata_index{};
+  // The asset directory is walked once, later changes come from inotify.
+  static const bool asset_dir_is_indexed =
+      file_metadata_index.AddRoot(GetAssetDir()).IsSuccess();
+  (void)asset_dir_is_indexed;
+
+  return file_metadata_index;
+}
+
 bool MM::FileSystem::FileSystem::Destroy() {
   std::lock_guard<std::mutex> guard{sync_flag_};
   if (file_system_) {
@@ -767,6 +969,18 @@ MM::FileSystem::FileSystem::~FileSystem() { file_system_ = nullptr; }
 MM::Result<MM::FileSystem::LastWriteTime, MM::ErrorResult>
 MM::FileSystem::FileSystem::GetLastWriteTime(
     const MM::FileSystem::Path& path) const {
+  // Asset IDs and cache paths are derived from the last write time, the
+  // index saves a stat per asset.
+  const FileMetadataIndex& file_metadata_index = GetFileMetadataIndex();
+  if (file_metadata_index.IsIndexed(path)) {
+    Result<FileMetadata, ErrorResult> metadata =
+        file_metadata_index.GetMetadata(path);
+    if (metadata.IsSuccess()) {
+      return Result<LastWriteTime, ErrorResult>{
+          st_execute_success, metadata.GetResult().last_write_time_};
+    }
+  }
+
   std::error_code error_code;
   LastWriteTime last_write_time =
       std::filesystem::last_write_time(path.path_, error_code);
@@ -810,3 +1024,65 @@ const MM::FileSystem::Path& MM::FileSystem::FileSystem::GetAssetDirCache()
 
   return asset_cache_path;
 }
+
+MM::FileSystem::MappedFile::~MappedFile() { Release(); }
+
+MM::FileSystem::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mapping_address_(other.mapping_address_),
+      mapping_size_(other.mapping_size_),
+      data_(other.data_),
+      size_(other.size_),
+      buffer_(std::move(other.buffer_)) {
+  other.mapping_address_ = nullptr;
+  other.mapping_size_ = 0;
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+MM::FileSystem::MappedFile& MM::FileSystem::MappedFile::operator=(
+    MappedFile&& other) noexcept {
+  if (&other == this) {
+    return *this;
+  }
+
+  Release();
+  mapping_address_ = other.mapping_address_;
+  mapping_size_ = other.mapping_size_;
+  data_ = other.data_;
+  size_ = other.size_;
+  buffer_ = std::move(other.buffer_);
+
+  other.mapping_address_ = nullptr;
+  other.mapping_size_ = 0;
+  other.data_ = nullptr;
+  other.size_ = 0;
+
+  return *this;
+}
+
+const char* MM::FileSystem::MappedFile::GetData() const { return data_; }
+
+std::size_t MM::FileSystem::MappedFile::GetSize() const { return size_; }
+
+std::string_view MM::FileSystem::MappedFile::GetStringView() const {
+  if (data_ == nullptr) {
+    return std::string_view{};
+  }
+
+  return std::string_view{data_, size_};
+}
+
+bool MM::FileSystem::MappedFile::IsValid() const { return data_ != nullptr; }
+
+void MM::FileSystem::MappedFile::Release() {
+#ifndef MM_PLATFORM_IS_WINDOWS
+  if (mapping_address_ != nullptr) {
+    munmap(mapping_address_, mapping_size_);
+  }
+#endif
+  mapping_address_ = nullptr;
+  mapping_size_ = 0;
+  data_ = nullptr;
+  size_ = 0;
+  buffer_ = std::vector<char>{};
+}
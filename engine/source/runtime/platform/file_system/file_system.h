@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <list>
 #include <locale>
@@ -21,6 +22,9 @@ using LastWriteTime = std::filesystem::file_time_type;
 
 class FileSystem;
 class Path;
+class AsyncFileReader;
+class FileMetadataIndex;
+struct FileReadRequest;
 
 std::string __GetCurrentPath__();
 
@@ -155,6 +159,53 @@ class Path {
   std::filesystem::path path_;
 };
 
+/**
+ * \brief How a mapped file will be read, passed to the system as a paging
+ * hint.
+ */
+enum class FileAccessPattern { NORMAL, SEQUENTIAL, RANDOM, WILL_NEED };
+
+/**
+ * \brief Read-only view of a file mapped into memory. The file is unmapped
+ * when the view is destroyed.
+ * \remark The data is read from the page cache in place, nothing is copied.
+ * Platforms without mmap read the file into a buffer owned by the view.
+ * \remark The file must not be truncated while it is mapped.
+ */
+class MappedFile {
+  friend FileSystem;
+
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+  MappedFile(const MappedFile& other) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(const MappedFile& other) = delete;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+ public:
+  const char* GetData() const;
+
+  std::size_t GetSize() const;
+
+  std::string_view GetStringView() const;
+
+  bool IsValid() const;
+
+  /**
+   * \brief Unmap the file, the view becomes invalid.
+   */
+  void Release();
+
+ private:
+  void* mapping_address_{nullptr};
+  std::size_t mapping_size_{0};
+  const char* data_{nullptr};
+  std::size_t size_{0};
+  // Holds the data on platforms without mmap.
+  std::vector<char> buffer_{};
+};
+
 class FileSystem {
  public:
   FileSystem(const FileSystem&) = delete;
@@ -365,6 +416,44 @@ class FileSystem {
   Result<std::vector<char>, ErrorResult> ReadFile(
       const MM::FileSystem::Path& path, std::size_t offset = 0, std::size_t read_size = UINT64_MAX) const;
 
+  /**
+   * \brief Map the file read-only into memory instead of reading it.
+   * \param path The file you want to map.
+   * \param access_pattern How the data will be read.
+   * \param offset The offset of the first mapped byte.
+   * \param map_size The number of bytes to map, UINT64_MAX maps the rest of
+   * the file.
+   * \return The view of the file or error.
+   */
+  Result<MappedFile, ErrorResult> MapFile(
+      const MM::FileSystem::Path& path,
+      FileAccessPattern access_pattern = FileAccessPattern::SEQUENTIAL,
+      std::size_t offset = 0, std::size_t map_size = UINT64_MAX) const;
+
+  /**
+   * \brief Read a batch of files asynchronously, see \ref AsyncFileReader.
+   * \param requests The files and ranges you want to read.
+   * \param callback Called with the index of each request and its data.
+   */
+  void ReadFilesAsync(
+      std::vector<FileReadRequest> requests,
+      std::function<void(std::size_t request_index,
+                         Result<std::vector<char>, ErrorResult>&& read_result)>
+          callback) const;
+
+  /**
+   * \brief The reader used by \ref ReadFilesAsync, created on first use.
+   */
+  AsyncFileReader& GetAsyncFileReader() const;
+
+  /**
+   * \brief The index that answers the metadata and directory queries for the
+   * asset directory, see \ref FileMetadataIndex. Created on first use.
+   * \remark A query the index cannot answer, a path it has not seen yet or
+   * a directory it could not watch, falls back to std::filesystem.
+   */
+  FileMetadataIndex& GetFileMetadataIndex() const;
+
   const Path& GetAssetDir() const;
 
   const Path& GetAssetDirStd() const;
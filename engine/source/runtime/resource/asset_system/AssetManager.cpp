@@ -74,6 +74,63 @@ MM::Result<MM::AssetSystem::AssetManager::HandlerType, ErrorResult> MM::AssetSys
   return ResultS<HandlerType>{std::move(base_handler.GetResult()), std::move(asset_ID_ID_handler.GetResult())};
 }
 
+MM::Result<std::vector<MM::AssetSystem::AssetManager::HandlerType>, ErrorResult>
+MM::AssetSystem::AssetManager::AddAssets(
+    std::vector<std::unique_ptr<AssetType::AssetBase>>&& assets) {
+  if (!IsValid()) {
+    return ResultE<ErrorResult>{ErrorCode::OBJECT_IS_INVALID};
+  }
+
+  std::vector<ManagedType> valid_assets;
+  std::vector<std::size_t> asset_indexes;
+  std::vector<std::pair<AssetType::AssetID, Manager::ManagedObjectID>> asset_IDs;
+  valid_assets.reserve(assets.size());
+  asset_indexes.reserve(assets.size());
+  asset_IDs.reserve(assets.size());
+  for (std::size_t i = 0; i != assets.size(); ++i) {
+    if (assets[i] == nullptr || !assets[i]->IsValid() ||
+        assets[i]->GetAssetType() == AssetType::AssetType::UNDEFINED) {
+      continue;
+    }
+
+    asset_IDs.emplace_back(assets[i]->GetAssetID(), assets[i]->GetObjectID());
+    valid_assets.emplace_back(std::move(assets[i]));
+    asset_indexes.emplace_back(i);
+  }
+
+  std::vector<Result<BaseHandlerType, ErrorResult>> base_handlers =
+      AddObjectBatchBase(std::move(valid_assets));
+  // Only assets that were added get an asset ID entry.
+  std::vector<std::size_t> added_indexes;
+  std::vector<std::pair<AssetType::AssetID, Manager::ManagedObjectID>>
+      added_asset_IDs;
+  added_indexes.reserve(base_handlers.size());
+  added_asset_IDs.reserve(base_handlers.size());
+  for (std::size_t i = 0; i != base_handlers.size(); ++i) {
+    if (base_handlers[i].Exception().IsSuccess()) {
+      added_indexes.emplace_back(i);
+      added_asset_IDs.emplace_back(std::move(asset_IDs[i]));
+    }
+  }
+
+  std::vector<Result<AssetIDToObjectIDContainerType::HandlerType, ErrorResult>>
+      asset_ID_ID_handlers =
+          asset_ID_to_object_ID_.AddObjectBatch(std::move(added_asset_IDs));
+  std::vector<HandlerType> handlers(assets.size());
+  for (std::size_t i = 0; i != added_indexes.size(); ++i) {
+    if (asset_ID_ID_handlers[i].Exception().IsError()) {
+      continue;
+    }
+
+    const std::size_t index = added_indexes[i];
+    handlers[asset_indexes[index]] =
+        HandlerType{std::move(base_handlers[index].GetResult()),
+                    std::move(asset_ID_ID_handlers[i].GetResult())};
+  }
+
+  return ResultS<std::vector<HandlerType>>{std::move(handlers)};
+}
+
 MM::Result<MM::AssetSystem::AssetManager::HandlerType, ErrorResult> MM::AssetSystem::AssetManager::AddImage(
     MM::FileSystem::Path image_path, int desired_channels) {
   if (!IsValid()) {
@@ -112,6 +169,74 @@ MM::Result<MM::AssetSystem::AssetManager::HandlerType, ErrorResult> MM::AssetSys
   return AddAsset(std::move(mesh));
 }
 
+MM::Result<std::vector<MM::AssetSystem::AssetManager::HandlerType>, ErrorResult>
+MM::AssetSystem::AssetManager::AddMeshes(
+    const FileSystem::Path& mesh_path,
+    AssetType::BoundingBox::BoundingBoxType bounding_box_type,
+    bool load_in_parallel) {
+  if (!IsValid()) {
+    return ResultE<ErrorResult>{ErrorCode::OBJECT_IS_INVALID};
+  }
+
+  Result<std::vector<std::unique_ptr<AssetType::Mesh>>, ErrorResult> meshes =
+      AssetType::Mesh::LoadMeshes(mesh_path, bounding_box_type,
+                                  AssetType::Mesh::kDefaultVertexFormat,
+                                  load_in_parallel)
+          .Exception()
+          .Move();
+  if (meshes.IsError()) {
+    return ResultE<ErrorResult>{meshes.GetError().GetErrorCode()};
+  }
+
+  std::vector<HandlerType> handlers(meshes.GetResult().size());
+  std::vector<AssetType::AssetID> asset_IDs(handlers.size());
+  std::vector<std::unique_ptr<AssetType::AssetBase>> new_meshes;
+  std::vector<std::size_t> new_mesh_indexes;
+  for (std::size_t i = 0; i != handlers.size(); ++i) {
+    std::unique_ptr<AssetType::Mesh>& mesh = meshes.GetResult()[i];
+    if (!mesh->IsValid()) {
+      continue;
+    }
+
+    asset_IDs[i] = mesh->GetAssetID();
+    if (Have(asset_IDs[i])) {
+      Result<HandlerType, ErrorResult> handler = GetAssetByAssetID(asset_IDs[i]);
+      if (handler.IsSuccess()) {
+        handlers[i] = std::move(handler.GetResult());
+      }
+      continue;
+    }
+
+    new_meshes.emplace_back(std::move(mesh));
+    new_mesh_indexes.emplace_back(i);
+  }
+
+  // The new meshes are registered with one batch.
+  Result<std::vector<HandlerType>, ErrorResult> new_handlers =
+      AddAssets(std::move(new_meshes));
+  if (new_handlers.IsError()) {
+    return ResultE<ErrorResult>{new_handlers.GetError().GetErrorCode()};
+  }
+  for (std::size_t i = 0; i != new_mesh_indexes.size(); ++i) {
+    const std::size_t index = new_mesh_indexes[i];
+    if (new_handlers.GetResult()[i].IsValid()) {
+      handlers[index] = std::move(new_handlers.GetResult()[i]);
+      continue;
+    }
+
+    // Another thread may have added the same mesh meanwhile.
+    if (Have(asset_IDs[index])) {
+      Result<HandlerType, ErrorResult> handler =
+          GetAssetByAssetID(asset_IDs[index]);
+      if (handler.IsSuccess()) {
+        handlers[index] = std::move(handler.GetResult());
+      }
+    }
+  }
+
+  return ResultS<std::vector<HandlerType>>{std::move(handlers)};
+}
+
 MM::Result<MM::AssetSystem::AssetManager::HandlerType, ErrorResult> MM::AssetSystem::AssetManager::AddMesh(
     const FileSystem::Path& asset_path, AssetType::AssetID asset_ID,
     std::unique_ptr<AssetType::RectangleBox>&& aabb_box,
@@ -227,6 +352,31 @@ MM::Result<MM::Manager::ManagedObjectID, ErrorResult> MM::AssetSystem::AssetMana
   return Result{handler.GetResult().GetObject()};
 }
 
+MM::Result<MM::AssetSystem::AssetManager::AssetHandleType, ErrorResult>
+MM::AssetSystem::AssetManager::GetAssetHandleByAssetID(
+    MM::AssetSystem::AssetType::AssetID asset_ID) const {
+  if (!IsValid()) {
+    return ResultE<ErrorResult>{ErrorCode::OBJECT_IS_INVALID};
+  }
+
+  Result<AssetIDToObjectIDContainerType::HandlerType, ErrorResult> handler = asset_ID_to_object_ID_.GetObject(asset_ID).Exception();
+  if (handler.IsError()) {
+    return ResultE<>{handler.GetError().GetErrorCode()};
+  }
+
+  return GetGenerationalHandle(handler.GetResult().GetObject());
+}
+
+MM::Result<MM::AssetSystem::AssetManager::BaseHandlerType, ErrorResult>
+MM::AssetSystem::AssetManager::GetAssetByHandle(
+    AssetHandleType asset_handle) const {
+  if (!IsValid()) {
+    return ResultE<ErrorResult>{ErrorCode::OBJECT_IS_INVALID};
+  }
+
+  return GetObjectByHandle(asset_handle);
+}
+
 MM::Result<std::string, ErrorResult> MM::AssetSystem::AssetManager::GetNameByAssetID(
     MM::AssetSystem::AssetType::AssetID asset_ID) const {
   if (!IsValid()) {
@@ -33,6 +33,7 @@ class AssetManager final
   using AssetIDToObjectIDContainerType =
       Manager::ManagedObjectUnorderedMap<AssetType::AssetID,
                                          Manager::ManagedObjectID>;
+  using AssetHandleType = Manager::ManagedObjectGenerationalHandle;
 
  public:
   AssetManager(const AssetManager& other) = delete;
@@ -91,6 +92,14 @@ class AssetManager final
 
   Result<HandlerType, ErrorResult> AddAsset(std::unique_ptr<AssetType::AssetBase>&& asset);
 
+  /**
+   * \brief Add every asset of \ref assets with one batch per index.
+   * \return The handlers, in the order of \ref assets. An asset that can not
+   * be added has an invalid handler.
+   */
+  Result<std::vector<HandlerType>, ErrorResult> AddAssets(
+      std::vector<std::unique_ptr<AssetType::AssetBase>>&& assets);
+
   Result<HandlerType, ErrorResult> AddImage(FileSystem::Path image_path, int desired_channels);
 
   Result<HandlerType, ErrorResult> AddImage(
@@ -100,6 +109,21 @@ class AssetManager final
 
   Result<HandlerType, ErrorResult> AddMesh(const FileSystem::Path& mesh_path, uint32_t mesh_index);
 
+  /**
+   * \brief Add every mesh of \ref mesh_path, the file is imported at most
+   * once.
+   * \return The handlers, the i-th handler is the mesh with index i. Meshes
+   * that have already been added are not loaded again, their existing asset is
+   * returned. A mesh that can not be loaded has an invalid handler.
+   * \remark The asset ID of the i-th mesh is
+   * AssetType::Mesh::CalculateAssetID(mesh_path, i, bounding_box_type).
+   */
+  Result<std::vector<HandlerType>, ErrorResult> AddMeshes(
+      const FileSystem::Path& mesh_path,
+      AssetType::BoundingBox::BoundingBoxType bounding_box_type =
+          AssetType::BoundingBox::BoundingBoxType::AABB,
+      bool load_in_parallel = true);
+
   Result<HandlerType, ErrorResult> AddMesh(const FileSystem::Path& asset_path,
                         AssetType::AssetID asset_ID,
                         std::unique_ptr<AssetType::RectangleBox>&& aabb_box,
@@ -132,6 +156,18 @@ class AssetManager final
 
   Result<std::vector<AssetType::AssetID>, ErrorResult>GetAssetIDByAssetName(const std::string& asset_name) const;
 
+  Result<AssetHandleType, ErrorResult> GetAssetHandleByAssetID(AssetType::AssetID asset_ID) const;
+
+  /**
+   * \brief Resolve \ref asset_handle without hashing or locking.
+   * \return A handler that keeps the asset alive, or an error if the asset has
+   * been removed.
+   * \remark The handler does not hold the asset ID index entry, use
+   * \ref GetAssetByAssetID when an \ref AssetHandler is needed.
+   */
+  Result<BaseHandlerType, ErrorResult> GetAssetByHandle(
+      AssetHandleType asset_handle) const;
+
  protected:
   AssetManager() = default;
   AssetManager(std::uint64_t size);
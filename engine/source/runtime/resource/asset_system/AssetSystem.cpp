@@ -45,3 +45,39 @@ MM::AssetSystem::AssetSystem::AssetSystem()
 MM::AssetSystem::AssetManager& MM::AssetSystem::AssetSystem::GetAssetManager() {
   return *assert_manager_;
 }
+
+MM::TaskSystem::AsyncTask<MM::Result<std::vector<char>, MM::ErrorResult>>
+MM::AssetSystem::AssetSystem::ReadFileAsync(const FileSystem::Path& path,
+                                            std::size_t offset,
+                                            std::size_t read_size) {
+  std::vector<FileSystem::FileReadRequest> requests{
+      FileSystem::FileReadRequest{path, offset, read_size}};
+
+  return std::move(ReadFilesAsync(std::move(requests)).front());
+}
+
+std::vector<
+    MM::TaskSystem::AsyncTask<MM::Result<std::vector<char>, MM::ErrorResult>>>
+MM::AssetSystem::AssetSystem::ReadFilesAsync(
+    std::vector<FileSystem::FileReadRequest> requests) {
+  using ReadResult = Result<std::vector<char>, ErrorResult>;
+
+  auto promises =
+      std::make_shared<std::vector<TaskSystem::AsyncTaskPromise<ReadResult>>>(
+          requests.size());
+  std::vector<TaskSystem::AsyncTask<ReadResult>> async_tasks;
+  async_tasks.reserve(requests.size());
+  for (const TaskSystem::AsyncTaskPromise<ReadResult>& promise : *promises) {
+    async_tasks.emplace_back(promise.GetAsyncTask());
+  }
+
+  // Continuations chained with Then are queued to their lanes, the I/O thread
+  // only publishes the data.
+  MM_FILE_SYSTEM->ReadFilesAsync(
+      std::move(requests),
+      [promises](std::size_t request_index, ReadResult&& read_result) {
+        (*promises)[request_index].SetValue(std::move(read_result));
+      });
+
+  return async_tasks;
+}
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "runtime/core/task_system/async_task.h"
+#include "runtime/platform/file_system/async_file_reader.h"
 #include "runtime/resource/asset_system/AssetManager.h"
 #include "runtime/resource/asset_system/asset_type/Combination.h"
 
@@ -20,6 +26,24 @@ class AssetSystem {
 
   AssetManager& GetAssetManager();
 
+  /**
+   * \brief Read \ref path through the asynchronous file reader, no worker
+   * waits for the read.
+   * \remark Chain the decoding of the data with TaskSystem::AsyncTask::Then
+   * instead of waiting for it.
+   */
+  static TaskSystem::AsyncTask<Result<std::vector<char>, ErrorResult>>
+  ReadFileAsync(const FileSystem::Path& path, std::size_t offset = 0,
+                std::size_t read_size = UINT64_MAX);
+
+  /**
+   * \brief Read a batch of files with all reads in flight at once.
+   * \return One task per request, in the order of \ref requests.
+   */
+  static std::vector<
+      TaskSystem::AsyncTask<Result<std::vector<char>, ErrorResult>>>
+  ReadFilesAsync(std::vector<FileSystem::FileReadRequest> requests);
+
  private:
   static bool Destroy();
 
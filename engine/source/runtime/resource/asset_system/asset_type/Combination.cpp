@@ -96,20 +96,17 @@ Combination::Combination(const FileSystem::Path& combination_path)
     return;
   }
 
-  std::ifstream combination_json_fstream(combination_path.StringView().data());
-  if (!combination_json_fstream.is_open()) {
+  Result<FileSystem::MappedFile, ErrorResult> combination_file =
+      MM_FILE_SYSTEM->MapFile(combination_path);
+  if (combination_file.IgnoreException().IsError()) {
     AssetBase::Release();
-    MM_LOG_ERROR(combination_path.String() + "can't open.");
+    MM_LOG_ERROR("{}can't open.", combination_path.StringView());
     return;
   }
-  std::ostringstream combination_json_string_stream;
-  std::string one_line_string;
-  while (std::getline(combination_json_fstream, one_line_string)) {
-    combination_json_string_stream << one_line_string;
-  }
-  combination_json_fstream.close();
   Utils::Json::Document combination_json;
-  if (combination_json.Parse(combination_json_string_stream.str().c_str())
+  if (combination_json
+          .Parse(combination_file.GetResult().GetData(),
+                 combination_file.GetResult().GetSize())
           .HasParseError()) {
     AssetBase::Release();
     MM_LOG_ERROR(std::string("Combination asset has parse error."));
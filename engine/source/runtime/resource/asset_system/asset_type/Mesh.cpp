@@ -1,9 +1,11 @@
 #include "runtime/resource/asset_system/asset_type/Mesh.h"
 
+#include <atomic>
 #include <cstdint>
 
 #include "base/asset_base.h"
 #include "base/bounding_box.h"
+#include "base/mesh_optimizer.h"
 #include "runtime/platform/base/error.h"
 
 MM::AssetSystem::AssetType::Mesh::Mesh(const FileSystem::Path& mesh_path,
@@ -12,22 +14,40 @@ MM::AssetSystem::AssetType::Mesh::Mesh(const FileSystem::Path& mesh_path,
       bounding_box_(
           std::make_unique<MM::AssetSystem::AssetType::RectangleBox>()) {
   if (!AssetBase::IsValid()) {
-    MM_LOG_ERROR(std::string("Failed to load the mesh with path ") +
-                 mesh_path.StringView().data() +
-                 ",because the file does not exist.");
+    MM_LOG_ERROR(
+        "Failed to load the mesh with path {},because the file does not exist.",
+        mesh_path.StringView());
     return;
   }
 
-  LoadModel(mesh_path, mesh_index);
+  LoadModel(mesh_path, mesh_index, kDefaultVertexFormat);
 
   if (!(AssetBase::IsValid() && bounding_box_ != nullptr && !indexes_.empty() &&
-        !vertices_.empty())) {
+        !vertex_data_.empty())) {
     AssetBase::Release();
     return;
   }
 
-  SetAssetID(GetAssetID() + mesh_index +
-             (static_cast<std::uint64_t>(0x1) << 16));
+  SetMeshAssetID(mesh_index);
+}
+
+MM::AssetSystem::AssetType::Mesh::Mesh(
+    const FileSystem::Path& mesh_path, std::uint32_t mesh_index,
+    BoundingBox::BoundingBoxType bounding_box_type, CookedSubMesh&& sub_mesh)
+    : AssetBase(mesh_path) {
+  if (!AssetBase::IsValid()) {
+    return;
+  }
+
+  CreateBoundingBox(bounding_box_type);
+  SetSubMesh(std::move(sub_mesh));
+
+  if (!Mesh::IsValid()) {
+    AssetBase::Release();
+    return;
+  }
+
+  SetMeshAssetID(mesh_index);
 }
 
 MM::AssetSystem::AssetType::Mesh::Mesh(const FileSystem::Path& asset_path,
@@ -37,8 +57,9 @@ MM::AssetSystem::AssetType::Mesh::Mesh(const FileSystem::Path& asset_path,
                                        std::vector<Vertex>&& vertices)
     : AssetBase(asset_path, asset_ID),
       bounding_box_(std::move(aabb_box)),
-      indexes_(std::move(indexes)),
-      vertices_(std::move(vertices)) {}
+      indexes_(std::move(indexes)) {
+  EncodeVertices(vertices);
+}
 
 MM::AssetSystem::AssetType::Mesh::Mesh(
     const FileSystem::Path& asset_path, AssetID asset_ID,
@@ -46,14 +67,18 @@ MM::AssetSystem::AssetType::Mesh::Mesh(
     std::vector<Vertex>&& vertices)
     : AssetBase(asset_path, asset_ID),
       bounding_box_(std::move(capsule_box)),
-      indexes_(std::move(indexes)),
-      vertices_(std::move(vertices)) {}
+      indexes_(std::move(indexes)) {
+  EncodeVertices(vertices);
+}
 
 MM::AssetSystem::AssetType::Mesh::Mesh(Mesh&& other) noexcept
     : AssetBase(std::move(other)),
       bounding_box_(std::move(other.bounding_box_)),
       indexes_(std::move(other.indexes_)),
-      vertices_(std::move(other.vertices_)) {}
+      vertex_layout_(other.vertex_layout_),
+      vertex_data_(std::move(other.vertex_data_)) {
+  other.vertex_layout_.Reset();
+}
 
 MM::AssetSystem::AssetType::Mesh& MM::AssetSystem::AssetType::Mesh::operator=(
     Mesh&& other) noexcept {
@@ -63,14 +88,17 @@ MM::AssetSystem::AssetType::Mesh& MM::AssetSystem::AssetType::Mesh::operator=(
   AssetBase::operator=(std::move(other));
   bounding_box_ = std::move(other.bounding_box_);
   indexes_ = std::move(other.indexes_);
-  vertices_ = std::move(other.vertices_);
+  vertex_layout_ = other.vertex_layout_;
+  vertex_data_ = std::move(other.vertex_data_);
+
+  other.vertex_layout_.Reset();
 
   return *this;
 }
 
 bool MM::AssetSystem::AssetType::Mesh::IsValid() const {
   return AssetBase::IsValid() && bounding_box_ != nullptr &&
-         !indexes_.empty() && !vertices_.empty();
+         !indexes_.empty() && !vertex_data_.empty();
 }
 
 MM::AssetSystem::AssetType::AssetType
@@ -79,7 +107,10 @@ MM::AssetSystem::AssetType::Mesh::GetAssetType() const {
 }
 
 uint32_t MM::AssetSystem::AssetType::Mesh::GetVerticesCount() const {
-  return vertices_.size();
+  if (!vertex_layout_.IsValid()) {
+    return 0;
+  }
+  return vertex_data_.size() / vertex_layout_.GetStride();
 }
 
 const MM::AssetSystem::AssetType::BoundingBox&
@@ -93,23 +124,101 @@ const std::vector<std::uint32_t>& MM::AssetSystem::AssetType::Mesh::GetIndexes()
   return indexes_;
 }
 
-const std::vector<MM::AssetSystem::AssetType::Vertex>&
-MM::AssetSystem::AssetType::Mesh::GetVertices() const {
-  return vertices_;
+const MM::AssetSystem::AssetType::VertexLayout&
+MM::AssetSystem::AssetType::Mesh::GetVertexLayout() const {
+  return vertex_layout_;
+}
+
+const std::vector<char>& MM::AssetSystem::AssetType::Mesh::GetVertexData()
+    const {
+  return vertex_data_;
+}
+
+MM::Math::vec3 MM::AssetSystem::AssetType::Mesh::GetVertexPosition(
+    std::uint32_t vertex_index) const {
+  assert(vertex_index < GetVerticesCount());
+  return vertex_layout_.DecodePosition(
+      vertex_data_.data() +
+      static_cast<std::size_t>(vertex_index) * vertex_layout_.GetStride());
+}
+
+MM::AssetSystem::AssetType::PositionStream
+MM::AssetSystem::AssetType::Mesh::GetPositionStream() const {
+  return PositionStream{vertex_data_.data(), GetVerticesCount(),
+                        vertex_layout_.GetStride()};
+}
+
+MM::AssetSystem::AssetType::Vertex
+MM::AssetSystem::AssetType::Mesh::GetVertex(std::uint32_t vertex_index) const {
+  assert(vertex_index < GetVerticesCount());
+  return vertex_layout_.Decode(
+      vertex_data_.data() +
+      static_cast<std::size_t>(vertex_index) * vertex_layout_.GetStride());
 }
 
 void MM::AssetSystem::AssetType::Mesh::Release() {
   bounding_box_.reset();
   indexes_.clear();
-  vertices_.clear();
+  vertex_layout_.Reset();
+  vertex_data_.clear();
   AssetBase::Release();
 }
 
 void MM::AssetSystem::AssetType::Mesh::LoadModel(
-    const FileSystem::Path& mesh_path, const uint64_t& mesh_index) {
+    const FileSystem::Path& mesh_path, const uint64_t& mesh_index,
+    VertexFormat vertex_format) {
   if (!mesh_path.IsExists()) {
     return;
   }
+
+  const bool optimize = IsOptimizeEnabled();
+  Result<CookedMesh, ErrorResult> cooked_mesh =
+      CookedMesh::Open(mesh_path, vertex_format, optimize);
+  if (cooked_mesh.IsSuccess()) {
+    if (cooked_mesh.GetResult().GetSubMeshCount() <= mesh_index) {
+      MM_LOG_ERROR("The grid index is larger than the maximum index.");
+      return;
+    }
+    Result<CookedSubMesh, ErrorResult> sub_mesh =
+        cooked_mesh.GetResult().GetSubMesh(
+            static_cast<std::uint32_t>(mesh_index));
+    if (sub_mesh.IsSuccess()) {
+      SetSubMesh(std::move(sub_mesh.GetResult()));
+      return;
+    }
+  }
+
+  Result<std::vector<CookedSubMesh>, ErrorResult> sub_meshes =
+      ImportModel(mesh_path, vertex_format, optimize, true);
+  if (sub_meshes.IsError()) {
+    return;
+  }
+
+  CookedMesh::Write(mesh_path, vertex_format, sub_meshes.GetResult(),
+                    optimize)
+      .Exception(MM_WARN_DESCRIPTION(Failed to save cooked mesh to file.));
+
+  if (sub_meshes.GetResult().size() <= mesh_index) {
+    MM_LOG_ERROR("The grid index is larger than the maximum index.");
+    return;
+  }
+  SetSubMesh(std::move(sub_meshes.GetResult()[mesh_index]));
+}
+
+bool MM::AssetSystem::AssetType::Mesh::IsOptimizeEnabled() {
+  std::uint32_t optimize = 1;
+  if (MM_CONFIG_SYSTEM->GetConfig("optimize_imported_mesh", optimize)
+          .IsError()) {
+    return true;
+  }
+  return optimize != 0;
+}
+
+MM::Result<std::vector<MM::AssetSystem::AssetType::CookedSubMesh>,
+           MM::ErrorResult>
+MM::AssetSystem::AssetType::Mesh::ImportModel(
+    const FileSystem::Path& mesh_path, VertexFormat vertex_format,
+    bool optimize, bool process_in_parallel) {
   Assimp::Importer mesh_importer;
   const aiScene* scene = mesh_importer.ReadFile(
       mesh_path.String().c_str(),
@@ -118,53 +227,208 @@ void MM::AssetSystem::AssetType::Mesh::LoadModel(
           aiProcess_OptimizeMeshes);
   if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
       !scene->mRootNode) {
-    MM_LOG_ERROR(std::string("Failed to create Mesh.(detail:") +
-                 mesh_importer.GetErrorString() + ")");
-    return;
+    MM_LOG_ERROR("Failed to create Mesh.(detail:{})",
+                 mesh_importer.GetErrorString());
+    return ResultE<ErrorResult>{ErrorCode::CREATE_OBJECT_FAILED};
   }
 
-  if (scene->mNumMeshes <= mesh_index) {
-    MM_LOG_ERROR("The grid index is larger than the maximum index.");
+  std::vector<CookedSubMesh> sub_meshes(scene->mNumMeshes);
+  ForEachSubMesh(sub_meshes.size(), process_in_parallel,
+                 [scene, vertex_format, optimize, &sub_meshes](std::size_t i) {
+                   sub_meshes[i] =
+                       ProcessMesh(*(scene->mMeshes[i]), vertex_format);
+                   if (optimize && sub_meshes[i].vertex_layout_.IsValid()) {
+                     OptimizeSubMesh(sub_meshes[i])
+                         .Exception(MM_WARN_DESCRIPTION(
+                             Failed to optimize the mesh.));
+                   }
+                 });
+
+  // Both boxes are cooked, the mesh picks the one it was asked for.
+  std::vector<PositionStream> position_streams;
+  position_streams.reserve(sub_meshes.size());
+  for (const CookedSubMesh& sub_mesh : sub_meshes) {
+    const std::size_t stride = sub_mesh.vertex_layout_.GetStride();
+    position_streams.push_back(PositionStream{
+        sub_mesh.vertex_data_.data(),
+        stride == 0 ? 0 : sub_mesh.vertex_data_.size() / stride, stride});
+  }
+  const std::vector<PositionBounds> bounds =
+      ComputePositionBounds(position_streams, process_in_parallel);
+  for (std::size_t i = 0; i != sub_meshes.size(); ++i) {
+    sub_meshes[i].aabb_box_.UpdateBoundingBox(bounds[i]);
+    sub_meshes[i].capsule_box_.UpdateBoundingBox(bounds[i]);
+  }
+
+  return Result<std::vector<CookedSubMesh>, ErrorResult>(
+      st_execute_success, std::move(sub_meshes));
+}
+
+MM::Result<std::vector<MM::AssetSystem::AssetType::CookedSubMesh>,
+           MM::ErrorResult>
+MM::AssetSystem::AssetType::Mesh::LoadSubMeshes(
+    const FileSystem::Path& mesh_path, VertexFormat vertex_format,
+    bool load_in_parallel) {
+  const bool optimize = IsOptimizeEnabled();
+  Result<CookedMesh, ErrorResult> cooked_mesh =
+      CookedMesh::Open(mesh_path, vertex_format, optimize);
+  if (cooked_mesh.IsSuccess()) {
+    const CookedMesh& cooked = cooked_mesh.GetResult();
+    std::vector<CookedSubMesh> sub_meshes(cooked.GetSubMeshCount());
+    std::atomic_bool is_corrupted{false};
+    ForEachSubMesh(sub_meshes.size(), load_in_parallel,
+                   [&cooked, &sub_meshes, &is_corrupted](std::size_t i) {
+                     Result<CookedSubMesh, ErrorResult> sub_mesh =
+                         cooked.GetSubMesh(static_cast<std::uint32_t>(i));
+                     if (sub_mesh.IsError()) {
+                       is_corrupted.store(true, std::memory_order_relaxed);
+                       return;
+                     }
+                     sub_meshes[i] = std::move(sub_mesh.GetResult());
+                   });
+    if (!is_corrupted.load(std::memory_order_relaxed)) {
+      return Result<std::vector<CookedSubMesh>, ErrorResult>(
+          st_execute_success, std::move(sub_meshes));
+    }
+  }
+
+  // Not cooked yet, or a sub-mesh of the cooked file is corrupted.
+  Result<std::vector<CookedSubMesh>, ErrorResult> sub_meshes =
+      ImportModel(mesh_path, vertex_format, optimize, load_in_parallel);
+  if (sub_meshes.IsSuccess()) {
+    CookedMesh::Write(mesh_path, vertex_format, sub_meshes.GetResult(),
+                      optimize)
+        .Exception(MM_WARN_DESCRIPTION(Failed to save cooked mesh to file.));
+  }
+  return sub_meshes;
+}
+
+MM::Result<std::vector<std::unique_ptr<MM::AssetSystem::AssetType::Mesh>>,
+           MM::ErrorResult>
+MM::AssetSystem::AssetType::Mesh::LoadMeshes(
+    const FileSystem::Path& mesh_path,
+    BoundingBox::BoundingBoxType bounding_box_type, VertexFormat vertex_format,
+    bool load_in_parallel) {
+  if (!mesh_path.IsExists()) {
+    MM_LOG_ERROR(
+        "Failed to load the meshes with path {},because the file does not "
+        "exist.",
+        mesh_path.StringView());
+    return ResultE<ErrorResult>{ErrorCode::FILE_IS_NOT_EXIST};
+  }
+
+  Result<std::vector<CookedSubMesh>, ErrorResult> sub_meshes =
+      LoadSubMeshes(mesh_path, vertex_format, load_in_parallel);
+  if (sub_meshes.IsError()) {
+    return ResultE<ErrorResult>{sub_meshes.GetError().GetErrorCode()};
+  }
+
+  std::vector<std::unique_ptr<Mesh>> meshes(sub_meshes.GetResult().size());
+  ForEachSubMesh(
+      meshes.size(), load_in_parallel,
+      [&mesh_path, bounding_box_type, &sub_meshes, &meshes](std::size_t i) {
+        meshes[i] = std::unique_ptr<Mesh>(
+            new Mesh(mesh_path, static_cast<std::uint32_t>(i),
+                     bounding_box_type,
+                     std::move(sub_meshes.GetResult()[i])));
+      });
+
+  return Result<std::vector<std::unique_ptr<Mesh>>, ErrorResult>(
+      st_execute_success, std::move(meshes));
+}
+
+void MM::AssetSystem::AssetType::Mesh::ForEachSubMesh(
+    std::size_t count, bool in_parallel,
+    const std::function<void(std::size_t)>& function) {
+  if (!in_parallel || count < 2) {
+    for (std::size_t i = 0; i != count; ++i) {
+      function(i);
+    }
     return;
   }
 
-  ProcessMesh(*(scene->mMeshes[mesh_index]));
+  TaskSystem::Taskflow task_flow;
+  MM_TASK_SYSTEM->EmplaceParallelFor(TaskSystem::TaskType::Common, task_flow, 0,
+                                     count, 1, function);
+  MM_TASK_SYSTEM->RunAndWait(TaskSystem::TaskType::Common, task_flow);
 }
 
-void MM::AssetSystem::AssetType::Mesh::ProcessMesh(const aiMesh& mesh) {
+MM::AssetSystem::AssetType::CookedSubMesh
+MM::AssetSystem::AssetType::Mesh::ProcessMesh(const aiMesh& mesh,
+                                              VertexFormat vertex_format) {
+  CookedSubMesh sub_mesh;
   if (!mesh.HasPositions()) {
     MM_LOG_ERROR("There is no vertex position information in the mesh.");
-    return;
+    return sub_mesh;
   }
-  std::vector<Vertex> vertices;
-  vertices.reserve(mesh.mNumVertices);
 
-  const bool have_normal = mesh.HasNormals();
-  const bool have_Tangent = mesh.HasTangentsAndBitangents();
-  const bool have_texture_coord = mesh.mTextureCoords[0] != nullptr;
-
-  for (unsigned i = 0; i < mesh.mNumVertices; ++i) {
-    Vertex temp;
-    temp.SetPosition(
-        {mesh.mVertices[i].x, mesh.mVertices[i].y, mesh.mVertices[i].z});
-    // TODO Added support for vertex multi texture coordinates.
+  // Only the attributes the mesh has are stored.
+  VertexAttribute attributes = VertexAttribute::POSITION;
+  // TODO Added support for vertex multi texture coordinates.
+  if (mesh.mTextureCoords[0] != nullptr) {
+    attributes |= VertexAttribute::TEXTURE_COORD;
+  }
+  if (mesh.HasNormals()) {
+    attributes |= VertexAttribute::NORMAL;
+  }
+  if (mesh.HasTangentsAndBitangents()) {
+    attributes |= VertexAttribute::TANGENT;
+  }
+  const VertexLayout vertex_layout{attributes, vertex_format};
+  const std::size_t stride = vertex_layout.GetStride();
+  std::vector<char> vertex_data(static_cast<std::size_t>(mesh.mNumVertices) *
+                                stride);
+
+  const bool have_texture_coord =
+      vertex_layout.HaveAttribute(VertexAttribute::TEXTURE_COORD);
+  const bool have_normal = vertex_layout.HaveAttribute(VertexAttribute::NORMAL);
+  const bool have_Tangent =
+      vertex_layout.HaveAttribute(VertexAttribute::TANGENT);
+
+  auto convert_vertex = [&mesh, &vertex_data, &vertex_layout, stride,
+                         have_normal, have_Tangent,
+                         have_texture_coord](std::size_t i) {
+    char* vertex = vertex_data.data() + i * stride;
+    vertex_layout.EncodePosition(
+        {mesh.mVertices[i].x, mesh.mVertices[i].y, mesh.mVertices[i].z},
+        vertex);
     if (have_texture_coord) {
-      temp.SetTextureCoord(
-          Math::vec2{mesh.mTextureCoords[0][i].x, mesh.mTextureCoords[0][i].y});
+      vertex_layout.EncodeTextureCoord(
+          Math::vec2{mesh.mTextureCoords[0][i].x, mesh.mTextureCoords[0][i].y},
+          vertex);
     }
+    Math::vec3 normal{MathDefinition::VEC3_ZERO};
     if (have_normal) {
-      temp.SetNormal(Math::vec3{mesh.mNormals[i].x, mesh.mNormals[i].y,
-                                mesh.mNormals[i].z});
+      normal = Math::Normalize(Math::vec3{mesh.mNormals[i].x,
+                                          mesh.mNormals[i].y,
+                                          mesh.mNormals[i].z});
+      vertex_layout.EncodeNormal(normal, vertex);
     }
     if (have_Tangent) {
-      temp.SetTangent(Math::vec3{mesh.mTangents[i].x, mesh.mTangents[i].y,
-                                 mesh.mTangents[i].z});
-      temp.SetBiTangent(Math::vec3{mesh.mBitangents[i].x, mesh.mBitangents[i].y,
-                                   mesh.mBitangents[i].z});
+      const Math::vec3 tangent = Math::Normalize(Math::vec3{
+          mesh.mTangents[i].x, mesh.mTangents[i].y, mesh.mTangents[i].z});
+      const Math::vec3 bi_tangent{mesh.mBitangents[i].x, mesh.mBitangents[i].y,
+                                  mesh.mBitangents[i].z};
+      vertex_layout.EncodeTangent(
+          tangent, VertexLayout::GetBiTangentSign(normal, tangent, bi_tangent),
+          vertex);
+    }
+  };
+  // Small meshes are not worth the scheduling.
+  if (mesh.mNumVertices < kParallelVertexGrainSize * 2) {
+    for (unsigned i = 0; i < mesh.mNumVertices; ++i) {
+      convert_vertex(i);
     }
-    vertices.push_back(std::move(temp));
+  } else {
+    TaskSystem::Taskflow task_flow;
+    MM_TASK_SYSTEM->EmplaceParallelFor(TaskSystem::TaskType::Common, task_flow,
+                                       0, mesh.mNumVertices,
+                                       kParallelVertexGrainSize,
+                                       convert_vertex);
+    MM_TASK_SYSTEM->RunAndWait(TaskSystem::TaskType::Common, task_flow);
   }
-  vertices_ = std::move(vertices);
+  sub_mesh.vertex_layout_ = vertex_layout;
+  sub_mesh.vertex_data_ = std::move(vertex_data);
 
   // Generally, unsigned does not overflow.
   std::vector<std::uint32_t> indexes;
@@ -176,9 +440,50 @@ void MM::AssetSystem::AssetType::Mesh::ProcessMesh(const aiMesh& mesh) {
     indexes.emplace_back(mesh.mFaces[i].mIndices[2]);
   }
   indexes.shrink_to_fit();
-  indexes_ = std::move(indexes);
+  sub_mesh.indexes_ = std::move(indexes);
+
+  return sub_mesh;
+}
+
+void MM::AssetSystem::AssetType::Mesh::SetSubMesh(CookedSubMesh&& sub_mesh) {
+  vertex_layout_ = sub_mesh.vertex_layout_;
+  vertex_data_ = std::move(sub_mesh.vertex_data_);
+  indexes_ = std::move(sub_mesh.indexes_);
+
+  if (bounding_box_ == nullptr) {
+    return;
+  }
+  switch (bounding_box_->GetBoundingType()) {
+    case BoundingBox::BoundingBoxType::AABB:
+      *static_cast<RectangleBox*>(bounding_box_.get()) = sub_mesh.aabb_box_;
+      break;
+    case BoundingBox::BoundingBoxType::CAPSULE:
+      *static_cast<CapsuleBox*>(bounding_box_.get()) = sub_mesh.capsule_box_;
+      break;
+  }
+}
 
-  bounding_box_->UpdateBoundingBox(*this);
+void MM::AssetSystem::AssetType::Mesh::EncodeVertices(
+    const std::vector<Vertex>& vertices) {
+  VertexAttribute attributes = VertexAttribute::POSITION;
+  for (const Vertex& vertex : vertices) {
+    if (vertex.HaveTextureCoord()) {
+      attributes |= VertexAttribute::TEXTURE_COORD;
+    }
+    if (vertex.HaveNormal()) {
+      attributes |= VertexAttribute::NORMAL;
+    }
+    if (vertex.HaveTangent()) {
+      attributes |= VertexAttribute::TANGENT;
+    }
+  }
+  vertex_layout_ = VertexLayout{attributes, kDefaultVertexFormat};
+
+  const std::size_t stride = vertex_layout_.GetStride();
+  vertex_data_.resize(vertices.size() * stride);
+  for (std::size_t i = 0; i != vertices.size(); ++i) {
+    vertex_layout_.Encode(vertices[i], vertex_data_.data() + i * stride);
+  }
 }
 
 std::string MM::AssetSystem::AssetType::Mesh::GetAssetTypeString() const {
@@ -197,7 +502,7 @@ MM::AssetSystem::AssetType::Mesh::GetJson() const {
 
   document.AddMember("asset id", GetAssetID(), allocator);
   document.AddMember("number of indexes", indexes_.size(), allocator);
-  document.AddMember("number of vertices", vertices_.size(), allocator);
+  document.AddMember("number of vertices", GetVerticesCount(), allocator);
   Utils::Json::Value bounding_box = bounding_box_->GetJson(allocator);
   document.AddMember("bounding box", bounding_box, allocator);
 
@@ -206,27 +511,39 @@ MM::AssetSystem::AssetType::Mesh::GetJson() const {
 
 MM::AssetSystem::AssetType::Mesh::Mesh(
     const MM::FileSystem::Path& mesh_path, std::uint32_t mesh_index,
-    MM::AssetSystem::AssetType::BoundingBox::BoundingBoxType bounding_box_type)
+    MM::AssetSystem::AssetType::BoundingBox::BoundingBoxType bounding_box_type,
+    VertexFormat vertex_format)
     : AssetBase(mesh_path) {
   if (!AssetBase::IsValid()) {
-    MM_LOG_ERROR(std::string("Failed to load the mesh with path ") +
-                 mesh_path.String() + ",because the file does not exist.");
+    MM_LOG_ERROR(
+        "Failed to load the mesh with path {},because the file does not exist.",
+        mesh_path.StringView());
     return;
   }
 
-  if (bounding_box_type == BoundingBox::BoundingBoxType::AABB) {
-    bounding_box_ = std::make_unique<RectangleBox>();
-  } else if (bounding_box_type == BoundingBox::BoundingBoxType::CAPSULE) {
-    bounding_box_ = std::make_unique<CapsuleBox>();
-  }
+  CreateBoundingBox(bounding_box_type);
 
-  LoadModel(mesh_path, mesh_index);
+  LoadModel(mesh_path, mesh_index, vertex_format);
 
   if (!Mesh::IsValid()) {
     AssetBase::Release();
     return;
   }
 
+  SetMeshAssetID(mesh_index);
+}
+
+void MM::AssetSystem::AssetType::Mesh::CreateBoundingBox(
+    BoundingBox::BoundingBoxType bounding_box_type) {
+  if (bounding_box_type == BoundingBox::BoundingBoxType::AABB) {
+    bounding_box_ = std::make_unique<RectangleBox>();
+  } else if (bounding_box_type == BoundingBox::BoundingBoxType::CAPSULE) {
+    bounding_box_ = std::make_unique<CapsuleBox>();
+  }
+}
+
+void MM::AssetSystem::AssetType::Mesh::SetMeshAssetID(
+    std::uint32_t mesh_index) {
   std::uint64_t bounding_type_offset = 0;
   switch (GetBoundingBox().GetBoundingType()) {
     case BoundingBox::BoundingBoxType::AABB:
@@ -272,8 +589,8 @@ MM::AssetSystem::AssetType::Mesh::GetDatas() {
   return std::vector<std::pair<void*, std::uint64_t>>{
       std::pair<void*, std::uint64_t>(indexes_.data(),
                                       sizeof(std::uint32_t) * indexes_.size()),
-      std::pair<void*, std::uint64_t>(vertices_.data(),
-                                      sizeof(Vertex) * vertices_.size())};
+      std::pair<void*, std::uint64_t>(vertex_data_.data(),
+                                      vertex_data_.size())};
 }
 
 std::vector<std::pair<const void*, std::uint64_t>>
@@ -281,13 +598,13 @@ MM::AssetSystem::AssetType::Mesh::GetDatas() const {
   return std::vector<std::pair<const void*, std::uint64_t>>{
       std::pair<const void*, std::uint64_t>(
           indexes_.data(), sizeof(std::uint32_t) * indexes_.size()),
-      std::pair<const void*, std::uint64_t>(vertices_.data(),
-                                            sizeof(Vertex) * vertices_.size())};
+      std::pair<const void*, std::uint64_t>(vertex_data_.data(),
+                                            vertex_data_.size())};
 }
 
 std::uint64_t MM::AssetSystem::AssetType::Mesh::GetSize() const {
   return indexes_.size() * sizeof(std::uint32_t) +
-         vertices_.size() * sizeof(Vertex);
+         vertex_data_.size();
 }
 
 std::uint32_t MM::AssetSystem::AssetType::Mesh::GetIndexesCount() const {
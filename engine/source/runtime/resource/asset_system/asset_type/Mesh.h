@@ -4,24 +4,44 @@
 #include <assimp/scene.h>
 
 #include <assimp/Importer.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
 
 #include "runtime/platform/base/error.h"
 #include "runtime/platform/file_system/file_system.h"
 #include "runtime/resource/asset_system/asset_type/base/asset_base.h"
 #include "runtime/resource/asset_system/asset_type/base/asset_type_define.h"
 #include "runtime/resource/asset_system/asset_type/base/bounding_box.h"
+#include "runtime/resource/asset_system/asset_type/base/cooked_mesh.h"
 #include "runtime/resource/asset_system/asset_type/base/vertex.h"
+#include "runtime/resource/asset_system/asset_type/base/vertex_layout.h"
 
 namespace MM {
 namespace AssetSystem {
 namespace AssetType {
 class Mesh : public AssetBase {
+ public:
+  static constexpr VertexFormat kDefaultVertexFormat = VertexFormat::PACKED;
+
  public:
   Mesh() = default;
   ~Mesh() override = default;
   Mesh(const FileSystem::Path& mesh_path, std::uint32_t mesh_index);
+  /**
+   * \remark Only the attributes that the mesh has are stored, encoded with
+   * \ref vertex_format.
+   * \remark The first load of a model file imports it and cooks all of its
+   * meshes into a \ref CookedMesh, the next loads read the cooked file. The
+   * imported meshes are optimized for the GPU, see \ref IsOptimizeEnabled.
+   */
   Mesh(const FileSystem::Path& mesh_path, std::uint32_t mesh_index,
-       BoundingBox::BoundingBoxType bounding_box_type);
+       BoundingBox::BoundingBoxType bounding_box_type,
+       VertexFormat vertex_format = kDefaultVertexFormat);
+  /**
+   * \remark The vertices are encoded with \ref kDefaultVertexFormat, only the
+   * attributes that any vertex has are stored.
+   */
   Mesh(const FileSystem::Path& asset_path, AssetID asset_ID,
        std::unique_ptr<RectangleBox>&& aabb_box,
        std::vector<uint32_t>&& indexes, std::vector<Vertex>&& vertices);
@@ -42,7 +62,25 @@ class Mesh : public AssetBase {
 
   const std::vector<std::uint32_t>& GetIndexes() const;
 
-  const std::vector<Vertex>& GetVertices() const;
+  const VertexLayout& GetVertexLayout() const;
+
+  /**
+   * \brief Get the encoded vertices, \ref GetVertexLayout describes them.
+   */
+  const std::vector<char>& GetVertexData() const;
+
+  Math::vec3 GetVertexPosition(std::uint32_t vertex_index) const;
+
+  /**
+   * \brief Get the positions of the vertices, to compute the bounds of many
+   * meshes at once with \ref ComputePositionBounds.
+   */
+  PositionStream GetPositionStream() const;
+
+  /**
+   * \brief Decode a vertex.
+   */
+  Vertex GetVertex(std::uint32_t vertex_index) const;
 
   std::uint64_t GetSize() const override;
 
@@ -62,17 +100,92 @@ class Mesh : public AssetBase {
       const FileSystem::Path& path, std::uint32_t index,
       AssetSystem::AssetType::BoundingBox::BoundingBoxType bounding_box_type);
 
+  /**
+   * \brief Load every mesh of a model file, the model is imported at most
+   * once.
+   * \param load_in_parallel Convert or copy the meshes in parallel on the
+   * task system.
+   * \return The meshes, the i-th one is the mesh with index i and has the
+   * same asset ID as Mesh(mesh_path, i, bounding_box_type), see \ref
+   * CalculateAssetID. A mesh that can not be loaded is invalid. Returns error
+   * if the model file can not be imported.
+   */
+  static MM::Result<std::vector<std::unique_ptr<Mesh>>, ErrorResult>
+  LoadMeshes(const FileSystem::Path& mesh_path,
+             BoundingBox::BoundingBoxType bounding_box_type,
+             VertexFormat vertex_format = kDefaultVertexFormat,
+             bool load_in_parallel = true);
+
   void Release() override;
 
  private:
-  void LoadModel(const FileSystem::Path& mesh_path, const uint64_t& mesh_index);
-
-  void ProcessMesh(const aiMesh& mesh);
+  Mesh(const FileSystem::Path& mesh_path, std::uint32_t mesh_index,
+       BoundingBox::BoundingBoxType bounding_box_type,
+       CookedSubMesh&& sub_mesh);
+
+  void CreateBoundingBox(BoundingBox::BoundingBoxType bounding_box_type);
+
+  /**
+   * \brief Add the mesh index and the bounding box type to the asset ID of
+   * the file, see \ref CalculateAssetID.
+   */
+  void SetMeshAssetID(std::uint32_t mesh_index);
+
+  void LoadModel(const FileSystem::Path& mesh_path, const uint64_t& mesh_index,
+                 VertexFormat vertex_format);
+
+  /**
+   * \brief Whether imported meshes go through \ref OptimizeSubMesh, set by
+   * the "optimize_imported_mesh" setting, true if it is not set.
+   */
+  static bool IsOptimizeEnabled();
+
+  /**
+   * \brief Import the model file and convert all of its meshes, the bounding
+   * boxes of the meshes are computed together.
+   * \param optimize Run \ref OptimizeSubMesh on every mesh. It runs only
+   * here, the result is cooked.
+   * \return The meshes, or error if the model file can not be imported.
+   */
+  static Result<std::vector<CookedSubMesh>, ErrorResult> ImportModel(
+      const FileSystem::Path& mesh_path, VertexFormat vertex_format,
+      bool optimize, bool process_in_parallel);
+
+  /**
+   * \brief Get all meshes of the model file from its cooked file, or import
+   * and cook the model file if it has not been cooked.
+   */
+  static Result<std::vector<CookedSubMesh>, ErrorResult> LoadSubMeshes(
+      const FileSystem::Path& mesh_path, VertexFormat vertex_format,
+      bool load_in_parallel);
+
+  /**
+   * \remark A mesh without positions returns a sub-mesh with an invalid
+   * layout, so the indexes of the other meshes are kept.
+   * \remark The bounding boxes are left to \ref ImportModel.
+   */
+  static CookedSubMesh ProcessMesh(const aiMesh& mesh,
+                                   VertexFormat vertex_format);
+
+  void SetSubMesh(CookedSubMesh&& sub_mesh);
+
+  /**
+   * \brief Call \ref function with every index in [0, count), one task per
+   * index when \ref in_parallel is true.
+   */
+  static void ForEachSubMesh(std::size_t count, bool in_parallel,
+                             const std::function<void(std::size_t)>& function);
+
+  void EncodeVertices(const std::vector<Vertex>& vertices);
 
  private:
+  // Vertices converted per chunk when a mesh is converted in parallel.
+  static constexpr std::size_t kParallelVertexGrainSize = 4096;
+
   std::unique_ptr<BoundingBox> bounding_box_{nullptr};
   std::vector<uint32_t> indexes_{};
-  std::vector<Vertex> vertices_{};
+  VertexLayout vertex_layout_{};
+  std::vector<char> vertex_data_{};
 };
 }  // namespace AssetType
 }  // namespace AssetSystem
@@ -128,23 +128,26 @@ MM::AssetSystem::AssetType::Shader::LoadShader(
   }
 
   if (compiled_shader_path.GetResult().IsExists()) {
-    Result<std::vector<char>, ErrorResult> read_result =
-        MM_FILE_SYSTEM->ReadFile(compiled_shader_path.GetResult());
-    read_result.Exception(
+    Result<FileSystem::MappedFile, ErrorResult> map_result =
+        MM_FILE_SYSTEM->MapFile(compiled_shader_path.GetResult());
+    map_result.Exception(
         MM_ERROR_DESCRIPTION(Failed to read data from compiled file.));
-    if (read_result.IsSuccess()) {
-      data_ = std::move(read_result.GetResult());
+    if (map_result.IsSuccess()) {
+      const FileSystem::MappedFile &compiled_file = map_result.GetResult();
+      data_.assign(compiled_file.GetData(),
+                   compiled_file.GetData() + compiled_file.GetSize());
+      size_ = data_.size();
       return Result<Nil, ErrorResult>{st_execute_success};
     }
   }
 
-  Result<std::vector<char>, ErrorResult> shader_read_result =
-      MM_FILE_SYSTEM->ReadFile(compiled_shader_path.GetResult());
-  shader_read_result.Exception(
+  Result<FileSystem::MappedFile, ErrorResult> shader_map_result =
+      MM_FILE_SYSTEM->MapFile(shader_path);
+  shader_map_result.Exception(
       MM_ERROR_DESCRIPTION(Failed to read shader data.));
-  if (!shader_read_result.IsSuccess()) {
+  if (!shader_map_result.IsSuccess()) {
     return Result<Nil, ErrorResult>{st_execute_error,
-                                    shader_read_result.GetError()};
+                                    shader_map_result.GetError()};
   }
 
   Result<Utils::ShadercShaderKind, ErrorResult> kind =
@@ -156,14 +159,16 @@ MM::AssetSystem::AssetType::Shader::LoadShader(
 
   Result<std::vector<char>, ErrorResult> compiled_result = Utils::CompileShader(
       shader_path.CStr(), std::string("main"), kind.GetResult(),
-      shader_read_result.GetResult().data(),
-      shader_read_result.GetResult().size(), true,
+      shader_map_result.GetResult().GetData(),
+      shader_map_result.GetResult().GetSize(), true,
       shaderc_optimization_level_performance);
   compiled_result.Exception(MM_ERROR_DESCRIPTION(Failed to compile shader.));
   if (compiled_result.IsError()) {
     return Result<Nil, ErrorResult>{st_execute_error,
                                     compiled_result.GetError()};
   }
+  data_ = std::move(compiled_result.GetResult());
+  size_ = data_.size();
 
   SaveCompiledShaderToFile(compiled_shader_path.GetResult())
       .Exception(MM_WARN_DESCRIPTION(Failed to save compiled shader to file.));
@@ -1,5 +1,8 @@
 #include "runtime/resource/asset_system/asset_type/base/bounding_box.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "runtime/platform/base/error.h"
 #include "runtime/resource/asset_system/asset_type/Mesh.h"
 
@@ -48,8 +51,8 @@ MM::AssetSystem::AssetType::RectangleBox::operator=(
   left_bottom_forward_ = other.left_bottom_forward_;
   right_top_back_ = other.right_top_back_;
 
-  left_bottom_forward_ = MathDefinition::VEC3_ZERO;
-  right_top_back_ = MathDefinition::VEC3_ZERO;
+  other.left_bottom_forward_ = MathDefinition::VEC3_ZERO;
+  other.right_top_back_ = MathDefinition::VEC3_ZERO;
 
   return *this;
 }
@@ -207,34 +210,24 @@ MM::AssetSystem::AssetType::RectangleBox::UpdateBoundingBox(const Mesh& mesh) {
         st_execute_error, ErrorCode::INPUT_PARAMETERS_ARE_INCORRECT};
   }
 
-  const std::vector<Vertex>& mesh_vertices = mesh.GetVertices();
-
-  for (const auto& vertex : mesh_vertices) {
-    const Math::vec3& vertex_position = vertex.GetPosition();
-
-    if (vertex_position.x < left_bottom_forward_.x) {
-      left_bottom_forward_.x = vertex_position.x;
-    }
-    if (vertex_position.x > right_top_back_.x) {
-      right_top_back_.x = vertex_position.x;
-    }
-    if (vertex_position.y < left_bottom_forward_.y) {
-      left_bottom_forward_.y = vertex_position.y;
-    }
-    if (vertex_position.y > right_top_back_.y) {
-      right_top_back_.y = vertex_position.y;
-    }
-    if (vertex_position.z < left_bottom_forward_.z) {
-      left_bottom_forward_.z = vertex_position.z;
-    }
-    if (vertex_position.z > right_top_back_.z) {
-      right_top_back_.z = vertex_position.z;
-    }
-  }
+  UpdateBoundingBox(ComputePositionBounds(mesh.GetPositionStream()));
 
   return Result<Nil, ErrorResult>{st_execute_success};
 }
 
+void MM::AssetSystem::AssetType::RectangleBox::UpdateBoundingBox(
+    const PositionBounds& bounds) {
+  if (bounds.IsEmpty()) {
+    return;
+  }
+  left_bottom_forward_.x = std::min(left_bottom_forward_.x, bounds.min_.x);
+  left_bottom_forward_.y = std::min(left_bottom_forward_.y, bounds.min_.y);
+  left_bottom_forward_.z = std::min(left_bottom_forward_.z, bounds.min_.z);
+  right_top_back_.x = std::max(right_top_back_.x, bounds.max_.x);
+  right_top_back_.y = std::max(right_top_back_.y, bounds.max_.y);
+  right_top_back_.z = std::max(right_top_back_.z, bounds.max_.z);
+}
+
 MM::Utils::Json::Value MM::AssetSystem::AssetType::RectangleBox::GetJson(
     Utils::Json::MemoryPoolAllocator<>& allocator) const {
   MM::Utils::Json::Value output_json_data{Utils::Json::kObjectType};
@@ -357,27 +350,21 @@ MM::AssetSystem::AssetType::CapsuleBox::UpdateBoundingBox(const Mesh& mesh) {
                                     ErrorCode::INPUT_PARAMETERS_ARE_INCORRECT};
   }
 
-  const std::vector<Vertex>& mesh_vertices = mesh.GetVertices();
-
-  for (const auto& vertex : mesh_vertices) {
-    const Math::vec3& vertex_position = vertex.GetPosition();
-
-    float distance = std::sqrt(std::pow(vertex_position.x, 2) +
-                               std::pow(vertex_position.z, 2));
-    if (distance > radius_) {
-      radius_ = distance;
-    }
-    if (vertex_position.y > top_) {
-      top_ = vertex_position.y;
-    }
-    if (vertex_position.y < bottom_) {
-      bottom_ = vertex_position.y;
-    }
-  }
+  UpdateBoundingBox(ComputePositionBounds(mesh.GetPositionStream()));
 
   return Result<Nil, ErrorResult>{st_execute_success};
 }
 
+void MM::AssetSystem::AssetType::CapsuleBox::UpdateBoundingBox(
+    const PositionBounds& bounds) {
+  if (bounds.IsEmpty()) {
+    return;
+  }
+  radius_ = std::max(radius_, std::sqrt(bounds.max_radius_squared_));
+  top_ = std::max(top_, bounds.max_.y);
+  bottom_ = std::min(bottom_, bounds.min_.y);
+}
+
 MM::Utils::Json::Value MM::AssetSystem::AssetType::CapsuleBox::GetJson(
     rapidjson::MemoryPoolAllocator<>& allocator) const {
   Utils::Json::Value output_json_data{Utils::Json::kObjectType};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "runtime/core/math/math.h"
+#include "runtime/resource/asset_system/asset_type/base/bounding_volume.h"
 #include "runtime/resource/asset_system/asset_type/base/vertex.h"
 #include "utils/Json.h"
 #include "utils/error.h"
@@ -29,6 +30,12 @@ class BoundingBox {
 
   virtual Result<Nil, ErrorResult> UpdateBoundingBox(const Mesh& mesh) = 0;
 
+  /**
+   * \brief Grow the bounding box to contain \ref bounds, see \ref
+   * ComputePositionBounds.
+   */
+  virtual void UpdateBoundingBox(const PositionBounds& bounds) = 0;
+
   virtual void UpdateBoundingBoxWithOneVertex(const Vertex& vertex) = 0;
 
   virtual Utils::Json::Value GetJson(
@@ -85,6 +92,8 @@ class RectangleBox : public BoundingBox {
 
   Result<Nil, ErrorResult> UpdateBoundingBox(const Mesh& mesh) override;
 
+  void UpdateBoundingBox(const PositionBounds& bounds) override;
+
   void UpdateBoundingBoxWithOneVertex(const Vertex& vertex) override;
 
   Utils::Json::Value GetJson(
@@ -143,6 +152,8 @@ class CapsuleBox : public BoundingBox {
 
   Result<Nil, ErrorResult> UpdateBoundingBox(const Mesh& mesh) override;
 
+  void UpdateBoundingBox(const PositionBounds& bounds) override;
+
   void UpdateBoundingBoxWithOneVertex(const Vertex& vertex) override;
 
   Utils::Json::Value GetJson(
@@ -0,0 +1,325 @@
+#include "runtime/resource/asset_system/asset_type/base/bounding_volume.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include "runtime/resource/asset_system/import_other_system.h"
+
+// The AVX2 kernel is always built on x86. Unless the compiler targets AVX2
+// already, it is compiled for AVX2 on its own and only used when the CPU
+// supports it, the rest of the file keeps the baseline instruction set.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MM_BOUNDS_AVX2
+#define MM_BOUNDS_AVX2_TARGET
+#elif defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#include <immintrin.h>
+#define MM_BOUNDS_AVX2
+#define MM_BOUNDS_AVX2_DISPATCH
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define MM_BOUNDS_AVX2_TARGET
+#else
+#define MM_BOUNDS_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+#if !defined(__AVX2__) &&                                      \
+    (defined(__SSE2__) || defined(_M_X64) ||                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define MM_BOUNDS_SSE
+#endif
+
+namespace {
+using MM::AssetSystem::AssetType::PositionBounds;
+using MM::AssetSystem::AssetType::PositionStream;
+
+void UpdateBoundsScalar(const PositionStream& stream, std::size_t first,
+                        std::size_t last, PositionBounds& bounds) {
+  for (std::size_t i = first; i != last; ++i) {
+    float position[3];
+    std::memcpy(position, stream.data_ + i * stream.stride_, sizeof(position));
+    bounds.min_.x = std::min(bounds.min_.x, position[0]);
+    bounds.min_.y = std::min(bounds.min_.y, position[1]);
+    bounds.min_.z = std::min(bounds.min_.z, position[2]);
+    bounds.max_.x = std::max(bounds.max_.x, position[0]);
+    bounds.max_.y = std::max(bounds.max_.y, position[1]);
+    bounds.max_.z = std::max(bounds.max_.z, position[2]);
+    bounds.max_radius_squared_ =
+        std::max(bounds.max_radius_squared_,
+                 position[0] * position[0] + position[2] * position[2]);
+  }
+}
+
+using UpdateBoundsFunction = std::size_t (*)(const PositionStream& stream,
+                                              std::size_t first,
+                                              std::size_t last,
+                                              PositionBounds& bounds);
+
+#if defined(MM_BOUNDS_AVX2)
+MM_BOUNDS_AVX2_TARGET float ReduceMin(__m256 values) {
+  alignas(32) float lanes[8];
+  _mm256_store_ps(lanes, values);
+  return *std::min_element(lanes, lanes + 8);
+}
+
+MM_BOUNDS_AVX2_TARGET float ReduceMax(__m256 values) {
+  alignas(32) float lanes[8];
+  _mm256_store_ps(lanes, values);
+  return *std::max_element(lanes, lanes + 8);
+}
+
+/**
+ * \brief Gather the x, y and z of 8 vertices at a time.
+ */
+MM_BOUNDS_AVX2_TARGET std::size_t UpdateBoundsAvx2(const PositionStream& stream,
+                                                   std::size_t first,
+                                                   std::size_t last,
+                                                   PositionBounds& bounds) {
+  const int stride = static_cast<int>(stream.stride_);
+  const __m256i offsets =
+      _mm256_setr_epi32(0, stride, 2 * stride, 3 * stride, 4 * stride,
+                        5 * stride, 6 * stride, 7 * stride);
+  const float infinity = std::numeric_limits<float>::infinity();
+  __m256 min_x = _mm256_set1_ps(infinity), min_y = min_x, min_z = min_x;
+  __m256 max_x = _mm256_set1_ps(-infinity), max_y = max_x, max_z = max_x;
+  __m256 max_radius_squared = _mm256_setzero_ps();
+
+  std::size_t i = first;
+  for (; i + 8 <= last; i += 8) {
+    const char* vertex = stream.data_ + i * stream.stride_;
+    const __m256 x = _mm256_i32gather_ps(
+        reinterpret_cast<const float*>(vertex), offsets, 1);
+    const __m256 y = _mm256_i32gather_ps(
+        reinterpret_cast<const float*>(vertex + sizeof(float)), offsets, 1);
+    const __m256 z = _mm256_i32gather_ps(
+        reinterpret_cast<const float*>(vertex + 2 * sizeof(float)), offsets,
+        1);
+    min_x = _mm256_min_ps(min_x, x);
+    min_y = _mm256_min_ps(min_y, y);
+    min_z = _mm256_min_ps(min_z, z);
+    max_x = _mm256_max_ps(max_x, x);
+    max_y = _mm256_max_ps(max_y, y);
+    max_z = _mm256_max_ps(max_z, z);
+    max_radius_squared = _mm256_max_ps(
+        max_radius_squared,
+        _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(z, z)));
+  }
+
+  bounds.min_.x = std::min(bounds.min_.x, ReduceMin(min_x));
+  bounds.min_.y = std::min(bounds.min_.y, ReduceMin(min_y));
+  bounds.min_.z = std::min(bounds.min_.z, ReduceMin(min_z));
+  bounds.max_.x = std::max(bounds.max_.x, ReduceMax(max_x));
+  bounds.max_.y = std::max(bounds.max_.y, ReduceMax(max_y));
+  bounds.max_.z = std::max(bounds.max_.z, ReduceMax(max_z));
+  bounds.max_radius_squared_ =
+      std::max(bounds.max_radius_squared_, ReduceMax(max_radius_squared));
+
+  return i;
+}
+#endif
+
+#if defined(MM_BOUNDS_AVX2_DISPATCH)
+bool IsAvx2Supported() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int registers[4];
+  __cpuid(registers, 0);
+  if (registers[0] < 7) {
+    return false;
+  }
+  // The OS must save the YMM registers (OSXSAVE and XCR0 bits 1 and 2).
+  __cpuid(registers, 1);
+  const bool os_saves_ymm = (registers[2] & (1 << 27)) != 0 &&
+                            (registers[2] & (1 << 28)) != 0 &&
+                            (_xgetbv(0) & 0x6) == 0x6;
+  __cpuidex(registers, 7, 0);
+  return os_saves_ymm && (registers[1] & (1 << 5)) != 0;
+#else
+  // Also checks that the OS saves the YMM registers.
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#if defined(MM_BOUNDS_SSE)
+float ReduceMin(__m128 values) {
+  alignas(16) float lanes[4];
+  _mm_store_ps(lanes, values);
+  return *std::min_element(lanes, lanes + 4);
+}
+
+float ReduceMax(__m128 values) {
+  alignas(16) float lanes[4];
+  _mm_store_ps(lanes, values);
+  return *std::max_element(lanes, lanes + 4);
+}
+
+/**
+ * \brief Load 4 vertices at a time and transpose them into x, y and z.
+ * \remark A load reads 4 floats, the last vertex is left to the scalar code
+ * so the stream is never read past its end.
+ */
+std::size_t UpdateBoundsSse(const PositionStream& stream, std::size_t first,
+                            std::size_t last, PositionBounds& bounds) {
+  const float infinity = std::numeric_limits<float>::infinity();
+  __m128 min_x = _mm_set1_ps(infinity), min_y = min_x, min_z = min_x;
+  __m128 max_x = _mm_set1_ps(-infinity), max_y = max_x, max_z = max_x;
+  __m128 max_radius_squared = _mm_setzero_ps();
+
+  std::size_t i = first;
+  for (; i + 4 < last; i += 4) {
+    const char* vertex = stream.data_ + i * stream.stride_;
+    __m128 x = _mm_loadu_ps(reinterpret_cast<const float*>(vertex));
+    __m128 y =
+        _mm_loadu_ps(reinterpret_cast<const float*>(vertex + stream.stride_));
+    __m128 z = _mm_loadu_ps(
+        reinterpret_cast<const float*>(vertex + 2 * stream.stride_));
+    __m128 w = _mm_loadu_ps(
+        reinterpret_cast<const float*>(vertex + 3 * stream.stride_));
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    min_x = _mm_min_ps(min_x, x);
+    min_y = _mm_min_ps(min_y, y);
+    min_z = _mm_min_ps(min_z, z);
+    max_x = _mm_max_ps(max_x, x);
+    max_y = _mm_max_ps(max_y, y);
+    max_z = _mm_max_ps(max_z, z);
+    max_radius_squared =
+        _mm_max_ps(max_radius_squared,
+                   _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(z, z)));
+  }
+
+  bounds.min_.x = std::min(bounds.min_.x, ReduceMin(min_x));
+  bounds.min_.y = std::min(bounds.min_.y, ReduceMin(min_y));
+  bounds.min_.z = std::min(bounds.min_.z, ReduceMin(min_z));
+  bounds.max_.x = std::max(bounds.max_.x, ReduceMax(max_x));
+  bounds.max_.y = std::max(bounds.max_.y, ReduceMax(max_y));
+  bounds.max_.z = std::max(bounds.max_.z, ReduceMax(max_z));
+  bounds.max_radius_squared_ =
+      std::max(bounds.max_radius_squared_, ReduceMax(max_radius_squared));
+
+  return i;
+}
+#endif
+
+#if !defined(MM_BOUNDS_SSE)
+std::size_t UpdateBoundsNone(const PositionStream&, std::size_t first,
+                             std::size_t, PositionBounds&) {
+  return first;
+}
+#endif
+
+UpdateBoundsFunction ChooseUpdateBoundsVector() {
+#if defined(MM_BOUNDS_AVX2_DISPATCH)
+  if (IsAvx2Supported()) {
+    return UpdateBoundsAvx2;
+  }
+#elif defined(MM_BOUNDS_AVX2)
+  return UpdateBoundsAvx2;
+#endif
+#if defined(MM_BOUNDS_SSE)
+  return UpdateBoundsSse;
+#else
+  return UpdateBoundsNone;
+#endif
+}
+
+/**
+ * \brief Run the widest kernel the CPU supports on [\ref first, \ref last).
+ * \return The first vertex left to the scalar code.
+ */
+std::size_t UpdateBoundsVector(const PositionStream& stream, std::size_t first,
+                               std::size_t last, PositionBounds& bounds) {
+  static const UpdateBoundsFunction update_bounds_vector =
+      ChooseUpdateBoundsVector();
+  return update_bounds_vector(stream, first, last, bounds);
+}
+
+PositionBounds ComputeBoundsSerial(const PositionStream& stream,
+                                   std::size_t first, std::size_t last) {
+  PositionBounds bounds;
+  const std::size_t vector_last =
+      UpdateBoundsVector(stream, first, last, bounds);
+  UpdateBoundsScalar(stream, vector_last, last, bounds);
+  return bounds;
+}
+}  // namespace
+
+MM::AssetSystem::AssetType::PositionBounds::PositionBounds()
+    : min_(std::numeric_limits<float>::infinity()),
+      max_(-std::numeric_limits<float>::infinity()) {}
+
+bool MM::AssetSystem::AssetType::PositionBounds::IsEmpty() const {
+  return min_.x > max_.x;
+}
+
+void MM::AssetSystem::AssetType::PositionBounds::Merge(
+    const PositionBounds& other) {
+  min_.x = std::min(min_.x, other.min_.x);
+  min_.y = std::min(min_.y, other.min_.y);
+  min_.z = std::min(min_.z, other.min_.z);
+  max_.x = std::max(max_.x, other.max_.x);
+  max_.y = std::max(max_.y, other.max_.y);
+  max_.z = std::max(max_.z, other.max_.z);
+  max_radius_squared_ =
+      std::max(max_radius_squared_, other.max_radius_squared_);
+}
+
+MM::AssetSystem::AssetType::PositionBounds
+MM::AssetSystem::AssetType::ComputePositionBounds(const PositionStream& stream,
+                                                  bool in_parallel) {
+  if (stream.data_ == nullptr || stream.count_ == 0) {
+    return PositionBounds{};
+  }
+  assert(stream.stride_ >= 3 * sizeof(float));
+
+  if (!in_parallel || stream.count_ < kParallelBoundsVertexCount) {
+    return ComputeBoundsSerial(stream, 0, stream.count_);
+  }
+
+  const std::size_t chunk_count =
+      (stream.count_ + kParallelBoundsGrainSize - 1) / kParallelBoundsGrainSize;
+  PositionBounds bounds;
+  TaskSystem::Taskflow task_flow;
+  MM_TASK_SYSTEM->EmplaceParallelReduce(
+      TaskSystem::TaskType::Common, task_flow, 0, chunk_count, 1, bounds,
+      [&stream](std::size_t chunk) {
+        const std::size_t first = chunk * kParallelBoundsGrainSize;
+        return ComputeBoundsSerial(
+            stream, first,
+            std::min(first + kParallelBoundsGrainSize, stream.count_));
+      },
+      [](PositionBounds lhs, const PositionBounds& rhs) {
+        lhs.Merge(rhs);
+        return lhs;
+      });
+  MM_TASK_SYSTEM->RunAndWait(TaskSystem::TaskType::Common, task_flow);
+
+  return bounds;
+}
+
+std::vector<MM::AssetSystem::AssetType::PositionBounds>
+MM::AssetSystem::AssetType::ComputePositionBounds(
+    const std::vector<PositionStream>& streams, bool in_parallel) {
+  std::vector<PositionBounds> bounds(streams.size());
+  if (!in_parallel || streams.size() < 2) {
+    for (std::size_t i = 0; i != streams.size(); ++i) {
+      bounds[i] = ComputePositionBounds(streams[i], in_parallel);
+    }
+    return bounds;
+  }
+
+  // A task running a large stream waits for its chunks by running them.
+  TaskSystem::Taskflow task_flow;
+  MM_TASK_SYSTEM->EmplaceParallelFor(
+      TaskSystem::TaskType::Common, task_flow, 0, streams.size(), 1,
+      [&streams, &bounds](std::size_t i) {
+        bounds[i] = ComputePositionBounds(streams[i], true);
+      });
+  MM_TASK_SYSTEM->RunAndWait(TaskSystem::TaskType::Common, task_flow);
+
+  return bounds;
+}
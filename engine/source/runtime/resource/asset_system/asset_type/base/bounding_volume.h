@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "runtime/core/math/math.h"
+
+namespace MM {
+namespace AssetSystem {
+namespace AssetType {
+// Streams below this size are computed on the calling thread.
+constexpr std::size_t kParallelBoundsVertexCount = 1 << 18;
+// Vertices computed per chunk when a stream is computed in parallel.
+constexpr std::size_t kParallelBoundsGrainSize = 1 << 16;
+
+/**
+ * \brief The positions of an interleaved vertex stream, 3 floats at the start
+ * of every vertex, see \ref VertexLayout.
+ */
+struct PositionStream {
+  const char* data_{nullptr};
+  std::size_t count_{0};
+  // The size of one vertex in bytes, at least 3 floats.
+  std::size_t stride_{3 * sizeof(float)};
+};
+
+/**
+ * \brief Everything \ref RectangleBox and \ref CapsuleBox need from a position
+ * stream, computed in one pass.
+ * \remark The bounds of an empty stream are empty: \ref min_ is +infinity and
+ * \ref max_ is -infinity, merging them changes nothing.
+ */
+struct PositionBounds {
+  PositionBounds();
+
+  Math::vec3 min_;
+  Math::vec3 max_;
+  // The largest x * x + z * z, the square of the capsule radius.
+  float max_radius_squared_{0.0f};
+
+  bool IsEmpty() const;
+
+  void Merge(const PositionBounds& other);
+};
+
+/**
+ * \brief Compute the bounds of \ref stream.
+ * \param in_parallel Split streams of at least \ref kParallelBoundsVertexCount
+ * vertices into chunks that are computed on the task system.
+ * \remark On x86 the kernel uses AVX2 when the CPU supports it, detected at
+ * run time, and SSE otherwise. Other targets use scalar code.
+ */
+PositionBounds ComputePositionBounds(const PositionStream& stream,
+                                     bool in_parallel = true);
+
+/**
+ * \brief Compute the bounds of every stream of \ref streams, the i-th bounds
+ * belongs to the i-th stream.
+ * \param in_parallel Compute the streams in parallel on the task system, large
+ * streams are also chunked, see \ref ComputePositionBounds.
+ */
+std::vector<PositionBounds> ComputePositionBounds(
+    const std::vector<PositionStream>& streams, bool in_parallel = true);
+}  // namespace AssetType
+}  // namespace AssetSystem
+}  // namespace MM
@@ -0,0 +1,369 @@
+#include "runtime/resource/asset_system/asset_type/base/cooked_mesh.h"
+
+#ifdef MM_PLATFORM_IS_WINDOWS
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include "runtime/resource/asset_system/import_other_system.h"
+
+static_assert(std::is_trivially_copyable_v<
+                  MM::AssetSystem::AssetType::CookedMeshHeader> &&
+                  sizeof(MM::AssetSystem::AssetType::CookedMeshHeader) == 40,
+              "The layout of CookedMeshHeader is part of the file format.");
+static_assert(std::is_trivially_copyable_v<
+                  MM::AssetSystem::AssetType::CookedSubMeshHeader> &&
+                  sizeof(MM::AssetSystem::AssetType::CookedSubMeshHeader) == 72,
+              "The layout of CookedSubMeshHeader is part of the file format.");
+
+namespace {
+std::uint64_t AlignUp(std::uint64_t value) {
+  constexpr std::uint64_t alignment =
+      MM::AssetSystem::AssetType::CookedMesh::kDataAlignment;
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * \brief Check that [offset, offset + size) is in a file of \ref file_size
+ * bytes without overflowing.
+ */
+bool IsInFile(std::uint64_t offset, std::uint64_t size,
+              std::uint64_t file_size) {
+  return offset <= file_size && size <= file_size - offset;
+}
+
+std::int64_t GetProcessID() {
+#ifdef MM_PLATFORM_IS_WINDOWS
+  return _getpid();
+#else
+  return getpid();
+#endif
+}
+
+std::uint64_t GetSubMeshHeaderOffset(std::uint32_t sub_mesh_index) {
+  return sizeof(MM::AssetSystem::AssetType::CookedMeshHeader) +
+         static_cast<std::uint64_t>(sub_mesh_index) *
+             sizeof(MM::AssetSystem::AssetType::CookedSubMeshHeader);
+}
+}  // namespace
+
+MM::AssetSystem::AssetType::CookedMesh::CookedMesh(
+    FileSystem::MappedFile&& mapped_file)
+    : mapped_file_(std::move(mapped_file)) {}
+
+MM::Result<MM::FileSystem::Path, MM::ErrorResult>
+MM::AssetSystem::AssetType::CookedMesh::GetCookedPath(
+    const FileSystem::Path& source_path, VertexFormat vertex_format,
+    bool optimized) {
+  Result<FileSystem::LastWriteTime, ErrorResult> last_write_time =
+      MM_FILE_SYSTEM->GetLastWriteTime(source_path);
+  if (last_write_time.IsError()) {
+    return Result<FileSystem::Path, ErrorResult>(st_execute_error,
+                                                 last_write_time.GetError());
+  }
+
+  return Result<FileSystem::Path, ErrorResult>(
+      st_execute_success,
+      MM_FILE_SYSTEM->GetAssetDirCache() +
+          ("/" + std::to_string(source_path.GetHash()) + "_" +
+           std::to_string(static_cast<std::uint64_t>(
+               last_write_time.GetResult().time_since_epoch().count())) +
+           "_" + std::to_string(static_cast<std::uint32_t>(vertex_format)) +
+           (optimized ? "_1" : "_0") + ".mesh"));
+}
+
+MM::Result<MM::AssetSystem::AssetType::CookedMesh, MM::ErrorResult>
+MM::AssetSystem::AssetType::CookedMesh::Open(
+    const FileSystem::Path& source_path, VertexFormat vertex_format,
+    bool optimized) {
+  Result<FileSystem::Path, ErrorResult> cooked_path =
+      GetCookedPath(source_path, vertex_format, optimized);
+  if (cooked_path.IsError()) {
+    return Result<CookedMesh, ErrorResult>(st_execute_error,
+                                           cooked_path.GetError());
+  }
+
+  // A missing file is the normal case before the first cook, it is not logged.
+  Result<FileSystem::MappedFile, ErrorResult> map_result =
+      MM_FILE_SYSTEM->MapFile(cooked_path.GetResult(),
+                              FileSystem::FileAccessPattern::WILL_NEED);
+  if (map_result.IsError()) {
+    return Result<CookedMesh, ErrorResult>(st_execute_error,
+                                           map_result.GetError());
+  }
+
+  if (!CheckFile(map_result.GetResult(), source_path.GetHash())) {
+    MM_LOG_WARN(
+        "The cooked mesh file {} is corrupted, the mesh will be imported "
+        "again.",
+        cooked_path.GetResult().StringView());
+    return ResultE<ErrorResult>{ErrorCode::OBJECT_IS_INVALID};
+  }
+
+  return Result<CookedMesh, ErrorResult>(
+      st_execute_success, CookedMesh{std::move(map_result.GetResult())});
+}
+
+MM::Result<MM::Nil, MM::ErrorResult>
+MM::AssetSystem::AssetType::CookedMesh::Write(
+    const FileSystem::Path& source_path, VertexFormat vertex_format,
+    const std::vector<CookedSubMesh>& sub_meshes, bool optimized) {
+  Result<FileSystem::LastWriteTime, ErrorResult> last_write_time =
+      MM_FILE_SYSTEM->GetLastWriteTime(source_path);
+  if (last_write_time.IsError()) {
+    return ResultE<ErrorResult>{last_write_time.GetError().GetErrorCode()};
+  }
+  Result<FileSystem::Path, ErrorResult> cooked_path =
+      GetCookedPath(source_path, vertex_format, optimized);
+  if (cooked_path.IsError()) {
+    return ResultE<ErrorResult>{cooked_path.GetError().GetErrorCode()};
+  }
+
+  // Lay out the file, then write it with a single write.
+  std::vector<CookedSubMeshHeader> sub_mesh_headers(sub_meshes.size());
+  std::uint64_t file_size = AlignUp(GetSubMeshHeaderOffset(
+      static_cast<std::uint32_t>(sub_meshes.size())));
+  for (std::size_t i = 0; i != sub_meshes.size(); ++i) {
+    const CookedSubMesh& sub_mesh = sub_meshes[i];
+    CookedSubMeshHeader& sub_mesh_header = sub_mesh_headers[i];
+    std::memset(&sub_mesh_header, 0, sizeof(CookedSubMeshHeader));
+
+    if (sub_mesh.vertex_layout_.IsValid()) {
+      sub_mesh_header.vertex_attributes_ =
+          static_cast<std::uint32_t>(sub_mesh.vertex_layout_.GetAttributes());
+      sub_mesh_header.vertex_format_ =
+          static_cast<std::uint32_t>(sub_mesh.vertex_layout_.GetFormat());
+      sub_mesh_header.vertex_count_ = static_cast<std::uint32_t>(
+          sub_mesh.vertex_data_.size() / sub_mesh.vertex_layout_.GetStride());
+    }
+    sub_mesh_header.index_count_ =
+        static_cast<std::uint32_t>(sub_mesh.indexes_.size());
+
+    sub_mesh_header.vertex_data_offset_ = file_size;
+    file_size = AlignUp(file_size + sub_mesh.vertex_data_.size());
+    sub_mesh_header.index_data_offset_ = file_size;
+    file_size = AlignUp(file_size +
+                        sub_mesh.indexes_.size() * sizeof(std::uint32_t));
+
+    const Math::vec3& left_bottom_forward =
+        sub_mesh.aabb_box_.GetLeftBottomForward();
+    const Math::vec3& right_top_back = sub_mesh.aabb_box_.GetRightTopBack();
+    for (int j = 0; j != 3; ++j) {
+      sub_mesh_header.aabb_left_bottom_forward_[j] = left_bottom_forward[j];
+      sub_mesh_header.aabb_right_top_back_[j] = right_top_back[j];
+    }
+    sub_mesh_header.capsule_radius_ = sub_mesh.capsule_box_.GetRadius();
+    sub_mesh_header.capsule_top_ = sub_mesh.capsule_box_.GetTop();
+    sub_mesh_header.capsule_bottom_ = sub_mesh.capsule_box_.GetBottom();
+  }
+
+  CookedMeshHeader header;
+  std::memset(&header, 0, sizeof(CookedMeshHeader));
+  std::memcpy(header.magic_, kMagic, sizeof(kMagic));
+  header.version_ = kVersion;
+  header.sub_mesh_count_ = static_cast<std::uint32_t>(sub_meshes.size());
+  header.source_path_hash_ = source_path.GetHash();
+  header.source_last_write_time_ =
+      last_write_time.GetResult().time_since_epoch().count();
+  header.file_size_ = file_size;
+
+  std::vector<char> file_data(file_size, 0);
+  std::memcpy(file_data.data(), &header, sizeof(CookedMeshHeader));
+  for (std::size_t i = 0; i != sub_meshes.size(); ++i) {
+    const CookedSubMeshHeader& sub_mesh_header = sub_mesh_headers[i];
+    std::memcpy(file_data.data() +
+                    GetSubMeshHeaderOffset(static_cast<std::uint32_t>(i)),
+                &sub_mesh_header, sizeof(CookedSubMeshHeader));
+    if (!sub_meshes[i].vertex_data_.empty()) {
+      std::memcpy(file_data.data() + sub_mesh_header.vertex_data_offset_,
+                  sub_meshes[i].vertex_data_.data(),
+                  sub_meshes[i].vertex_data_.size());
+    }
+    if (!sub_meshes[i].indexes_.empty()) {
+      std::memcpy(file_data.data() + sub_mesh_header.index_data_offset_,
+                  sub_meshes[i].indexes_.data(),
+                  sub_meshes[i].indexes_.size() * sizeof(std::uint32_t));
+    }
+  }
+
+  const FileSystem::Path& cache_dir = MM_FILE_SYSTEM->GetAssetDirCache();
+  if (!cache_dir.IsExists()) {
+    Result<Nil, ErrorResult> create_result =
+        MM_FILE_SYSTEM->CreateDirectory(cache_dir);
+    if (create_result.IsError() && !cache_dir.IsExists()) {
+      return ResultE<ErrorResult>{create_result.GetError().GetErrorCode()};
+    }
+  }
+
+  // Several threads and processes may cook the same model, each one writes
+  // its own temporary file and the last rename wins.
+  FileSystem::Path temp_path{
+      cooked_path.GetResult() +
+      ("." + std::to_string(GetProcessID()) + "_" +
+       std::to_string(
+           std::hash<std::thread::id>{}(std::this_thread::get_id())))};
+  std::ofstream file(temp_path.CStr(),
+                     std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    return ResultE<ErrorResult>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+  file.write(file_data.data(), static_cast<std::streamsize>(file_data.size()));
+  file.close();
+  if (!file) {
+    MM_FILE_SYSTEM->Delete(temp_path);
+    return ResultE<ErrorResult>{ErrorCode::FILE_OPERATION_ERROR};
+  }
+
+  Result<Nil, ErrorResult> rename_result =
+      MM_FILE_SYSTEM->Rename(temp_path, cooked_path.GetResult());
+  if (rename_result.IsError()) {
+    MM_FILE_SYSTEM->Delete(temp_path);
+    return ResultE<ErrorResult>{rename_result.GetError().GetErrorCode()};
+  }
+
+  return ResultS<Nil>{Nil()};
+}
+
+std::uint32_t MM::AssetSystem::AssetType::CookedMesh::GetSubMeshCount() const {
+  if (!IsValid()) {
+    return 0;
+  }
+  return GetHeader().sub_mesh_count_;
+}
+
+MM::Result<MM::AssetSystem::AssetType::CookedSubMesh, MM::ErrorResult>
+MM::AssetSystem::AssetType::CookedMesh::GetSubMesh(
+    std::uint32_t sub_mesh_index) const {
+  if (sub_mesh_index >= GetSubMeshCount()) {
+    return ResultE<ErrorResult>{ErrorCode::INPUT_PARAMETERS_ARE_INCORRECT};
+  }
+
+  const CookedSubMeshHeader sub_mesh_header = GetSubMeshHeader(sub_mesh_index);
+  const char* data = mapped_file_.GetData();
+  CookedSubMesh sub_mesh;
+  if (sub_mesh_header.vertex_attributes_ !=
+      static_cast<std::uint32_t>(VertexAttribute::NONE)) {
+    sub_mesh.vertex_layout_ = VertexLayout{
+        static_cast<VertexAttribute>(sub_mesh_header.vertex_attributes_),
+        static_cast<VertexFormat>(sub_mesh_header.vertex_format_)};
+    const char* vertex_data = data + sub_mesh_header.vertex_data_offset_;
+    sub_mesh.vertex_data_.assign(
+        vertex_data,
+        vertex_data + static_cast<std::size_t>(sub_mesh_header.vertex_count_) *
+                          sub_mesh.vertex_layout_.GetStride());
+  }
+  sub_mesh.indexes_.resize(sub_mesh_header.index_count_);
+  if (!sub_mesh.indexes_.empty()) {
+    std::memcpy(sub_mesh.indexes_.data(),
+                data + sub_mesh_header.index_data_offset_,
+                sub_mesh.indexes_.size() * sizeof(std::uint32_t));
+  }
+  // Only the copied sub-mesh is checked, so opening the file stays free of
+  // parsing. An index out of range would make every user of the mesh read
+  // past its vertex data.
+  for (std::uint32_t index : sub_mesh.indexes_) {
+    if (index >= sub_mesh_header.vertex_count_) {
+      MM_LOG_WARN("The cooked sub-mesh {} has an index out of range.",
+                  sub_mesh_index);
+      return ResultE<ErrorResult>{ErrorCode::OBJECT_IS_INVALID};
+    }
+  }
+
+  const float* left_bottom_forward = sub_mesh_header.aabb_left_bottom_forward_;
+  const float* right_top_back = sub_mesh_header.aabb_right_top_back_;
+  sub_mesh.aabb_box_ = RectangleBox{
+      Math::vec3{left_bottom_forward[0], left_bottom_forward[1],
+                 left_bottom_forward[2]},
+      Math::vec3{right_top_back[0], right_top_back[1], right_top_back[2]}};
+  sub_mesh.capsule_box_.SetRadius(sub_mesh_header.capsule_radius_);
+  sub_mesh.capsule_box_.SetTop(sub_mesh_header.capsule_top_);
+  sub_mesh.capsule_box_.SetBottom(sub_mesh_header.capsule_bottom_);
+
+  return Result<CookedSubMesh, ErrorResult>(st_execute_success,
+                                            std::move(sub_mesh));
+}
+
+bool MM::AssetSystem::AssetType::CookedMesh::IsValid() const {
+  return mapped_file_.IsValid();
+}
+
+MM::AssetSystem::AssetType::CookedMeshHeader
+MM::AssetSystem::AssetType::CookedMesh::GetHeader() const {
+  CookedMeshHeader header;
+  std::memcpy(&header, mapped_file_.GetData(), sizeof(CookedMeshHeader));
+  return header;
+}
+
+MM::AssetSystem::AssetType::CookedSubMeshHeader
+MM::AssetSystem::AssetType::CookedMesh::GetSubMeshHeader(
+    std::uint32_t sub_mesh_index) const {
+  CookedSubMeshHeader sub_mesh_header;
+  std::memcpy(&sub_mesh_header,
+              mapped_file_.GetData() + GetSubMeshHeaderOffset(sub_mesh_index),
+              sizeof(CookedSubMeshHeader));
+  return sub_mesh_header;
+}
+
+bool MM::AssetSystem::AssetType::CookedMesh::CheckFile(
+    const FileSystem::MappedFile& mapped_file,
+    std::uint64_t source_path_hash) {
+  const std::uint64_t file_size = mapped_file.GetSize();
+  if (file_size < sizeof(CookedMeshHeader)) {
+    return false;
+  }
+
+  CookedMeshHeader header;
+  std::memcpy(&header, mapped_file.GetData(), sizeof(CookedMeshHeader));
+  if (std::memcmp(header.magic_, kMagic, sizeof(kMagic)) != 0 ||
+      header.version_ != kVersion ||
+      header.source_path_hash_ != source_path_hash ||
+      header.file_size_ != file_size ||
+      !IsInFile(sizeof(CookedMeshHeader),
+                static_cast<std::uint64_t>(header.sub_mesh_count_) *
+                    sizeof(CookedSubMeshHeader),
+                file_size)) {
+    return false;
+  }
+
+  for (std::uint32_t i = 0; i != header.sub_mesh_count_; ++i) {
+    CookedSubMeshHeader sub_mesh_header;
+    std::memcpy(&sub_mesh_header,
+                mapped_file.GetData() + GetSubMeshHeaderOffset(i),
+                sizeof(CookedSubMeshHeader));
+
+    std::uint64_t vertex_data_size = 0;
+    if (sub_mesh_header.vertex_attributes_ !=
+        static_cast<std::uint32_t>(VertexAttribute::NONE)) {
+      if ((sub_mesh_header.vertex_attributes_ &
+           ~static_cast<std::uint32_t>(VertexAttribute::ALL)) != 0 ||
+          sub_mesh_header.vertex_format_ >
+              static_cast<std::uint32_t>(VertexFormat::PACKED)) {
+        return false;
+      }
+      const VertexLayout vertex_layout{
+          static_cast<VertexAttribute>(sub_mesh_header.vertex_attributes_),
+          static_cast<VertexFormat>(sub_mesh_header.vertex_format_)};
+      vertex_data_size =
+          static_cast<std::uint64_t>(sub_mesh_header.vertex_count_) *
+          vertex_layout.GetStride();
+    }
+    if (!IsInFile(sub_mesh_header.vertex_data_offset_, vertex_data_size,
+                  file_size) ||
+        !IsInFile(sub_mesh_header.index_data_offset_,
+                  static_cast<std::uint64_t>(sub_mesh_header.index_count_) *
+                      sizeof(std::uint32_t),
+                  file_size)) {
+      return false;
+    }
+  }
+
+  return true;
+}
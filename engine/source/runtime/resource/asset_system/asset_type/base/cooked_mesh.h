@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "runtime/platform/base/error.h"
+#include "runtime/platform/file_system/file_system.h"
+#include "runtime/resource/asset_system/asset_type/base/bounding_box.h"
+#include "runtime/resource/asset_system/asset_type/base/vertex_layout.h"
+
+namespace MM {
+namespace AssetSystem {
+namespace AssetType {
+/**
+ * \brief A sub-mesh of a model file, ready to be used by \ref Mesh.
+ */
+struct CookedSubMesh {
+  VertexLayout vertex_layout_{};
+  std::vector<char> vertex_data_{};
+  std::vector<std::uint32_t> indexes_{};
+  RectangleBox aabb_box_{};
+  CapsuleBox capsule_box_{};
+};
+
+/**
+ * \brief The header at the start of a cooked mesh file.
+ * \remark A cooked mesh file is laid out as:
+ * CookedMeshHeader
+ * CookedSubMeshHeader[sub_mesh_count_]
+ * the vertices and the indexes of every sub-mesh.
+ * The data of the sub-meshes is aligned to \ref CookedMesh::kDataAlignment, so
+ * a mapped file can be read in place. Everything is stored in the byte order of
+ * the machine that cooked it, cooked files are not meant to be shipped.
+ */
+struct CookedMeshHeader {
+  char magic_[8];
+  std::uint32_t version_;
+  std::uint32_t sub_mesh_count_;
+  std::uint64_t source_path_hash_;
+  std::int64_t source_last_write_time_;
+  std::uint64_t file_size_;
+};
+
+struct CookedSubMeshHeader {
+  std::uint32_t vertex_attributes_;
+  std::uint32_t vertex_format_;
+  std::uint32_t vertex_count_;
+  std::uint32_t index_count_;
+  // Offsets from the start of the file.
+  std::uint64_t vertex_data_offset_;
+  std::uint64_t index_data_offset_;
+  float aabb_left_bottom_forward_[3];
+  float aabb_right_top_back_[3];
+  float capsule_radius_;
+  float capsule_top_;
+  float capsule_bottom_;
+  std::uint32_t reserved_;
+};
+
+/**
+ * \brief Binary cache of every sub-mesh of a model file, so that loading a
+ * mesh again does not import the model.
+ * \remark A cooked file is stored under \ref FileSystem::GetAssetDirCache,
+ * named after the path and the last write time of the model file, the vertex
+ * format and whether the meshes are optimized, so a modified model is cooked
+ * again.
+ * \remark Opening a cooked file maps it and checks its header, nothing is
+ * parsed.
+ */
+class CookedMesh {
+ public:
+  static constexpr char kMagic[8] = "MMMESH";
+  /**
+   * \remark Increase it whenever the layout of the file, the vertex encoding or
+   * the import options of \ref Mesh change, so stale files are cooked again.
+   */
+  static constexpr std::uint32_t kVersion = 2;
+  static constexpr std::uint64_t kDataAlignment = 16;
+
+ public:
+  CookedMesh() = default;
+  ~CookedMesh() = default;
+  CookedMesh(const CookedMesh& other) = delete;
+  CookedMesh(CookedMesh&& other) noexcept = default;
+  CookedMesh& operator=(const CookedMesh& other) = delete;
+  CookedMesh& operator=(CookedMesh&& other) noexcept = default;
+
+ public:
+  /**
+   * \brief Get the path of the cooked file of \ref source_path.
+   * \return The path, or error if the last write time of \ref source_path
+   * can not be read.
+   */
+  static Result<FileSystem::Path, ErrorResult> GetCookedPath(
+      const FileSystem::Path& source_path, VertexFormat vertex_format,
+      bool optimized = true);
+
+  /**
+   * \brief Map the cooked file of \ref source_path.
+   * \return The cooked mesh, FILE_IS_NOT_EXIST if the model has not been
+   * cooked, or OBJECT_IS_INVALID if the cooked file is corrupted.
+   */
+  static Result<CookedMesh, ErrorResult> Open(
+      const FileSystem::Path& source_path, VertexFormat vertex_format,
+      bool optimized = true);
+
+  /**
+   * \brief Write the cooked file of \ref source_path.
+   * \remark The file is written to a temporary file first and renamed, readers
+   * never see a partial file.
+   * \param optimized Whether \ref sub_meshes went through \ref
+   * OptimizeSubMesh.
+   */
+  static Result<Nil, ErrorResult> Write(
+      const FileSystem::Path& source_path, VertexFormat vertex_format,
+      const std::vector<CookedSubMesh>& sub_meshes, bool optimized = true);
+
+  std::uint32_t GetSubMeshCount() const;
+
+  /**
+   * \brief Copy a sub-mesh out of the mapped file.
+   * \return The sub-mesh, INPUT_PARAMETERS_ARE_INCORRECT if \ref
+   * sub_mesh_index is out of range, or OBJECT_IS_INVALID if one of its indexes
+   * refers to no vertex.
+   */
+  Result<CookedSubMesh, ErrorResult> GetSubMesh(
+      std::uint32_t sub_mesh_index) const;
+
+  bool IsValid() const;
+
+ private:
+  explicit CookedMesh(FileSystem::MappedFile&& mapped_file);
+
+  CookedMeshHeader GetHeader() const;
+
+  CookedSubMeshHeader GetSubMeshHeader(std::uint32_t sub_mesh_index) const;
+
+  /**
+   * \brief Check that every offset and size of the file is in range. The
+   * indexes are checked by \ref GetSubMesh.
+   */
+  static bool CheckFile(const FileSystem::MappedFile& mapped_file,
+                        std::uint64_t source_path_hash);
+
+ private:
+  FileSystem::MappedFile mapped_file_{};
+};
+}  // namespace AssetType
+}  // namespace AssetSystem
+}  // namespace MM
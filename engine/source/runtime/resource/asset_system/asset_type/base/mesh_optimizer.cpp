@@ -0,0 +1,378 @@
+#include "runtime/resource/asset_system/asset_type/base/mesh_optimizer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+constexpr std::uint32_t kUnusedVertex = std::numeric_limits<std::uint32_t>::max();
+
+/**
+ * \brief Simulate a FIFO post-transform cache with time stamps, a vertex is in
+ * the cache if less than \ref cache_size_ vertices were added after it.
+ */
+class FifoCache {
+ public:
+  FifoCache(std::size_t vertex_count, std::uint32_t cache_size)
+      : cache_size_(cache_size),
+        time_(cache_size + 1),
+        vertex_times_(vertex_count, 0) {}
+
+ public:
+  bool IsCached(std::uint32_t vertex) const {
+    return time_ - vertex_times_[vertex] <= cache_size_;
+  }
+
+  /**
+   * \return 1 if \ref vertex is missing and added, 0 otherwise.
+   */
+  std::size_t Access(std::uint32_t vertex) {
+    if (IsCached(vertex)) {
+      return 0;
+    }
+    vertex_times_[vertex] = time_++;
+    return 1;
+  }
+
+  std::size_t AccessTriangle(const std::uint32_t* triangle) {
+    return Access(triangle[0]) + Access(triangle[1]) + Access(triangle[2]);
+  }
+
+  std::size_t GetAge(std::uint32_t vertex) const {
+    return time_ - vertex_times_[vertex];
+  }
+
+  void Clear() { time_ += cache_size_ + 1; }
+
+ private:
+  std::size_t cache_size_;
+  std::size_t time_;
+  std::vector<std::size_t> vertex_times_;
+};
+
+MM::Math::vec3 ReadPosition(
+    const MM::AssetSystem::AssetType::PositionStream& positions,
+    std::uint32_t vertex) {
+  float position[3];
+  std::memcpy(position, positions.data_ + vertex * positions.stride_,
+              sizeof(position));
+  return MM::Math::vec3{position[0], position[1], position[2]};
+}
+
+/**
+ * \brief Split [first, last) wherever the cache miss ratio of the triangles
+ * since the last split is within \ref threshold of the ratio of the range.
+ */
+void SplitCluster(const std::vector<std::uint32_t>& indexes, std::size_t first,
+                  std::size_t last, float threshold, FifoCache& cache,
+                  std::vector<std::size_t>& cluster_starts) {
+  cache.Clear();
+  std::size_t misses = 0;
+  for (std::size_t i = first; i != last; ++i) {
+    misses += cache.AccessTriangle(indexes.data() + i * 3);
+  }
+  const float split_ratio =
+      threshold * static_cast<float>(misses) / static_cast<float>(last - first);
+
+  cache.Clear();
+  cluster_starts.push_back(first);
+  std::size_t cluster_first = first, cluster_misses = 0;
+  for (std::size_t i = first; i != last; ++i) {
+    cluster_misses += cache.AccessTriangle(indexes.data() + i * 3);
+    if (i + 1 != last &&
+        static_cast<float>(cluster_misses) <=
+            split_ratio * static_cast<float>(i + 1 - cluster_first)) {
+      cluster_starts.push_back(i + 1);
+      cluster_first = i + 1;
+      cluster_misses = 0;
+      cache.Clear();
+    }
+  }
+}
+}  // namespace
+
+float MM::AssetSystem::AssetType::GetAverageCacheMissRatio(
+    const std::vector<std::uint32_t>& indexes, std::size_t vertex_count,
+    std::uint32_t cache_size) {
+  const std::size_t triangle_count = indexes.size() / 3;
+  if (triangle_count == 0) {
+    return 0.0f;
+  }
+
+  FifoCache cache{vertex_count, cache_size};
+  std::size_t misses = 0;
+  for (std::size_t i = 0; i != triangle_count; ++i) {
+    misses += cache.AccessTriangle(indexes.data() + i * 3);
+  }
+
+  return static_cast<float>(misses) / static_cast<float>(triangle_count);
+}
+
+void MM::AssetSystem::AssetType::DeduplicateVertices(
+    std::size_t stride, std::vector<char>& vertex_data,
+    std::vector<std::uint32_t>& indexes) {
+  const std::size_t vertex_count = vertex_data.size() / stride;
+  std::vector<std::uint32_t> remap(vertex_count, kUnusedVertex);
+  std::unordered_map<std::string_view, std::uint32_t> unique_vertices;
+  unique_vertices.reserve(vertex_count);
+  std::vector<char> unique_vertex_data;
+  unique_vertex_data.reserve(vertex_data.size());
+
+  for (std::uint32_t& index : indexes) {
+    if (remap[index] == kUnusedVertex) {
+      const std::string_view vertex{vertex_data.data() + index * stride,
+                                    stride};
+      auto insert_result = unique_vertices.emplace(
+          vertex, static_cast<std::uint32_t>(unique_vertices.size()));
+      if (insert_result.second) {
+        unique_vertex_data.insert(unique_vertex_data.end(), vertex.begin(),
+                                  vertex.end());
+      }
+      remap[index] = insert_result.first->second;
+    }
+    index = remap[index];
+  }
+
+  // The keys point into vertex_data.
+  unique_vertices.clear();
+  vertex_data = std::move(unique_vertex_data);
+}
+
+std::vector<std::size_t> MM::AssetSystem::AssetType::OptimizeVertexCache(
+    std::vector<std::uint32_t>& indexes, std::size_t vertex_count,
+    std::uint32_t cache_size) {
+  const std::size_t triangle_count = indexes.size() / 3;
+  std::vector<std::size_t> cluster_starts;
+  if (triangle_count == 0) {
+    return cluster_starts;
+  }
+
+  // The triangles of every vertex, and how many of them are not emitted.
+  std::vector<std::uint32_t> live_triangle_counts(vertex_count, 0);
+  for (std::uint32_t index : indexes) {
+    ++live_triangle_counts[index];
+  }
+  std::vector<std::size_t> adjacency_offsets(vertex_count + 1, 0);
+  for (std::size_t i = 0; i != vertex_count; ++i) {
+    adjacency_offsets[i + 1] = adjacency_offsets[i] + live_triangle_counts[i];
+  }
+  std::vector<std::uint32_t> adjacency(indexes.size());
+  {
+    std::vector<std::size_t> fill_offsets(adjacency_offsets.begin(),
+                                          adjacency_offsets.end() - 1);
+    for (std::size_t i = 0; i != indexes.size(); ++i) {
+      adjacency[fill_offsets[indexes[i]]++] = static_cast<std::uint32_t>(i / 3);
+    }
+  }
+
+  FifoCache cache{vertex_count, cache_size};
+  std::vector<bool> emitted(triangle_count, false);
+  std::vector<std::uint32_t> dead_end_stack, candidates;
+  std::vector<std::uint32_t> output;
+  output.reserve(indexes.size());
+  std::size_t scan_cursor = 0;
+
+  auto skip_dead_end = [&]() -> std::uint32_t {
+    while (!dead_end_stack.empty()) {
+      const std::uint32_t vertex = dead_end_stack.back();
+      dead_end_stack.pop_back();
+      if (live_triangle_counts[vertex] != 0) {
+        return vertex;
+      }
+    }
+    for (; scan_cursor != vertex_count; ++scan_cursor) {
+      if (live_triangle_counts[scan_cursor] != 0) {
+        return static_cast<std::uint32_t>(scan_cursor);
+      }
+    }
+    return kUnusedVertex;
+  };
+
+  std::uint32_t fanning_vertex = skip_dead_end();
+  while (fanning_vertex != kUnusedVertex) {
+    // Emit the remaining triangles around the fanning vertex.
+    candidates.clear();
+    for (std::size_t i = adjacency_offsets[fanning_vertex];
+         i != adjacency_offsets[fanning_vertex + 1]; ++i) {
+      const std::uint32_t triangle = adjacency[i];
+      if (emitted[triangle]) {
+        continue;
+      }
+      for (std::size_t j = 0; j != 3; ++j) {
+        const std::uint32_t vertex = indexes[triangle * 3 + j];
+        output.push_back(vertex);
+        dead_end_stack.push_back(vertex);
+        candidates.push_back(vertex);
+        --live_triangle_counts[vertex];
+        cache.Access(vertex);
+      }
+      emitted[triangle] = true;
+    }
+
+    // Fan next around the oldest candidate that stays in the cache while its
+    // triangles are emitted.
+    std::uint32_t next_vertex = kUnusedVertex;
+    std::size_t best_priority = 0;
+    for (std::uint32_t vertex : candidates) {
+      if (live_triangle_counts[vertex] == 0) {
+        continue;
+      }
+      std::size_t priority = 1;
+      if (cache.GetAge(vertex) + 2 * live_triangle_counts[vertex] <=
+          cache_size) {
+        priority += cache.GetAge(vertex);
+      }
+      if (priority > best_priority) {
+        best_priority = priority;
+        next_vertex = vertex;
+      }
+    }
+    if (next_vertex == kUnusedVertex) {
+      next_vertex = skip_dead_end();
+      if (next_vertex != kUnusedVertex) {
+        cluster_starts.push_back(output.size() / 3);
+      }
+    }
+    fanning_vertex = next_vertex;
+  }
+
+  if (cluster_starts.empty() || cluster_starts.front() != 0) {
+    cluster_starts.insert(cluster_starts.begin(), 0);
+  }
+  indexes = std::move(output);
+
+  return cluster_starts;
+}
+
+void MM::AssetSystem::AssetType::OptimizeOverdraw(
+    std::vector<std::uint32_t>& indexes,
+    const std::vector<std::size_t>& cluster_starts,
+    const PositionStream& positions, std::uint32_t cache_size,
+    float threshold) {
+  const std::size_t triangle_count = indexes.size() / 3;
+  if (triangle_count < 2 || cluster_starts.empty()) {
+    return;
+  }
+
+  FifoCache cache{positions.count_, cache_size};
+  std::vector<std::size_t> soft_cluster_starts;
+  for (std::size_t i = 0; i != cluster_starts.size(); ++i) {
+    const std::size_t last = i + 1 == cluster_starts.size()
+                                 ? triangle_count
+                                 : cluster_starts[i + 1];
+    if (cluster_starts[i] < last) {
+      SplitCluster(indexes, cluster_starts[i], last, threshold, cache,
+                   soft_cluster_starts);
+    }
+  }
+  if (soft_cluster_starts.size() < 2) {
+    return;
+  }
+
+  // The centroid and the normal of every cluster, weighted by the area.
+  struct Cluster {
+    std::size_t first_;
+    std::size_t last_;
+    float sort_key_;
+  };
+  std::vector<Cluster> clusters(soft_cluster_starts.size());
+  std::vector<Math::vec3> centroids(clusters.size()), normals(clusters.size());
+  std::vector<float> areas(clusters.size(), 0.0f);
+  Math::vec3 mesh_centroid{0.0f};
+  float mesh_area = 0.0f;
+  for (std::size_t i = 0; i != clusters.size(); ++i) {
+    clusters[i].first_ = soft_cluster_starts[i];
+    clusters[i].last_ = i + 1 == clusters.size() ? triangle_count
+                                                 : soft_cluster_starts[i + 1];
+    Math::vec3 centroid{0.0f}, normal{0.0f};
+    float area = 0.0f;
+    for (std::size_t j = clusters[i].first_; j != clusters[i].last_; ++j) {
+      const Math::vec3 p0 = ReadPosition(positions, indexes[j * 3]),
+                       p1 = ReadPosition(positions, indexes[j * 3 + 1]),
+                       p2 = ReadPosition(positions, indexes[j * 3 + 2]);
+      const Math::vec3 triangle_normal = Math::cross(p1 - p0, p2 - p0);
+      const float triangle_area = Math::length(triangle_normal);
+      centroid += (p0 + p1 + p2) * (triangle_area / 3.0f);
+      normal += triangle_normal;
+      area += triangle_area;
+    }
+    centroids[i] = centroid;
+    normals[i] = normal;
+    areas[i] = area;
+    mesh_centroid += centroid;
+    mesh_area += area;
+  }
+  if (mesh_area == 0.0f) {
+    return;
+  }
+  mesh_centroid /= mesh_area;
+
+  for (std::size_t i = 0; i != clusters.size(); ++i) {
+    const float normal_length = Math::length(normals[i]);
+    clusters[i].sort_key_ =
+        areas[i] == 0.0f || normal_length == 0.0f
+            ? 0.0f
+            : Math::dot(centroids[i] / areas[i] - mesh_centroid,
+                        normals[i] / normal_length);
+  }
+  std::stable_sort(clusters.begin(), clusters.end(),
+                   [](const Cluster& lhs, const Cluster& rhs) {
+                     return lhs.sort_key_ > rhs.sort_key_;
+                   });
+
+  std::vector<std::uint32_t> output;
+  output.reserve(indexes.size());
+  for (const Cluster& cluster : clusters) {
+    output.insert(output.end(), indexes.begin() + cluster.first_ * 3,
+                  indexes.begin() + cluster.last_ * 3);
+  }
+  indexes = std::move(output);
+}
+
+void MM::AssetSystem::AssetType::OptimizeVertexFetch(
+    std::size_t stride, std::vector<char>& vertex_data,
+    std::vector<std::uint32_t>& indexes) {
+  const std::size_t vertex_count = vertex_data.size() / stride;
+  std::vector<std::uint32_t> remap(vertex_count, kUnusedVertex);
+  std::vector<char> ordered_vertex_data;
+  ordered_vertex_data.reserve(vertex_data.size());
+  std::uint32_t next_vertex = 0;
+
+  for (std::uint32_t& index : indexes) {
+    if (remap[index] == kUnusedVertex) {
+      remap[index] = next_vertex++;
+      ordered_vertex_data.insert(ordered_vertex_data.end(),
+                                 vertex_data.begin() + index * stride,
+                                 vertex_data.begin() + (index + 1) * stride);
+    }
+    index = remap[index];
+  }
+
+  vertex_data = std::move(ordered_vertex_data);
+}
+
+MM::Result<MM::Nil, MM::ErrorResult>
+MM::AssetSystem::AssetType::OptimizeSubMesh(CookedSubMesh& sub_mesh) {
+  if (!sub_mesh.vertex_layout_.IsValid() || sub_mesh.indexes_.size() % 3 != 0) {
+    return ResultE<ErrorResult>{ErrorCode::INPUT_PARAMETERS_ARE_INCORRECT};
+  }
+  const std::size_t stride = sub_mesh.vertex_layout_.GetStride();
+  const std::size_t vertex_count = sub_mesh.vertex_data_.size() / stride;
+  for (std::uint32_t index : sub_mesh.indexes_) {
+    if (index >= vertex_count) {
+      return ResultE<ErrorResult>{ErrorCode::INPUT_PARAMETERS_ARE_INCORRECT};
+    }
+  }
+
+  DeduplicateVertices(stride, sub_mesh.vertex_data_, sub_mesh.indexes_);
+  const PositionStream positions{sub_mesh.vertex_data_.data(),
+                                 sub_mesh.vertex_data_.size() / stride, stride};
+  const std::vector<std::size_t> cluster_starts =
+      OptimizeVertexCache(sub_mesh.indexes_, positions.count_);
+  OptimizeOverdraw(sub_mesh.indexes_, cluster_starts, positions);
+  OptimizeVertexFetch(stride, sub_mesh.vertex_data_, sub_mesh.indexes_);
+
+  return ResultS<Nil>{Nil()};
+}
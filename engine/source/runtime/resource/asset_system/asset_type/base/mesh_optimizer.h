@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "runtime/platform/base/error.h"
+#include "runtime/resource/asset_system/asset_type/base/bounding_volume.h"
+#include "runtime/resource/asset_system/asset_type/base/cooked_mesh.h"
+
+namespace MM {
+namespace AssetSystem {
+namespace AssetType {
+// The number of vertices of the post-transform cache that is optimized for.
+constexpr std::uint32_t kVertexCacheSize = 16;
+// A cluster is split once its cache miss ratio is within this factor of the
+// ratio of the whole cluster, smaller values keep the clusters larger.
+constexpr float kOverdrawThreshold = 1.05f;
+
+/**
+ * \brief Get the number of vertices transformed per triangle when \ref indexes
+ * are drawn with a FIFO cache of \ref cache_size vertices.
+ * \remark It is between 0.5 for a large regular grid and 3.
+ */
+float GetAverageCacheMissRatio(const std::vector<std::uint32_t>& indexes,
+                               std::size_t vertex_count,
+                               std::uint32_t cache_size = kVertexCacheSize);
+
+/**
+ * \brief Merge the vertices whose encoded data is identical.
+ * \remark The vertices that are left keep the order of their first
+ * occurrence, the vertices that no index refers to are dropped.
+ */
+void DeduplicateVertices(std::size_t stride, std::vector<char>& vertex_data,
+                         std::vector<std::uint32_t>& indexes);
+
+/**
+ * \brief Reorder the triangles for the post-transform cache with Tipsify
+ * (Sander et al. 2007), in linear time.
+ * \return The first triangle of every run of triangles that starts with an
+ * empty cache, see \ref OptimizeOverdraw.
+ */
+std::vector<std::size_t> OptimizeVertexCache(
+    std::vector<std::uint32_t>& indexes, std::size_t vertex_count,
+    std::uint32_t cache_size = kVertexCacheSize);
+
+/**
+ * \brief Split the triangles into clusters and draw the clusters that face
+ * away from the center of the mesh first, so the mesh occludes more of itself.
+ * \param cluster_starts The result of \ref OptimizeVertexCache, the clusters
+ * are split further as long as the cache miss ratio grows by less than \ref
+ * threshold.
+ * \remark The order of the triangles in a cluster is kept.
+ */
+void OptimizeOverdraw(std::vector<std::uint32_t>& indexes,
+                      const std::vector<std::size_t>& cluster_starts,
+                      const PositionStream& positions,
+                      std::uint32_t cache_size = kVertexCacheSize,
+                      float threshold = kOverdrawThreshold);
+
+/**
+ * \brief Reorder the vertices in the order the indexes first use them, so the
+ * vertex fetch reads memory sequentially.
+ * \remark The vertices that no index refers to are dropped.
+ */
+void OptimizeVertexFetch(std::size_t stride, std::vector<char>& vertex_data,
+                         std::vector<std::uint32_t>& indexes);
+
+/**
+ * \brief Run \ref DeduplicateVertices, \ref OptimizeVertexCache, \ref
+ * OptimizeOverdraw and \ref OptimizeVertexFetch on \ref sub_mesh.
+ * \return INPUT_PARAMETERS_ARE_INCORRECT if the layout is invalid or the
+ * indexes are not triangles of the vertices, \ref sub_mesh is not modified.
+ * \remark The bounding boxes are not updated.
+ */
+Result<Nil, ErrorResult> OptimizeSubMesh(CookedSubMesh& sub_mesh);
+}  // namespace AssetType
+}  // namespace AssetSystem
+}  // namespace MM
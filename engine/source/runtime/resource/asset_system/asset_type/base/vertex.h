@@ -6,6 +6,11 @@
 namespace MM {
 namespace AssetSystem {
 namespace AssetType {
+/**
+ * \brief A decoded vertex.
+ * \remark Meshes do not store Vertex, they store only the attributes they have,
+ * encoded as described by a \ref VertexLayout.
+ */
 class Vertex {
  public:
   Vertex() = default;
@@ -65,12 +70,11 @@ class Vertex {
   constexpr static std::uint32_t GetOffsetOfTextureCoord();
 
  private:
-  // Memory alignment for shader reading.
   Math::vec3 position_{MathDefinition::VEC3_ZERO};
-  alignas(16) Math::vec2 texture_coord_{MathDefinition::VEC2_ZERO};
-  alignas(16) Math::vec3 normal_{MathDefinition::VEC3_ZERO};
-  alignas(16) Math::vec3 tangent_{MathDefinition::VEC3_ZERO};
-  alignas(16) Math::vec3 bi_tangent_{MathDefinition::VEC3_ZERO};
+  Math::vec2 texture_coord_{MathDefinition::VEC2_ZERO};
+  Math::vec3 normal_{MathDefinition::VEC3_ZERO};
+  Math::vec3 tangent_{MathDefinition::VEC3_ZERO};
+  Math::vec3 bi_tangent_{MathDefinition::VEC3_ZERO};
 };
 }  // namespace AssetType
 }  // namespace AssetSystem
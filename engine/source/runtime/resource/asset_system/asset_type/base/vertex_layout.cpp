@@ -0,0 +1,303 @@
+#include "runtime/resource/asset_system/asset_type/base/vertex_layout.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace {
+float SignNotZero(float value) { return value < 0.0f ? -1.0f : 1.0f; }
+
+/**
+ * \brief Map a normalized vector onto the octahedron |x|+|y|+|z|=1 and unfold
+ * it into the square [-1, 1]^2.
+ */
+MM::Math::vec2 OctahedralEncode(const MM::Math::vec3& vector) {
+  const float l1_norm =
+      std::abs(vector.x) + std::abs(vector.y) + std::abs(vector.z);
+  if (l1_norm == 0.0f) {
+    return MM::Math::vec2{0.0f, 0.0f};
+  }
+  MM::Math::vec2 result{vector.x / l1_norm, vector.y / l1_norm};
+  if (vector.z < 0.0f) {
+    result = MM::Math::vec2{(1.0f - std::abs(result.y)) * SignNotZero(result.x),
+                            (1.0f - std::abs(result.x)) * SignNotZero(result.y)};
+  }
+  return result;
+}
+
+MM::Math::vec3 OctahedralDecode(const MM::Math::vec2& encoded) {
+  MM::Math::vec3 result{encoded.x, encoded.y,
+                        1.0f - std::abs(encoded.x) - std::abs(encoded.y)};
+  if (result.z < 0.0f) {
+    const float x = result.x;
+    result.x = (1.0f - std::abs(result.y)) * SignNotZero(x);
+    result.y = (1.0f - std::abs(x)) * SignNotZero(result.y);
+  }
+  return MM::Math::Normalize(result);
+}
+
+// Math::vec* may be padded, the attributes are copied component by component.
+void WriteFloats(const float* values, std::uint32_t count, char* destination) {
+  std::memcpy(destination, values, count * sizeof(float));
+}
+
+void ReadFloats(const char* source, std::uint32_t count, float* values) {
+  std::memcpy(values, source, count * sizeof(float));
+}
+
+void WriteUint32(std::uint32_t value, char* destination) {
+  std::memcpy(destination, &value, sizeof(std::uint32_t));
+}
+
+std::uint32_t ReadUint32(const char* source) {
+  std::uint32_t value;
+  std::memcpy(&value, source, sizeof(std::uint32_t));
+  return value;
+}
+}  // namespace
+
+MM::AssetSystem::AssetType::VertexAttribute
+MM::AssetSystem::AssetType::operator|(const VertexAttribute& lhs,
+                                      const VertexAttribute& rhs) {
+  return static_cast<VertexAttribute>(static_cast<std::uint32_t>(lhs) |
+                                      static_cast<std::uint32_t>(rhs));
+}
+
+MM::AssetSystem::AssetType::VertexAttribute&
+MM::AssetSystem::AssetType::operator|=(VertexAttribute& lhs,
+                                       const VertexAttribute& rhs) {
+  lhs = lhs | rhs;
+  return lhs;
+}
+
+MM::AssetSystem::AssetType::VertexAttribute
+MM::AssetSystem::AssetType::operator&(const VertexAttribute& lhs,
+                                      const VertexAttribute& rhs) {
+  return static_cast<VertexAttribute>(static_cast<std::uint32_t>(lhs) &
+                                      static_cast<std::uint32_t>(rhs));
+}
+
+MM::AssetSystem::AssetType::VertexAttribute&
+MM::AssetSystem::AssetType::operator&=(VertexAttribute& lhs,
+                                       const VertexAttribute& rhs) {
+  lhs = lhs & rhs;
+  return lhs;
+}
+
+MM::AssetSystem::AssetType::VertexAttribute
+MM::AssetSystem::AssetType::operator~(const VertexAttribute& attribute) {
+  return static_cast<VertexAttribute>(~static_cast<std::uint32_t>(attribute)) &
+         VertexAttribute::ALL;
+}
+
+MM::AssetSystem::AssetType::VertexLayout::VertexLayout(
+    VertexAttribute attributes, VertexFormat format)
+    : attributes_((attributes & VertexAttribute::ALL) |
+                  VertexAttribute::POSITION),
+      format_(format) {
+  if (!HaveAttribute(VertexAttribute::NORMAL)) {
+    attributes_ &= ~VertexAttribute::TANGENT;
+  }
+  const bool is_packed = format_ == VertexFormat::PACKED;
+  stride_ = 3 * sizeof(float);
+  if (HaveAttribute(VertexAttribute::TEXTURE_COORD)) {
+    texture_coord_offset_ = stride_;
+    stride_ += is_packed ? sizeof(std::uint32_t) : 2 * sizeof(float);
+  }
+  if (HaveAttribute(VertexAttribute::NORMAL)) {
+    normal_offset_ = stride_;
+    stride_ += is_packed ? sizeof(std::uint32_t) : 3 * sizeof(float);
+  }
+  if (HaveAttribute(VertexAttribute::TANGENT)) {
+    tangent_offset_ = stride_;
+    stride_ += is_packed ? 2 * sizeof(std::uint32_t) : 4 * sizeof(float);
+  }
+}
+
+bool MM::AssetSystem::AssetType::operator==(const VertexLayout& lhs,
+                                            const VertexLayout& rhs) {
+  return lhs.attributes_ == rhs.attributes_ && lhs.format_ == rhs.format_;
+}
+
+bool MM::AssetSystem::AssetType::operator!=(const VertexLayout& lhs,
+                                            const VertexLayout& rhs) {
+  return !(lhs == rhs);
+}
+
+MM::AssetSystem::AssetType::VertexAttribute
+MM::AssetSystem::AssetType::VertexLayout::GetAttributes() const {
+  return attributes_;
+}
+
+MM::AssetSystem::AssetType::VertexFormat
+MM::AssetSystem::AssetType::VertexLayout::GetFormat() const {
+  return format_;
+}
+
+bool MM::AssetSystem::AssetType::VertexLayout::HaveAttribute(
+    VertexAttribute attribute) const {
+  return attribute != VertexAttribute::NONE &&
+         (attributes_ & attribute) == attribute;
+}
+
+std::uint32_t MM::AssetSystem::AssetType::VertexLayout::GetStride() const {
+  return stride_;
+}
+
+std::uint32_t MM::AssetSystem::AssetType::VertexLayout::GetOffset(
+    VertexAttribute attribute) const {
+  assert(HaveAttribute(attribute));
+  switch (attribute) {
+    case VertexAttribute::TEXTURE_COORD:
+      return texture_coord_offset_;
+    case VertexAttribute::NORMAL:
+      return normal_offset_;
+    case VertexAttribute::TANGENT:
+      return tangent_offset_;
+    default:
+      return 0;
+  }
+}
+
+void MM::AssetSystem::AssetType::VertexLayout::EncodePosition(
+    const Math::vec3& position, char* vertex) const {
+  const float values[3]{position.x, position.y, position.z};
+  WriteFloats(values, 3, vertex);
+}
+
+void MM::AssetSystem::AssetType::VertexLayout::EncodeTextureCoord(
+    const Math::vec2& texture_coord, char* vertex) const {
+  assert(HaveAttribute(VertexAttribute::TEXTURE_COORD));
+  if (format_ == VertexFormat::PACKED) {
+    WriteUint32(Math::packHalf2x16(texture_coord),
+                vertex + texture_coord_offset_);
+    return;
+  }
+  const float values[2]{texture_coord.x, texture_coord.y};
+  WriteFloats(values, 2, vertex + texture_coord_offset_);
+}
+
+void MM::AssetSystem::AssetType::VertexLayout::EncodeNormal(
+    const Math::vec3& normal, char* vertex) const {
+  assert(HaveAttribute(VertexAttribute::NORMAL));
+  if (format_ == VertexFormat::PACKED) {
+    WriteUint32(Math::packSnorm2x16(OctahedralEncode(normal)),
+                vertex + normal_offset_);
+    return;
+  }
+  const float values[3]{normal.x, normal.y, normal.z};
+  WriteFloats(values, 3, vertex + normal_offset_);
+}
+
+void MM::AssetSystem::AssetType::VertexLayout::EncodeTangent(
+    const Math::vec3& tangent, float bi_tangent_sign, char* vertex) const {
+  assert(HaveAttribute(VertexAttribute::TANGENT));
+  const float sign = SignNotZero(bi_tangent_sign);
+  if (format_ == VertexFormat::PACKED) {
+    WriteUint32(Math::packSnorm2x16(OctahedralEncode(tangent)),
+                vertex + tangent_offset_);
+    WriteUint32(Math::packSnorm2x16(Math::vec2{sign, 0.0f}),
+                vertex + tangent_offset_ + sizeof(std::uint32_t));
+    return;
+  }
+  const float values[4]{tangent.x, tangent.y, tangent.z, sign};
+  WriteFloats(values, 4, vertex + tangent_offset_);
+}
+
+void MM::AssetSystem::AssetType::VertexLayout::Encode(const Vertex& vertex,
+                                                      char* vertex_data) const {
+  assert(IsValid());
+  EncodePosition(vertex.GetPosition(), vertex_data);
+  if (HaveAttribute(VertexAttribute::TEXTURE_COORD)) {
+    EncodeTextureCoord(vertex.GetTextureCoord(), vertex_data);
+  }
+  if (HaveAttribute(VertexAttribute::NORMAL)) {
+    EncodeNormal(vertex.GetNormal(), vertex_data);
+  }
+  if (HaveAttribute(VertexAttribute::TANGENT)) {
+    EncodeTangent(vertex.GetTangent(),
+                  GetBiTangentSign(vertex.GetNormal(), vertex.GetTangent(),
+                                   vertex.GetBiTangent()),
+                  vertex_data);
+  }
+}
+
+MM::Math::vec3 MM::AssetSystem::AssetType::VertexLayout::DecodePosition(
+    const char* vertex_data) const {
+  float values[3];
+  ReadFloats(vertex_data, 3, values);
+  return Math::vec3{values[0], values[1], values[2]};
+}
+
+MM::AssetSystem::AssetType::Vertex
+MM::AssetSystem::AssetType::VertexLayout::Decode(
+    const char* vertex_data) const {
+  assert(IsValid());
+  const bool is_packed = format_ == VertexFormat::PACKED;
+  Vertex vertex;
+  vertex.GetPosition() = DecodePosition(vertex_data);
+  if (HaveAttribute(VertexAttribute::TEXTURE_COORD)) {
+    const char* texture_coord_data = vertex_data + texture_coord_offset_;
+    if (is_packed) {
+      vertex.GetTextureCoord() =
+          Math::unpackHalf2x16(ReadUint32(texture_coord_data));
+    } else {
+      float values[2];
+      ReadFloats(texture_coord_data, 2, values);
+      vertex.GetTextureCoord() = Math::vec2{values[0], values[1]};
+    }
+  }
+  if (HaveAttribute(VertexAttribute::NORMAL)) {
+    const char* normal_data = vertex_data + normal_offset_;
+    if (is_packed) {
+      vertex.GetNormal() =
+          OctahedralDecode(Math::unpackSnorm2x16(ReadUint32(normal_data)));
+    } else {
+      float values[3];
+      ReadFloats(normal_data, 3, values);
+      vertex.GetNormal() = Math::vec3{values[0], values[1], values[2]};
+    }
+  }
+  if (HaveAttribute(VertexAttribute::TANGENT)) {
+    const char* tangent_data = vertex_data + tangent_offset_;
+    float sign;
+    if (is_packed) {
+      vertex.GetTangent() =
+          OctahedralDecode(Math::unpackSnorm2x16(ReadUint32(tangent_data)));
+      sign = Math::unpackSnorm2x16(
+                 ReadUint32(tangent_data + sizeof(std::uint32_t)))
+                 .x;
+    } else {
+      float values[4];
+      ReadFloats(tangent_data, 4, values);
+      vertex.GetTangent() = Math::vec3{values[0], values[1], values[2]};
+      sign = values[3];
+    }
+    const Math::vec3 bi_tangent =
+        Math::cross(vertex.GetNormal(), vertex.GetTangent());
+    if (Math::dot(bi_tangent, bi_tangent) != 0.0f) {
+      vertex.GetBiTangent() = Math::Normalize(bi_tangent) * SignNotZero(sign);
+    }
+  }
+
+  return vertex;
+}
+
+bool MM::AssetSystem::AssetType::VertexLayout::IsValid() const {
+  return HaveAttribute(VertexAttribute::POSITION);
+}
+
+void MM::AssetSystem::AssetType::VertexLayout::Reset() {
+  attributes_ = VertexAttribute::NONE;
+  format_ = VertexFormat::PACKED;
+  stride_ = 0;
+  texture_coord_offset_ = 0;
+  normal_offset_ = 0;
+  tangent_offset_ = 0;
+}
+
+float MM::AssetSystem::AssetType::VertexLayout::GetBiTangentSign(
+    const Math::vec3& normal, const Math::vec3& tangent,
+    const Math::vec3& bi_tangent) {
+  return SignNotZero(Math::dot(Math::cross(normal, tangent), bi_tangent));
+}
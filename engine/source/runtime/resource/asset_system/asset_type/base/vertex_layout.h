@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+
+#include "runtime/core/math/math.h"
+#include "runtime/resource/asset_system/asset_type/base/vertex.h"
+
+namespace MM {
+namespace AssetSystem {
+namespace AssetType {
+/**
+ * \brief The attributes stored in a vertex stream.
+ * \remark The bitangent is not stored. It is derived in the shader from the
+ * normal, the tangent and the bitangent sign stored with the tangent.
+ */
+enum class VertexAttribute : std::uint32_t {
+  NONE = 0x0,
+  POSITION = 0x1,
+  TEXTURE_COORD = 0x2,
+  NORMAL = 0x4,
+  TANGENT = 0x8,
+  ALL = 0xF
+};
+
+VertexAttribute operator|(const VertexAttribute& lhs,
+                          const VertexAttribute& rhs);
+
+VertexAttribute& operator|=(VertexAttribute& lhs, const VertexAttribute& rhs);
+
+VertexAttribute operator&(const VertexAttribute& lhs,
+                          const VertexAttribute& rhs);
+
+VertexAttribute& operator&=(VertexAttribute& lhs, const VertexAttribute& rhs);
+
+VertexAttribute operator~(const VertexAttribute& attribute);
+
+/**
+ * \brief How the attributes of a vertex stream are encoded.
+ * \remark The position is always 3 floats, the other attributes are:
+ * | attribute     | FP32                       | PACKED                     |
+ * | ------------- | -------------------------- | -------------------------- |
+ * | texture coord | 2 floats                   | 2 halfs                    |
+ * | normal        | 3 floats                   | octahedral, 2 snorm16      |
+ * | tangent       | 3 floats + bitangent sign  | octahedral, 2 snorm16 +    |
+ * |               |                            | bitangent sign, 2 snorm16  |
+ */
+enum class VertexFormat : std::uint32_t { FP32, PACKED };
+
+/**
+ * \brief Describes an interleaved vertex stream: which attributes every vertex
+ * stores, how they are encoded and where. Attributes that are not stored take
+ * no space and there is no padding between the attributes.
+ * \remark The attributes are stored in the order of \ref VertexAttribute, the
+ * position is always at offset 0.
+ */
+class VertexLayout {
+ public:
+  VertexLayout() = default;
+  ~VertexLayout() = default;
+  /**
+   * \remark POSITION is added to \ref attributes if it is missing. TANGENT
+   * is removed without NORMAL, the bitangent can not be derived without it.
+   */
+  VertexLayout(VertexAttribute attributes, VertexFormat format);
+  VertexLayout(const VertexLayout& other) = default;
+  VertexLayout(VertexLayout&& other) noexcept = default;
+  VertexLayout& operator=(const VertexLayout& other) = default;
+  VertexLayout& operator=(VertexLayout&& other) noexcept = default;
+
+  friend bool operator==(const VertexLayout& lhs, const VertexLayout& rhs);
+
+  friend bool operator!=(const VertexLayout& lhs, const VertexLayout& rhs);
+
+ public:
+  VertexAttribute GetAttributes() const;
+
+  VertexFormat GetFormat() const;
+
+  bool HaveAttribute(VertexAttribute attribute) const;
+
+  /**
+   * \brief Get the size of one vertex in bytes.
+   */
+  std::uint32_t GetStride() const;
+
+  /**
+   * \brief Get the offset of \ref attribute in a vertex.
+   * \remark \ref attribute must be a single attribute that the layout stores.
+   */
+  std::uint32_t GetOffset(VertexAttribute attribute) const;
+
+  void EncodePosition(const Math::vec3& position, char* vertex) const;
+
+  void EncodeTextureCoord(const Math::vec2& texture_coord, char* vertex) const;
+
+  /**
+   * \param normal A normalized vector.
+   */
+  void EncodeNormal(const Math::vec3& normal, char* vertex) const;
+
+  /**
+   * \param tangent A normalized vector.
+   * \param bi_tangent_sign 1 if the bitangent is cross(normal, tangent), -1 if
+   * it is the opposite.
+   */
+  void EncodeTangent(const Math::vec3& tangent, float bi_tangent_sign,
+                     char* vertex) const;
+
+  /**
+   * \brief Encode the attributes of \ref vertex that the layout stores.
+   * \param vertex_data The destination, at least \ref GetStride bytes.
+   */
+  void Encode(const Vertex& vertex, char* vertex_data) const;
+
+  Math::vec3 DecodePosition(const char* vertex_data) const;
+
+  /**
+   * \brief Decode a vertex. The attributes that the layout does not store are
+   * zero.
+   */
+  Vertex Decode(const char* vertex_data) const;
+
+  bool IsValid() const;
+
+  void Reset();
+
+  /**
+   * \brief Get the sign of the bitangent relative to cross(normal, tangent).
+   */
+  static float GetBiTangentSign(const Math::vec3& normal,
+                                const Math::vec3& tangent,
+                                const Math::vec3& bi_tangent);
+
+ private:
+  VertexAttribute attributes_{VertexAttribute::NONE};
+  VertexFormat format_{VertexFormat::PACKED};
+  std::uint32_t stride_{0};
+  std::uint32_t texture_coord_offset_{0};
+  std::uint32_t normal_offset_{0};
+  std::uint32_t tangent_offset_{0};
+};
+}  // namespace AssetType
+}  // namespace AssetSystem
+}  // namespace MM
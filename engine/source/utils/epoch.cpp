@@ -0,0 +1,167 @@
+//
+// Created by beimingxianyu on 23-6-3.
+//
+
+#include "utils/epoch.h"
+
+#include <algorithm>
+
+MM::Utils::EpochDomain::~EpochDomain() {
+  std::lock_guard<std::mutex> guard{retired_mutex_};
+  for (const RetiredObject& retired_object : retired_objects_) {
+    retired_object.deleter_(retired_object.object_);
+  }
+  retired_objects_.clear();
+
+  ThreadRecord* record = thread_records_.load(std::memory_order_acquire);
+  while (record != nullptr) {
+    ThreadRecord* next_record = record->next_record_;
+    delete record;
+    record = next_record;
+  }
+}
+
+MM::Utils::EpochDomain* MM::Utils::EpochDomain::GetInstance() {
+  static EpochDomain epoch_domain{};
+  return &epoch_domain;
+}
+
+void MM::Utils::EpochDomain::Enter() {
+  ThreadRecordHolder& holder = GetThreadRecordHolder();
+  if (holder.nesting_count_++ != 0) {
+    return;
+  }
+
+  if (holder.record_ == nullptr) {
+    holder.record_ = AcquireThreadRecord();
+  }
+  holder.record_->state_.store(
+      (global_epoch_.load(std::memory_order_seq_cst) << 1) | 1,
+      std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void MM::Utils::EpochDomain::Leave() {
+  ThreadRecordHolder& holder = GetThreadRecordHolder();
+  if (--holder.nesting_count_ != 0) {
+    return;
+  }
+
+  holder.record_->state_.store(0, std::memory_order_release);
+}
+
+void MM::Utils::EpochDomain::Retire(void* object, DeleterType deleter) {
+  if (object == nullptr) {
+    return;
+  }
+
+  std::vector<RetiredObject> reclaimable_objects;
+  {
+    std::lock_guard<std::mutex> guard{retired_mutex_};
+    retired_objects_.push_back(
+        {object, deleter, global_epoch_.load(std::memory_order_seq_cst)});
+    if (retired_objects_.size() < kReclaimThreshold) {
+      return;
+    }
+    CollectReclaimable(reclaimable_objects);
+  }
+
+  // Deleters run outside the lock, they may retire other objects.
+  for (const RetiredObject& retired_object : reclaimable_objects) {
+    retired_object.deleter_(retired_object.object_);
+  }
+}
+
+std::uint64_t MM::Utils::EpochDomain::Reclaim() {
+  std::vector<RetiredObject> reclaimable_objects;
+  std::uint64_t remain_count = 0;
+  {
+    std::lock_guard<std::mutex> guard{retired_mutex_};
+    remain_count = CollectReclaimable(reclaimable_objects);
+  }
+
+  for (const RetiredObject& retired_object : reclaimable_objects) {
+    retired_object.deleter_(retired_object.object_);
+  }
+
+  return remain_count;
+}
+
+std::uint64_t MM::Utils::EpochDomain::GetRetiredCount() const {
+  std::lock_guard<std::mutex> guard{retired_mutex_};
+  return retired_objects_.size();
+}
+
+MM::Utils::EpochDomain::ThreadRecordHolder::~ThreadRecordHolder() {
+  if (record_ != nullptr) {
+    record_->state_.store(0, std::memory_order_release);
+    record_->in_use_.store(false, std::memory_order_release);
+  }
+}
+
+MM::Utils::EpochDomain::ThreadRecordHolder&
+MM::Utils::EpochDomain::GetThreadRecordHolder() {
+  thread_local ThreadRecordHolder holder{};
+  return holder;
+}
+
+MM::Utils::EpochDomain::ThreadRecord*
+MM::Utils::EpochDomain::AcquireThreadRecord() {
+  // Reuse the record of a thread that has already exited.
+  for (ThreadRecord* record = thread_records_.load(std::memory_order_acquire);
+       record != nullptr; record = record->next_record_) {
+    bool expected = false;
+    if (!record->in_use_.load(std::memory_order_relaxed) &&
+        record->in_use_.compare_exchange_strong(expected, true,
+                                                std::memory_order_acq_rel)) {
+      return record;
+    }
+  }
+
+  auto* new_record = new ThreadRecord{};
+  new_record->in_use_.store(true, std::memory_order_relaxed);
+  ThreadRecord* head = thread_records_.load(std::memory_order_relaxed);
+  do {
+    new_record->next_record_ = head;
+  } while (!thread_records_.compare_exchange_weak(head, new_record,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed));
+
+  return new_record;
+}
+
+bool MM::Utils::EpochDomain::TryAdvanceEpoch() {
+  std::uint64_t current_epoch = global_epoch_.load(std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  for (ThreadRecord* record = thread_records_.load(std::memory_order_acquire);
+       record != nullptr; record = record->next_record_) {
+    std::uint64_t state = record->state_.load(std::memory_order_seq_cst);
+    if ((state & 1) != 0 && (state >> 1) != current_epoch) {
+      return false;
+    }
+  }
+
+  return global_epoch_.compare_exchange_strong(current_epoch,
+                                               current_epoch + 1,
+                                               std::memory_order_seq_cst);
+}
+
+std::uint64_t MM::Utils::EpochDomain::CollectReclaimable(
+    std::vector<RetiredObject>& reclaimable_objects) {
+  TryAdvanceEpoch();
+
+  // An object retired in epoch E may still be referenced by readers that
+  // entered in epoch E, so it can be destroyed once the epoch reaches E + 2.
+  const std::uint64_t current_epoch =
+      global_epoch_.load(std::memory_order_seq_cst);
+  auto first_alive = std::partition(
+      retired_objects_.begin(), retired_objects_.end(),
+      [current_epoch](const RetiredObject& retired_object) {
+        return retired_object.retire_epoch_ + 2 <= current_epoch;
+      });
+  reclaimable_objects.insert(reclaimable_objects.end(),
+                             retired_objects_.begin(), first_alive);
+  retired_objects_.erase(retired_objects_.begin(), first_alive);
+
+  return retired_objects_.size();
+}
@@ -0,0 +1,111 @@
+//
+// Created by beimingxianyu on 23-6-3.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace MM {
+namespace Utils {
+/**
+ * \brief Epoch based memory reclamation shared by the lock free read paths.
+ * \remark Readers wrap every traversal in an \ref EpochGuard. Writers unlink an
+ * object first and then hand it to \ref Retire; the object is only destroyed
+ * after every thread that could still observe it has left its guard.
+ */
+class EpochDomain {
+ public:
+  using DeleterType = void (*)(void*);
+
+ public:
+  ~EpochDomain();
+  EpochDomain(const EpochDomain& other) = delete;
+  EpochDomain(EpochDomain&& other) = delete;
+  EpochDomain& operator=(const EpochDomain& other) = delete;
+  EpochDomain& operator=(EpochDomain&& other) = delete;
+
+ public:
+  static EpochDomain* GetInstance();
+
+ public:
+  void Enter();
+
+  void Leave();
+
+  void Retire(void* object, DeleterType deleter);
+
+  template <typename ObjectType>
+  void Retire(ObjectType* object) {
+    Retire(object, [](void* retired_object) {
+      delete static_cast<ObjectType*>(retired_object);
+    });
+  }
+
+  /**
+   * \brief Try to advance the global epoch and destroy every retired object
+   * that no reader can reference any more.
+   * \return The number of retired objects that are still waiting.
+   */
+  std::uint64_t Reclaim();
+
+  std::uint64_t GetRetiredCount() const;
+
+ private:
+  EpochDomain() = default;
+
+ private:
+  struct alignas(64) ThreadRecord {
+    // (epoch << 1) | 1 while the thread is inside a guard, 0 otherwise.
+    std::atomic_uint64_t state_{0};
+    std::atomic_bool in_use_{false};
+    ThreadRecord* next_record_{nullptr};
+  };
+
+  struct RetiredObject {
+    void* object_;
+    DeleterType deleter_;
+    std::uint64_t retire_epoch_;
+  };
+
+  struct ThreadRecordHolder {
+    ~ThreadRecordHolder();
+
+    ThreadRecord* record_{nullptr};
+    std::uint32_t nesting_count_{0};
+  };
+
+ private:
+  ThreadRecordHolder& GetThreadRecordHolder();
+
+  ThreadRecord* AcquireThreadRecord();
+
+  bool TryAdvanceEpoch();
+
+  std::uint64_t CollectReclaimable(
+      std::vector<RetiredObject>& reclaimable_objects);
+
+ private:
+  static constexpr std::uint64_t kReclaimThreshold = 64;
+
+  std::atomic_uint64_t global_epoch_{1};
+  std::atomic<ThreadRecord*> thread_records_{nullptr};
+
+  mutable std::mutex retired_mutex_{};
+  std::vector<RetiredObject> retired_objects_{};
+};
+
+class EpochGuard {
+ public:
+  EpochGuard() { EpochDomain::GetInstance()->Enter(); }
+  ~EpochGuard() { EpochDomain::GetInstance()->Leave(); }
+  EpochGuard(const EpochGuard& other) = delete;
+  EpochGuard(EpochGuard&& other) = delete;
+  EpochGuard& operator=(const EpochGuard& other) = delete;
+  EpochGuard& operator=(EpochGuard&& other) = delete;
+};
+}  // namespace Utils
+}  // namespace MM
@@ -1,26 +1,69 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <shared_mutex>
+#include <vector>
 
 #include "utils.h"
+#include "utils/epoch.h"
 #include "utils/error.h"
+#include "utils/marco.h"
+#include "utils/striped_mutex.h"
 #include "utils/type_utils.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace MM {
 namespace Utils {
+using PrimeBucket = FalseType;
+using PowerOfTwoBucket = TrueType;
+
+/**
+ * \brief Murmur3 fmix64 finalizer. Spreads the entropy of every input bit over
+ * the whole 64-bit result, so that the low bits can be used as a bucket index
+ * even for weak hashes (identity integer hashes, XOR of sub IDs, ...).
+ */
+inline std::uint64_t HashMix64(std::uint64_t hash_code) {
+  hash_code ^= hash_code >> 33;
+  hash_code *= 0xff51afd7ed558ccdULL;
+  hash_code ^= hash_code >> 33;
+  hash_code *= 0xc4ceb9fe1a85ec53ULL;
+  hash_code ^= hash_code >> 33;
+  return hash_code;
+}
+
+/**
+ * \brief Index of the lowest set bit of \p value, which must not be 0.
+ */
+inline std::uint32_t CountTrailingZeros64(std::uint64_t value) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return static_cast<std::uint32_t>(index);
+#else
+  return static_cast<std::uint32_t>(__builtin_ctzll(value));
+#endif
+}
+
 template <typename RelationshipTrait, typename MultiTrait, typename KeyType,
           typename ObjectType, typename ReturnType,
           typename Hash = std::hash<KeyType>, typename Equal = std::equal_to<>,
-          typename Allocator = std::allocator<ObjectType>>
+          typename Allocator = std::allocator<ObjectType>,
+          typename BucketTrait = PrimeBucket>
 class HashTable {
  public:
   using ThisType = HashTable<RelationshipTrait, MultiTrait, KeyType, ObjectType,
-                             ReturnType, Hash, Equal, Allocator>;
+                             ReturnType, Hash, Equal, Allocator, BucketTrait>;
   using IsMap = TrueType;
   using IsSet = FalseType;
   using IsMulti = TrueType;
@@ -30,6 +73,28 @@ class HashTable {
  private:
   using MutexType = std::shared_mutex;
 
+  static constexpr bool kIsPowerOfTwoBucket =
+      std::is_same_v<BucketTrait, PowerOfTwoBucket>;
+  static constexpr std::uint64_t kDefaultBucketCount =
+      kIsPowerOfTwoBucket ? 128 : 131;
+  // How many elements ahead the batch operations prefetch buckets.
+  static constexpr std::uint64_t kBatchPrefetchDistance = 8;
+
+  using ObjectAllocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<ObjectType>;
+  using ObjectAllocatorTraits = std::allocator_traits<ObjectAllocator>;
+
+  // Objects are created with a default constructed allocator, so only
+  // stateless allocators such as std::allocator and SlabAllocator are usable.
+  struct ObjectDeleter {
+    void operator()(ObjectType* object) const {
+      ObjectAllocator allocator{};
+      ObjectAllocatorTraits::destroy(allocator, object);
+      ObjectAllocatorTraits::deallocate(allocator, object, 1);
+    }
+  };
+  using ObjectPointer = std::unique_ptr<ObjectType, ObjectDeleter>;
+
   struct Node;
 
  public:
@@ -39,10 +104,9 @@ class HashTable {
     delete[] data_;
   }
   explicit HashTable(std::uint64_t size)
-      : data_(new Node[size]{}),
-        load_factor_(0.75),
-        size_(0),
-        bucket_count_(size) {
+      : data_(nullptr), load_factor_(0.75), size_(0), bucket_count_(0) {
+    bucket_count_ = kIsPowerOfTwoBucket ? MinPowerOfTwo(size) : size;
+    data_ = new Node[bucket_count_]{};
     for (std::uint64_t i = 0; i != bucket_count_; ++i) {
       data_[i] = Node{};
     }
@@ -59,10 +123,10 @@ class HashTable {
         Node* other_first_node = &other.data_[i];
         Node* first_node = &data_[i];
         data_[i].object_ =
-            std::make_unique<ObjectType>(*(other_first_node->object_));
+            MakeObject(*(other_first_node->object_));
         while (other_first_node->next_node_) {
           Node* next_node =
-              new Node{std::make_unique<ObjectType>(
+              new Node{MakeObject(
                            *(other_first_node->next_node_->object_)),
                        nullptr};
           first_node->next_node_ = next_node;
@@ -81,8 +145,8 @@ class HashTable {
     size_ = other.size_;
     bucket_count_ = other.bucket_count_;
 
-    other.data_ = new Node[131]{};
-    other.bucket_count_ = 131;
+    other.data_ = new Node[kDefaultBucketCount]{};
+    other.bucket_count_ = kDefaultBucketCount;
     for (std::uint64_t i = 0; i != other.bucket_count_; ++i) {
       other.data_[i] = Node{};
     }
@@ -110,10 +174,10 @@ class HashTable {
         Node* other_first_node = &other.data_[i];
         Node* first_node = &data_[i];
         data_[i].object_ =
-            std::make_unique<ObjectType>(*(other_first_node->object_));
+            MakeObject(*(other_first_node->object_));
         while (other_first_node->next_node_) {
           Node* next_node =
-              new Node{std::make_unique<ObjectType>(
+              new Node{MakeObject(
                            *(other_first_node->next_node_->object_)),
                        nullptr};
           first_node->next_node_ = next_node;
@@ -142,8 +206,8 @@ class HashTable {
     size_ = other.size_;
     bucket_count_ = other.bucket_count_;
 
-    other.data_ = new Node[131]{};
-    other.bucket_count_ = 131;
+    other.data_ = new Node[kDefaultBucketCount]{};
+    other.bucket_count_ = kDefaultBucketCount;
     for (std::uint64_t i = 0; i != other.bucket_count_; ++i) {
       other.data_[i] = Node{};
     }
@@ -191,7 +255,7 @@ class HashTable {
 
     std::uint64_t hash_code = GetObjectHash(*object_ptr);
 
-    std::uint64_t data_offset = hash_code % bucket_count_;
+    std::uint64_t data_offset = BucketIndex(hash_code);
     if (data_[data_offset].object_ == nullptr) {
       return Result<Nil, ErrorResult>(
           st_execute_error,
@@ -238,51 +302,14 @@ class HashTable {
 
   template <typename K>
   std::uint32_t Erase(const K& key) {
-    std::uint64_t hash_code = GetObjectHash(key);
-
-    std::uint64_t data_offset = hash_code % bucket_count_;
-    if (data_[data_offset].object_ == nullptr) {
-      return 0;
-    }
-
-    std::uint32_t count = 0;
-    while (KeyEqual(*(data_[data_offset].object_), key)) {
-      if (data_[data_offset].next_node_) {
-        Node* old_node = data_[data_offset].next_node_;
-        data_[data_offset] = std::move(*(data_[data_offset].next_node_));
-        delete old_node;
-        ++count;
-      } else {
-        data_[data_offset].object_.reset();
-        ++count;
-
-        size_ -= count;
-        return count;
-      }
-    }
-
-    Node* node_ptr = &data_[data_offset];
-    while (node_ptr->next_node_) {
-      if (KeyEqual(*(node_ptr->next_node_->object_), key)) {
-        Node* old_nex_node = node_ptr->next_node_;
-        node_ptr->next_node_ = node_ptr->next_node_->next_node_;
-        delete old_nex_node;
-        ++count;
-        continue;
-      }
-      node_ptr = node_ptr->next_node_;
-    }
-
-    size_ = count;
-
-    return count;
+    return EraseWithHash(key, GetObjectHash(key));
   }
 
   template <typename K>
   std::uint32_t Count(const K& key) const {
     std::uint64_t hash_code = GetObjectHash(key);
 
-    const Node* first_node = &data_[hash_code % bucket_count_];
+    const Node* first_node = &data_[BucketIndex(hash_code)];
     if (first_node->object_ == nullptr) {
       return 0;
     }
@@ -300,42 +327,12 @@ class HashTable {
 
   template <typename K>
   ReturnType* Find(const K& key) {
-    std::uint64_t hash_code = GetObjectHash(key);
-
-    Node* first_node = &data_[hash_code % bucket_count_];
-
-    if (first_node->object_) {
-      while (first_node) {
-        if (KeyEqual(*(first_node->object_), key)) {
-          return first_node->object_.get();
-        }
-        first_node = first_node->next_node_;
-      }
-
-      return nullptr;
-    }
-
-    return nullptr;
+    return FindWithHash(key, GetObjectHash(key));
   }
 
   template <typename K>
   const ReturnType* Find(const K& key) const {
-    std::uint64_t hash_code = GetObjectHash(key);
-
-    const Node* first_node = &data_[hash_code % bucket_count_];
-
-    if (first_node->object_) {
-      while (first_node) {
-        if (KeyEqual(*(first_node->object_), key)) {
-          return first_node->object_.get();
-        }
-        first_node = first_node->next_node_;
-      }
-
-      return nullptr;
-    }
-
-    return nullptr;
+    return FindWithHash(key, GetObjectHash(key));
   }
 
   template <typename K>
@@ -347,7 +344,7 @@ class HashTable {
   std::vector<ReturnType*> EqualRange(const K& key) {
     std::uint64_t hash_code = GetObjectHash(key);
 
-    Node* first_node = &data_[hash_code % bucket_count_];
+    Node* first_node = &data_[BucketIndex(hash_code)];
 
     if (first_node->object_ == nullptr) {
       return std::vector<ReturnType*>{};
@@ -369,7 +366,7 @@ class HashTable {
   std::vector<const ReturnType*> EqualRange(const K& key) const {
     std::uint64_t hash_code = GetObjectHash(key);
 
-    const Node* first_node = &data_[hash_code % bucket_count_];
+    const Node* first_node = &data_[BucketIndex(hash_code)];
 
     if (first_node->object_ == nullptr) {
       return std::vector<const ReturnType*>{};
@@ -389,7 +386,7 @@ class HashTable {
 
   void ReHash(std::uint64_t new_bucket_size) {
     if (new_bucket_size > bucket_count_) {
-      new_bucket_size = MinPrime(new_bucket_size);
+      new_bucket_size = BucketCountFor(new_bucket_size);
 
       Node* new_data = new Node[new_bucket_size]{};
       for (std::uint64_t i = 0; i != new_bucket_size; ++i) {
@@ -399,7 +396,8 @@ class HashTable {
       for (std::uint64_t i = 0; i != bucket_count_; ++i) {
         if (data_[i].object_) {
           std::uint64_t insert_pos =
-              GetObjectHash(*(data_[i].object_)) % new_bucket_size;
+              BucketIndex(GetObjectHash(*(data_[i].object_)),
+                          new_bucket_size);
 
           bool insert_first = false;
           if (new_data[insert_pos].object_ == nullptr) {
@@ -418,8 +416,9 @@ class HashTable {
 
           Node* old_data_first_node = data_[i].next_node_;
           while (old_data_first_node) {
-            insert_pos = GetObjectHash(*(old_data_first_node->object_)) %
-                         new_bucket_size;
+            insert_pos =
+                BucketIndex(GetObjectHash(*(old_data_first_node->object_)),
+                            new_bucket_size);
 
             if (new_data[insert_pos].object_ == nullptr) {
               new_data[insert_pos].object_ =
@@ -449,6 +448,91 @@ class HashTable {
     }
   }
 
+  /**
+   * \brief Grows the table so that \ref element_count elements fit without
+   * another rehash.
+   */
+  void Reserve(std::uint64_t element_count) {
+    if (element_count > std::floor(bucket_count_ * load_factor_)) {
+      ReHash(static_cast<std::uint64_t>(
+                 std::ceil(static_cast<double>(element_count) / load_factor_)) +
+             1);
+    }
+  }
+
+  /**
+   * \brief Inserts every object of \ref objects. The table grows at most once,
+   * up front, to fit the whole batch.
+   * \return The inserted (or already existing) element of every object and
+   * whether it was inserted, in the order of \ref objects.
+   * \remark All hashes are computed up front, so the bucket of a later object
+   * is prefetched while the current one is probed.
+   * \remark A container that guards this table with lock stripes must
+   * \ref Reserve room for the batch beforehand, then no rehash happens here
+   * and it can call this while holding only the stripe of the objects.
+   */
+  std::vector<std::pair<ReturnType*, bool>> InsertBatch(
+      std::vector<ObjectType>&& objects) {
+    Reserve(size_ + objects.size());
+
+    std::vector<std::uint64_t> hash_codes = GetObjectHashes(objects);
+    std::vector<std::pair<ReturnType*, bool>> result;
+    result.reserve(objects.size());
+    for (std::uint64_t i = 0; i != objects.size(); ++i) {
+      PrefetchBucket(hash_codes, i + kBatchPrefetchDistance);
+      std::pair<ReturnType&, bool> insert_result =
+          InsertWithHash(std::move(objects[i]), hash_codes[i], MultiTrait{});
+      result.emplace_back(&(insert_result.first), insert_result.second);
+    }
+
+    return result;
+  }
+
+  /**
+   * \return The element of every key (nullptr if there is none), in the order
+   * of \ref keys.
+   */
+  template <typename K>
+  std::vector<ReturnType*> FindBatch(const std::vector<K>& keys) {
+    std::vector<std::uint64_t> hash_codes = GetObjectHashes(keys);
+    std::vector<ReturnType*> result;
+    result.reserve(keys.size());
+    for (std::uint64_t i = 0; i != keys.size(); ++i) {
+      PrefetchBucket(hash_codes, i + kBatchPrefetchDistance);
+      result.emplace_back(FindWithHash(keys[i], hash_codes[i]));
+    }
+
+    return result;
+  }
+
+  template <typename K>
+  std::vector<const ReturnType*> FindBatch(const std::vector<K>& keys) const {
+    std::vector<std::uint64_t> hash_codes = GetObjectHashes(keys);
+    std::vector<const ReturnType*> result;
+    result.reserve(keys.size());
+    for (std::uint64_t i = 0; i != keys.size(); ++i) {
+      PrefetchBucket(hash_codes, i + kBatchPrefetchDistance);
+      result.emplace_back(FindWithHash(keys[i], hash_codes[i]));
+    }
+
+    return result;
+  }
+
+  /**
+   * \return The number of erased elements.
+   */
+  template <typename K>
+  std::uint64_t EraseBatch(const std::vector<K>& keys) {
+    std::vector<std::uint64_t> hash_codes = GetObjectHashes(keys);
+    std::uint64_t count = 0;
+    for (std::uint64_t i = 0; i != keys.size(); ++i) {
+      PrefetchBucket(hash_codes, i + kBatchPrefetchDistance);
+      count += EraseWithHash(keys[i], hash_codes[i]);
+    }
+
+    return count;
+  }
+
   double GetLoadFactor() const { return load_factor_; }
 
   void SetLoadFactor(double new_load_factor) { load_factor_ = new_load_factor; }
@@ -463,9 +547,9 @@ class HashTable {
 
     std::uint64_t hash_code = GetObjectHash(other);
 
-    std::uint64_t data_offset = hash_code % bucket_count_;
+    std::uint64_t data_offset = BucketIndex(hash_code);
     if (data_[data_offset].object_ == nullptr) {
-      data_[data_offset].object_ = std::make_unique<ObjectType>(other);
+      data_[data_offset].object_ = MakeObject(other);
       ++size_;
       return {*(data_[data_offset].object_), true};
     }
@@ -481,7 +565,7 @@ class HashTable {
 
     Node* old_first_node = new Node{std::move(data_[data_offset])};
     data_[data_offset] =
-        Node{std::make_unique<ObjectType>(other), old_first_node};
+        Node{MakeObject(other), old_first_node};
     ++size_;
     return {*(data_[data_offset].object_), true};
   }
@@ -491,16 +575,16 @@ class HashTable {
 
     std::uint64_t hash_code = GetObjectHash(other);
 
-    std::uint64_t data_offset = hash_code % bucket_count_;
+    std::uint64_t data_offset = BucketIndex(hash_code);
     if (data_[data_offset].object_ == nullptr) {
-      data_[data_offset].object_ = std::make_unique<ObjectType>(other);
+      data_[data_offset].object_ = MakeObject(other);
       ++size_;
       return {*(data_[data_offset].object_), true};
     }
 
     Node* old_first_node = new Node{std::move(data_[data_offset])};
     data_[data_offset] =
-        Node{std::make_unique<ObjectType>(other), old_first_node};
+        Node{MakeObject(other), old_first_node};
     ++size_;
     return {*(data_[data_offset].object_), true};
   }
@@ -509,11 +593,23 @@ class HashTable {
     RehashWhenNeed();
 
     std::uint64_t hash_code = GetObjectHash(other);
+    return InsertWithHash(std::move(other), hash_code, NotMulti{});
+  }
+
+  std::pair<ReturnType&, bool> Insert(ObjectType&& other, IsMulti) {
+    RehashWhenNeed();
+
+    std::uint64_t hash_code = GetObjectHash(other);
+    return InsertWithHash(std::move(other), hash_code, IsMulti{});
+  }
 
-    std::uint64_t data_offset = hash_code % bucket_count_;
+  std::pair<ReturnType&, bool> InsertWithHash(ObjectType&& other,
+                                              std::uint64_t hash_code,
+                                              NotMulti) {
+    std::uint64_t data_offset = BucketIndex(hash_code);
     if (data_[data_offset].object_ == nullptr) {
       data_[data_offset].object_ =
-          std::make_unique<ObjectType>(std::move(other));
+          MakeObject(std::move(other));
       ++size_;
       return {*(data_[data_offset].object_), true};
     }
@@ -529,32 +625,106 @@ class HashTable {
 
     Node* old_first_node = new Node{std::move(data_[data_offset])};
     data_[data_offset] =
-        Node{std::make_unique<ObjectType>(std::move(other)), old_first_node};
+        Node{MakeObject(std::move(other)), old_first_node};
     ++size_;
     return {*(data_[data_offset].object_), true};
   }
 
-  std::pair<ReturnType&, bool> Insert(ObjectType&& other, IsMulti) {
-    RehashWhenNeed();
-
-    std::uint64_t hash_code = GetObjectHash(other);
-
-    std::uint64_t data_offset = hash_code % bucket_count_;
+  std::pair<ReturnType&, bool> InsertWithHash(ObjectType&& other,
+                                              std::uint64_t hash_code,
+                                              IsMulti) {
+    std::uint64_t data_offset = BucketIndex(hash_code);
     if (data_[data_offset].object_ == nullptr) {
       data_[data_offset].object_ =
-          std::make_unique<ObjectType>(std::move(other));
+          MakeObject(std::move(other));
       ++size_;
       return {*(data_[data_offset].object_), true};
     }
 
     Node* old_first_node = new Node{std::move(data_[data_offset])};
     data_[data_offset] =
-        Node{std::make_unique<ObjectType>(std::move(other)), old_first_node};
+        Node{MakeObject(std::move(other)), old_first_node};
     ++size_;
 
     return {*(data_[data_offset].object_), true};
   }
 
+  template <typename K>
+  std::uint32_t EraseWithHash(const K& key, std::uint64_t hash_code) {
+    std::uint64_t data_offset = BucketIndex(hash_code);
+    if (data_[data_offset].object_ == nullptr) {
+      return 0;
+    }
+
+    std::uint32_t count = 0;
+    while (KeyEqual(*(data_[data_offset].object_), key)) {
+      if (data_[data_offset].next_node_) {
+        Node* old_node = data_[data_offset].next_node_;
+        data_[data_offset] = std::move(*(data_[data_offset].next_node_));
+        delete old_node;
+        ++count;
+      } else {
+        data_[data_offset].object_.reset();
+        ++count;
+
+        size_ -= count;
+        return count;
+      }
+    }
+
+    Node* node_ptr = &data_[data_offset];
+    while (node_ptr->next_node_) {
+      if (KeyEqual(*(node_ptr->next_node_->object_), key)) {
+        Node* old_nex_node = node_ptr->next_node_;
+        node_ptr->next_node_ = node_ptr->next_node_->next_node_;
+        delete old_nex_node;
+        ++count;
+        continue;
+      }
+      node_ptr = node_ptr->next_node_;
+    }
+
+    size_ -= count;
+
+    return count;
+  }
+
+  template <typename K>
+  ReturnType* FindWithHash(const K& key, std::uint64_t hash_code) {
+    Node* first_node = &data_[BucketIndex(hash_code)];
+
+    if (first_node->object_) {
+      while (first_node) {
+        if (KeyEqual(*(first_node->object_), key)) {
+          return first_node->object_.get();
+        }
+        first_node = first_node->next_node_;
+      }
+
+      return nullptr;
+    }
+
+    return nullptr;
+  }
+
+  template <typename K>
+  const ReturnType* FindWithHash(const K& key, std::uint64_t hash_code) const {
+    const Node* first_node = &data_[BucketIndex(hash_code)];
+
+    if (first_node->object_) {
+      while (first_node) {
+        if (KeyEqual(*(first_node->object_), key)) {
+          return first_node->object_.get();
+        }
+        first_node = first_node->next_node_;
+      }
+
+      return nullptr;
+    }
+
+    return nullptr;
+  }
+
   template <typename... Args>
   std::pair<ReturnType&, bool> Emplace(NotMulti, Args&&... args) {
     return Insert(ObjectType{std::forward<Args>(args)...}, NotMulti{});
@@ -565,6 +735,24 @@ class HashTable {
     return Insert(ObjectType{std::forward<Args>(args)...}, IsMulti{});
   }
 
+  template <typename K>
+  std::vector<std::uint64_t> GetObjectHashes(const std::vector<K>& keys) const {
+    std::vector<std::uint64_t> hash_codes;
+    hash_codes.reserve(keys.size());
+    for (const K& key : keys) {
+      hash_codes.emplace_back(GetObjectHash(key));
+    }
+
+    return hash_codes;
+  }
+
+  void PrefetchBucket(const std::vector<std::uint64_t>& hash_codes,
+                      std::uint64_t index) const {
+    if (index < hash_codes.size()) {
+      MM_PREFETCH(&data_[BucketIndex(hash_codes[index])]);
+    }
+  }
+
   void DeleteOneListNext(Node* node, std::uint32_t& count) {
     if (node->next_node_) {
       DeleteOneListNext(node->next_node_);
@@ -601,17 +789,43 @@ class HashTable {
     node->next_node_ = nullptr;
   }
 
+  static std::uint64_t BucketCountFor(std::uint64_t bucket_count) {
+    return kIsPowerOfTwoBucket ? MinPowerOfTwo(bucket_count)
+                               : MinPrime(bucket_count);
+  }
+
+  static std::uint64_t BucketIndex(std::uint64_t hash_code,
+                                   std::uint64_t bucket_count) {
+    if constexpr (kIsPowerOfTwoBucket) {
+      return hash_code & (bucket_count - 1);
+    } else {
+      return hash_code % bucket_count;
+    }
+  }
+
+  std::uint64_t BucketIndex(std::uint64_t hash_code) const {
+    return BucketIndex(hash_code, bucket_count_);
+  }
+
+  static std::uint64_t FinalizeHash(std::uint64_t hash_code) {
+    if constexpr (kIsPowerOfTwoBucket) {
+      return HashMix64(hash_code);
+    } else {
+      return hash_code;
+    }
+  }
+
   std::uint64_t GetObjectHash(const ObjectType& object, IsMap) const {
-    return Hash{}(object.first);
+    return FinalizeHash(Hash{}(object.first));
   }
 
   std::uint64_t GetObjectHash(const ObjectType& object, IsSet) const {
-    return Hash{}(object);
+    return FinalizeHash(Hash{}(object));
   }
 
   template <typename K>
   std::uint64_t GetObjectHash(const K& key) const {
-    return Hash{}(key);
+    return FinalizeHash(Hash{}(key));
   }
 
   std::uint64_t GetObjectHash(const ObjectType& object) const {
@@ -643,10 +857,19 @@ class HashTable {
     }
   }
 
+  template <typename... Args>
+  static ObjectPointer MakeObject(Args&&... args) {
+    ObjectAllocator allocator{};
+    ObjectType* object = ObjectAllocatorTraits::allocate(allocator, 1);
+    ObjectAllocatorTraits::construct(allocator, object,
+                                     std::forward<Args>(args)...);
+    return ObjectPointer{object};
+  }
+
  private:
   struct Node {
     Node() = default;
-    Node(std::unique_ptr<ObjectType>&& object, Node* next_node)
+    Node(ObjectPointer&& object, Node* next_node)
         : object_(std::move(object)), next_node_(next_node) {}
     Node(const Node& other) = delete;
     Node(Node&& other) noexcept
@@ -668,27 +891,45 @@ class HashTable {
     }
     ~Node() = default;
 
-    std::unique_ptr<ObjectType> object_{nullptr};
+    ObjectPointer object_{nullptr};
     Node* next_node_{nullptr};
   };
 
  private:
-  Node* data_{new Node[131]{}};
+  Node* data_{new Node[kDefaultBucketCount]{}};
 
   double load_factor_{0.75f};
   std::uint64_t size_{0};
-  std::uint64_t bucket_count_{131};
+  std::uint64_t bucket_count_{kDefaultBucketCount};
 };
 
+/**
+ * \brief Hash table that can be used by several threads at the same time.
+ * \remark Writers lock one of the bucket stripes (16 unless another count is
+ * passed to the constructor). \ref Find, \ref Contains, \ref Count and
+ * \ref EqualRange take no lock at all: nodes are published with release stores
+ * and unlinked nodes are handed to the \ref EpochDomain, so a reader never
+ * touches freed memory while it walks a bucket. The returned pointers stay
+ * valid until the element is erased, as with the other tables.
+ * \remark With \ref PowerOfTwoBucket the table grows incrementally: a rehash
+ * only publishes the new bucket array, and every later write moves a few of
+ * the old buckets over until none is left. Lookups consult the old array for
+ * buckets that have not been moved yet. An old bucket and all the new buckets
+ * it splits into share one stripe, so moving it only takes that stripe lock.
+ * With \ref PrimeBucket the buckets do not split this way, and a rehash still
+ * rebuilds the whole table under every stripe lock, so tables that grow while
+ * other threads use them should pick \ref PowerOfTwoBucket.
+ */
 template <typename RelationshipTrait, typename MultiTrait, typename KeyType,
           typename ObjectType, typename ReturnType,
           typename Hash = std::hash<KeyType>, typename Equal = std::equal_to<>,
-          typename Allocator = std::allocator<ObjectType>>
+          typename Allocator = std::allocator<ObjectType>,
+          typename BucketTrait = PrimeBucket>
 class ConcurrentHashTable {
  public:
   using ThisType =
       ConcurrentHashTable<RelationshipTrait, MultiTrait, KeyType, ObjectType,
-                          ReturnType, Hash, Equal, Allocator>;
+                          ReturnType, Hash, Equal, Allocator, BucketTrait>;
   using IsMap = TrueType;
   using IsSet = FalseType;
   using IsMulti = TrueType;
@@ -701,89 +942,72 @@ class ConcurrentHashTable {
  private:
   using MutexType = std::shared_mutex;
 
+  static constexpr bool kIsPowerOfTwoBucket =
+      std::is_same_v<BucketTrait, PowerOfTwoBucket>;
+  static constexpr std::uint64_t kDefaultBucketCount =
+      kIsPowerOfTwoBucket ? 128 : 131;
+  // The number of old buckets every write moves while an incremental rehash is
+  // in progress.
+  static constexpr std::uint64_t kMigrateBucketsPerOperation = 8;
+
   struct Node;
+  struct Buckets;
 
  public:
   ConcurrentHashTable() = default;
   virtual ~ConcurrentHashTable() {
-    Clear();
-    delete[] data_;
+    DeleteBuckets(old_buckets_.load(std::memory_order_acquire));
+    DeleteBuckets(buckets_.load(std::memory_order_acquire));
   }
-  explicit ConcurrentHashTable(std::uint64_t size)
-      : data_(new Node[size]{}),
+  explicit ConcurrentHashTable(
+      std::uint64_t size,
+      std::uint64_t stripe_count = StripedMutex<MutexType>::kDefaultStripeCount)
+      : buckets_(nullptr),
         load_factor_(0.75),
         size_(0),
-        bucket_count_(size) {
-    for (std::uint64_t i = 0; i != bucket_count_; ++i) {
-      data_[i] = Node{};
-    }
+        bucket_count_(0),
+        data_mutexes_(stripe_count) {
+    bucket_count_.store(kIsPowerOfTwoBucket ? MinPowerOfTwo(size) : size,
+                        std::memory_order_relaxed);
+    buckets_.store(new Buckets{bucket_count_.load(std::memory_order_relaxed)},
+                   std::memory_order_release);
   }
   ConcurrentHashTable(const ConcurrentHashTable& other)
-      : data_(nullptr), load_factor_(0.75), size_(0), bucket_count_(0) {
-    other.LockAll();
-#if MM_COMPILER == MM_COMPILER_MSVC
-    std::lock_guard<std::shared_mutex>
-#else
-    std::shared_lock<std::shared_mutex>
-#endif
-        guard0{other.data_mutex0_, std::adopt_lock},
-        guard1{other.data_mutex1_, std::adopt_lock},
-        guard2{other.data_mutex2_, std::adopt_lock},
-        guard3{other.data_mutex3_, std::adopt_lock},
-        guard4{other.data_mutex4_, std::adopt_lock},
-        guard5{other.data_mutex5_, std::adopt_lock},
-        guard6{other.data_mutex6_, std::adopt_lock},
-        guard7{other.data_mutex7_, std::adopt_lock},
-        guard8{other.data_mutex8_, std::adopt_lock},
-        guard9{other.data_mutex9_, std::adopt_lock},
-        guard10{other.data_mutex10_, std::adopt_lock},
-        guard11{other.data_mutex11_, std::adopt_lock},
-        guard12{other.data_mutex12_, std::adopt_lock},
-        guard13{other.data_mutex13_, std::adopt_lock},
-        guard14{other.data_mutex14_, std::adopt_lock},
-        guard15{other.data_mutex15_, std::adopt_lock};
+      : buckets_(nullptr),
+        load_factor_(0.75),
+        size_(0),
+        bucket_count_(0),
+        data_mutexes_(other.StripeCount()) {
+    LockAllGuard guard{other};
 
-    data_ = new Node[other.bucket_count_]{};
+    buckets_.store(other.CopyBuckets(), std::memory_order_release);
     load_factor_ = other.load_factor_;
-    size_.store(other.size_.load(std::memory_order_consume),
+    size_.store(other.size_.load(std::memory_order_relaxed),
                 std::memory_order_release);
-    bucket_count_ = other.bucket_count_;
-
-    for (std::uint64_t i = 0; i != bucket_count_; ++i) {
-      if (other.data_[i].object_) {
-        Node* other_first_node = &other.data_[i];
-        Node* first_node = &data_[i];
-        data_[i].object_ =
-            std::make_unique<ObjectType>(*(other_first_node->object_));
-        while (other_first_node->next_node_) {
-          Node* next_node =
-              new Node{std::make_unique<ObjectType>(
-                           *(other_first_node->next_node_->object_)),
-                       nullptr};
-          first_node->next_node_ = next_node;
-          first_node = first_node->next_node_;
-
-          other_first_node = other_first_node->next_node_;
-        }
-      }
-    }
+    bucket_count_.store(other.bucket_count_.load(std::memory_order_relaxed),
+                        std::memory_order_release);
   }
 
   ConcurrentHashTable(ConcurrentHashTable&& other) noexcept
-      : data_(nullptr), load_factor_(0), size_(0), bucket_count_(0) {
+      : buckets_(nullptr),
+        load_factor_(0),
+        size_(0),
+        bucket_count_(0),
+        data_mutexes_(other.StripeCount()) {
     LockAllGuard guard{other};
+    other.MigrateAllBuckets();
 
-    data_ = other.data_;
+    buckets_.store(other.buckets_.load(std::memory_order_relaxed),
+                   std::memory_order_release);
     load_factor_ = other.load_factor_;
-    size_.store(other.size_.load(std::memory_order_consume),
+    size_.store(other.size_.load(std::memory_order_relaxed),
                 std::memory_order_release);
-    bucket_count_ = other.bucket_count_;
+    bucket_count_.store(other.bucket_count_.load(std::memory_order_relaxed),
+                        std::memory_order_release);
 
-    other.data_ = new Node[131]{};
-    other.bucket_count_ = 131;
-    for (std::uint64_t i = 0; i != other.bucket_count_; ++i) {
-      other.data_[i] = Node{};
-    }
+    other.buckets_.store(new Buckets{kDefaultBucketCount},
+                         std::memory_order_release);
+    other.bucket_count_.store(kDefaultBucketCount, std::memory_order_release);
     other.load_factor_ = 0.75;
     other.size_.store(0, std::memory_order_release);
   }
@@ -792,69 +1016,17 @@ class ConcurrentHashTable {
       return *this;
     }
 
-    std::lock(data_mutex0_, data_mutex1_, data_mutex2_, data_mutex3_,
-              data_mutex4_, data_mutex5_, data_mutex6_, data_mutex7_,
-              data_mutex8_, data_mutex9_, data_mutex10_, data_mutex11_,
-              data_mutex12_, data_mutex13_, data_mutex14_, data_mutex15_,
-              other.data_mutex0_, other.data_mutex1_, other.data_mutex2_,
-              other.data_mutex3_, other.data_mutex4_, other.data_mutex5_,
-              other.data_mutex6_, other.data_mutex7_, other.data_mutex8_,
-              other.data_mutex9_, other.data_mutex10_, other.data_mutex11_,
-              other.data_mutex12_, other.data_mutex13_, other.data_mutex14_,
-              other.data_mutex15_);
-    LockAllGuard main_guard{*this, std::adopt_lock};
-#if MM_COMPILER == MM_COMPILER_MSVC
-    std::lock_guard<std::shared_mutex>
-#else
-    std::shared_lock<std::shared_mutex>
-#endif
-        guard0{other.data_mutex0_, std::adopt_lock},
-        guard1{other.data_mutex1_, std::adopt_lock},
-        guard2{other.data_mutex2_, std::adopt_lock},
-        guard3{other.data_mutex3_, std::adopt_lock},
-        guard4{other.data_mutex4_, std::adopt_lock},
-        guard5{other.data_mutex5_, std::adopt_lock},
-        guard6{other.data_mutex6_, std::adopt_lock},
-        guard7{other.data_mutex7_, std::adopt_lock},
-        guard8{other.data_mutex8_, std::adopt_lock},
-        guard9{other.data_mutex9_, std::adopt_lock},
-        guard10{other.data_mutex10_, std::adopt_lock},
-        guard11{other.data_mutex11_, std::adopt_lock},
-        guard12{other.data_mutex12_, std::adopt_lock},
-        guard13{other.data_mutex13_, std::adopt_lock},
-        guard14{other.data_mutex14_, std::adopt_lock},
-        guard15{other.data_mutex15_, std::adopt_lock};
-
-    if (!Empty()) {
-      Clear();
-    }
-
-    delete[] data_;
+    StripedMutex<MutexType>::LockAllPair(data_mutexes_,
+                                         other.data_mutexes_);
+    LockAllGuard main_guard{*this, std::adopt_lock},
+        other_guard{other, std::adopt_lock};
 
-    data_ = new Node[other.bucket_count_]{};
+    ResetBuckets(other.CopyBuckets());
     load_factor_ = other.load_factor_;
-    size_.store(other.size_.load(std::memory_order_consume),
+    size_.store(other.size_.load(std::memory_order_relaxed),
                 std::memory_order_release);
-    bucket_count_ = other.bucket_count_;
-
-    for (std::uint64_t i = 0; i != bucket_count_; ++i) {
-      if (other.data_[i].object_) {
-        Node* other_first_node = &other.data_[i];
-        Node* first_node = &data_[i];
-        data_[i].object_ =
-            std::make_unique<ObjectType>(*(other_first_node->object_));
-        while (other_first_node->next_node_) {
-          Node* next_node =
-              new Node{std::make_unique<ObjectType>(
-                           *(other_first_node->next_node_->object_)),
-                       nullptr};
-          first_node->next_node_ = next_node;
-          first_node = first_node->next_node_;
-
-          other_first_node = other_first_node->next_node_;
-        }
-      }
-    }
+    bucket_count_.store(other.bucket_count_.load(std::memory_order_relaxed),
+                        std::memory_order_release);
 
     return *this;
   }
@@ -863,36 +1035,22 @@ class ConcurrentHashTable {
       return *this;
     }
 
-    std::lock(data_mutex0_, data_mutex1_, data_mutex2_, data_mutex3_,
-              data_mutex4_, data_mutex5_, data_mutex6_, data_mutex7_,
-              data_mutex8_, data_mutex9_, data_mutex10_, data_mutex11_,
-              data_mutex12_, data_mutex13_, data_mutex14_, data_mutex15_,
-              other.data_mutex0_, other.data_mutex1_, other.data_mutex2_,
-              other.data_mutex3_, other.data_mutex4_, other.data_mutex5_,
-              other.data_mutex6_, other.data_mutex7_, other.data_mutex8_,
-              other.data_mutex9_, other.data_mutex10_, other.data_mutex11_,
-              other.data_mutex12_, other.data_mutex13_, other.data_mutex14_,
-              other.data_mutex15_);
+    StripedMutex<MutexType>::LockAllPair(data_mutexes_,
+                                         other.data_mutexes_);
     LockAllGuard main_guard{*this, std::adopt_lock},
         other_guard{other, std::adopt_lock};
 
-    if (!Empty()) {
-      Clear();
-    }
-
-    delete[] data_;
-
-    data_ = other.data_;
+    other.MigrateAllBuckets();
+    ResetBuckets(other.buckets_.load(std::memory_order_relaxed));
     load_factor_ = other.load_factor_;
-    size_.store(other.size_.load(std::memory_order_acquire),
+    size_.store(other.size_.load(std::memory_order_relaxed),
                 std::memory_order_release);
-    bucket_count_ = other.bucket_count_;
+    bucket_count_.store(other.bucket_count_.load(std::memory_order_relaxed),
+                        std::memory_order_release);
 
-    other.data_ = new Node[131]{};
-    other.bucket_count_ = 131;
-    for (std::uint64_t i = 0; i != other.bucket_count_; ++i) {
-      other.data_[i] = Node{};
-    }
+    other.buckets_.store(new Buckets{kDefaultBucketCount},
+                         std::memory_order_release);
+    other.bucket_count_.store(kDefaultBucketCount, std::memory_order_release);
     other.load_factor_ = 0.75;
     other.size_.store(0, std::memory_order_relaxed);
 
@@ -900,90 +1058,36 @@ class ConcurrentHashTable {
   }
 
  public:
-  bool Empty() const { return size_.load(std::memory_order_consume) == 0; }
+  bool Empty() const { return size_.load(std::memory_order_acquire) == 0; }
 
-  std::uint64_t Size() const { return size_.load(std::memory_order_consume); }
+  std::uint64_t Size() const { return size_.load(std::memory_order_acquire); }
 
-  std::uint64_t BucketCount() const { return bucket_count_; }
+  std::uint64_t BucketCount() const {
+    return bucket_count_.load(std::memory_order_acquire);
+  }
 
   void Clear() {
     LockAllGuard guard{*this};
-    for (std::uint64_t i = 0; i != bucket_count_; ++i) {
-      if (data_[i].object_ != nullptr) {
-        DeleteOneList(&data_[i]);
-      }
-    }
+    ResetBuckets(new Buckets{bucket_count_.load(std::memory_order_relaxed)});
 
     size_.store(0, std::memory_order_relaxed);
   }
 
   std::pair<ReturnType&, bool> Insert(const ObjectType& object) {
-    return Insert(object, MultiTrait{});
+    return InsertImp(object, MultiTrait{});
   }
 
   std::pair<ReturnType&, bool> Insert(ObjectType&& other) {
-    return Insert(std::move(other), MultiTrait{});
+    return InsertImp(std::move(other), MultiTrait{});
   }
 
   template <typename... Args>
   std::pair<ReturnType&, bool> Emplace(Args&&... args) {
-    return Emplace(MultiTrait{}, std::forward<Args>(args)...);
+    return InsertImp(ObjectType{std::forward<Args>(args)...}, MultiTrait{});
   }
 
   Result<Nil, ErrorResult> Erase(ObjectType* object_ptr) {
-    if (object_ptr == nullptr) {
-      return Result<Nil, ErrorResult>(
-          st_execute_error, ErrorCode::INPUT_PARAMETERS_ARE_NOT_SUITABLE);
-    }
-
-    std::uint64_t hash_code = GetObjectHash(*object_ptr);
-    LockGuard<UniqueLockType> guard{*this, hash_code};
-    MutexType* new_mutex = &guard.ChooseMutex(hash_code);
-    while (new_mutex != guard.guard_.mutex()) {
-      guard.Unlock();
-      guard.guard_ = std::move(std::unique_lock(*new_mutex));
-      new_mutex = &guard.ChooseMutex(hash_code);
-    }
-
-    std::uint64_t data_offset = hash_code % bucket_count_;
-    if (data_[data_offset].object_ == nullptr) {
-      return Result<Nil, ErrorResult>(
-          st_execute_error,
-          ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
-    }
-
-    Node* first_node = &data_[data_offset];
-    if (first_node->object_.get() == object_ptr) {
-      if (data_[data_offset].next_node_) {
-        Node* old_node = first_node->next_node_;
-        data_[data_offset] = std::move(*(first_node->next_node_));
-        delete old_node;
-      } else {
-        data_[data_offset].object_.reset();
-      }
-      size_.fetch_sub(1, std::memory_order_relaxed);
-
-      return Result<Nil, ErrorResult>(st_execute_success);
-    }
-
-    while (first_node->next_node_ != nullptr &&
-           first_node->next_node_->object_.get() != object_ptr) {
-      first_node = first_node->next_node_;
-    }
-
-    if (first_node->next_node_ != nullptr &&
-        first_node->next_node_->object_.get() == object_ptr) {
-      Node* old_next_node = first_node->next_node_;
-      first_node->next_node_ = first_node->next_node_->next_node_;
-      delete old_next_node;
-      size_.fetch_sub(1, std::memory_order_relaxed);
-
-      return Result<Nil, ErrorResult>(st_execute_success);
-    }
-
-    return Result<Nil, ErrorResult>(
-        st_execute_error,
-        ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+    return Erase(const_cast<const ObjectType*>(object_ptr));
   }
 
   Result<Nil, ErrorResult> Erase(const ObjectType* object_ptr) {
@@ -993,6 +1097,7 @@ class ConcurrentHashTable {
     }
 
     std::uint64_t hash_code = GetObjectHash(*object_ptr);
+    MigrateSomeBuckets();
     LockGuard<UniqueLockType> guard{*this, hash_code};
     MutexType* new_mutex = &guard.ChooseMutex(hash_code);
     while (new_mutex != guard.guard_.mutex()) {
@@ -1000,51 +1105,34 @@ class ConcurrentHashTable {
       guard.guard_ = std::move(std::unique_lock(*new_mutex));
       new_mutex = &guard.ChooseMutex(hash_code);
     }
+    EpochGuard epoch_guard{};
+    MigrateBucketOf(hash_code);
 
-    std::uint64_t data_offset = hash_code % bucket_count_;
-    if (data_[data_offset].object_ == nullptr) {
+    std::atomic<Node*>* link = &GetBucketHead(hash_code);
+    Node* node = link->load(std::memory_order_relaxed);
+    while (node != nullptr && node->object_ != object_ptr) {
+      link = &node->next_node_;
+      node = link->load(std::memory_order_relaxed);
+    }
+
+    if (node == nullptr) {
       return Result<Nil, ErrorResult>(
           st_execute_error,
           ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
     }
 
-    Node* first_node = &data_[data_offset];
-    if (first_node->object_.get() == object_ptr) {
-      if (data_[data_offset].next_node_) {
-        Node* old_node = first_node->next_node_;
-        data_[data_offset] = std::move(*(first_node->next_node_));
-        delete old_node;
-      } else {
-        data_[data_offset].object_.reset();
-      }
-      size_.fetch_sub(1, std::memory_order_relaxed);
-
-      return Result<Nil, ErrorResult>(st_execute_success);
-    }
-
-    while (first_node->next_node_ != nullptr &&
-           first_node->next_node_->object_.get() != object_ptr) {
-      first_node = first_node->next_node_;
-    }
-
-    if (first_node->next_node_ != nullptr &&
-        first_node->next_node_->object_.get() == object_ptr) {
-      Node* old_next_node = first_node->next_node_;
-      first_node->next_node_ = first_node->next_node_->next_node_;
-      delete old_next_node;
-      size_.fetch_sub(1, std::memory_order_relaxed);
-
-      return Result<Nil, ErrorResult>(st_execute_success);
-    }
+    link->store(node->next_node_.load(std::memory_order_relaxed),
+                std::memory_order_release);
+    RetireNode(node);
+    size_.fetch_sub(1, std::memory_order_relaxed);
 
-    return Result<Nil, ErrorResult>(
-        st_execute_error,
-        ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+    return Result<Nil, ErrorResult>(st_execute_success);
   }
 
   template <typename K>
   std::uint32_t Erase(const K& key) {
     std::uint64_t hash_code = GetObjectHash(key);
+    MigrateSomeBuckets();
     LockGuard<UniqueLockType> guard{*this, hash_code};
     MutexType* new_mutex = &guard.ChooseMutex(hash_code);
     while (new_mutex != guard.guard_.mutex()) {
@@ -1052,38 +1140,22 @@ class ConcurrentHashTable {
       guard.guard_ = std::move(std::unique_lock(*new_mutex));
       new_mutex = &guard.ChooseMutex(hash_code);
     }
-
-    std::uint64_t data_offset = hash_code % bucket_count_;
-    if (data_[data_offset].object_ == nullptr) {
-      return 0;
-    }
+    EpochGuard epoch_guard{};
+    MigrateBucketOf(hash_code);
 
     std::uint32_t count = 0;
-    while (KeyEqual(*(data_[data_offset].object_), key)) {
-      if (data_[data_offset].next_node_) {
-        Node* old_node = data_[data_offset].next_node_;
-        data_[data_offset] = std::move(*(data_[data_offset].next_node_));
-        delete old_node;
+    std::atomic<Node*>* link = &GetBucketHead(hash_code);
+    Node* node = link->load(std::memory_order_relaxed);
+    while (node != nullptr) {
+      Node* next_node = node->next_node_.load(std::memory_order_relaxed);
+      if (KeyEqual(*(node->object_), key)) {
+        link->store(next_node, std::memory_order_release);
+        RetireNode(node);
         ++count;
       } else {
-        data_[data_offset].object_.reset();
-        ++count;
-
-        size_.fetch_sub(count, std::memory_order_relaxed);
-        return count;
-      }
-    }
-
-    Node* node_ptr = &data_[data_offset];
-    while (node_ptr->next_node_) {
-      if (KeyEqual(*(node_ptr->next_node_->object_), key)) {
-        Node* old_nex_node = node_ptr->next_node_;
-        node_ptr->next_node_ = node_ptr->next_node_->next_node_;
-        delete old_nex_node;
-        ++count;
-        continue;
+        link = &node->next_node_;
       }
-      node_ptr = node_ptr->next_node_;
+      node = next_node;
     }
 
     size_.fetch_sub(count, std::memory_order_relaxed);
@@ -1094,25 +1166,14 @@ class ConcurrentHashTable {
   template <typename K>
   std::uint32_t Count(const K& key) const {
     std::uint64_t hash_code = GetObjectHash(key);
-    LockGuard<SharedLockType> guard(*this, hash_code);
-    MutexType* new_mutex = &guard.ChooseMutex(hash_code);
-    while (new_mutex != guard.guard_.mutex()) {
-      guard.Unlock();
-      guard.guard_ = std::move(std::shared_lock(*new_mutex));
-      new_mutex = &guard.ChooseMutex(hash_code);
-    }
-
-    const Node* first_node = &data_[hash_code % bucket_count_];
-    if (first_node->object_ == nullptr) {
-      return 0;
-    }
+    EpochGuard guard{};
 
     std::uint32_t count = 0;
-    while (first_node) {
-      if (KeyEqual(*(first_node->object_), key)) {
+    for (const Node* node = LoadBucketFirstNode(hash_code); node != nullptr;
+         node = node->next_node_.load(std::memory_order_acquire)) {
+      if (KeyEqual(*(node->object_), key)) {
         ++count;
       }
-      first_node = first_node->next_node_;
     }
 
     return count;
@@ -1121,25 +1182,13 @@ class ConcurrentHashTable {
   template <typename K>
   ReturnType* Find(const K& key) {
     std::uint64_t hash_code = GetObjectHash(key);
-    LockGuard<SharedLockType> guard(*this, hash_code);
-    MutexType* new_mutex = &guard.ChooseMutex(hash_code);
-    while (new_mutex != guard.guard_.mutex()) {
-      guard.Unlock();
-      guard.guard_ = std::move(std::shared_lock(*new_mutex));
-      new_mutex = &guard.ChooseMutex(hash_code);
-    }
+    EpochGuard guard{};
 
-    Node* first_node = &data_[hash_code % bucket_count_];
-
-    if (first_node->object_) {
-      while (first_node) {
-        if (KeyEqual(*(first_node->object_), key)) {
-          return first_node->object_.get();
-        }
-        first_node = first_node->next_node_;
+    for (Node* node = LoadBucketFirstNode(hash_code); node != nullptr;
+         node = node->next_node_.load(std::memory_order_acquire)) {
+      if (KeyEqual(*(node->object_), key)) {
+        return node->object_;
       }
-
-      return nullptr;
     }
 
     return nullptr;
@@ -1148,25 +1197,13 @@ class ConcurrentHashTable {
   template <typename K>
   const ReturnType* Find(const K& key) const {
     std::uint64_t hash_code = GetObjectHash(key);
-    LockGuard<SharedLockType> guard(*this, hash_code);
-    MutexType* new_mutex = &guard.ChooseMutex(hash_code);
-    while (new_mutex != guard.guard_.mutex()) {
-      guard.Unlock();
-      guard.guard_ = std::move(std::shared_lock(*new_mutex));
-      new_mutex = &guard.ChooseMutex(hash_code);
-    }
+    EpochGuard guard{};
 
-    const Node* first_node = &data_[hash_code % bucket_count_];
-
-    if (first_node->object_) {
-      while (first_node) {
-        if (KeyEqual(*(first_node->object_), key)) {
-          return first_node->object_.get();
-        }
-        first_node = first_node->next_node_;
+    for (const Node* node = LoadBucketFirstNode(hash_code); node != nullptr;
+         node = node->next_node_.load(std::memory_order_acquire)) {
+      if (KeyEqual(*(node->object_), key)) {
+        return node->object_;
       }
-
-      return nullptr;
     }
 
     return nullptr;
@@ -1178,168 +1215,99 @@ class ConcurrentHashTable {
   }
 
   std::vector<ReturnType*> EqualRange(const KeyType& key) {
-    std::uint64_t hash_code = Hash{}(key);
-    LockGuard<SharedLockType> guard{*this, hash_code};
-    MutexType* new_mutex = &guard.ChooseMutex(hash_code);
-    while (new_mutex != guard.guard_.mutex()) {
-      guard.Unlock();
-      guard.guard_ = std::move(std::shared_lock(*new_mutex));
-      new_mutex = &guard.ChooseMutex(hash_code);
-    }
-
-    Node* first_node = &data_[hash_code % bucket_count_];
-
-    if (first_node->object_ == nullptr) {
-      return std::vector<ReturnType*>{};
-    }
+    std::uint64_t hash_code = GetObjectHash(key);
+    EpochGuard guard{};
 
     std::vector<ReturnType*> result;
-    while (first_node) {
-      if (KeyEqual(*(first_node->object_), key)) {
-        result.emplace_back(first_node->object_.get());
+    for (Node* node = LoadBucketFirstNode(hash_code); node != nullptr;
+         node = node->next_node_.load(std::memory_order_acquire)) {
+      if (KeyEqual(*(node->object_), key)) {
+        result.emplace_back(node->object_);
       }
-
-      first_node = first_node->next_node_;
     }
 
     return result;
   }
 
   std::vector<const ReturnType*> EqualRange(const KeyType& key) const {
-    std::uint64_t hash_code = Hash{}(key);
-    LockGuard<SharedLockType> guard{*this, hash_code};
-    MutexType* new_mutex = &guard.ChooseMutex(hash_code);
-    while (new_mutex != guard.guard_.mutex()) {
-      guard.Unlock();
-      guard.guard_ = std::move(std::shared_lock(*new_mutex));
-      new_mutex = &guard.ChooseMutex(hash_code);
-    }
-
-    const Node* first_node = data_[hash_code % bucket_count_];
-
-    if (first_node->object_ == nullptr) {
-      return std::vector<const ReturnType>{};
-    }
+    std::uint64_t hash_code = GetObjectHash(key);
+    EpochGuard guard{};
 
     std::vector<const ReturnType*> result;
-    while (first_node) {
-      if (KeyEqual(*(first_node->object_), key)) {
-        result.emplace_back(first_node->object_.get());
+    for (const Node* node = LoadBucketFirstNode(hash_code); node != nullptr;
+         node = node->next_node_.load(std::memory_order_acquire)) {
+      if (KeyEqual(*(node->object_), key)) {
+        result.emplace_back(node->object_);
       }
-
-      first_node = first_node->next_node_;
     }
 
     return result;
   }
 
   void ReHash(std::uint64_t new_bucket_size) {
-    if (new_bucket_size > bucket_count_) {
-      LockAllGuard guard{*this};
-
-      new_bucket_size = MinPrime(new_bucket_size);
-
-      Node* new_data = new Node[new_bucket_size]{};
+    if (new_bucket_size <= bucket_count_.load(std::memory_order_acquire)) {
+      return;
+    }
 
-      for (std::uint64_t i = 0; i != new_bucket_size; ++i) {
-        new_data[i] = Node{};
+    LockAllGuard guard{*this};
+    // Another writer may have grown the table while we waited for the locks.
+    if (new_bucket_size <= bucket_count_.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    new_bucket_size = BucketCountFor(new_bucket_size);
+    if constexpr (kIsPowerOfTwoBucket) {
+      StartMigration(new_bucket_size);
+      return;
+    }
+
+    // Readers may still be walking the old chains, so they are left untouched
+    // and every element gets a new node in the new bucket array.
+    Buckets* old_buckets = buckets_.load(std::memory_order_relaxed);
+    auto* new_buckets = new Buckets{new_bucket_size};
+    // Append to the tail of every new bucket, so that elements with equal keys
+    // keep their relative order.
+    std::vector<std::atomic<Node*>*> new_tails(new_bucket_size);
+    for (std::uint64_t i = 0; i != new_bucket_size; ++i) {
+      new_tails[i] = &new_buckets->heads_[i];
+    }
+    for (std::uint64_t i = 0; i != old_buckets->bucket_count_; ++i) {
+      for (Node* node = old_buckets->heads_[i].load(std::memory_order_relaxed);
+           node != nullptr;
+           node = node->next_node_.load(std::memory_order_relaxed)) {
+        std::atomic<Node*>*& new_tail = new_tails[BucketIndex(
+            GetObjectHash(*(node->object_)), new_bucket_size)];
+        auto* new_node = new Node{node->object_, nullptr};
+        new_tail->store(new_node, std::memory_order_relaxed);
+        new_tail = &new_node->next_node_;
       }
+    }
 
-      for (std::uint64_t i = 0; i != bucket_count_; ++i) {
-        if (data_[i].object_) {
-          std::uint64_t insert_pos =
-              GetObjectHash(*(data_[i].object_)) % new_bucket_size;
+    buckets_.store(new_buckets, std::memory_order_release);
+    bucket_count_.store(new_bucket_size, std::memory_order_release);
+    EpochDomain::GetInstance()->Retire(old_buckets, &DeleteBucketNodes);
+  }
 
-          bool insert_first = false;
-          if (new_data[insert_pos].object_ == nullptr) {
-            new_data[insert_pos].object_ = std::move(data_[i].object_);
-            insert_first = true;
-          }
+  double GetLoadFactor() const { return load_factor_; }
 
-          if (!insert_first) {
-            Node* new_data_first_node = &new_data[insert_pos];
-            while (new_data_first_node->next_node_) {
-              new_data_first_node = new_data_first_node->next_node_;
-            }
-            new_data_first_node->next_node_ =
-                new Node{std::move(data_[i].object_), nullptr};
-          }
+  void SetLoadFactor(double new_load_factor) {
+    LockAllGuard guard(*this);
+    load_factor_ = new_load_factor;
+  }
 
-          Node* old_data_first_node = data_[i].next_node_;
-          while (old_data_first_node) {
-            insert_pos = GetObjectHash(*(old_data_first_node->object_)) %
-                         new_bucket_size;
+  std::uint64_t StripeCount() const { return data_mutexes_.StripeCount(); }
 
-            if (new_data[insert_pos].object_ == nullptr) {
-              new_data[insert_pos].object_ =
-                  std::move(old_data_first_node->object_);
-              Node* delete_old_node = old_data_first_node;
-              old_data_first_node = old_data_first_node->next_node_;
-              delete delete_old_node;
-              continue;
-            }
+  void LockAll() const { data_mutexes_.LockAll(); }
 
-            Node* new_data_first_node = &new_data[insert_pos];
-            while (new_data_first_node->next_node_) {
-              new_data_first_node = new_data_first_node->next_node_;
-            }
-            new_data_first_node->next_node_ =
-                new Node{std::move(old_data_first_node->object_), nullptr};
-            Node* delete_old_node = old_data_first_node;
-            old_data_first_node = old_data_first_node->next_node_;
-            delete delete_old_node;
-          }
-        }
-      }
-
-      bucket_count_ = new_bucket_size;
-      delete[] data_;
-      data_ = new_data;
-    }
-  }
-
-  double GetLoadFactor() const { return load_factor_; }
-
-  void SetLoadFactor(double new_load_factor) {
-    LockAllGuard guard(*this);
-    load_factor_ = new_load_factor;
-  }
-
-  Node* Data() { return data_; }
-
-  Node* Data() const { return data_; }
-
-  void LockAll() const {
-    std::lock(data_mutex0_, data_mutex1_, data_mutex2_, data_mutex3_,
-              data_mutex4_, data_mutex5_, data_mutex6_, data_mutex7_,
-              data_mutex8_, data_mutex9_, data_mutex10_, data_mutex11_,
-              data_mutex12_, data_mutex13_, data_mutex14_, data_mutex15_);
-  }
-
-  void UnlockAll() const {
-    data_mutex0_.unlock();
-    data_mutex1_.unlock();
-    data_mutex2_.unlock();
-    data_mutex3_.unlock();
-    data_mutex4_.unlock();
-    data_mutex5_.unlock();
-    data_mutex6_.unlock();
-    data_mutex7_.unlock();
-    data_mutex8_.unlock();
-    data_mutex9_.unlock();
-    data_mutex10_.unlock();
-    data_mutex11_.unlock();
-    data_mutex12_.unlock();
-    data_mutex13_.unlock();
-    data_mutex14_.unlock();
-    data_mutex15_.unlock();
-  }
+  void UnlockAll() const { data_mutexes_.UnlockAll(); }
 
  private:
-  std::pair<ReturnType&, bool> Insert(const ObjectType& other, NotMulti) {
+  template <typename ObjectArg>
+  std::pair<ReturnType&, bool> InsertImp(ObjectArg&& object, NotMulti) {
     RehashWhenNeed();
 
-    std::uint64_t hash_code = GetObjectHash(other);
+    std::uint64_t hash_code = GetObjectHash(object);
+    MigrateSomeBuckets();
     LockGuard<UniqueLockType> guard(*this, hash_code);
     MutexType* new_mutex = &guard.ChooseMutex(hash_code);
     while (new_mutex != guard.guard_.mutex()) {
@@ -1347,34 +1315,31 @@ class ConcurrentHashTable {
       guard.guard_ = std::move(std::unique_lock(*new_mutex));
       new_mutex = &guard.ChooseMutex(hash_code);
     }
+    EpochGuard epoch_guard{};
+    MigrateBucketOf(hash_code);
 
-    std::uint64_t data_offset = hash_code % bucket_count_;
-    if (data_[data_offset].object_ == nullptr) {
-      data_[data_offset].object_ = std::make_unique<ObjectType>(other);
-      size_.fetch_add(1, std::memory_order_relaxed);
-      return {*(data_[data_offset].object_), true};
-    }
-
-    Node* first_node = &data_[data_offset];
-    while (first_node) {
-      if (KeyEqual(*(first_node->object_), other)) {
-        return {*(first_node->object_), false};
+    std::atomic<Node*>& head = GetBucketHead(hash_code);
+    Node* first_node = head.load(std::memory_order_relaxed);
+    for (Node* node = first_node; node != nullptr;
+         node = node->next_node_.load(std::memory_order_relaxed)) {
+      if (KeyEqual(*(node->object_), object)) {
+        return {*(node->object_), false};
       }
-
-      first_node = first_node->next_node_;
     }
 
-    Node* old_first_node = new Node{std::move(data_[data_offset])};
-    data_[data_offset] =
-        Node{std::make_unique<ObjectType>(other), old_first_node};
+    auto* new_node = new Node{
+        new ObjectType(std::forward<ObjectArg>(object)), first_node};
+    head.store(new_node, std::memory_order_release);
     size_.fetch_add(1, std::memory_order_relaxed);
-    return {*(data_[data_offset].object_), true};
+    return {*(new_node->object_), true};
   }
 
-  std::pair<ReturnType&, bool> Insert(const ObjectType& other, IsMulti) {
+  template <typename ObjectArg>
+  std::pair<ReturnType&, bool> InsertImp(ObjectArg&& object, IsMulti) {
     RehashWhenNeed();
 
-    std::uint64_t hash_code = GetObjectHash(other);
+    std::uint64_t hash_code = GetObjectHash(object);
+    MigrateSomeBuckets();
     LockGuard<UniqueLockType> guard(*this, hash_code);
     MutexType* new_mutex = &guard.ChooseMutex(hash_code);
     while (new_mutex != guard.guard_.mutex()) {
@@ -1382,142 +1347,338 @@ class ConcurrentHashTable {
       guard.guard_ = std::move(std::unique_lock(*new_mutex));
       new_mutex = &guard.ChooseMutex(hash_code);
     }
+    EpochGuard epoch_guard{};
+    MigrateBucketOf(hash_code);
 
-    std::uint64_t data_offset = hash_code % bucket_count_;
-    if (data_[data_offset].object_ == nullptr) {
-      data_[data_offset].object_ = std::make_unique<ObjectType>(other);
-      size_.fetch_add(1, std::memory_order_relaxed);
-      return {*(data_[data_offset].object_), true};
-    }
-
-    Node* old_first_node = new Node{std::move(data_[data_offset])};
-    data_[data_offset] =
-        Node{std::make_unique<ObjectType>(other), old_first_node};
+    std::atomic<Node*>& head = GetBucketHead(hash_code);
+    auto* new_node =
+        new Node{new ObjectType(std::forward<ObjectArg>(object)),
+                 head.load(std::memory_order_relaxed)};
+    head.store(new_node, std::memory_order_release);
     size_.fetch_add(1, std::memory_order_relaxed);
-    return {*(data_[data_offset].object_), true};
+    return {*(new_node->object_), true};
+  }
+
+  /**
+   * \remark The caller must hold the stripe lock of \ref hash_code.
+   */
+  std::atomic<Node*>& GetBucketHead(std::uint64_t hash_code) const {
+    Buckets* buckets = buckets_.load(std::memory_order_relaxed);
+    return buckets->heads_[BucketIndex(hash_code, buckets->bucket_count_)];
+  }
+
+  /**
+   * \remark The caller must be inside an \ref EpochGuard.
+   */
+  Node* LoadBucketFirstNode(std::uint64_t hash_code) const {
+    while (true) {
+      const Buckets* buckets = buckets_.load(std::memory_order_acquire);
+      const Buckets* old_buckets = old_buckets_.load(std::memory_order_acquire);
+      if (old_buckets != nullptr && old_buckets != buckets) {
+        Node* first_node =
+            old_buckets
+                ->heads_[BucketIndex(hash_code, old_buckets->bucket_count_)]
+                .load(std::memory_order_acquire);
+        if (first_node != MovedNode()) {
+          return first_node;
+        }
+      }
+
+      Node* first_node =
+          buckets->heads_[BucketIndex(hash_code, buckets->bucket_count_)].load(
+              std::memory_order_acquire);
+      if (first_node != MovedNode()) {
+        return first_node;
+      }
+      // This bucket array became the old one of a newer rehash after it was
+      // loaded, load the arrays again.
+    }
   }
 
-  std::pair<ReturnType&, bool> Insert(ObjectType&& other, NotMulti) {
-    RehashWhenNeed();
+  /**
+   * \brief Returns the node that marks an old bucket whose nodes have been
+   * moved to the new bucket array.
+   */
+  static Node* MovedNode() {
+    static Node moved_node{nullptr, nullptr};
+    return &moved_node;
+  }
 
-    std::uint64_t hash_code = GetObjectHash(other);
-    LockGuard<UniqueLockType> guard(*this, hash_code);
-    MutexType* new_mutex = &guard.ChooseMutex(hash_code);
-    while (new_mutex != guard.guard_.mutex()) {
-      guard.Unlock();
-      guard.guard_ = std::move(std::unique_lock(*new_mutex));
-      new_mutex = &guard.ChooseMutex(hash_code);
+  /**
+   * \remark The caller must hold every stripe lock.
+   */
+  Buckets* CopyBuckets() const {
+    const Buckets* old_buckets = old_buckets_.load(std::memory_order_relaxed);
+    const Buckets* buckets = buckets_.load(std::memory_order_relaxed);
+    auto* new_buckets = new Buckets{buckets->bucket_count_};
+    std::vector<std::atomic<Node*>*> new_tails(buckets->bucket_count_);
+    for (std::uint64_t i = 0; i != buckets->bucket_count_; ++i) {
+      new_tails[i] = &new_buckets->heads_[i];
     }
 
-    std::uint64_t data_offset = hash_code % bucket_count_;
-    if (data_[data_offset].object_ == nullptr) {
-      data_[data_offset].object_ =
-          std::make_unique<ObjectType>(std::move(other));
-      size_.fetch_add(1, std::memory_order_relaxed);
-      return {*(data_[data_offset].object_), true};
+    // All elements with equal keys are either in an old bucket that has not
+    // been moved yet or in the new one, so appending keeps their order.
+    for (const Buckets* other : {old_buckets, buckets}) {
+      if (other == nullptr) {
+        continue;
+      }
+      for (std::uint64_t i = 0; i != other->bucket_count_; ++i) {
+        const Node* other_node = other->heads_[i].load(std::memory_order_relaxed);
+        if (other_node == MovedNode()) {
+          continue;
+        }
+        for (; other_node != nullptr;
+             other_node = other_node->next_node_.load(std::memory_order_relaxed)) {
+          std::atomic<Node*>*& new_tail = new_tails[BucketIndex(
+              GetObjectHash(*(other_node->object_)), buckets->bucket_count_)];
+          auto* node =
+              new Node{new ObjectType(*(other_node->object_)), nullptr};
+          new_tail->store(node, std::memory_order_relaxed);
+          new_tail = &node->next_node_;
+        }
+      }
     }
 
-    Node* first_node = &data_[data_offset];
-    while (first_node) {
-      if (KeyEqual(*(first_node->object_), other)) {
-        return {*(first_node->object_), false};
-      }
+    return new_buckets;
+  }
 
-      first_node = first_node->next_node_;
+  /**
+   * \brief Replaces the bucket arrays, the old ones are retired.
+   * \remark The caller must hold every stripe lock.
+   */
+  void ResetBuckets(Buckets* new_buckets) {
+    RetireBuckets(old_buckets_.exchange(nullptr, std::memory_order_acq_rel));
+    RetireBuckets(buckets_.exchange(new_buckets, std::memory_order_acq_rel));
+  }
+
+  /**
+   * \brief Publishes a new bucket array and makes the current one the old
+   * array, whose buckets are moved by the following writes.
+   * \remark The caller must hold every stripe lock.
+   */
+  void StartMigration(std::uint64_t new_bucket_count) {
+    MigrateAllBuckets();
+
+    Buckets* old_buckets = buckets_.load(std::memory_order_relaxed);
+    old_buckets_.store(old_buckets, std::memory_order_release);
+    buckets_.store(new Buckets{new_bucket_count}, std::memory_order_release);
+    bucket_count_.store(new_bucket_count, std::memory_order_release);
+
+    // With fewer buckets than stripes an old bucket is split across several
+    // stripes, so it can only be moved while every stripe is locked.
+    if (old_buckets->bucket_count_ < StripeCount()) {
+      MigrateAllBuckets();
     }
+  }
 
-    Node* old_first_node = new Node{std::move(data_[data_offset])};
-    data_[data_offset] =
-        Node{std::make_unique<ObjectType>(std::move(other)), old_first_node};
-    size_.fetch_add(1, std::memory_order_relaxed);
-    return {*(data_[data_offset].object_), true};
+  /**
+   * \brief Moves every old bucket that is left.
+   * \remark The caller must hold every stripe lock.
+   */
+  void MigrateAllBuckets() {
+    Buckets* old_buckets = old_buckets_.load(std::memory_order_relaxed);
+    if (old_buckets == nullptr) {
+      return;
+    }
+
+    EpochGuard epoch_guard{};
+    for (std::uint64_t i = 0; i != old_buckets->bucket_count_; ++i) {
+      if (MigrateBucket(old_buckets, i)) {
+        FinishBucketMigration(old_buckets);
+      }
+    }
   }
 
-  std::pair<ReturnType&, bool> Insert(ObjectType&& other, IsMulti) {
-    RehashWhenNeed();
+  /**
+   * \brief Moves up to \ref kMigrateBucketsPerOperation old buckets.
+   * \remark The caller must not hold any stripe lock.
+   */
+  void MigrateSomeBuckets() {
+    if (old_buckets_.load(std::memory_order_relaxed) == nullptr) {
+      return;
+    }
 
-    std::uint64_t hash_code = GetObjectHash(other);
-    LockGuard<UniqueLockType> guard(*this, hash_code);
-    MutexType* new_mutex = &guard.ChooseMutex(hash_code);
-    while (new_mutex != guard.guard_.mutex()) {
-      guard.Unlock();
-      guard.guard_ = std::move(std::unique_lock(*new_mutex));
-      new_mutex = &guard.ChooseMutex(hash_code);
+    EpochGuard epoch_guard{};
+    Buckets* old_buckets = old_buckets_.load(std::memory_order_acquire);
+    if (old_buckets == nullptr) {
+      return;
     }
+    for (std::uint64_t i = 0; i != kMigrateBucketsPerOperation; ++i) {
+      std::uint64_t old_index =
+          old_buckets->migrate_cursor_.fetch_add(1, std::memory_order_relaxed);
+      if (old_index >= old_buckets->bucket_count_) {
+        return;
+      }
 
-    std::uint64_t data_offset = hash_code % bucket_count_;
-    if (data_[data_offset].object_ == nullptr) {
-      data_[data_offset].object_ =
-          std::make_unique<ObjectType>(std::move(other));
-      size_.fetch_add(1, std::memory_order_relaxed);
-      return {*(data_[data_offset].object_), true};
+      std::unique_lock<MutexType> guard{data_mutexes_.ChooseMutex(old_index)};
+      if (MigrateBucket(old_buckets, old_index)) {
+        FinishBucketMigration(old_buckets);
+      }
     }
+  }
 
-    Node* old_first_node = new Node{std::move(data_[data_offset])};
-    data_[data_offset] =
-        Node{std::make_unique<ObjectType>(std::move(other)), old_first_node};
-    size_.fetch_add(1, std::memory_order_relaxed);
+  /**
+   * \brief Moves the old bucket of \ref hash_code before a write touches the
+   * new one.
+   * \remark The caller must hold the stripe lock of \ref hash_code and be
+   * inside an \ref EpochGuard.
+   */
+  void MigrateBucketOf(std::uint64_t hash_code) {
+    Buckets* old_buckets = old_buckets_.load(std::memory_order_acquire);
+    if (old_buckets != nullptr &&
+        MigrateBucket(old_buckets,
+                      BucketIndex(hash_code, old_buckets->bucket_count_))) {
+      FinishBucketMigration(old_buckets);
+    }
+  }
+
+  /**
+   * \brief Gives every element of an old bucket a node in the new bucket array.
+   * \return True if this call moved the bucket, false if it had already been
+   * moved.
+   * \remark The caller must hold the stripe lock of \ref old_index and be
+   * inside an \ref EpochGuard. Both bucket counts are powers of two that are
+   * not smaller than the stripe count, so the old bucket and every new bucket
+   * it splits into are guarded by that one stripe.
+   */
+  bool MigrateBucket(Buckets* old_buckets, std::uint64_t old_index) {
+    Node* first_node =
+        old_buckets->heads_[old_index].load(std::memory_order_relaxed);
+    if (first_node == MovedNode()) {
+      return false;
+    }
+
+    // Writers move the old bucket before they touch a new one, so the new
+    // buckets are still empty apart from the nodes appended here.
+    Buckets* buckets = buckets_.load(std::memory_order_relaxed);
+    for (Node* node = first_node; node != nullptr;
+         node = node->next_node_.load(std::memory_order_relaxed)) {
+      std::atomic<Node*>* new_tail =
+          &buckets->heads_[BucketIndex(GetObjectHash(*(node->object_)),
+                                       buckets->bucket_count_)];
+      for (Node* tail_node = new_tail->load(std::memory_order_relaxed);
+           tail_node != nullptr;
+           tail_node = new_tail->load(std::memory_order_relaxed)) {
+        new_tail = &tail_node->next_node_;
+      }
+      new_tail->store(new Node{node->object_, nullptr},
+                      std::memory_order_release);
+    }
 
-    return {*(data_[data_offset].object_), true};
+    old_buckets->heads_[old_index].store(MovedNode(), std::memory_order_release);
+    EpochDomain::GetInstance()->Retire(first_node, &DeleteNodeChain);
+
+    return true;
   }
 
-  template <typename... Args>
-  std::pair<ReturnType&, bool> Emplace(NotMulti, Args&&... args) {
-    return Insert(ObjectType{std::forward<Args>(args)...}, NotMulti{});
+  /**
+   * \brief Counts one moved bucket. The old bucket array is retired after the
+   * last one.
+   */
+  void FinishBucketMigration(Buckets* old_buckets) {
+    if (old_buckets->migrated_count_.fetch_add(1, std::memory_order_acq_rel) +
+            1 ==
+        old_buckets->bucket_count_) {
+      old_buckets_.store(nullptr, std::memory_order_release);
+      EpochDomain::GetInstance()->Retire(old_buckets);
+    }
   }
 
-  template <typename... Args>
-  std::pair<ReturnType&, bool> Emplace(IsMulti, Args&&... args) {
-    return Insert(ObjectType{std::forward<Args>(args)...}, IsMulti{});
+
+  static void DeleteNode(void* node) {
+    delete static_cast<Node*>(node)->object_;
+    delete static_cast<Node*>(node);
   }
 
-  void DeleteOneListNext(Node* node, std::uint32_t& count) {
-    if (node->next_node_) {
-      DeleteOneListNext(node->next_node_);
+  // Used after a bucket has been moved, the objects now belong to the nodes
+  // of the new bucket array.
+  static void DeleteNodeChain(void* first_node) {
+    auto* node = static_cast<Node*>(first_node);
+    while (node != nullptr) {
+      Node* next_node = node->next_node_.load(std::memory_order_relaxed);
+      delete node;
+      node = next_node;
     }
-
-    delete node;
-    ++count;
   }
 
-  void DeleteOneList(Node* node, std::uint32_t& count) {
-    if (node->next_node_) {
-      DeleteOneList(node->next_node_, count);
+  // Used after a rehash, the objects now belong to the nodes of the new
+  // bucket array.
+  static void DeleteBucketNodes(void* buckets) {
+    auto* old_buckets = static_cast<Buckets*>(buckets);
+    for (std::uint64_t i = 0; i != old_buckets->bucket_count_; ++i) {
+      DeleteNodeChain(old_buckets->heads_[i].load(std::memory_order_relaxed));
     }
 
-    node->object_.reset();
-    node->next_node_ = nullptr;
+    delete old_buckets;
   }
 
-  void DeleteOneListNext(Node* node) {
-    if (node->next_node_) {
-      DeleteOneListNext(node->next_node_);
+  static void DeleteBuckets(void* buckets) {
+    if (buckets == nullptr) {
+      return;
     }
 
-    delete node;
+    auto* old_buckets = static_cast<Buckets*>(buckets);
+    for (std::uint64_t i = 0; i != old_buckets->bucket_count_; ++i) {
+      Node* node = old_buckets->heads_[i].load(std::memory_order_relaxed);
+      if (node == MovedNode()) {
+        continue;
+      }
+      while (node != nullptr) {
+        Node* next_node = node->next_node_.load(std::memory_order_relaxed);
+        DeleteNode(node);
+        node = next_node;
+      }
+    }
+
+    delete old_buckets;
   }
 
-  void DeleteOneList(Node* node) {
-    assert(node != nullptr);
-    if (node->next_node_) {
-      DeleteOneListNext(node->next_node_);
+  static void RetireNode(Node* node) {
+    EpochDomain::GetInstance()->Retire(node, &DeleteNode);
+  }
+
+  static void RetireBuckets(Buckets* buckets) {
+    EpochDomain::GetInstance()->Retire(buckets, &DeleteBuckets);
+  }
+
+  static std::uint64_t BucketCountFor(std::uint64_t bucket_count) {
+    return kIsPowerOfTwoBucket ? MinPowerOfTwo(bucket_count)
+                               : MinPrime(bucket_count);
+  }
+
+  static std::uint64_t BucketIndex(std::uint64_t hash_code,
+                                   std::uint64_t bucket_count) {
+    if constexpr (kIsPowerOfTwoBucket) {
+      return hash_code & (bucket_count - 1);
+    } else {
+      return hash_code % bucket_count;
     }
+  }
 
-    node->object_.reset();
-    node->next_node_ = nullptr;
+  std::uint64_t BucketIndex(std::uint64_t hash_code) const {
+    return BucketIndex(hash_code,
+                       bucket_count_.load(std::memory_order_relaxed));
+  }
+
+  static std::uint64_t FinalizeHash(std::uint64_t hash_code) {
+    if constexpr (kIsPowerOfTwoBucket) {
+      return HashMix64(hash_code);
+    } else {
+      return hash_code;
+    }
   }
 
   std::uint64_t GetObjectHash(const ObjectType& object, IsMap) const {
-    return Hash{}(object.first);
+    return FinalizeHash(Hash{}(object.first));
   }
 
   std::uint64_t GetObjectHash(const ObjectType& object, IsSet) const {
-    return Hash{}(object);
+    return FinalizeHash(Hash{}(object));
   }
 
   template <typename K>
   std::uint64_t GetObjectHash(const K& key) const {
-    return Hash{}(key);
+    return FinalizeHash(Hash{}(key));
   }
 
   std::uint64_t GetObjectHash(const ObjectType& object) const {
@@ -1544,9 +1705,16 @@ class ConcurrentHashTable {
   }
 
   void RehashWhenNeed() {
-    if (size_.load(std::memory_order_consume) >
-        std::floor(bucket_count_ * load_factor_)) {
-      ReHash(2 * bucket_count_);
+    // The new bucket array is already twice as large, the next rehash waits
+    // until the current one has finished.
+    if (old_buckets_.load(std::memory_order_acquire) != nullptr) {
+      return;
+    }
+
+    std::uint64_t bucket_count = bucket_count_.load(std::memory_order_acquire);
+    if (size_.load(std::memory_order_acquire) >
+        std::floor(bucket_count * load_factor_)) {
+      ReHash(2 * bucket_count);
     }
   }
 
@@ -1557,12 +1725,6 @@ class ConcurrentHashTable {
         IfThenElseT<std::is_same_v<LockType, SharedLockType>,
                     std::shared_lock<MutexType>, std::unique_lock<MutexType>>;
 
-    LockGuard(const ThisType& hash_table, const KeyType& key)
-        : is_lock_(true), parent_(hash_table), guard_(ChooseMutex(key)) {}
-    LockGuard(const ThisType& hash_table, const KeyType& key, std::adopt_lock_t)
-        : is_lock_(true),
-          parent_(hash_table),
-          guard_(ChooseMutex(key), std::adopt_lock) {}
     LockGuard(const ThisType& hash_table, std::uint64_t hash_code)
         : is_lock_(true), parent_(hash_table), guard_(ChooseMutex(hash_code)) {}
     LockGuard(const ThisType& hash_table, std::uint64_t hash_code,
@@ -1585,47 +1747,7 @@ class ConcurrentHashTable {
     }
 
     MutexType& ChooseMutex(std::uint64_t hash_code) {
-      switch (hash_code % parent_.bucket_count_ & 0xF) {
-        case 0:
-          return parent_.data_mutex0_;
-        case 1:
-          return parent_.data_mutex1_;
-        case 2:
-          return parent_.data_mutex2_;
-        case 3:
-          return parent_.data_mutex3_;
-        case 4:
-          return parent_.data_mutex4_;
-        case 5:
-          return parent_.data_mutex5_;
-        case 6:
-          return parent_.data_mutex6_;
-        case 7:
-          return parent_.data_mutex7_;
-        case 8:
-          return parent_.data_mutex8_;
-        case 9:
-          return parent_.data_mutex9_;
-        case 10:
-          return parent_.data_mutex10_;
-        case 11:
-          return parent_.data_mutex11_;
-        case 12:
-          return parent_.data_mutex12_;
-        case 13:
-          return parent_.data_mutex13_;
-        case 14:
-          return parent_.data_mutex14_;
-        case 15:
-          return parent_.data_mutex15_;
-        default:
-          assert(false);
-          return parent_.data_mutex0_;
-      }
-    }
-
-    MutexType& ChooseMutex(const KeyType& key) {
-      return ChooseMutex(Hash{}(key));
+      return parent_.data_mutexes_.ChooseMutex(parent_.BucketIndex(hash_code));
     }
 
     void Unlock() {
@@ -1680,120 +1802,732 @@ class ConcurrentHashTable {
   };
 
   struct Node {
-    Node() = default;
-    Node(std::unique_ptr<ObjectType>&& object, Node* next_node)
-        : object_(std::move(object)), next_node_(next_node) {}
+    Node(ObjectType* object, Node* next_node)
+        : object_(object), next_node_(next_node) {}
     Node(const Node& other) = delete;
-    Node(Node&& other) noexcept
-        : object_(other.object_.release()), next_node_(other.next_node_) {
-      other.next_node_ = nullptr;
-    }
+    Node(Node&& other) = delete;
     Node& operator=(const Node& other) = delete;
-    Node& operator=(Node&& other) noexcept {
-      if (&other == this) {
-        return *this;
+    Node& operator=(Node&& other) = delete;
+    ~Node() = default;
+
+    // Never changes after the node is published, readers dereference it
+    // without any lock.
+    ObjectType* const object_;
+    std::atomic<Node*> next_node_;
+  };
+
+  struct Buckets {
+    explicit Buckets(std::uint64_t bucket_count)
+        : bucket_count_(bucket_count),
+          heads_(new std::atomic<Node*>[bucket_count]) {
+      for (std::uint64_t i = 0; i != bucket_count_; ++i) {
+        heads_[i].store(nullptr, std::memory_order_relaxed);
       }
+    }
+    Buckets(const Buckets& other) = delete;
+    Buckets(Buckets&& other) = delete;
+    Buckets& operator=(const Buckets& other) = delete;
+    Buckets& operator=(Buckets&& other) = delete;
+    ~Buckets() { delete[] heads_; }
+
+    const std::uint64_t bucket_count_;
+    std::atomic<Node*>* heads_;
+    // Only used while this is the old bucket array of an incremental rehash.
+    std::atomic_uint64_t migrate_cursor_{0};
+    std::atomic_uint64_t migrated_count_{0};
+  };
 
-      object_.reset(other.object_.release());
-      next_node_ = other.next_node_;
+ private:
+  std::atomic<Buckets*> buckets_{new Buckets{kDefaultBucketCount}};
+  std::atomic<Buckets*> old_buckets_{nullptr};
 
-      other.next_node_ = nullptr;
+  double load_factor_{0.75f};
+  std::atomic_uint64_t size_{0};
+  std::atomic_uint64_t bucket_count_{kDefaultBucketCount};
+
+  StripedMutex<MutexType> data_mutexes_{};
+};
 
+/**
+ * \brief Open addressing hash table that stores elements inline in one slot
+ * array. Every slot has a one byte control word (empty, deleted or the low 7
+ * bits of the hash). A probe loads the control bytes of \ref kGroupWidth
+ * consecutive slots as one 64-bit word and matches all of them at once, so
+ * keys are only compared for slots whose control byte matches.
+ * \remark Unlike \ref HashTable, elements are moved when the table grows, so
+ * pointers returned by \ref Insert, \ref Emplace and \ref Find are invalidated
+ * by any later insertion that triggers a rehash.
+ * \remark A moved-from table owns no storage and allocates again on the next
+ * insertion.
+ */
+template <typename RelationshipTrait, typename MultiTrait, typename KeyType,
+          typename ObjectType, typename ReturnType,
+          typename Hash = std::hash<KeyType>, typename Equal = std::equal_to<>,
+          typename Allocator = std::allocator<ObjectType>>
+class FlatHashTable {
+ public:
+  using ThisType =
+      FlatHashTable<RelationshipTrait, MultiTrait, KeyType, ObjectType,
+                    ReturnType, Hash, Equal, Allocator>;
+  using IsMap = TrueType;
+  using IsSet = FalseType;
+  using IsMulti = TrueType;
+  using NotMulti = FalseType;
+
+ private:
+  using AllocatorTraits = std::allocator_traits<Allocator>;
+  using ControlType = std::int8_t;
+
+  static constexpr ControlType kEmpty = -128;
+  static constexpr ControlType kDeleted = -2;
+  static constexpr std::uint64_t kMinCapacity = 16;
+  // The first kGroupWidth - 1 control bytes are cloned after the last one, so
+  // a group starting near the end of the table wraps around without a branch.
+  static constexpr std::uint64_t kGroupWidth = 8;
+  static constexpr std::uint64_t kLowBits = 0x0101010101010101ULL;
+  static constexpr std::uint64_t kHighBits = 0x8080808080808080ULL;
+
+ public:
+  FlatHashTable() { InitData(kMinCapacity); }
+  virtual ~FlatHashTable() { FreeData(); }
+  explicit FlatHashTable(std::uint64_t size) { InitData(CapacityFor(size)); }
+  FlatHashTable(const FlatHashTable& other)
+      : load_factor_(other.load_factor_) {
+    InitData(other.capacity_);
+    CopyFrom(other);
+  }
+  FlatHashTable(FlatHashTable&& other) noexcept
+      : control_(other.control_),
+        slots_(other.slots_),
+        load_factor_(other.load_factor_),
+        size_(other.size_),
+        deleted_count_(other.deleted_count_),
+        capacity_(other.capacity_) {
+    other.ReleaseData();
+  }
+  FlatHashTable& operator=(const FlatHashTable& other) {
+    if (&other == this) {
       return *this;
     }
-    ~Node() = default;
 
-    std::unique_ptr<ObjectType> object_{nullptr};
-    Node* next_node_{nullptr};
-  };
+    FreeData();
+    load_factor_ = other.load_factor_;
+    InitData(other.capacity_);
+    CopyFrom(other);
+
+    return *this;
+  }
+  FlatHashTable& operator=(FlatHashTable&& other) noexcept {
+    if (&other == this) {
+      return *this;
+    }
+
+    FreeData();
+    control_ = other.control_;
+    slots_ = other.slots_;
+    load_factor_ = other.load_factor_;
+    size_ = other.size_;
+    deleted_count_ = other.deleted_count_;
+    capacity_ = other.capacity_;
+
+    other.ReleaseData();
+
+    return *this;
+  }
+
+ public:
+  bool Empty() const { return size_ == 0; }
+
+  std::uint64_t Size() const { return size_; }
+
+  std::uint64_t BucketCount() const { return capacity_; }
+
+  void Clear() {
+    if (control_ == nullptr) {
+      return;
+    }
+
+    for (std::uint64_t i = 0; i != capacity_; ++i) {
+      if (IsFull(control_[i])) {
+        AllocatorTraits::destroy(allocator_, slots_ + i);
+      }
+    }
+    std::fill(control_, control_ + capacity_ + kGroupWidth - 1, kEmpty);
+
+    size_ = 0;
+    deleted_count_ = 0;
+  }
+
+  std::pair<ReturnType&, bool> Insert(const ObjectType& object) {
+    return InsertImp(object, MultiTrait{});
+  }
+
+  std::pair<ReturnType&, bool> Insert(ObjectType&& other) {
+    return InsertImp(std::move(other), MultiTrait{});
+  }
+
+  template <typename... Args>
+  std::pair<ReturnType&, bool> Emplace(Args&&... args) {
+    return InsertImp(ObjectType{std::forward<Args>(args)...}, MultiTrait{});
+  }
+
+  Result<Nil, ErrorResult> Erase(const ObjectType* object_ptr) {
+    if (object_ptr == nullptr) {
+      return Result<Nil, ErrorResult>(
+          st_execute_error, ErrorCode::INPUT_PARAMETERS_ARE_NOT_SUITABLE);
+    }
+
+    if (size_ == 0 || object_ptr < slots_ ||
+        object_ptr >= slots_ + capacity_ ||
+        !IsFull(control_[object_ptr - slots_])) {
+      return Result<Nil, ErrorResult>(
+          st_execute_error,
+          ErrorCode::PARENT_OBJECT_NOT_CONTAIN_SPECIFIC_CHILD_OBJECT);
+    }
+
+    EraseSlot(object_ptr - slots_);
+
+    return Result<Nil, ErrorResult>{st_execute_success};
+  }
+
+  Result<Nil, ErrorResult> Erase(ObjectType* object_ptr) {
+    return Erase(const_cast<const ObjectType*>(object_ptr));
+  }
+
+  template <typename K>
+  std::uint32_t Erase(const K& key) {
+    std::uint32_t count = 0;
+    ProbeMatches(key, [this, &count](std::uint64_t index) {
+      EraseSlot(index);
+      ++count;
+      return std::is_same_v<MultiTrait, NotMulti>;
+    });
+
+    return count;
+  }
+
+  template <typename K>
+  std::uint32_t Count(const K& key) const {
+    std::uint32_t count = 0;
+    ProbeMatches(key, [&count](std::uint64_t) {
+      ++count;
+      return std::is_same_v<MultiTrait, NotMulti>;
+    });
+
+    return count;
+  }
+
+  template <typename K>
+  ReturnType* Find(const K& key) {
+    std::uint64_t index = FindIndex(key);
+    return index == capacity_ ? nullptr : slots_ + index;
+  }
+
+  template <typename K>
+  const ReturnType* Find(const K& key) const {
+    std::uint64_t index = FindIndex(key);
+    return index == capacity_ ? nullptr : slots_ + index;
+  }
+
+  template <typename K>
+  bool Contains(const K& key) const {
+    return FindIndex(key) != capacity_;
+  }
+
+  template <typename K>
+  std::vector<ReturnType*> EqualRange(const K& key) {
+    std::vector<ReturnType*> result;
+    ProbeMatches(key, [this, &result](std::uint64_t index) {
+      result.emplace_back(slots_ + index);
+      return false;
+    });
+
+    return result;
+  }
+
+  template <typename K>
+  std::vector<const ReturnType*> EqualRange(const K& key) const {
+    std::vector<const ReturnType*> result;
+    ProbeMatches(key, [this, &result](std::uint64_t index) {
+      result.emplace_back(slots_ + index);
+      return false;
+    });
+
+    return result;
+  }
+
+  void ReHash(std::uint64_t new_bucket_size) {
+    new_bucket_size = CapacityFor(new_bucket_size);
+    if (new_bucket_size > capacity_) {
+      Resize(new_bucket_size);
+    }
+  }
+
+  double GetLoadFactor() const { return load_factor_; }
+
+  void SetLoadFactor(double new_load_factor) {
+    // At least one slot must stay empty, otherwise probing never terminates
+    // early.
+    load_factor_ = new_load_factor < 0.95 ? new_load_factor : 0.95;
+  }
 
  private:
-  Node* data_{new Node[131]{}};
+  static bool IsFull(ControlType control) { return control >= 0; }
 
-  double load_factor_{0.75f};
-  std::atomic_uint64_t size_{0};
-  std::uint64_t bucket_count_{131};
-
-  mutable MutexType data_mutex0_{};
-  mutable MutexType data_mutex1_{};
-  mutable MutexType data_mutex2_{};
-  mutable MutexType data_mutex3_{};
-  mutable MutexType data_mutex4_{};
-  mutable MutexType data_mutex5_{};
-  mutable MutexType data_mutex6_{};
-  mutable MutexType data_mutex7_{};
-  mutable MutexType data_mutex8_{};
-  mutable MutexType data_mutex9_{};
-  mutable MutexType data_mutex10_{};
-  mutable MutexType data_mutex11_{};
-  mutable MutexType data_mutex12_{};
-  mutable MutexType data_mutex13_{};
-  mutable MutexType data_mutex14_{};
-  mutable MutexType data_mutex15_{};
+  static std::uint64_t CapacityFor(std::uint64_t size) {
+    std::uint64_t capacity = kMinCapacity;
+    while (capacity < size) {
+      capacity <<= 1;
+    }
+
+    return capacity;
+  }
+
+  std::uint64_t H1(std::uint64_t hash_code) const {
+    return (hash_code >> 7) & (capacity_ - 1);
+  }
+
+  static ControlType H2(std::uint64_t hash_code) {
+    return static_cast<ControlType>(hash_code & 0x7F);
+  }
+
+  /**
+   * \brief Loads the control bytes of the \ref kGroupWidth slots starting at
+   * \p index. Byte i of the result belongs to slot index + i.
+   * \remark The byte order assumes a little-endian target.
+   */
+  std::uint64_t LoadGroup(std::uint64_t index) const {
+    std::uint64_t group;
+    std::memcpy(&group, control_ + index, sizeof(group));
+    return group;
+  }
+
+  /**
+   * \brief Returns a word with the high bit set in every byte of \p group that
+   * equals \p control.
+   * \remark A byte equal to control ^ 1 directly above a match may also be
+   * reported. For \ref H2 values, \ref kEmpty and \ref kDeleted such a byte
+   * is always a full slot, and the caller compares its key anyway.
+   */
+  static std::uint64_t MatchByte(std::uint64_t group, ControlType control) {
+    std::uint64_t difference =
+        group ^ (kLowBits * static_cast<std::uint8_t>(control));
+    return (difference - kLowBits) & ~difference & kHighBits;
+  }
+
+  /**
+   * \brief Returns the bytes of a group that still belong to the probe chain:
+   * those before the first empty slot and within the \p remaining unscanned
+   * slots.
+   */
+  static std::uint64_t ChainMask(std::uint64_t empty_match,
+                                 std::uint64_t remaining) {
+    std::uint64_t mask = remaining < kGroupWidth
+                             ? (std::uint64_t{1} << (remaining * 8)) - 1
+                             : ~std::uint64_t{0};
+    if (empty_match != 0) {
+      mask &= (empty_match & (~empty_match + 1)) - 1;
+    }
+
+    return mask;
+  }
+
+  std::uint64_t NextGroup(std::uint64_t index) const {
+    return (index + kGroupWidth) & (capacity_ - 1);
+  }
+
+  std::uint64_t GroupSlot(std::uint64_t index, std::uint64_t match) const {
+    return (index + CountTrailingZeros64(match) / 8) & (capacity_ - 1);
+  }
+
+  /**
+   * \brief Calls \p function with the index of every slot in the probe chain
+   * of \p key whose key equals \p key, until \p function returns true.
+   */
+  template <typename K, typename Function>
+  void ProbeMatches(const K& key, Function&& function) const {
+    if (size_ == 0) {
+      return;
+    }
+
+    std::uint64_t hash_code = GetObjectHash(key);
+    ControlType h2 = H2(hash_code);
+
+    for (std::uint64_t index = H1(hash_code), probe_count = 0;
+         probe_count < capacity_;
+         index = NextGroup(index), probe_count += kGroupWidth) {
+      std::uint64_t group = LoadGroup(index);
+      std::uint64_t empty_match = MatchByte(group, kEmpty);
+      std::uint64_t chain_mask =
+          ChainMask(empty_match, capacity_ - probe_count);
+      for (std::uint64_t match = MatchByte(group, h2) & chain_mask; match != 0;
+           match &= match - 1) {
+        std::uint64_t slot_index = GroupSlot(index, match);
+        if (KeyEqual(slots_[slot_index], key) && function(slot_index)) {
+          return;
+        }
+      }
+      if (empty_match != 0) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * \brief Returns the first empty or deleted slot in the probe chain that
+   * starts at \p index.
+   */
+  std::uint64_t FindFirstNonFull(std::uint64_t index) const {
+    while (true) {
+      std::uint64_t non_full = LoadGroup(index) & kHighBits;
+      if (non_full != 0) {
+        return GroupSlot(index, non_full);
+      }
+      index = NextGroup(index);
+    }
+  }
+
+  void SetControl(std::uint64_t index, ControlType control) {
+    control_[index] = control;
+    if (index < kGroupWidth - 1) {
+      control_[capacity_ + index] = control;
+    }
+  }
+
+  void InitData(std::uint64_t capacity) {
+    capacity_ = capacity;
+    if (capacity_ == 0) {
+      control_ = nullptr;
+      slots_ = nullptr;
+      return;
+    }
+
+    control_ = new ControlType[capacity_ + kGroupWidth - 1];
+    std::fill(control_, control_ + capacity_ + kGroupWidth - 1, kEmpty);
+    slots_ = AllocatorTraits::allocate(allocator_, capacity_);
+  }
+
+  void FreeData() {
+    if (control_ == nullptr) {
+      return;
+    }
+
+    Clear();
+    delete[] control_;
+    AllocatorTraits::deallocate(allocator_, slots_, capacity_);
+    control_ = nullptr;
+    slots_ = nullptr;
+  }
+
+  /**
+   * \brief Forgets the storage after it was handed to another table.
+   */
+  void ReleaseData() noexcept {
+    control_ = nullptr;
+    slots_ = nullptr;
+    load_factor_ = 0.875;
+    size_ = 0;
+    deleted_count_ = 0;
+    capacity_ = 0;
+  }
+
+  void CopyFrom(const FlatHashTable& other) {
+    for (std::uint64_t i = 0; i != other.capacity_; ++i) {
+      if (IsFull(other.control_[i])) {
+        AllocatorTraits::construct(allocator_, slots_ + i, other.slots_[i]);
+      }
+      SetControl(i,
+                 other.control_[i] == kDeleted ? kEmpty : other.control_[i]);
+    }
+    size_ = other.size_;
+
+    // Dropping tombstones can break probe chains, so reinsert in that case.
+    if (other.deleted_count_ != 0) {
+      Resize(capacity_);
+    }
+  }
+
+  void Resize(std::uint64_t new_capacity) {
+    ControlType* old_control = control_;
+    ObjectType* old_slots = slots_;
+    std::uint64_t old_capacity = capacity_;
+
+    InitData(new_capacity);
+    deleted_count_ = 0;
+
+    if (old_control == nullptr) {
+      return;
+    }
+
+    for (std::uint64_t i = 0; i != old_capacity; ++i) {
+      if (IsFull(old_control[i])) {
+        std::uint64_t hash_code = GetObjectHash(old_slots[i]);
+        std::uint64_t index = FindFirstNonFull(H1(hash_code));
+        AllocatorTraits::construct(allocator_, slots_ + index,
+                                   std::move(old_slots[i]));
+        SetControl(index, H2(hash_code));
+        AllocatorTraits::destroy(allocator_, old_slots + i);
+      }
+    }
+
+    delete[] old_control;
+    AllocatorTraits::deallocate(allocator_, old_slots, old_capacity);
+  }
+
+  void RehashWhenNeed() {
+    if (size_ + deleted_count_ + 1 >
+        static_cast<std::uint64_t>(std::floor(capacity_ * load_factor_))) {
+      // Mostly tombstones, so cleaning them up in place is enough.
+      if (size_ + 1 <= static_cast<std::uint64_t>(
+                           std::floor(capacity_ * load_factor_ / 2))) {
+        Resize(capacity_);
+      } else {
+        Resize(std::max(capacity_ * 2, kMinCapacity));
+      }
+    }
+  }
+
+  template <typename K>
+  std::uint64_t FindIndex(const K& key) const {
+    std::uint64_t result = capacity_;
+    ProbeMatches(key, [&result](std::uint64_t index) {
+      result = index;
+      return true;
+    });
+
+    return result;
+  }
+
+  void EraseSlot(std::uint64_t index) {
+    AllocatorTraits::destroy(allocator_, slots_ + index);
+    // A slot followed by an empty slot can never be in the middle of a probe
+    // chain, so it can be released directly.
+    if (control_[(index + 1) & (capacity_ - 1)] == kEmpty) {
+      SetControl(index, kEmpty);
+    } else {
+      SetControl(index, kDeleted);
+      ++deleted_count_;
+    }
+    --size_;
+  }
+
+  template <typename Object>
+  std::pair<ReturnType&, bool> InsertImp(Object&& object, NotMulti) {
+    RehashWhenNeed();
+
+    std::uint64_t hash_code = GetObjectHash(object);
+    ControlType h2 = H2(hash_code);
+
+    std::uint64_t insert_index = capacity_;
+    for (std::uint64_t index = H1(hash_code), probe_count = 0;
+         probe_count < capacity_;
+         index = NextGroup(index), probe_count += kGroupWidth) {
+      std::uint64_t group = LoadGroup(index);
+      std::uint64_t empty_match = MatchByte(group, kEmpty);
+      std::uint64_t chain_mask =
+          ChainMask(empty_match, capacity_ - probe_count);
+      for (std::uint64_t match = MatchByte(group, h2) & chain_mask; match != 0;
+           match &= match - 1) {
+        std::uint64_t slot_index = GroupSlot(index, match);
+        if (KeyEqual(slots_[slot_index], object)) {
+          return {slots_[slot_index], false};
+        }
+      }
+      if (insert_index == capacity_) {
+        std::uint64_t deleted_match = MatchByte(group, kDeleted) & chain_mask;
+        if (deleted_match != 0) {
+          insert_index = GroupSlot(index, deleted_match);
+        }
+      }
+      if (empty_match != 0) {
+        if (insert_index == capacity_) {
+          insert_index = GroupSlot(index, empty_match);
+        }
+        break;
+      }
+    }
+
+    return {EmplaceAt(insert_index, h2, std::forward<Object>(object)), true};
+  }
+
+  template <typename Object>
+  std::pair<ReturnType&, bool> InsertImp(Object&& object, IsMulti) {
+    RehashWhenNeed();
+
+    std::uint64_t hash_code = GetObjectHash(object);
+    std::uint64_t index = FindFirstNonFull(H1(hash_code));
+
+    return {EmplaceAt(index, H2(hash_code), std::forward<Object>(object)),
+            true};
+  }
+
+  template <typename Object>
+  ObjectType& EmplaceAt(std::uint64_t index, ControlType h2, Object&& object) {
+    if (control_[index] == kDeleted) {
+      --deleted_count_;
+    }
+    AllocatorTraits::construct(allocator_, slots_ + index,
+                               std::forward<Object>(object));
+    SetControl(index, h2);
+    ++size_;
+
+    return slots_[index];
+  }
+
+  std::uint64_t GetObjectHash(const ObjectType& object, IsMap) const {
+    return HashMix64(Hash{}(object.first));
+  }
+
+  std::uint64_t GetObjectHash(const ObjectType& object, IsSet) const {
+    return HashMix64(Hash{}(object));
+  }
+
+  template <typename K>
+  std::uint64_t GetObjectHash(const K& key) const {
+    return HashMix64(Hash{}(key));
+  }
+
+  std::uint64_t GetObjectHash(const ObjectType& object) const {
+    return GetObjectHash(object, RelationshipTrait());
+  }
+
+  template <typename K>
+  bool KeyEqual(const ObjectType& lhs, const K& rhs, IsMap) const {
+    return Equal{}(lhs.first, rhs);
+  }
+
+  bool KeyEqual(const ObjectType& lhs, const ObjectType& rhs, IsMap) const {
+    return Equal{}(lhs.first, rhs.first);
+  }
+
+  template <typename K>
+  bool KeyEqual(const ObjectType& lhs, const K& rhs, IsSet) const {
+    return Equal{}(lhs, rhs);
+  }
+
+  template <typename K>
+  bool KeyEqual(const ObjectType& lhs, const K& rhs) const {
+    return KeyEqual(lhs, rhs, RelationshipTrait{});
+  }
+
+ private:
+  ControlType* control_{nullptr};
+  ObjectType* slots_{nullptr};
+  Allocator allocator_{};
+
+  double load_factor_{0.875};
+  std::uint64_t size_{0};
+  std::uint64_t deleted_count_{0};
+  std::uint64_t capacity_{0};
 };
 
 template <typename ObjectType, typename Hash = std::hash<ObjectType>,
           typename Equal = std::equal_to<>,
-          typename Allocator = std::allocator<ObjectType>>
-using HashSet = HashTable<FalseType, FalseType, ObjectType, ObjectType,
-                          const ObjectType, Hash, Equal, Allocator>;
+          typename Allocator = std::allocator<ObjectType>,
+          typename BucketTrait = PrimeBucket>
+using HashSet =
+    HashTable<FalseType, FalseType, ObjectType, ObjectType, const ObjectType,
+              Hash, Equal, Allocator, BucketTrait>;
 
 template <typename ObjectType, typename Hash = std::hash<ObjectType>,
           typename Equal = std::equal_to<>,
-          typename Allocator = std::allocator<ObjectType>>
-using MultiHashSet = HashTable<FalseType, TrueType, ObjectType, ObjectType,
-                               const ObjectType, Hash, Equal, Allocator>;
+          typename Allocator = std::allocator<ObjectType>,
+          typename BucketTrait = PrimeBucket>
+using MultiHashSet =
+    HashTable<FalseType, TrueType, ObjectType, ObjectType, const ObjectType,
+              Hash, Equal, Allocator, BucketTrait>;
 
 template <typename KeyObject, typename ValueObject,
           typename Hash = std::hash<KeyObject>,
           typename Equal = std::equal_to<>,
           typename Allocator =
-              std::allocator<std::pair<const KeyObject, ValueObject>>>
+              std::allocator<std::pair<const KeyObject, ValueObject>>,
+          typename BucketTrait = PrimeBucket>
 using HashMap =
     HashTable<TrueType, FalseType, KeyObject,
               std::pair<const KeyObject, ValueObject>,
-              std::pair<const KeyObject, ValueObject>, Hash, Equal, Allocator>;
+              std::pair<const KeyObject, ValueObject>, Hash, Equal, Allocator,
+    BucketTrait>;
 
 template <typename KeyObject, typename ValueObject,
           typename Hash = std::hash<KeyObject>,
           typename Equal = std::equal_to<>,
           typename Allocator =
-              std::allocator<std::pair<const KeyObject, ValueObject>>>
+              std::allocator<std::pair<const KeyObject, ValueObject>>,
+          typename BucketTrait = PrimeBucket>
 using MultiHashMap =
     HashTable<TrueType, TrueType, KeyObject,
               std::pair<const KeyObject, ValueObject>,
-              std::pair<const KeyObject, ValueObject>, Hash, Equal, Allocator>;
+              std::pair<const KeyObject, ValueObject>, Hash, Equal, Allocator,
+    BucketTrait>;
+
+template <typename ObjectType, typename Hash = std::hash<ObjectType>,
+          typename Equal = std::equal_to<>,
+          typename Allocator = std::allocator<ObjectType>>
+using FlatHashSet = FlatHashTable<FalseType, FalseType, ObjectType, ObjectType,
+                                  const ObjectType, Hash, Equal, Allocator>;
 
 template <typename ObjectType, typename Hash = std::hash<ObjectType>,
           typename Equal = std::equal_to<>,
           typename Allocator = std::allocator<ObjectType>>
+using FlatMultiHashSet =
+    FlatHashTable<FalseType, TrueType, ObjectType, ObjectType,
+                  const ObjectType, Hash, Equal, Allocator>;
+
+template <typename KeyObject, typename ValueObject,
+          typename Hash = std::hash<KeyObject>,
+          typename Equal = std::equal_to<>,
+          typename Allocator =
+              std::allocator<std::pair<const KeyObject, ValueObject>>>
+using FlatHashMap = FlatHashTable<
+    TrueType, FalseType, KeyObject, std::pair<const KeyObject, ValueObject>,
+    std::pair<const KeyObject, ValueObject>, Hash, Equal, Allocator>;
+
+template <typename KeyObject, typename ValueObject,
+          typename Hash = std::hash<KeyObject>,
+          typename Equal = std::equal_to<>,
+          typename Allocator =
+              std::allocator<std::pair<const KeyObject, ValueObject>>>
+using FlatMultiHashMap = FlatHashTable<
+    TrueType, TrueType, KeyObject, std::pair<const KeyObject, ValueObject>,
+    std::pair<const KeyObject, ValueObject>, Hash, Equal, Allocator>;
+
+template <typename ObjectType, typename Hash = std::hash<ObjectType>,
+          typename Equal = std::equal_to<>,
+          typename Allocator = std::allocator<ObjectType>,
+          typename BucketTrait = PrimeBucket>
 using ConcurrentSet =
     ConcurrentHashTable<FalseType, FalseType, ObjectType, ObjectType,
-                        const ObjectType, Hash, Equal, Allocator>;
+                        const ObjectType, Hash, Equal, Allocator, BucketTrait>;
 
 template <typename ObjectType, typename Hash = std::hash<ObjectType>,
           typename Equal = std::equal_to<>,
-          typename Allocator = std::allocator<ObjectType>>
+          typename Allocator = std::allocator<ObjectType>,
+          typename BucketTrait = PrimeBucket>
 using ConcurrentMultiSet =
     ConcurrentHashTable<FalseType, TrueType, ObjectType, ObjectType,
-                        const ObjectType, Hash, Equal, Allocator>;
+                        const ObjectType, Hash, Equal, Allocator, BucketTrait>;
 
 template <typename KeyObject, typename ValueObject,
           typename Hash = std::hash<KeyObject>,
           typename Equal = std::equal_to<>,
           typename Allocator =
-              std::allocator<std::pair<const KeyObject, ValueObject>>>
+              std::allocator<std::pair<const KeyObject, ValueObject>>,
+          typename BucketTrait = PrimeBucket>
 using ConcurrentMap = ConcurrentHashTable<
     TrueType, FalseType, KeyObject, std::pair<const KeyObject, ValueObject>,
-    std::pair<const KeyObject, ValueObject>, Hash, Equal, Allocator>;
+    std::pair<const KeyObject, ValueObject>, Hash, Equal, Allocator,
+    BucketTrait>;
 
 template <typename KeyObject, typename ValueObject,
           typename Hash = std::hash<KeyObject>,
           typename Equal = std::equal_to<>,
           typename Allocator =
-              std::allocator<std::pair<const KeyObject, ValueObject>>>
+              std::allocator<std::pair<const KeyObject, ValueObject>>,
+          typename BucketTrait = PrimeBucket>
 using ConcurrentMultiMap = ConcurrentHashTable<
     TrueType, TrueType, KeyObject, std::pair<const KeyObject, ValueObject>,
-    std::pair<const KeyObject, ValueObject>, Hash, Equal, Allocator>;
+    std::pair<const KeyObject, ValueObject>, Hash, Equal, Allocator,
+    BucketTrait>;
 }  // namespace Utils
 }  // namespace MM
@@ -2,6 +2,10 @@
 
 #include <cstddef>
 
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
 namespace MM {
 namespace Utils {
 #define OFFSET_OF(class_, member) offsetof(class_, member)
@@ -59,5 +63,12 @@ namespace Utils {
 #define likely(x)       __builtin_expect(!!(x), 1)
 #define unlikely(x)     __builtin_expect(!!(x), 0)
 #endif
+
+#if defined(_MSC_VER)
+#define MM_PREFETCH(address) \
+  _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define MM_PREFETCH(address) __builtin_prefetch(address)
+#endif
 }  // namespace Utils
 }  // namespace MM
@@ -0,0 +1,180 @@
+//
+// Created by beimingxianyu on 23-6-3.
+//
+
+#include "utils/slab_allocator.h"
+
+#include <algorithm>
+
+namespace {
+// Plain flag that stays readable after the thread caches of this thread are
+// destroyed, containers destroyed later fall back to the shared free list.
+thread_local bool thread_cache_destroyed = false;
+}  // namespace
+
+std::atomic_uint32_t MM::Utils::SlabPool::pool_count_{0};
+
+MM::Utils::SlabPool::SlabPool(std::size_t block_size,
+                              std::size_t block_alignment)
+    : block_size_(std::max(block_size, sizeof(FreeBlock))),
+      block_alignment_(std::max(block_alignment, alignof(FreeBlock))),
+      block_count_per_slab_(std::max<std::size_t>(1, kSlabSize / block_size_)),
+      pool_index_(pool_count_.fetch_add(1, std::memory_order_relaxed)) {}
+
+void* MM::Utils::SlabPool::Allocate() {
+  ThreadCache* thread_cache = GetThreadCache(pool_index_);
+  if (thread_cache == nullptr) {
+    std::lock_guard<std::mutex> guard{pool_mutex_};
+    if (shared_first_block_ == nullptr) {
+      AllocateSlab();
+    }
+    FreeBlock* block = shared_first_block_;
+    shared_first_block_ = block->next_block_;
+    --shared_free_block_count_;
+    AddUsedCount();
+    return block;
+  }
+
+  thread_cache->pool_ = this;
+  if (thread_cache->first_block_ == nullptr) {
+    FillThreadCache(*thread_cache);
+  }
+  FreeBlock* block = thread_cache->first_block_;
+  thread_cache->first_block_ = block->next_block_;
+  --thread_cache->block_count_;
+  AddUsedCount();
+  return block;
+}
+
+void MM::Utils::SlabPool::Deallocate(void* block) {
+  if (block == nullptr) {
+    return;
+  }
+
+  deallocate_count_.fetch_add(1, std::memory_order_relaxed);
+  auto* free_block = static_cast<FreeBlock*>(block);
+  ThreadCache* thread_cache = GetThreadCache(pool_index_);
+  if (thread_cache == nullptr) {
+    std::lock_guard<std::mutex> guard{pool_mutex_};
+    free_block->next_block_ = shared_first_block_;
+    shared_first_block_ = free_block;
+    ++shared_free_block_count_;
+    return;
+  }
+
+  thread_cache->pool_ = this;
+  free_block->next_block_ = thread_cache->first_block_;
+  thread_cache->first_block_ = free_block;
+  if (++thread_cache->block_count_ > kThreadCacheCapacity) {
+    FlushThreadCache(*thread_cache, kThreadCacheCapacity / 2);
+  }
+}
+
+void MM::Utils::SlabPool::ReleaseThreadCache() {
+  ThreadCache* thread_cache = GetThreadCache(pool_index_);
+  if (thread_cache != nullptr && thread_cache->block_count_ != 0) {
+    FlushThreadCache(*thread_cache, 0);
+  }
+}
+
+MM::Utils::SlabPoolStats MM::Utils::SlabPool::GetStats() const {
+  SlabPoolStats stats;
+  stats.block_size_ = block_size_;
+  stats.allocate_count_ = allocate_count_.load(std::memory_order_relaxed);
+  stats.deallocate_count_ = deallocate_count_.load(std::memory_order_relaxed);
+  stats.used_block_count_ = stats.allocate_count_ - stats.deallocate_count_;
+  stats.peak_used_block_count_ =
+      peak_used_block_count_.load(std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> guard{pool_mutex_};
+  stats.slab_count_ = slabs_.size();
+  stats.capacity_block_count_ = slabs_.size() * block_count_per_slab_;
+  stats.shared_free_block_count_ = shared_free_block_count_;
+
+  return stats;
+}
+
+MM::Utils::SlabPool::ThreadCacheSet::~ThreadCacheSet() {
+  for (ThreadCache& thread_cache : caches_) {
+    if (thread_cache.pool_ != nullptr && thread_cache.block_count_ != 0) {
+      thread_cache.pool_->FlushThreadCache(thread_cache, 0);
+    }
+  }
+  thread_cache_destroyed = true;
+}
+
+MM::Utils::SlabPool::ThreadCache* MM::Utils::SlabPool::GetThreadCache(
+    std::uint32_t pool_index) {
+  if (pool_index >= kMaxPoolCount || thread_cache_destroyed) {
+    return nullptr;
+  }
+
+  thread_local ThreadCacheSet thread_cache_set{};
+  return &thread_cache_set.caches_[pool_index];
+}
+
+void MM::Utils::SlabPool::AllocateSlab() {
+  std::size_t slab_size = block_size_ * block_count_per_slab_;
+  auto* slab_data = static_cast<std::byte*>(
+      ::operator new(slab_size, std::align_val_t{block_alignment_}));
+  slabs_.push_back(slab_data);
+
+  // Link the blocks in address order so that a fresh slab is handed out
+  // sequentially.
+  for (std::size_t i = block_count_per_slab_; i != 0; --i) {
+    auto* block =
+        reinterpret_cast<FreeBlock*>(slab_data + (i - 1) * block_size_);
+    block->next_block_ = shared_first_block_;
+    shared_first_block_ = block;
+  }
+  shared_free_block_count_ += block_count_per_slab_;
+}
+
+void MM::Utils::SlabPool::FillThreadCache(ThreadCache& thread_cache) {
+  std::lock_guard<std::mutex> guard{pool_mutex_};
+  if (shared_first_block_ == nullptr) {
+    AllocateSlab();
+  }
+
+  std::uint32_t move_count = kThreadCacheCapacity / 2;
+  while (move_count != 0 && shared_first_block_ != nullptr) {
+    FreeBlock* block = shared_first_block_;
+    shared_first_block_ = block->next_block_;
+    block->next_block_ = thread_cache.first_block_;
+    thread_cache.first_block_ = block;
+    ++thread_cache.block_count_;
+    --shared_free_block_count_;
+    --move_count;
+  }
+}
+
+void MM::Utils::SlabPool::FlushThreadCache(ThreadCache& thread_cache,
+                                           std::uint32_t keep_count) {
+  std::lock_guard<std::mutex> guard{pool_mutex_};
+  while (thread_cache.block_count_ > keep_count) {
+    FreeBlock* block = thread_cache.first_block_;
+    thread_cache.first_block_ = block->next_block_;
+    block->next_block_ = shared_first_block_;
+    shared_first_block_ = block;
+    --thread_cache.block_count_;
+    ++shared_free_block_count_;
+  }
+}
+
+void MM::Utils::SlabPool::AddUsedCount() {
+  std::uint64_t allocate_count =
+      allocate_count_.fetch_add(1, std::memory_order_relaxed) + 1;
+  std::uint64_t deallocate_count =
+      deallocate_count_.load(std::memory_order_relaxed);
+  if (deallocate_count > allocate_count) {
+    return;
+  }
+
+  std::uint64_t used_count = allocate_count - deallocate_count;
+  std::uint64_t peak_count =
+      peak_used_block_count_.load(std::memory_order_relaxed);
+  while (used_count > peak_count &&
+         !peak_used_block_count_.compare_exchange_weak(
+             peak_count, used_count, std::memory_order_relaxed)) {
+  }
+}
@@ -0,0 +1,221 @@
+//
+// Created by beimingxianyu on 23-6-3.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace MM {
+namespace Utils {
+struct SlabPoolStats {
+  std::uint64_t block_size_{0};
+  std::uint64_t slab_count_{0};
+  // Number of blocks carved out of all slabs.
+  std::uint64_t capacity_block_count_{0};
+  // Number of blocks that currently hold an object.
+  std::uint64_t used_block_count_{0};
+  std::uint64_t peak_used_block_count_{0};
+  // Free blocks in the shared free list, the rest of the free blocks sit in the
+  // thread caches.
+  std::uint64_t shared_free_block_count_{0};
+  std::uint64_t allocate_count_{0};
+  std::uint64_t deallocate_count_{0};
+
+  /**
+   * \brief The fraction of slab memory that does not hold a live object.
+   */
+  double Fragmentation() const {
+    if (capacity_block_count_ == 0) {
+      return 0.0;
+    }
+    return 1.0 - static_cast<double>(used_block_count_) /
+                     static_cast<double>(capacity_block_count_);
+  }
+};
+
+/**
+ * \brief Hands out fixed size blocks carved from large slabs.
+ * \remark Every thread keeps a small free list of its own for each pool, so
+ * the common allocate/deallocate pair never takes the pool lock. When a thread
+ * cache runs empty or overflows, half of \ref kThreadCacheCapacity blocks move
+ * between it and the shared free list at once. A thread returns its cached
+ * blocks when it exits.
+ * \remark Pools are obtained by \ref GetInstance and live until the process
+ * exits, so containers with static storage duration may still release their
+ * blocks during shutdown. Slabs are never returned to the system.
+ */
+class SlabPool {
+ public:
+  SlabPool(const SlabPool& other) = delete;
+  SlabPool(SlabPool&& other) = delete;
+  SlabPool& operator=(const SlabPool& other) = delete;
+  SlabPool& operator=(SlabPool&& other) = delete;
+
+ public:
+  /**
+   * \brief Get the pool for blocks of \ref BlockSize bytes.
+   * \remark Pools with different \ref Tag types never share memory, this is
+   * how a container or manager gets a pool of its own.
+   */
+  template <std::size_t BlockSize, std::size_t BlockAlignment,
+            typename Tag = void>
+  static SlabPool& GetInstance() {
+    static SlabPool* pool = new SlabPool{BlockSize, BlockAlignment};
+    return *pool;
+  }
+
+ public:
+  void* Allocate();
+
+  void Deallocate(void* block);
+
+  /**
+   * \brief Move the blocks cached by the calling thread back to the shared
+   * free list.
+   */
+  void ReleaseThreadCache();
+
+  SlabPoolStats GetStats() const;
+
+  std::size_t BlockSize() const { return block_size_; }
+
+ private:
+  SlabPool(std::size_t block_size, std::size_t block_alignment);
+  ~SlabPool() = default;
+
+ private:
+  static constexpr std::uint32_t kMaxPoolCount = 64;
+  static constexpr std::uint32_t kThreadCacheCapacity = 64;
+  static constexpr std::size_t kSlabSize = 64 * 1024;
+  static constexpr std::size_t kCacheLineSize = 64;
+
+  struct FreeBlock {
+    FreeBlock* next_block_;
+  };
+
+  struct ThreadCache {
+    SlabPool* pool_{nullptr};
+    FreeBlock* first_block_{nullptr};
+    std::uint32_t block_count_{0};
+  };
+
+  struct ThreadCacheSet {
+    ~ThreadCacheSet();
+
+    ThreadCache caches_[kMaxPoolCount]{};
+  };
+
+ private:
+  static ThreadCache* GetThreadCache(std::uint32_t pool_index);
+
+  // Must be called with pool_mutex_ held.
+  void AllocateSlab();
+
+  void FillThreadCache(ThreadCache& thread_cache);
+
+  void FlushThreadCache(ThreadCache& thread_cache, std::uint32_t keep_count);
+
+  void AddUsedCount();
+
+ private:
+  static std::atomic_uint32_t pool_count_;
+
+  const std::size_t block_size_;
+  const std::size_t block_alignment_;
+  const std::size_t block_count_per_slab_;
+  // Pools created after the first kMaxPoolCount ones get no thread cache.
+  const std::uint32_t pool_index_;
+
+  mutable std::mutex pool_mutex_{};
+  std::vector<std::byte*> slabs_{};
+  FreeBlock* shared_first_block_{nullptr};
+  std::uint64_t shared_free_block_count_{0};
+
+  alignas(kCacheLineSize) std::atomic_uint64_t allocate_count_{0};
+  alignas(kCacheLineSize) std::atomic_uint64_t deallocate_count_{0};
+  std::atomic_uint64_t peak_used_block_count_{0};
+};
+
+/**
+ * \brief Standard allocator backed by a \ref SlabPool per object size.
+ * \remark Only single object allocations use the pool, which is what node based
+ * containers ask for. Array allocations go to the global operator new. The
+ * allocator is stateless, so every instance can free the memory of another.
+ * Use a distinct \ref Tag to give a container or manager a pool of its own.
+ */
+template <typename ObjectType, typename Tag = void>
+class SlabAllocator {
+ public:
+  using value_type = ObjectType;
+  using is_always_equal = std::true_type;
+
+  template <typename OtherType>
+  struct rebind {
+    using other = SlabAllocator<OtherType, Tag>;
+  };
+
+ public:
+  SlabAllocator() noexcept = default;
+  template <typename OtherType>
+  SlabAllocator(const SlabAllocator<OtherType, Tag>&) noexcept {}
+
+ public:
+  static SlabPool& GetPool() {
+    return SlabPool::GetInstance<kBlockSize, kBlockAlignment, Tag>();
+  }
+
+  ObjectType* allocate(std::size_t n) {
+    if (n == 1) {
+      return static_cast<ObjectType*>(GetPool().Allocate());
+    }
+
+    if constexpr (alignof(ObjectType) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      return static_cast<ObjectType*>(::operator new(
+          n * sizeof(ObjectType), std::align_val_t{alignof(ObjectType)}));
+    } else {
+      return static_cast<ObjectType*>(::operator new(n * sizeof(ObjectType)));
+    }
+  }
+
+  void deallocate(ObjectType* object, std::size_t n) noexcept {
+    if (n == 1) {
+      GetPool().Deallocate(object);
+      return;
+    }
+
+    if constexpr (alignof(ObjectType) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      ::operator delete(object, std::align_val_t{alignof(ObjectType)});
+    } else {
+      ::operator delete(object);
+    }
+  }
+
+ private:
+  static constexpr std::size_t kBlockAlignment =
+      alignof(ObjectType) > alignof(void*) ? alignof(ObjectType)
+                                           : alignof(void*);
+  static constexpr std::size_t kBlockSize =
+      (sizeof(ObjectType) + kBlockAlignment - 1) / kBlockAlignment *
+      kBlockAlignment;
+};
+
+template <typename LeftType, typename RightType, typename Tag>
+bool operator==(const SlabAllocator<LeftType, Tag>&,
+                const SlabAllocator<RightType, Tag>&) noexcept {
+  return true;
+}
+
+template <typename LeftType, typename RightType, typename Tag>
+bool operator!=(const SlabAllocator<LeftType, Tag>&,
+                const SlabAllocator<RightType, Tag>&) noexcept {
+  return false;
+}
+}  // namespace Utils
+}  // namespace MM
@@ -0,0 +1,79 @@
+//
+// Created by beimingxianyu on 23-6-3.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+
+#include "utils/utils.h"
+
+namespace MM {
+namespace Utils {
+/**
+ * \brief A set of mutexes used to lock the buckets of a hash container in
+ * stripes. Every mutex lives in its own cache line, so writers on neighbouring
+ * stripes do not false-share.
+ * \remark The stripe count is rounded up to a power of two. \ref LockAll locks
+ * the stripes in index order, and \ref LockAllPair orders two sets by address,
+ * so they can be mixed without deadlock.
+ */
+template <typename MutexType = std::shared_mutex>
+class StripedMutex {
+ public:
+  static constexpr std::uint64_t kDefaultStripeCount = 16;
+  static constexpr std::uint64_t kCacheLineSize = 64;
+
+ public:
+  StripedMutex() : StripedMutex(kDefaultStripeCount) {}
+  ~StripedMutex() = default;
+  explicit StripedMutex(std::uint64_t stripe_count)
+      : stripe_count_(MinPowerOfTwo(stripe_count == 0 ? 1 : stripe_count)),
+        stripes_(new PaddedMutex[stripe_count_]) {}
+  StripedMutex(const StripedMutex& other) = delete;
+  StripedMutex(StripedMutex&& other) = delete;
+  StripedMutex& operator=(const StripedMutex& other) = delete;
+  StripedMutex& operator=(StripedMutex&& other) = delete;
+
+ public:
+  std::uint64_t StripeCount() const { return stripe_count_; }
+
+  MutexType& ChooseMutex(std::uint64_t bucket_index) const {
+    return stripes_[bucket_index & (stripe_count_ - 1)].mutex_;
+  }
+
+  void LockAll() const {
+    for (std::uint64_t i = 0; i != stripe_count_; ++i) {
+      stripes_[i].mutex_.lock();
+    }
+  }
+
+  void UnlockAll() const {
+    for (std::uint64_t i = stripe_count_; i != 0; --i) {
+      stripes_[i - 1].mutex_.unlock();
+    }
+  }
+
+  static void LockAllPair(const StripedMutex& lhs, const StripedMutex& rhs) {
+    if (&lhs < &rhs) {
+      lhs.LockAll();
+      rhs.LockAll();
+    } else {
+      rhs.LockAll();
+      lhs.LockAll();
+    }
+  }
+
+ private:
+  struct alignas(kCacheLineSize) PaddedMutex {
+    MutexType mutex_{};
+  };
+
+ private:
+  std::uint64_t stripe_count_;
+  std::unique_ptr<PaddedMutex[]> stripes_;
+};
+}  // namespace Utils
+}  // namespace MM
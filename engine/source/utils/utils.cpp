@@ -43,6 +43,14 @@ std::uint32_t MM::Utils::MinPrime32(std::uint32_t n) { return MinPrime(n); }
 
 std::uint64_t MM::Utils::MinPrime64(std::uint64_t n) { return MinPrime(n); }
 
+std::uint64_t MM::Utils::MinPowerOfTwo(std::uint64_t n) {
+  std::uint64_t result = 1;
+  while (result < n) {
+    result <<= 1;
+  }
+  return result;
+}
+
 void MM::Utils::SpinSharedMutex::Lock() {
   bool expect = false;
   while (!is_write_.compare_exchange_weak(
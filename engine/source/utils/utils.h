@@ -48,6 +48,8 @@ std::uint32_t MinPrime32(std::uint32_t n);
 
 std::uint64_t MinPrime64(std::uint64_t n);
 
+std::uint64_t MinPowerOfTwo(std::uint64_t n);
+
 class SpinSharedMutex {
  public:
   SpinSharedMutex() = default;
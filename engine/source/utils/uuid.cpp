@@ -68,6 +68,46 @@ std::string MM::Utils::UUID::ToString() const {
   return uuid_string;
 }
 
+bool MM::Utils::UUID::FromString(const std::string& uuid_string, UUID& uuid) {
+  if (uuid_string.size() != 36) {
+    return false;
+  }
+
+  std::uint64_t first_part = 0;
+  std::uint64_t second_part = 0;
+  std::uint32_t char_count = 0;
+  for (std::uint32_t i = 0; i != 36; ++i) {
+    char uuid_char = uuid_string[i];
+    if (i == 8 || i == 13 || i == 18 || i == 23) {
+      if (uuid_char != '-') {
+        return false;
+      }
+      continue;
+    }
+
+    std::uint64_t char_value = 0;
+    if (uuid_char >= '0' && uuid_char <= '9') {
+      char_value = uuid_char - '0';
+    } else if (uuid_char >= 'a' && uuid_char <= 'f') {
+      char_value = uuid_char - 'a' + 10;
+    } else {
+      return false;
+    }
+
+    if (char_count < 16) {
+      first_part = (first_part << 4) | char_value;
+    } else {
+      second_part = (second_part << 4) | char_value;
+    }
+    ++char_count;
+  }
+
+  uuid.first_part_ = first_part;
+  uuid.second_part_ = second_part;
+
+  return true;
+}
+
 MM::Utils::UUID::UUID() : first_part_(0), second_part_(0) {
   std::uint64_t nanoseconds_since_1582 =
       std::chrono::system_clock::now().time_since_epoch().count() +
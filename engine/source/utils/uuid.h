@@ -43,6 +43,13 @@ class UUID {
 
   std::string ToString() const;
 
+  /**
+   * \brief Parse a string produced by \ref ToString.
+   * \return False if \ref uuid_string is not a valid UUID string, \ref uuid is
+   * left unchanged in that case.
+   */
+  static bool FromString(const std::string& uuid_string, UUID& uuid);
+
   std::uint64_t GetHash() const;
 
   void Reset();
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "runtime/core/log/async_log_queue.h"
+#include "runtime/core/log/log_system.h"
+
+MM_IMPORT_LOG_SYSTEM;
+
+namespace {
+std::string PopMessage(MM::LogSystem::AsyncLogQueue& queue,
+                       spdlog::level::level_enum& level) {
+  spdlog::memory_buf_t message;
+  if (!queue.Pop(level, message)) {
+    return "<empty>";
+  }
+  return std::string(message.data(), message.size());
+}
+}  // namespace
+
+TEST(log_system, async_log_queue) {
+  auto queue = std::make_unique<MM::LogSystem::AsyncLogQueue>();
+  spdlog::level::level_enum level{spdlog::level::trace};
+  EXPECT_EQ(queue->HasRecord(), false);
+
+  // Strings are copied into the record, not referenced.
+  std::string path = "mesh.obj";
+  queue->Push(spdlog::level::err, "Failed to load {} ({} vertices, {:.1f}).",
+              path, 42, 0.5);
+  path = "changed";
+  const char* c_string = "c string";
+  queue->Push(spdlog::level::info, c_string);
+  // A single argument is a message, not a format string.
+  queue->Push(spdlog::level::warn, std::string("{not a format}"));
+  queue->Push(spdlog::level::debug, 7);
+  EXPECT_EQ(queue->GetPushCount(), 4);
+
+  EXPECT_EQ(PopMessage(*queue, level),
+            "Failed to load mesh.obj (42 vertices, 0.5).");
+  EXPECT_EQ(level, spdlog::level::err);
+  EXPECT_EQ(PopMessage(*queue, level), "c string");
+  EXPECT_EQ(level, spdlog::level::info);
+  EXPECT_EQ(PopMessage(*queue, level), "{not a format}");
+  EXPECT_EQ(PopMessage(*queue, level), "7");
+  EXPECT_EQ(level, spdlog::level::debug);
+  EXPECT_EQ(PopMessage(*queue, level), "<empty>");
+  EXPECT_EQ(queue->GetPopCount(), 4);
+
+  // Arguments that do not fit into a record are formatted by the producer.
+  std::string long_string(MM::LogSystem::AsyncLogQueue::kArgumentStorageSize,
+                          'a');
+  queue->Push(spdlog::level::info, long_string);
+  queue->Push(spdlog::level::info, "{}-{}", long_string, 1);
+  EXPECT_EQ(PopMessage(*queue, level), long_string);
+  EXPECT_EQ(PopMessage(*queue, level), long_string + "-1");
+
+  // Arguments that may view memory of the caller are formatted by the
+  // producer, the record must not outlive what they view.
+  {
+    std::vector<int> values{1, 2, 3};
+    queue->Push(spdlog::level::info, "values: {}", fmt::join(values, ", "));
+    int value = 4;
+    queue->Push(spdlog::level::info, "{} {}", std::cref(value), 5);
+  }
+  EXPECT_EQ(PopMessage(*queue, level), "values: 1, 2, 3");
+  EXPECT_EQ(PopMessage(*queue, level), "4 5");
+
+  // A bad format string is reported instead of thrown.
+  queue->Push(spdlog::level::info, "{} {}", 1);
+  EXPECT_EQ(PopMessage(*queue, level).rfind("[Failed to format log message]", 0),
+            0);
+
+  // Unpopped records are released by the destructor.
+  queue->Push(spdlog::level::info, "{}", std::string(64, 'b'));
+  queue.reset();
+}
+
+TEST(log_system, async_log_queue_multi_thread) {
+  auto queue = std::make_unique<MM::LogSystem::AsyncLogQueue>();
+  const std::uint64_t thread_count = 4;
+  // More records than the capacity, producers have to wait for the consumer.
+  const std::uint64_t record_count =
+      MM::LogSystem::AsyncLogQueue::kCapacity * 2;
+
+  std::vector<std::thread> threads;
+  for (std::uint64_t i = 0; i != thread_count; ++i) {
+    threads.emplace_back([i, record_count, &queue]() {
+      for (std::uint64_t j = 0; j != record_count; ++j) {
+        queue->Push(spdlog::level::info, "{} {}", i, j);
+      }
+    });
+  }
+
+  std::vector<std::uint64_t> next_record(thread_count, 0);
+  spdlog::level::level_enum level{spdlog::level::trace};
+  spdlog::memory_buf_t message;
+  std::uint64_t pop_count = 0;
+  while (pop_count != thread_count * record_count) {
+    if (!queue->Pop(level, message)) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::string text(message.data(), message.size());
+    message.clear();
+    std::uint64_t thread_index = std::stoull(text.substr(0, text.find(' ')));
+    std::uint64_t record_index = std::stoull(text.substr(text.find(' ') + 1));
+    ASSERT_LT(thread_index, thread_count);
+    // Records of one producer keep their order.
+    EXPECT_EQ(record_index, next_record[thread_index]);
+    next_record[thread_index] = record_index + 1;
+    ++pop_count;
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(queue->HasRecord(), false);
+  EXPECT_EQ(queue->GetPushCount(), thread_count * record_count);
+  EXPECT_EQ(queue->GetPopCount(), thread_count * record_count);
+}
+
+TEST(log_system, level_gate) {
+  std::uint32_t evaluate_count = 0;
+  auto message = [&evaluate_count]() {
+    ++evaluate_count;
+    return std::string("log_system level_gate test message");
+  };
+
+  EXPECT_EQ(MM::LogSystem::LogSystem::IsLevelCompiled(
+                MM::LogSystem::LogSystem::LogLevel::FATAL),
+            true);
+
+  MM_LOG_SYSTEM->SetLevel(MM::LogSystem::LogSystem::LogLevel::WARN);
+  EXPECT_EQ(MM_LOG_SYSTEM->GetLevel(),
+            MM::LogSystem::LogSystem::LogLevel::WARN);
+  EXPECT_EQ(
+      MM_LOG_SYSTEM->ShouldLog(MM::LogSystem::LogSystem::LogLevel::INFO),
+      false);
+  EXPECT_EQ(
+      MM_LOG_SYSTEM->ShouldLog(MM::LogSystem::LogSystem::LogLevel::DEBUG),
+      false);
+  EXPECT_EQ(
+      MM_LOG_SYSTEM->ShouldLog(MM::LogSystem::LogSystem::LogLevel::ERROR),
+      true);
+
+  // Filtered logs do not evaluate their arguments.
+  MM_LOG_TRACE(message());
+  MM_LOG_DEBUG(message());
+  MM_LOG_INFO(message());
+  EXPECT_EQ(evaluate_count, 0);
+
+  for (auto mode : {MM::LogSystem::LogSystem::LogMode::SYNCHRONOUS,
+                    MM::LogSystem::LogSystem::LogMode::ASYNCHRONOUS}) {
+    MM_LOG_SYSTEM->SetMode(mode);
+    EXPECT_EQ(MM_LOG_SYSTEM->GetMode(), mode);
+    MM_LOG_WARN(message());
+    MM_LOG_ERROR("{} {}", message(), 1);
+    MM_LOG_SYSTEM->Flush();
+  }
+  EXPECT_EQ(evaluate_count, 4);
+
+  EXPECT_THROW(MM_LOG_FATAL("log_system level_gate fatal {}", 1),
+               std::runtime_error);
+
+  MM_LOG_SYSTEM->SetLevel(MM::LogSystem::LogSystem::LogLevel::TRACE);
+}
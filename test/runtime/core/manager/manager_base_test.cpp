@@ -3,9 +3,11 @@
 //
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <thread>
 
 #include "runtime/core/manager/ManagerBase.h"
+#include "utils/slab_allocator.h"
 
 TEST(manager, manager_base) {
   struct TestString : MM::Manager::ManagedObjectBase {
@@ -265,4 +267,440 @@ TEST(manager, manager_base_thread) {
   }
 
   ASSERT_EQ(manager.GetSize(), 0);
-}
\ No newline at end of file
+}
+
+TEST(manager, manager_base_slab_allocator) {
+  struct TestString : MM::Manager::ManagedObjectBase {
+    std::string data_{};
+
+    explicit TestString(const std::string& name)
+        : MM::Manager::ManagedObjectBase(name), data_(name + "_data") {}
+    ~TestString() override = default;
+  };
+
+  struct StringManagerTag {};
+  using AllocatorType = MM::Utils::SlabAllocator<TestString, StringManagerTag>;
+  using BaseType = MM::Manager::ManagerBase<
+      TestString, MM::Manager::ManagedObjectIsNotSmartPoint, AllocatorType>;
+
+  class StringManager : public BaseType {
+   public:
+    using HandlerType = BaseType::HandlerType;
+
+   public:
+    StringManager() = default;
+    ~StringManager() override = default;
+
+   public:
+    MM::Result<HandlerType, MM::ErrorResult> AddObject(TestString&& object) {
+      return AddObjectBase(std::move(object));
+    }
+  };
+
+  MM::Utils::SlabPool& object_pool = MM::Utils::SlabAllocator<
+      std::pair<const MM::Manager::ManagedObjectID,
+                MM::Manager::ManagedObjectWrapper<TestString>>,
+      StringManagerTag>::GetPool();
+  MM::Utils::SlabPoolStats stats = object_pool.GetStats();
+  ASSERT_EQ(stats.used_block_count_, 0);
+
+  {
+    StringManager manager;
+    std::vector<StringManager::HandlerType> handlers;
+    for (std::uint32_t i = 0; i != 100; ++i) {
+      auto handler =
+          manager.AddObject(TestString{std::to_string(i)}).Exception();
+      ASSERT_EQ(handler.IsSuccess(), true);
+      handlers.emplace_back(std::move(handler.GetResult()));
+      ASSERT_EQ(handlers.back().GetObjectName(), std::to_string(i));
+    }
+    ASSERT_EQ(manager.GetSize(), 100);
+
+    stats = object_pool.GetStats();
+    ASSERT_EQ(stats.used_block_count_, 100);
+    ASSERT_EQ(stats.allocate_count_, 100);
+    ASSERT_GE(stats.capacity_block_count_, 100);
+    ASSERT_LT(stats.Fragmentation(), 1.0);
+
+    for (std::uint32_t i = 0; i != 50; ++i) {
+      handlers[i].Release();
+    }
+    ASSERT_EQ(manager.GetSize(), 50);
+    ASSERT_EQ(object_pool.GetStats().used_block_count_, 50);
+  }
+
+  stats = object_pool.GetStats();
+  ASSERT_EQ(stats.used_block_count_, 0);
+  ASSERT_EQ(stats.allocate_count_, stats.deallocate_count_);
+  ASSERT_EQ(stats.peak_used_block_count_, 100);
+}
+
+TEST(manager, manager_base_generational_handle) {
+  struct TestString : MM::Manager::ManagedObjectBase {
+    std::string data_{};
+
+    explicit TestString(const std::string& name)
+        : MM::Manager::ManagedObjectBase(name), data_(name + "_data") {}
+    ~TestString() override = default;
+  };
+
+  class StringManager : public MM::Manager::ManagerBase<TestString> {
+   public:
+    using HandlerType = MM::Manager::ManagerBase<TestString>::HandlerType;
+
+   public:
+    StringManager() = default;
+    ~StringManager() override = default;
+
+   public:
+    MM::Result<HandlerType, MM::ErrorResult> AddObject(TestString&& object) {
+      return AddObjectBase(std::move(object));
+    }
+  };
+
+  StringManager manager;
+
+  MM::Manager::ManagedObjectGenerationalHandle invalid_handle;
+  ASSERT_EQ(invalid_handle.IsValid(), false);
+  ASSERT_EQ(manager.IsAlive(invalid_handle), false);
+  ASSERT_EQ(manager.GetObjectByHandle(invalid_handle).Exception().IsSuccess(),
+            false);
+  ASSERT_EQ(manager.GetGenerationalHandle(MM::Manager::ManagedObjectID{})
+                .Exception()
+                .IsSuccess(),
+            false);
+
+  auto handler1 = manager.AddObject(TestString{"TestString1"}).Exception();
+  ASSERT_EQ(handler1.IsSuccess(), true);
+  auto handle1 =
+      manager.GetGenerationalHandle(handler1.GetResult().GetObjectID())
+          .Exception();
+  ASSERT_EQ(handle1.IsSuccess(), true);
+  ASSERT_EQ(handle1.GetResult().IsValid(), true);
+  ASSERT_EQ(manager.IsAlive(handle1.GetResult()), true);
+  {
+    auto handle_handler1 =
+        manager.GetObjectByHandle(handle1.GetResult()).Exception();
+    ASSERT_EQ(handle_handler1.IsSuccess(), true);
+    ASSERT_EQ(handle_handler1.GetResult().GetObjectPtr(),
+              handler1.GetResult().GetObjectPtr());
+    ASSERT_EQ(handle_handler1.GetResult().GetObjectID(),
+              handler1.GetResult().GetObjectID());
+    ASSERT_EQ(handle_handler1.GetResult().GetObject().data_,
+              std::string{"TestString1_data"});
+    ASSERT_EQ(handle_handler1.GetResult().GetObjectName(),
+              std::string{"TestString1"});
+    ASSERT_EQ(handler1.GetResult().GetObjectUseCountPtr()->load(), 2);
+  }
+  ASSERT_EQ(handler1.GetResult().GetObjectUseCountPtr()->load(), 1);
+  ASSERT_EQ(MM::Manager::ManagedObjectGenerationalHandle::Unpack(
+                handle1.GetResult().Pack()),
+            handle1.GetResult());
+
+  // A copy of the handler keeps the object, and the handle, alive.
+  StringManager::HandlerType handler1_copy = handler1.GetResult();
+  handler1.GetResult().Release();
+  ASSERT_EQ(manager.IsAlive(handle1.GetResult()), true);
+  // So does a handler got through the handle.
+  auto handle_handler1 =
+      manager.GetObjectByHandle(handle1.GetResult()).Exception();
+  ASSERT_EQ(handle_handler1.IsSuccess(), true);
+  handler1_copy.Release();
+  ASSERT_EQ(manager.IsAlive(handle1.GetResult()), true);
+  ASSERT_EQ(handle_handler1.GetResult().GetObject().data_,
+            std::string{"TestString1_data"});
+  handle_handler1.GetResult().Release();
+  ASSERT_EQ(manager.IsAlive(handle1.GetResult()), false);
+  ASSERT_EQ(
+      manager.GetObjectByHandle(handle1.GetResult()).Exception().IsSuccess(),
+      false);
+
+  // The freed slot is reused with a new generation, the old handle stays stale.
+  auto handler2 = manager.AddObject(TestString{"TestString2"}).Exception();
+  ASSERT_EQ(handler2.IsSuccess(), true);
+  auto handle2 =
+      manager.GetGenerationalHandle(handler2.GetResult().GetObjectID())
+          .Exception();
+  ASSERT_EQ(handle2.IsSuccess(), true);
+  ASSERT_EQ(handle2.GetResult().index_, handle1.GetResult().index_);
+  ASSERT_NE(handle2.GetResult().generation_, handle1.GetResult().generation_);
+  ASSERT_EQ(manager.IsAlive(handle1.GetResult()), false);
+  ASSERT_EQ(
+      manager.GetObjectByHandle(handle1.GetResult()).Exception().IsSuccess(),
+      false);
+  ASSERT_EQ(manager.GetObjectByHandle(handle2.GetResult())
+                .Exception()
+                .GetResult()
+                .GetObject()
+                .data_,
+            std::string{"TestString2_data"});
+
+  std::vector<StringManager::HandlerType> handlers;
+  std::vector<MM::Manager::ManagedObjectGenerationalHandle> handles;
+  for (std::uint32_t i = 0; i != 3000; ++i) {
+    auto handler =
+        manager.AddObject(TestString{std::to_string(i)}).Exception();
+    ASSERT_EQ(handler.IsSuccess(), true);
+    handles.emplace_back(
+        manager.GetGenerationalHandle(handler.GetResult().GetObjectID())
+            .Exception()
+            .GetResult());
+    handlers.emplace_back(std::move(handler.GetResult()));
+  }
+  for (std::uint32_t i = 0; i != 3000; ++i) {
+    ASSERT_EQ(manager.GetObjectByHandle(handles[i])
+                  .Exception()
+                  .GetResult()
+                  .GetObject()
+                  .data_,
+              std::to_string(i) + "_data");
+  }
+  handlers.clear();
+  handler2.GetResult().Release();
+  for (const auto& handle : handles) {
+    ASSERT_EQ(manager.IsAlive(handle), false);
+  }
+  ASSERT_EQ(manager.GetSize(), 0);
+
+  // Objects are registered and removed from several threads at once, freed
+  // slots are shared between all of them.
+  std::vector<std::thread> threads;
+  for (std::uint32_t i = 0; i != 8; ++i) {
+    threads.emplace_back([&manager, i]() {
+      for (std::uint32_t round = 0; round != 4; ++round) {
+        std::vector<StringManager::HandlerType> thread_handlers;
+        std::vector<MM::Manager::ManagedObjectGenerationalHandle>
+            thread_handles;
+        for (std::uint32_t j = 0; j != 1000; ++j) {
+          std::string name = std::to_string(i * 1000 + j);
+          auto handler = manager.AddObject(TestString{name}).Exception();
+          ASSERT_EQ(handler.IsSuccess(), true);
+          auto handle =
+              manager.GetGenerationalHandle(handler.GetResult().GetObjectID())
+                  .Exception();
+          ASSERT_EQ(handle.IsSuccess(), true);
+          ASSERT_EQ(manager.GetObjectByHandle(handle.GetResult())
+                        .Exception()
+                        .GetResult()
+                        .GetObject()
+                        .data_,
+                    name + "_data");
+          thread_handles.emplace_back(handle.GetResult());
+          thread_handlers.emplace_back(std::move(handler.GetResult()));
+        }
+        thread_handlers.clear();
+        for (const auto& handle : thread_handles) {
+          ASSERT_EQ(manager.IsAlive(handle), false);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(manager.GetSize(), 0);
+
+  // Handles are resolved while their objects are removed, a resolved handler
+  // keeps its object alive.
+  std::vector<MM::Manager::ManagedObjectGenerationalHandle> shared_handles;
+  std::vector<StringManager::HandlerType> shared_handlers;
+  for (std::uint32_t i = 0; i != 1000; ++i) {
+    auto handler =
+        manager.AddObject(TestString{std::to_string(i)}).Exception();
+    ASSERT_EQ(handler.IsSuccess(), true);
+    shared_handles.emplace_back(
+        manager.GetGenerationalHandle(handler.GetResult().GetObjectID())
+            .Exception()
+            .GetResult());
+    shared_handlers.emplace_back(std::move(handler.GetResult()));
+  }
+  std::atomic_bool is_released{false};
+  std::vector<std::thread> readers;
+  for (std::uint32_t i = 0; i != 4; ++i) {
+    readers.emplace_back([&manager, &shared_handles, &is_released]() {
+      do {
+        for (std::uint32_t j = 0; j != shared_handles.size(); ++j) {
+          auto handler =
+              manager.GetObjectByHandle(shared_handles[j]).IgnoreException();
+          if (handler.IsSuccess()) {
+            ASSERT_EQ(handler.GetResult().GetObject().data_,
+                      std::to_string(j) + "_data");
+          }
+        }
+      } while (!is_released.load(std::memory_order_acquire));
+    });
+  }
+  shared_handlers.clear();
+  is_released.store(true, std::memory_order_release);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  for (const auto& handle : shared_handles) {
+    ASSERT_EQ(manager.IsAlive(handle), false);
+  }
+  ASSERT_EQ(manager.GetSize(), 0);
+}
+
+TEST(manager, manager_base_unnamed_object) {
+  struct TestString : MM::Manager::ManagedObjectBase {
+    std::string data_{};
+
+    TestString() = default;
+    explicit TestString(const std::string& name)
+        : MM::Manager::ManagedObjectBase(name), data_(name + "_data") {}
+    ~TestString() override = default;
+  };
+
+  class StringManager : public MM::Manager::ManagerBase<TestString> {
+   public:
+    using HandlerType = MM::Manager::ManagerBase<TestString>::HandlerType;
+
+   public:
+    StringManager() = default;
+    ~StringManager() override = default;
+
+   public:
+    MM::Result<HandlerType, MM::ErrorResult> AddObject(TestString&& object) {
+      return AddObjectBase(std::move(object));
+    }
+
+    MM::Result<HandlerType, MM::ErrorResult> GetObjectByID(
+        MM::Manager::ManagedObjectID object_id) const {
+      return GetObjectByIDBase(object_id);
+    }
+
+    MM::Result<std::vector<HandlerType>, MM::ErrorResult> GetObjectByName(
+        const std::string& object_name) const {
+      return GetObjectByNameBase(object_name, MM::st_get_multiply_object);
+    }
+  };
+
+  TestString unnamed_string;
+  ASSERT_EQ(unnamed_string.IsNamed(), false);
+  ASSERT_EQ(TestString{"TestString"}.IsNamed(), true);
+  MM::Manager::ManagedObjectID unnamed_ID = unnamed_string.GetObjectID();
+  TestString copied_string{unnamed_string};
+  ASSERT_EQ(copied_string.IsNamed(), false);
+  ASSERT_EQ(copied_string.GetObjectName(), unnamed_ID.ToString());
+
+  StringManager manager;
+  auto named_handler = manager.AddObject(TestString{"TestString"}).Exception();
+  ASSERT_EQ(named_handler.IsSuccess(), true);
+  auto unnamed_handler = manager.AddObject(std::move(unnamed_string)).Exception();
+  ASSERT_EQ(unnamed_handler.IsSuccess(), true);
+  ASSERT_EQ(unnamed_handler.GetResult().IsValid(), true);
+  ASSERT_EQ(unnamed_handler.GetResult().GetNameToIDHandler().IsValid(), false);
+  ASSERT_EQ(unnamed_handler.GetResult().GetObjectID(), unnamed_ID);
+  ASSERT_EQ(unnamed_handler.GetResult().GetObjectName(), unnamed_ID.ToString());
+  ASSERT_EQ(manager.GetSize(), 2);
+  ASSERT_EQ(manager.Have(unnamed_ID), true);
+
+  auto name = manager.GetNameByID(unnamed_ID).Exception();
+  ASSERT_EQ(name.IsSuccess(), true);
+  ASSERT_EQ(name.GetResult(), unnamed_ID.ToString());
+
+  auto ID = manager.GetIDByName(unnamed_ID.ToString()).Exception();
+  ASSERT_EQ(ID.IsSuccess(), true);
+  ASSERT_EQ(ID.GetResult(), unnamed_ID);
+  auto IDs = manager
+                 .GetIDByName(unnamed_ID.ToString(),
+                              MM::st_get_multiply_object)
+                 .Exception();
+  ASSERT_EQ(IDs.IsSuccess(), true);
+  ASSERT_EQ(IDs.GetResult().size(), 1);
+
+  auto handlers = manager.GetObjectByName(unnamed_ID.ToString()).Exception();
+  ASSERT_EQ(handlers.IsSuccess(), true);
+  ASSERT_EQ(handlers.GetResult().size(), 1);
+  ASSERT_EQ(handlers.GetResult()[0].GetObjectID(), unnamed_ID);
+
+  auto handler = manager.GetObjectByID(unnamed_ID).Exception();
+  ASSERT_EQ(handler.IsSuccess(), true);
+  ASSERT_EQ(handler.GetResult().GetObjectName(), unnamed_ID.ToString());
+
+  // The name of a named object is not treated as an ID.
+  auto named_ID = named_handler.GetResult().GetObjectID();
+  ASSERT_EQ(manager.GetIDByName(named_ID.ToString()).Exception().IsSuccess(),
+            false);
+
+  handlers.GetResult().clear();
+  handler.GetResult().Release();
+  unnamed_handler.GetResult().Release();
+  ASSERT_EQ(manager.Have(unnamed_ID), false);
+  ASSERT_EQ(manager.GetIDByName(unnamed_ID.ToString()).Exception().IsSuccess(),
+            false);
+  named_handler.GetResult().Release();
+  ASSERT_EQ(manager.GetSize(), 0);
+}
+
+TEST(manager, manager_base_add_object_batch) {
+  struct TestString : MM::Manager::ManagedObjectBase {
+    std::string data_{};
+
+    TestString() = default;
+    explicit TestString(const std::string& name)
+        : MM::Manager::ManagedObjectBase(name), data_(name + "_data") {}
+    ~TestString() override = default;
+  };
+
+  class StringManager : public MM::Manager::ManagerBase<TestString> {
+   public:
+    using HandlerType = MM::Manager::ManagerBase<TestString>::HandlerType;
+
+   public:
+    StringManager() = default;
+    ~StringManager() override = default;
+
+   public:
+    std::vector<MM::Result<HandlerType, MM::ErrorResult>> AddObjects(
+        std::vector<TestString>&& objects) {
+      return AddObjectBatchBase(std::move(objects));
+    }
+  };
+
+  StringManager manager;
+  std::vector<TestString> objects;
+  for (std::uint32_t i = 0; i != 3000; ++i) {
+    objects.emplace_back(std::to_string(i));
+  }
+  objects.emplace_back();
+  MM::Manager::ManagedObjectID unnamed_ID = objects.back().GetObjectID();
+
+  auto results = manager.AddObjects(std::move(objects));
+  ASSERT_EQ(results.size(), 3001);
+  ASSERT_EQ(manager.GetSize(), 3001);
+  for (std::uint32_t i = 0; i != 3000; ++i) {
+    ASSERT_EQ(results[i].Exception().IsSuccess(), true);
+    ASSERT_EQ(results[i].GetResult().GetObjectName(), std::to_string(i));
+    ASSERT_EQ(results[i].GetResult().GetObject().data_,
+              std::to_string(i) + "_data");
+    ASSERT_EQ(manager.GetIDByName(std::to_string(i)).Exception().GetResult(),
+              results[i].GetResult().GetObjectID());
+    auto handle =
+        manager.GetGenerationalHandle(results[i].GetResult().GetObjectID())
+            .Exception();
+    ASSERT_EQ(handle.IsSuccess(), true);
+    ASSERT_EQ(manager.IsAlive(handle.GetResult()), true);
+  }
+  ASSERT_EQ(results[3000].Exception().IsSuccess(), true);
+  ASSERT_EQ(results[3000].GetResult().GetObjectID(), unnamed_ID);
+  ASSERT_EQ(results[3000].GetResult().GetNameToIDHandler().IsValid(), false);
+
+  // An object whose ID is already managed is rejected, the others are added.
+  std::vector<TestString> duplicated_objects;
+  duplicated_objects.emplace_back(results[0].GetResult().GetObject());
+  duplicated_objects.emplace_back("new");
+  auto duplicated_results = manager.AddObjects(std::move(duplicated_objects));
+  ASSERT_EQ(duplicated_results[0].IgnoreException().IsSuccess(), false);
+  ASSERT_EQ(duplicated_results[1].Exception().IsSuccess(), true);
+  ASSERT_EQ(manager.GetSize(), 3002);
+  ASSERT_EQ(manager.GetIDByName(std::to_string(0), MM::st_get_multiply_object)
+                .Exception()
+                .GetResult()
+                .size(),
+            1);
+
+  results.clear();
+  duplicated_results.clear();
+  ASSERT_EQ(manager.GetSize(), 0);
+}
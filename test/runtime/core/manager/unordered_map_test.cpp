@@ -127,6 +127,103 @@ TEST(manager, unordered_map_thread) {
   ASSERT_EQ(map_data2.GetSize(), 0);
 }
 
+TEST(manager, unordered_map_stripe_count) {
+  MM::Manager::ManagedObjectUnorderedMap<std::uint32_t, std::string> map_data1(
+      1024, 64),
+      map_data2;
+  std::vector<std::vector<MM::Manager::ManagedObjectUnorderedMap<
+      std::uint32_t, std::string>::HandlerType>>
+      handlers_vector(8);
+  std::vector<std::thread> threads;
+  for (std::uint32_t i = 0; i != 8; ++i) {
+    threads.emplace_back([&map_data1, &handlers = handlers_vector[i], i]() {
+      for (std::uint32_t j = i * 1000; j != (i + 1) * 1000; ++j) {
+        auto handler = map_data1.AddObject(j, std::to_string(j)).Exception();
+        ASSERT_EQ(handler.IsSuccess(), true);
+        handlers.emplace_back(std::move(handler.GetResult()));
+      }
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  ASSERT_EQ(map_data1.GetSize(), 8000);
+
+  map_data2 = std::move(map_data1);
+  for (std::uint32_t j = 0; j < 8000; j += 97) {
+    auto handler = map_data2.GetObject(j).Exception();
+    ASSERT_EQ(handler.IsSuccess(), true);
+    ASSERT_EQ(handler.GetResult().GetObject(), std::to_string(j));
+  }
+
+  handlers_vector.clear();
+  ASSERT_EQ(map_data2.GetSize(), 0);
+}
+
+TEST(manager, unordered_map_batch) {
+  using MapType =
+      MM::Manager::ManagedObjectUnorderedMap<std::uint32_t, std::string>;
+  MapType map_data;
+  std::vector<std::vector<MM::Result<MapType::HandlerType, MM::ErrorResult>>>
+      results_vector(4);
+  std::vector<std::thread> threads;
+  for (std::uint32_t i = 0; i != 4; ++i) {
+    threads.emplace_back([&map_data, &results = results_vector[i], i]() {
+      std::vector<std::pair<std::uint32_t, std::string>> objects;
+      for (std::uint32_t j = i * 3000; j != (i + 1) * 3000; ++j) {
+        objects.emplace_back(j, std::to_string(j));
+      }
+      // A key that is already in this batch.
+      objects.emplace_back(i * 3000, std::string("duplicate"));
+      results = map_data.AddObjectBatch(std::move(objects));
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  ASSERT_EQ(map_data.GetSize(), 12000);
+  for (std::uint32_t i = 0; i != 4; ++i) {
+    ASSERT_EQ(results_vector[i].size(), 3001);
+    for (std::uint32_t j = 0; j != 3000; ++j) {
+      ASSERT_EQ(results_vector[i][j].IsSuccess(), true);
+      ASSERT_EQ(results_vector[i][j].GetResult().GetObject(),
+                std::to_string(i * 3000 + j));
+    }
+    ASSERT_EQ(results_vector[i][3000].IsError(), true);
+    ASSERT_EQ(results_vector[i][3000].GetError().GetErrorCode(),
+              MM::ErrorCode::OPERATION_NOT_SUPPORTED);
+  }
+
+  std::vector<std::uint32_t> keys{11999, 12000, 0, 5000};
+  auto get_results = map_data.GetObjectBatch(keys);
+  ASSERT_EQ(get_results.size(), 4);
+  ASSERT_EQ(get_results[0].GetResult().GetObject(), std::string("11999"));
+  ASSERT_EQ(get_results[1].IsError(), true);
+  ASSERT_EQ(get_results[2].GetResult().GetObject(), std::string("0"));
+  ASSERT_EQ(get_results[3].GetResult().GetObject(), std::string("5000"));
+  ASSERT_EQ(map_data.GetUseCount(5000), 2);
+
+  get_results.clear();
+  results_vector.clear();
+  ASSERT_EQ(map_data.GetSize(), 0);
+}
+
+TEST(manager, managed_object_wrapper_move) {
+  using WrapperType = MM::Manager::ManagedObjectWrapper<std::string>;
+  // A wrapper without handlers is moved while it is inserted.
+  WrapperType wrapper{std::string("wrapper")};
+  WrapperType moved_wrapper{std::move(wrapper)};
+  ASSERT_EQ(moved_wrapper.GetObject(), std::string("wrapper"));
+
+  // Handlers point into a published wrapper, moving it is fatal in every
+  // build.
+  moved_wrapper.GetUseCountPtr()->fetch_add(1, std::memory_order_acq_rel);
+  ASSERT_DEATH(WrapperType{std::move(moved_wrapper)}, "");
+  WrapperType other_wrapper{std::string("other")};
+  ASSERT_DEATH(other_wrapper = std::move(moved_wrapper), "");
+  moved_wrapper.GetUseCountPtr()->fetch_sub(1, std::memory_order_acq_rel);
+}
+
 TEST(manager, unordered_multimap) {
   MM::Manager::ManagedObjectUnorderedMultiMap<std::string, int> multi_map_data1,
       multi_map_data2;
@@ -0,0 +1,431 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "runtime/core/task_system/async_task.h"
+#include "runtime/core/task_system/frame_scheduler.h"
+#include "runtime/core/task_system/task_system.h"
+
+TEST(task_system, lane) {
+  MM::TaskSystem::TaskSystem* task_system =
+      MM::TaskSystem::TaskSystem::GetInstance();
+  EXPECT_EQ(task_system->NumWorkers(MM::TaskSystem::TaskType::Render),
+            std::max<size_t>(1, std::thread::hardware_concurrency()));
+
+  MM::TaskSystem::Taskflow task_flow;
+  std::atomic_uint32_t count{0};
+  std::vector<MM::TaskSystem::Task> tasks;
+  for (std::uint32_t i = 0; i != 10; ++i) {
+    tasks.emplace_back(task_flow.emplace([&count]() { ++count; }));
+  }
+  task_system->Run(MM::TaskSystem::TaskType::Common, task_flow).wait();
+  EXPECT_EQ(count, 10);
+  for (const MM::TaskSystem::Task& task : tasks) {
+    EXPECT_EQ(task.priority(), MM::TaskSystem::TaskPriority::LOW);
+  }
+
+  task_system->Run(MM::TaskSystem::TaskType::Render, task_flow).wait();
+  EXPECT_EQ(count, 20);
+  for (const MM::TaskSystem::Task& task : tasks) {
+    EXPECT_EQ(task.priority(), MM::TaskSystem::TaskPriority::HIGH);
+  }
+}
+
+TEST(task_system, async) {
+  MM::TaskSystem::TaskSystem* task_system =
+      MM::TaskSystem::TaskSystem::GetInstance();
+  for (MM::TaskSystem::TaskType task_type :
+       {MM::TaskSystem::TaskType::Total, MM::TaskSystem::TaskType::Common,
+        MM::TaskSystem::TaskType::Render,
+        MM::TaskSystem::TaskType::Physical}) {
+    auto future = task_system->Async(
+        task_type, [](int lhs, int rhs) { return lhs + rhs; }, 1, 2);
+    EXPECT_EQ(future.get(), 3);
+
+    auto move_only_future = task_system->Async(
+        task_type, [](std::unique_ptr<int> value) { return *value; },
+        std::make_unique<int>(4));
+    EXPECT_EQ(move_only_future.get(), 4);
+
+    std::atomic_bool is_run{false};
+    task_system->Async(task_type, [&is_run]() { is_run = true; }).wait();
+    EXPECT_EQ(is_run, true);
+
+    std::atomic_uint32_t count{0};
+    for (std::uint32_t i = 0; i != 100; ++i) {
+      task_system->SilentAsync(task_type, [&count]() { ++count; });
+    }
+    task_system->WaitForAll(task_type);
+    EXPECT_EQ(count, 100);
+  }
+}
+
+TEST(task_system, frame_scheduler) {
+  const std::uint32_t phase_count = 3;
+  const std::uint32_t job_count = 16;
+  MM::TaskSystem::FrameScheduler frame_scheduler{phase_count};
+  EXPECT_EQ(frame_scheduler.GetPhaseCount(), phase_count);
+
+  for (std::uint64_t frame_index = 0; frame_index != 10; ++frame_index) {
+    if (frame_index != 0) {
+      frame_scheduler.BeginFrame();
+    }
+    EXPECT_EQ(frame_scheduler.GetFrameIndex(), frame_index);
+
+    std::atomic_uint32_t finished_count[phase_count]{};
+    std::atomic_bool is_ordered{true};
+    for (std::uint32_t phase_index = 0; phase_index != phase_count;
+         ++phase_index) {
+      for (std::uint32_t i = 0; i != job_count; ++i) {
+        MM::TaskSystem::Task task = frame_scheduler.AddJob(
+            phase_index,
+            phase_index == 1 ? MM::TaskSystem::TaskType::Render
+                             : MM::TaskSystem::TaskType::Common,
+            "job", [&, phase_index]() {
+              if (phase_index != 0 &&
+                  finished_count[phase_index - 1] != job_count) {
+                is_ordered = false;
+              }
+              ++finished_count[phase_index];
+            });
+        EXPECT_EQ(task.empty(), false);
+      }
+    }
+    EXPECT_EQ(frame_scheduler
+                  .AddJob(phase_count, MM::TaskSystem::TaskType::Common, "job",
+                          []() {})
+                  .empty(),
+              true);
+
+    frame_scheduler.Submit();
+    frame_scheduler.Wait();
+    EXPECT_EQ(is_ordered, true);
+    for (std::uint32_t phase_index = 0; phase_index != phase_count;
+         ++phase_index) {
+      EXPECT_EQ(finished_count[phase_index], job_count);
+    }
+  }
+
+  // Jobs of the same phase can still depend on each other.
+  frame_scheduler.BeginFrame();
+  std::atomic_uint32_t value{0};
+  MM::TaskSystem::Task first = frame_scheduler.AddJob(
+      0, MM::TaskSystem::TaskType::Common, "first", [&value]() { value = 1; });
+  MM::TaskSystem::Task second = frame_scheduler.AddJob(
+      0, MM::TaskSystem::TaskType::Common, "second",
+      [&value]() { value = value * 10; });
+  first.precede(second);
+  frame_scheduler.Submit();
+  frame_scheduler.Wait();
+  EXPECT_EQ(value, 10);
+}
+
+TEST(task_system, profiler) {
+  MM::TaskSystem::TaskSystem* task_system =
+      MM::TaskSystem::TaskSystem::GetInstance();
+  MM::TaskSystem::TaskProfiler& profiler = task_system->GetProfiler();
+  MM::TaskSystem::TaskProfileStats begin_stats = profiler.GetStats();
+  profiler.Start();
+  EXPECT_EQ(profiler.IsEnabled(), true);
+
+  MM::TaskSystem::Taskflow render_flow;
+  for (std::uint32_t i = 0; i != 8; ++i) {
+    render_flow.emplace([]() {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }).name("render \"job\"");
+  }
+  task_system->Run(MM::TaskSystem::TaskType::Render, render_flow).wait();
+  task_system->Async(MM::TaskSystem::TaskType::Common, []() {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }).wait();
+  task_system->WaitForAll(MM::TaskSystem::TaskType::Common);
+  profiler.Stop();
+  EXPECT_EQ(profiler.IsEnabled(), false);
+
+  MM::TaskSystem::TaskProfileStats stats = profiler.GetStats();
+  EXPECT_EQ(stats.worker_count_,
+            task_system->NumWorkers(MM::TaskSystem::TaskType::Total));
+  EXPECT_EQ(stats.GetTaskCount(MM::TaskSystem::TaskType::Render) -
+                begin_stats.GetTaskCount(MM::TaskSystem::TaskType::Render),
+            8);
+  EXPECT_EQ(stats.GetTaskCount(MM::TaskSystem::TaskType::Common) -
+                begin_stats.GetTaskCount(MM::TaskSystem::TaskType::Common),
+            1);
+  EXPECT_GE(stats.GetBusyTime(MM::TaskSystem::TaskType::Render), 800000);
+  EXPECT_GT(stats.Utilization(MM::TaskSystem::TaskType::Render), 0.0);
+  EXPECT_LE(stats.Utilization(MM::TaskSystem::TaskType::Render), 1.0);
+
+  std::vector<MM::TaskSystem::TaskProfileRecord> records =
+      profiler.GetRecords();
+  std::uint32_t render_record_count = 0;
+  for (const MM::TaskSystem::TaskProfileRecord& record : records) {
+    EXPECT_LE(record.begin_time_, record.end_time_);
+    EXPECT_LT(record.worker_id_, stats.worker_count_);
+    if (record.is_lane_known_ &&
+        record.task_type_ == MM::TaskSystem::TaskType::Render) {
+      EXPECT_EQ(record.task_name_, "render \"job\"");
+      ++render_record_count;
+    }
+  }
+  EXPECT_EQ(render_record_count, 8);
+
+  // Nothing is recorded while the profiler is stopped.
+  task_system->Run(MM::TaskSystem::TaskType::Render, render_flow).wait();
+  EXPECT_EQ(profiler.GetRecords().size(), records.size());
+
+  std::string trace = profiler.DumpChromeTrace();
+  EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0);
+  EXPECT_NE(trace.find("\"name\":\"render \\\"job\\\"\",\"cat\":\"Render\""),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"Render_utilization\":"), std::string::npos);
+  EXPECT_NE(trace.find("\"Unknown_utilization\":"), std::string::npos);
+}
+
+TEST(task_system, profiler_nested_subflow) {
+  MM::TaskSystem::TaskSystem* task_system =
+      MM::TaskSystem::TaskSystem::GetInstance();
+  MM::TaskSystem::TaskProfiler& profiler = task_system->GetProfiler();
+  MM::TaskSystem::TaskProfileStats begin_stats = profiler.GetStats();
+  profiler.Start();
+
+  // The parent joins its children, so the worker running it runs children
+  // inside it. A child spawned without a lane is reported in the unknown lane.
+  MM::TaskSystem::Taskflow flow;
+  flow.emplace([task_system](MM::TaskSystem::Subflow& subflow) {
+        for (std::uint32_t i = 0; i != 4; ++i) {
+          task_system->AssignTaskType(
+              subflow
+                  .emplace([]() {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                  })
+                  .name("child"),
+              MM::TaskSystem::TaskType::Render);
+        }
+        subflow
+            .emplace([]() {
+              std::this_thread::sleep_for(std::chrono::microseconds(200));
+            })
+            .name("unknown child");
+        subflow.join();
+      })
+      .name("parent");
+  task_system->Run(MM::TaskSystem::TaskType::Render, flow).wait();
+  profiler.Stop();
+
+  MM::TaskSystem::TaskProfileStats stats = profiler.GetStats();
+  EXPECT_EQ(stats.GetTaskCount(MM::TaskSystem::TaskType::Render) -
+                begin_stats.GetTaskCount(MM::TaskSystem::TaskType::Render),
+            5);
+  EXPECT_EQ(stats.GetUnknownTaskCount() - begin_stats.GetUnknownTaskCount(),
+            1);
+  EXPECT_GE(stats.GetUnknownBusyTime() - begin_stats.GetUnknownBusyTime(),
+            200000);
+
+  // Nested entries keep their own begin time: the parent starts before and
+  // ends after every child, whichever worker ran it.
+  const MM::TaskSystem::TaskProfileRecord* parent = nullptr;
+  std::vector<const MM::TaskSystem::TaskProfileRecord*> children;
+  std::vector<MM::TaskSystem::TaskProfileRecord> records =
+      profiler.GetRecords();
+  for (const MM::TaskSystem::TaskProfileRecord& record : records) {
+    if (record.task_name_ == "parent") {
+      parent = &record;
+    } else if (record.task_name_ == "child") {
+      EXPECT_EQ(record.is_lane_known_, true);
+      EXPECT_EQ(record.task_type_, MM::TaskSystem::TaskType::Render);
+      children.emplace_back(&record);
+    } else if (record.task_name_ == "unknown child") {
+      EXPECT_EQ(record.is_lane_known_, false);
+      children.emplace_back(&record);
+    }
+  }
+  ASSERT_NE(parent, nullptr);
+  ASSERT_EQ(children.size(), 5);
+  for (const MM::TaskSystem::TaskProfileRecord* child : children) {
+    EXPECT_LE(parent->begin_time_, child->begin_time_);
+    EXPECT_GE(parent->end_time_, child->end_time_);
+  }
+
+  EXPECT_NE(profiler.DumpChromeTrace().find(
+                "\"name\":\"unknown child\",\"cat\":\"Unknown\""),
+            std::string::npos);
+}
+
+TEST(task_system, parallel_algorithm) {
+  MM::TaskSystem::TaskSystem* task_system =
+      MM::TaskSystem::TaskSystem::GetInstance();
+
+  std::vector<std::uint64_t> values(100000, 0);
+  task_system
+      ->ParallelFor(MM::TaskSystem::TaskType::Common, 0, values.size(), 64,
+                    [&values](std::size_t index) { values[index] = index; })
+      .wait();
+  for (std::uint64_t i = 0; i != values.size(); ++i) {
+    ASSERT_EQ(values[i], i);
+  }
+
+  std::atomic_uint32_t call_count{0};
+  task_system
+      ->ParallelFor(MM::TaskSystem::TaskType::Common, 10, 10, 1,
+                    [&call_count](std::size_t) { ++call_count; })
+      .wait();
+  EXPECT_EQ(call_count, 0);
+
+  auto sum = task_system->ParallelReduce(
+      MM::TaskSystem::TaskType::Physical, 0, values.size(), 256,
+      std::uint64_t{7},
+      [&values](std::size_t index) { return values[index]; },
+      [](std::uint64_t lhs, std::uint64_t rhs) { return lhs + rhs; });
+  EXPECT_EQ(sum.get(), 7 + (values.size() - 1) * values.size() / 2);
+
+  auto max = task_system->ParallelReduce(
+      MM::TaskSystem::TaskType::Common, 0, 0, 1, std::uint64_t{42},
+      [](std::size_t index) { return std::uint64_t{index}; },
+      [](std::uint64_t lhs, std::uint64_t rhs) { return std::max(lhs, rhs); });
+  EXPECT_EQ(max.get(), 42);
+
+  // Concatenation is associative but not commutative, the chunks must be
+  // combined in index order.
+  std::string expected_text = "text:";
+  for (std::size_t i = 0; i != 100000; ++i) {
+    expected_text += std::to_string(i) + ',';
+  }
+  auto text = task_system->ParallelReduce(
+      MM::TaskSystem::TaskType::Common, 0, 100000, 16, std::string{"text:"},
+      [](std::size_t index) { return std::to_string(index) + ','; },
+      [](std::string lhs, const std::string& rhs) {
+        lhs += rhs;
+        return lhs;
+      });
+  EXPECT_EQ(text.get(), expected_text);
+
+  std::vector<std::uint64_t> sort_values(values.rbegin(), values.rend());
+  task_system
+      ->ParallelSort(MM::TaskSystem::TaskType::Common, sort_values.begin(),
+                     sort_values.end())
+      .wait();
+  EXPECT_EQ(sort_values, values);
+  task_system
+      ->ParallelSort(MM::TaskSystem::TaskType::Common, sort_values.begin(),
+                     sort_values.end(), std::greater<>{})
+      .wait();
+  EXPECT_EQ(sort_values.front(), values.back());
+
+  // Chain a loop and a reduction in one taskflow, and wait for it from inside
+  // a task.
+  std::uint64_t result = 0;
+  task_system
+      ->Async(MM::TaskSystem::TaskType::Common,
+              [task_system, &values, &result]() {
+                MM::TaskSystem::Taskflow task_flow;
+                MM::TaskSystem::Task for_task = task_system->EmplaceParallelFor(
+                    MM::TaskSystem::TaskType::Common, task_flow, 0,
+                    values.size(), 128,
+                    [&values](std::size_t index) { values[index] *= 2; });
+                MM::TaskSystem::Task reduce_task =
+                    task_system->EmplaceParallelReduce(
+                        MM::TaskSystem::TaskType::Common, task_flow, 0,
+                        values.size(), 128, result,
+                        [&values](std::size_t index) { return values[index]; },
+                        [](std::uint64_t lhs, std::uint64_t rhs) {
+                          return lhs + rhs;
+                        });
+                for_task.precede(reduce_task);
+                task_system->RunAndWait(MM::TaskSystem::TaskType::Common,
+                                        task_flow);
+              })
+      .wait();
+  EXPECT_EQ(result, (values.size() - 1) * values.size());
+  task_system->WaitForAll(MM::TaskSystem::TaskType::Common);
+}
+
+TEST(task_system, async_task) {
+  MM::TaskSystem::AsyncTask<int> task = MM::TaskSystem::RunAsyncTask(
+      MM::TaskSystem::TaskType::Common, [](int value) { return value * 2; },
+      21);
+  EXPECT_EQ(task.IsValid(), true);
+  EXPECT_EQ(task.Get(), 42);
+  EXPECT_EQ(task.IsValid(), false);
+
+  // Steps run one after another without blocking a worker in between, a step
+  // returning a task is flattened.
+  std::atomic_uint32_t step_count{0};
+  MM::TaskSystem::AsyncTaskPromise<std::string> io_promise;
+  MM::TaskSystem::AsyncTask<std::size_t> pipeline =
+      io_promise.GetAsyncTask()
+          .Then(MM::TaskSystem::TaskType::Common,
+                [&step_count](std::string data) {
+                  ++step_count;
+                  return data + " decoded";
+                })
+          .Then(MM::TaskSystem::TaskType::Render,
+                [&step_count](std::string data) {
+                  ++step_count;
+                  return MM::TaskSystem::RunAsyncTask(
+                      MM::TaskSystem::TaskType::Common,
+                      [data]() { return data.size(); });
+                })
+          .Then(MM::TaskSystem::TaskType::Common,
+                [&step_count](std::size_t size) {
+                  ++step_count;
+                  return size;
+                });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(pipeline.IsReady(), false);
+  EXPECT_EQ(step_count, 0);
+  io_promise.SetValue("file");
+  EXPECT_EQ(pipeline.Get(), std::string("file decoded").size());
+  EXPECT_EQ(step_count, 3);
+
+  std::atomic_bool is_run{false};
+  MM::TaskSystem::AsyncTask<void> void_task =
+      MM::TaskSystem::MakeReadyAsyncTask().Then(
+          MM::TaskSystem::TaskType::Physical, [&is_run]() { is_run = true; });
+  void_task.Wait();
+  EXPECT_EQ(is_run, true);
+  EXPECT_EQ(
+      MM::TaskSystem::MakeReadyAsyncTask(std::vector<int>{1, 2, 3}).Get().size(),
+      3);
+
+  // Waiting from a worker keeps the worker busy with other tasks.
+  auto result = MM::TaskSystem::RunAsyncTask(
+      MM::TaskSystem::TaskType::Common, []() {
+        MM::TaskSystem::AsyncTask<int> inner = MM::TaskSystem::RunAsyncTask(
+            MM::TaskSystem::TaskType::Common, []() { return 1; });
+        return inner.Get() + 1;
+      });
+  EXPECT_EQ(result.Get(), 2);
+
+  // A throwing step releases the waiters, the steps after it are skipped and
+  // Get rethrows.
+  std::atomic_bool is_skipped_step_run{false};
+  MM::TaskSystem::AsyncTask<int> failed_pipeline =
+      MM::TaskSystem::MakeReadyAsyncTask(1)
+          .Then(MM::TaskSystem::TaskType::Common,
+                [](int) -> int { throw std::runtime_error("decode failed"); })
+          .Then(MM::TaskSystem::TaskType::Common,
+                [&is_skipped_step_run](int value) {
+                  is_skipped_step_run = true;
+                  return value;
+                });
+  failed_pipeline.Wait();
+  EXPECT_EQ(failed_pipeline.IsReady(), true);
+  EXPECT_THROW(failed_pipeline.Get(), std::runtime_error);
+  EXPECT_EQ(is_skipped_step_run, false);
+  EXPECT_THROW(MM::TaskSystem::RunAsyncTask(
+                   MM::TaskSystem::TaskType::Common,
+                   []() {
+                     return MM::TaskSystem::RunAsyncTask(
+                         MM::TaskSystem::TaskType::Common,
+                         []() -> int { throw std::runtime_error("inner"); });
+                   })
+                   .Get(),
+               std::runtime_error);
+  MM::TaskSystem::TaskSystem::GetInstance()->WaitForAll(
+      MM::TaskSystem::TaskType::Common);
+}
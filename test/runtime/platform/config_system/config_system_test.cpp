@@ -2,7 +2,14 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <thread>
+#include <vector>
+
+#include "ini_parser.h"
 
 TEST(config_system, config_system) {
   MM::ConfigSystem::ConfigSystem* config_system(
@@ -60,3 +67,159 @@ TEST(config_system, config_system) {
   config_system->Clear();
   EXPECT_EQ(config_system->Size(), 0);
 }
+
+TEST(config_system, config_key) {
+  MM::ConfigSystem::ConfigSystem* config_system(
+      MM::ConfigSystem::ConfigSystem::GetInstance());
+  config_system->Clear();
+
+  // A key can be resolved before the setting exists.
+  const MM::ConfigSystem::ConfigKey int_key =
+      config_system->GetConfigKey("config_key_int");
+  EXPECT_EQ(int_key.IsValid(), true);
+  EXPECT_EQ(MM::ConfigSystem::ConfigKey{}.IsValid(), false);
+  std::int32_t int_value = 0;
+  EXPECT_EQ(config_system->GetConfig(int_key, int_value).GetError()
+                .GetErrorCode(),
+            MM::ErrorCode::NO_SUCH_CONFIG);
+
+  config_system->SetConfig("config_key_int", -42);
+  config_system->SetConfig("config_key_float", "0.5");
+  config_system->SetConfig("config_key_string", "data");
+  EXPECT_EQ(config_system->GetConfigKey("config_key_int").IsValid(), true);
+  EXPECT_EQ(config_system->GetConfig(int_key, int_value).IsSuccess(), true);
+  EXPECT_EQ(int_value, -42);
+  std::int64_t int64_value = 0;
+  EXPECT_EQ(config_system->GetConfig(int_key, int64_value).IsSuccess(), true);
+  EXPECT_EQ(int64_value, -42);
+  // Negative values are not converted to unsigned types.
+  std::uint32_t uint_value = 0;
+  EXPECT_EQ(config_system->GetConfig(int_key, uint_value).GetError()
+                .GetErrorCode(),
+            MM::ErrorCode::TYPE_CONVERSION_FAILED);
+
+  const MM::ConfigSystem::ConfigKey float_key =
+      config_system->GetConfigKey("config_key_float");
+  float float_value = 0;
+  EXPECT_EQ(config_system->GetConfig(float_key, float_value).IsSuccess(), true);
+  EXPECT_EQ(float_value, 0.5f);
+  std::string string_value;
+  EXPECT_EQ(config_system->GetConfig(
+                config_system->GetConfigKey("config_key_string"), string_value)
+                .IsSuccess(),
+            true);
+  EXPECT_EQ(string_value, "data");
+  EXPECT_EQ(config_system->GetConfig("config_key_string", int_value)
+                .GetError()
+                .GetErrorCode(),
+            MM::ErrorCode::TYPE_CONVERSION_FAILED);
+
+  // Readers on other threads see the old or the new value, never a torn one.
+  std::atomic_bool stop{false};
+  std::atomic_uint64_t bad_read_count{0};
+  std::vector<std::thread> readers;
+  for (std::uint32_t i = 0; i != 4; ++i) {
+    readers.emplace_back([&]() {
+      while (!stop.load(std::memory_order_relaxed)) {
+        std::int32_t value = 0;
+        if (config_system->GetConfig(int_key, value).IsError() ||
+            (value != -42 && value < 0)) {
+          bad_read_count.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+  for (std::int32_t i = 0; i != 1000; ++i) {
+    config_system->SetConfig("config_key_int", i);
+  }
+  stop.store(true, std::memory_order_relaxed);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(bad_read_count.load(), 0);
+  EXPECT_EQ(config_system->GetConfig(int_key, int_value).IsSuccess(), true);
+  EXPECT_EQ(int_value, 999);
+
+  // Handles survive Clear.
+  config_system->Clear();
+  EXPECT_EQ(config_system->GetConfig(int_key, int_value).IsError(), true);
+  config_system->SetConfig("config_key_int", 7);
+  EXPECT_EQ(config_system->GetConfig(int_key, int_value).IsSuccess(), true);
+  EXPECT_EQ(int_value, 7);
+  config_system->Clear();
+}
+
+TEST(config_system, load_config_from_ini) {
+  const std::string ini_text =
+      "[section]\n"
+      "key1=value1;comment\r\n"
+      "\n"
+      "not a setting\n"
+      "key2=value2\n"
+      "key1=duplicate\n"
+      "empty=\n"
+      "key3=a=b";
+  std::vector<std::pair<std::string_view, std::string_view>> settings;
+  MM::ConfigSystem::ParseIni(
+      ini_text, [&settings](std::string_view key, std::string_view value) {
+        settings.emplace_back(key, value);
+      });
+  ASSERT_EQ(settings.size(), 5);
+  EXPECT_EQ(settings[0].first, "key1");
+  EXPECT_EQ(settings[0].second, "value1");
+  EXPECT_EQ(settings[1].second, "value2");
+  EXPECT_EQ(settings[2].second, "duplicate");
+  EXPECT_EQ(settings[3].second, "");
+  EXPECT_EQ(settings[4].first, "key3");
+  EXPECT_EQ(settings[4].second, "a=b");
+  // The views point into the text, nothing is copied.
+  EXPECT_EQ(settings[0].first.data(), ini_text.data() + 10);
+
+  std::size_t callback_count = 0;
+  MM::ConfigSystem::ParseIni(ini_text,
+                             [&callback_count](std::string_view key,
+                                               std::string_view) {
+                               ++callback_count;
+                               return key != "key2";
+                             });
+  EXPECT_EQ(callback_count, 2);
+
+  const std::string ini_path =
+      (std::filesystem::temp_directory_path() / "mm_load_config_test.ini")
+          .string();
+  {
+    std::ofstream ini_file(ini_path, std::ios::binary | std::ios::trunc);
+    ini_file << ini_text;
+  }
+  const MM::FileSystem::Path path(ini_path);
+  std::unordered_map<std::string, std::string> all_settings =
+      MM::ConfigSystem::LoadConfigFromIni(path);
+  EXPECT_EQ(all_settings.size(), 4);
+  EXPECT_EQ(all_settings["key1"], "value1");
+  EXPECT_EQ(MM::ConfigSystem::LoadOneConfigFromIni(path, "key2"), "value2");
+  EXPECT_EQ(MM::ConfigSystem::LoadOneConfigFromIni(path, "missing"), "");
+  std::unordered_map<std::string, std::string> some_settings =
+      MM::ConfigSystem::LoadConfigFromIni(
+          path, std::vector<std::string>{"key3", "key1", "missing"});
+  EXPECT_EQ(some_settings.size(), 2);
+  EXPECT_EQ(some_settings["key1"], "value1");
+  EXPECT_EQ(some_settings["key3"], "a=b");
+
+  MM::ConfigSystem::ConfigSystem* config_system(
+      MM::ConfigSystem::ConfigSystem::GetInstance());
+  config_system->Clear();
+  EXPECT_EQ(config_system
+                ->LoadConfigFromIni(path,
+                                    std::vector<std::string>{"key1", "key2"})
+                .IsSuccess(),
+            true);
+  EXPECT_EQ(config_system->Size(), 2);
+  EXPECT_EQ(config_system->LoadOneConfigFromIni(path, "missing"), false);
+  EXPECT_EQ(config_system->LoadOneConfigFromIni(path, "key3"), true);
+  std::string value;
+  EXPECT_EQ(config_system->GetConfig("key3", value).IsSuccess(), true);
+  EXPECT_EQ(value, "a=b");
+  config_system->Clear();
+
+  std::filesystem::remove(ini_path);
+}
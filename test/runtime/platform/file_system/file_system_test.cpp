@@ -2,6 +2,12 @@
 
 #include <gtest/gtest.h>
 
+#include <condition_variable>
+#include <mutex>
+
+#include "async_file_reader.h"
+#include "file_metadata_index.h"
+
 TEST(file_system, relative_path) {
   const MM::FileSystem::Path ori_path(MM_ORIGINE_DIR);
   EXPECT_EQ(ori_path.IsDirectory(), true);
@@ -20,4 +26,304 @@ TEST(file_system, relative_path) {
       ori_path.GetRelativePath(std::string(MM_ORIGINE_DIR) + "/../test.txt"),
       "./origine");
   EXPECT_EQ(ori_path.GetRelativePath("C:/user"), std::string());
-}
\ No newline at end of file
+}
+TEST(file_system, map_file) {
+  const MM::FileSystem::FileSystem* file_system =
+      MM::FileSystem::FileSystem::GetInstance();
+  const std::string file_path =
+      (std::filesystem::temp_directory_path() / "mm_map_file_test.bin")
+          .string();
+  std::string file_data;
+  // Longer than a page so that an offset in the second page is mapped too.
+  for (std::size_t i = 0; i != 10000; ++i) {
+    file_data.push_back(static_cast<char>('a' + i % 26));
+  }
+  {
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    file.write(file_data.data(), file_data.size());
+  }
+
+  auto map_result = file_system->MapFile(MM::FileSystem::Path(file_path));
+  ASSERT_EQ(map_result.IsSuccess(), true);
+  MM::FileSystem::MappedFile mapped_file = std::move(map_result.GetResult());
+  EXPECT_EQ(mapped_file.IsValid(), true);
+  EXPECT_EQ(mapped_file.GetStringView(), file_data);
+
+  auto offset_result =
+      file_system->MapFile(MM::FileSystem::Path(file_path),
+                           MM::FileSystem::FileAccessPattern::RANDOM, 5000, 100);
+  ASSERT_EQ(offset_result.IsSuccess(), true);
+  EXPECT_EQ(offset_result.GetResult().GetStringView(),
+            file_data.substr(5000, 100));
+
+  auto tail_result = file_system->MapFile(
+      MM::FileSystem::Path(file_path),
+      MM::FileSystem::FileAccessPattern::WILL_NEED, file_data.size());
+  ASSERT_EQ(tail_result.IsSuccess(), true);
+  EXPECT_EQ(tail_result.GetResult().IsValid(), true);
+  EXPECT_EQ(tail_result.GetResult().GetSize(), 0);
+
+  EXPECT_EQ(file_system
+                ->MapFile(MM::FileSystem::Path(file_path),
+                          MM::FileSystem::FileAccessPattern::SEQUENTIAL, 0,
+                          file_data.size() + 1)
+                .IsSuccess(),
+            false);
+  EXPECT_EQ(file_system
+                ->MapFile(MM::FileSystem::Path(file_path + ".not_exist"))
+                .IsSuccess(),
+            false);
+
+  MM::FileSystem::MappedFile moved_file{std::move(mapped_file)};
+  EXPECT_EQ(mapped_file.IsValid(), false);
+  EXPECT_EQ(moved_file.GetSize(), file_data.size());
+  moved_file.Release();
+  EXPECT_EQ(moved_file.IsValid(), false);
+
+  std::filesystem::remove(file_path);
+}
+
+TEST(file_system, async_file_reader) {
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "mm_async_file_reader_test";
+  std::filesystem::create_directories(directory);
+  const std::size_t file_count = 64;
+  std::vector<std::string> file_datas;
+  std::vector<MM::FileSystem::FileReadRequest> requests;
+  for (std::size_t i = 0; i != file_count; ++i) {
+    std::string file_data(1000 + i * 997, static_cast<char>('a' + i % 26));
+    file_data[0] = static_cast<char>(i);
+    const std::string file_path =
+        (directory / (std::to_string(i) + ".bin")).string();
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    file.write(file_data.data(), file_data.size());
+    file_datas.emplace_back(std::move(file_data));
+    requests.push_back(
+        MM::FileSystem::FileReadRequest{MM::FileSystem::Path(file_path)});
+  }
+  // A range, an empty range, a range past the end and a missing file.
+  requests.push_back(MM::FileSystem::FileReadRequest{
+      MM::FileSystem::Path((directory / "1.bin").string()), 10, 100});
+  requests.push_back(MM::FileSystem::FileReadRequest{
+      MM::FileSystem::Path((directory / "1.bin").string()), file_datas[1].size(),
+      UINT64_MAX});
+  requests.push_back(MM::FileSystem::FileReadRequest{
+      MM::FileSystem::Path((directory / "1.bin").string()), 1,
+      file_datas[1].size()});
+  requests.push_back(MM::FileSystem::FileReadRequest{
+      MM::FileSystem::Path((directory / "not_exist.bin").string())});
+
+  for (auto backend : {MM::FileSystem::AsyncFileReaderBackend::IO_URING,
+                       MM::FileSystem::AsyncFileReaderBackend::THREAD_POOL}) {
+    // A small queue depth makes the batch wait for free slots.
+    MM::FileSystem::AsyncFileReader async_file_reader{backend, 8};
+    if (backend == MM::FileSystem::AsyncFileReaderBackend::THREAD_POOL) {
+      EXPECT_EQ(async_file_reader.GetBackend(), backend);
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::size_t complete_count = 0;
+    std::vector<MM::Result<std::vector<char>, MM::ErrorResult>> results(
+        requests.size(), MM::ResultE<>{MM::ErrorCode::UNDEFINED_ERROR});
+    async_file_reader.ReadFiles(
+        requests,
+        [&](std::size_t request_index,
+            MM::Result<std::vector<char>, MM::ErrorResult>&& read_result) {
+          std::lock_guard<std::mutex> guard{mutex};
+          results[request_index] = std::move(read_result);
+          ++complete_count;
+          condition.notify_one();
+        });
+    {
+      std::unique_lock<std::mutex> guard{mutex};
+      condition.wait(guard,
+                     [&]() { return complete_count == requests.size(); });
+    }
+
+    for (std::size_t i = 0; i != file_count; ++i) {
+      ASSERT_EQ(results[i].IsSuccess(), true);
+      EXPECT_EQ(std::string(results[i].GetResult().begin(),
+                            results[i].GetResult().end()),
+                file_datas[i]);
+    }
+    ASSERT_EQ(results[file_count].IsSuccess(), true);
+    EXPECT_EQ(std::string(results[file_count].GetResult().begin(),
+                          results[file_count].GetResult().end()),
+              file_datas[1].substr(10, 100));
+    ASSERT_EQ(results[file_count + 1].IsSuccess(), true);
+    EXPECT_EQ(results[file_count + 1].GetResult().empty(), true);
+    EXPECT_EQ(results[file_count + 2].IsSuccess(), false);
+    ASSERT_EQ(results[file_count + 3].IsSuccess(), false);
+    EXPECT_EQ(results[file_count + 3].GetError().GetErrorCode(),
+              MM::ErrorCode::FILE_IS_NOT_EXIST);
+
+    // A callback may read again while the queue is full, the new batch waits
+    // in the queue instead of blocking the I/O thread.
+    std::size_t nested_complete_count = 0;
+    async_file_reader.ReadFiles(
+        std::vector<MM::FileSystem::FileReadRequest>(16, requests[0]),
+        [&](std::size_t, MM::Result<std::vector<char>, MM::ErrorResult>&&) {
+          async_file_reader.ReadFiles(
+              std::vector<MM::FileSystem::FileReadRequest>(4, requests[1]),
+              [&](std::size_t,
+                  MM::Result<std::vector<char>, MM::ErrorResult>&&
+                      read_result) {
+                std::lock_guard<std::mutex> guard{mutex};
+                EXPECT_EQ(read_result.IsSuccess(), true);
+                ++nested_complete_count;
+                condition.notify_one();
+              });
+        });
+    {
+      std::unique_lock<std::mutex> guard{mutex};
+      condition.wait(guard, [&]() { return nested_complete_count == 64; });
+    }
+  }
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(file_system, file_metadata_index) {
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "mm_file_metadata_index_test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory / "dir");
+  // "dir-a" sorts between "dir" and "dir/..." and must not be taken for a
+  // child of "dir".
+  std::filesystem::create_directories(directory / "dir-a");
+  auto write_file = [](const std::filesystem::path& path, std::size_t size) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << std::string(size, 'a');
+  };
+  write_file(directory / "dir" / "1.bin", 100);
+  write_file(directory / "dir" / "2.bin", 200);
+  write_file(directory / "dir-a" / "3.bin", 300);
+
+  MM::FileSystem::FileMetadataIndex file_metadata_index;
+  const MM::FileSystem::Path root(directory.string()),
+      dir((directory / "dir").string()),
+      file1((directory / "dir" / "1.bin").string());
+  ASSERT_EQ(file_metadata_index.AddRoot(root).IsSuccess(), true);
+  EXPECT_EQ(file_metadata_index.GetEntryCount(), 6);
+  EXPECT_EQ(file_metadata_index.IsIndexed(file1), true);
+  EXPECT_EQ(file_metadata_index.IsIndexed(
+                MM::FileSystem::Path(directory.string() + "-other")),
+            false);
+
+  MM::Result<MM::FileSystem::FileMetadata, MM::ErrorResult> metadata =
+      file_metadata_index.GetMetadata(file1);
+  ASSERT_EQ(metadata.IsSuccess(), true);
+  EXPECT_EQ(metadata.GetResult().type_, MM::FileSystem::FileType::FILE);
+  EXPECT_EQ(metadata.GetResult().size_, 100);
+  EXPECT_EQ(metadata.GetResult().last_write_time_,
+            std::filesystem::last_write_time(directory / "dir" / "1.bin"));
+  EXPECT_EQ(file_metadata_index.GetMetadata(dir).GetResult().type_,
+            MM::FileSystem::FileType::DIRECTORY);
+  EXPECT_EQ(file_metadata_index.GetDirectorySize(dir).GetResult(), 300);
+  EXPECT_EQ(file_metadata_index.GetDirectorySize(root).GetResult(), 600);
+  EXPECT_EQ(file_metadata_index.GetChildren(dir, true, true).GetResult().size(),
+            2);
+  EXPECT_EQ(
+      file_metadata_index.GetChildren(root, false, true).GetResult().size(), 2);
+  EXPECT_EQ(file_metadata_index.GetChildren(file1, true, true).GetError()
+                .GetErrorCode(),
+            MM::ErrorCode::FILE_OPERATION_ERROR);
+
+  // Changes made behind the back of the index arrive through inotify.
+  write_file(directory / "dir" / "1.bin", 1000);
+  std::filesystem::remove(directory / "dir" / "2.bin");
+  std::filesystem::create_directories(directory / "dir" / "sub");
+  write_file(directory / "dir" / "sub" / "4.bin", 400);
+  std::filesystem::rename(directory / "dir-a", directory / "dir-b");
+  file_metadata_index.Synchronize();
+
+  metadata = file_metadata_index.GetMetadata(file1);
+  ASSERT_EQ(metadata.IsSuccess(), true);
+  EXPECT_EQ(metadata.GetResult().size_, 1000);
+  EXPECT_EQ(metadata.GetResult().last_write_time_,
+            std::filesystem::last_write_time(directory / "dir" / "1.bin"));
+  EXPECT_EQ(file_metadata_index
+                .GetMetadata(
+                    MM::FileSystem::Path((directory / "dir" / "2.bin").string()))
+                .GetError()
+                .GetErrorCode(),
+            MM::ErrorCode::FILE_IS_NOT_EXIST);
+  EXPECT_EQ(file_metadata_index.GetDirectorySize(dir).GetResult(), 1400);
+  EXPECT_EQ(file_metadata_index
+                .GetMetadata(MM::FileSystem::Path(
+                    (directory / "dir-b" / "3.bin").string()))
+                .IsSuccess(),
+            true);
+  EXPECT_EQ(file_metadata_index
+                .GetMetadata(MM::FileSystem::Path(
+                    (directory / "dir-a" / "3.bin").string()))
+                .IsSuccess(),
+            false);
+  EXPECT_EQ(file_metadata_index.GetDirectorySize(root).GetResult(), 1700);
+
+  // Changes inside a moved directory are still tracked.
+  write_file(directory / "dir-b" / "5.bin", 500);
+  file_metadata_index.Synchronize();
+  EXPECT_EQ(file_metadata_index.GetDirectorySize(root).GetResult(), 2200);
+
+  // Refresh makes a change visible without waiting for inotify.
+  write_file(directory / "dir" / "1.bin", 10);
+  file_metadata_index.Refresh(file1);
+  EXPECT_EQ(file_metadata_index.GetMetadata(file1).GetResult().size_, 10);
+
+  std::filesystem::remove_all(directory);
+  file_metadata_index.Synchronize();
+  EXPECT_EQ(file_metadata_index.GetEntryCount(), 0);
+}
+
+TEST(file_system, file_metadata_index_unwatched_directory) {
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path() /
+      "mm_file_metadata_index_unwatched_test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory / "locked" / "sub");
+  std::filesystem::create_directories(directory / "open");
+  {
+    std::ofstream file(directory / "open" / "1.bin",
+                       std::ios::binary | std::ios::trunc);
+    file << std::string(100, 'a');
+  }
+  // Without read permission inotify_add_watch fails, like it does once the
+  // watch limit is reached.
+  std::filesystem::permissions(directory / "locked",
+                               std::filesystem::perms::none);
+  std::error_code error_code;
+  std::filesystem::directory_iterator probe(directory / "locked", error_code);
+  if (!error_code) {
+    std::filesystem::permissions(directory / "locked",
+                                 std::filesystem::perms::owner_all);
+    std::filesystem::remove_all(directory);
+    GTEST_SKIP() << "Permissions are not enforced for this user.";
+  }
+
+  MM::FileSystem::FileMetadataIndex file_metadata_index;
+  const MM::FileSystem::Path root(directory.string()),
+      locked((directory / "locked").string()),
+      file1((directory / "open" / "1.bin").string());
+  ASSERT_EQ(file_metadata_index.AddRoot(root).IsSuccess(), true);
+  // The root, "open" and "1.bin", nothing of the unwatched subtree.
+  EXPECT_EQ(file_metadata_index.GetEntryCount(), 3);
+  EXPECT_EQ(file_metadata_index.IsIndexed(file1), true);
+  EXPECT_EQ(file_metadata_index.IsIndexed(locked), false);
+  EXPECT_EQ(file_metadata_index.IsIndexed(
+                MM::FileSystem::Path((directory / "locked" / "sub").string())),
+            false);
+  // A query over the root would miss the subtree, it must not use the index.
+  EXPECT_EQ(file_metadata_index.IsIndexed(root), false);
+
+  // The parent reports the permission change, the directory is watched again.
+  std::filesystem::permissions(directory / "locked",
+                               std::filesystem::perms::owner_all);
+  file_metadata_index.Synchronize();
+  EXPECT_EQ(file_metadata_index.IsIndexed(locked), true);
+  EXPECT_EQ(file_metadata_index.IsIndexed(root), true);
+  EXPECT_EQ(file_metadata_index.GetEntryCount(), 5);
+
+  std::filesystem::remove_all(directory);
+}
@@ -13,6 +13,7 @@
 #include "runtime/resource/asset_system/AssetSystem.h"
 #include "runtime/resource/asset_system/asset_type/Combination.h"
 #include "runtime/resource/asset_system/asset_type/Image.h"
+#include "runtime/resource/asset_system/asset_type/Mesh.h"
 #include "runtime/resource/asset_system/asset_type/base/asset_type_define.h"
 #include "runtime/resource/asset_system/asset_type/base/bounding_box.h"
 #include "utils/error.h"
@@ -435,4 +436,63 @@ TEST(asset_system, asset_manager) {
   ASSERT_EQ(handler4.GetResult().GetUseCount(), 2);
   ASSERT_EQ(handler5.GetResult().GetUseCount(), 3);
   ASSERT_EQ(handler6.GetResult().GetUseCount(), 2);
-}
\ No newline at end of file
+}
+TEST(asset_system, add_meshes) {
+  using MM::AssetSystem::AssetType::BoundingBox;
+  using MM::AssetSystem::AssetType::Mesh;
+
+  MM::FileSystem::Path path(std::string(MM_TEST_FILE_DIR_TEST) +
+                            "/asset_system/model.fbx");
+  MM::AssetSystem::AssetManager* asset_manager =
+      MM::AssetSystem::AssetManager::GetInstance();
+
+  MM::Result<std::vector<MM::AssetSystem::AssetManager::HandlerType>>
+      handlers = asset_manager
+                     ->AddMeshes(path, BoundingBox::BoundingBoxType::CAPSULE)
+                     .Exception()
+                     .Move();
+  ASSERT_EQ(handlers.IsSuccess(), true);
+  ASSERT_EQ(handlers.GetResult().empty(), false);
+  for (std::uint32_t i = 0; i != handlers.GetResult().size(); ++i) {
+    ASSERT_EQ(handlers.GetResult()[i].IsValid(), true);
+    MM::Result<MM::AssetSystem::AssetType::AssetID> asset_id =
+        Mesh::CalculateAssetID(path, i, BoundingBox::BoundingBoxType::CAPSULE)
+            .Exception()
+            .Move();
+    ASSERT_EQ(asset_id.IsSuccess(), true);
+    ASSERT_EQ(handlers.GetResult()[i].GetAssetID(), asset_id.GetResult());
+    ASSERT_EQ(handlers.GetResult()[i].GetAsset().GetAssetType(),
+              MM::AssetSystem::AssetType::AssetType::MESH);
+  }
+
+  // The meshes are the ones that are loaded one by one.
+  Mesh first_mesh(path, 0, BoundingBox::BoundingBoxType::CAPSULE);
+  ASSERT_EQ(first_mesh.IsValid(), true);
+  const Mesh& added_first_mesh =
+      static_cast<const Mesh&>(handlers.GetResult()[0].GetAsset());
+  ASSERT_EQ(added_first_mesh.GetAssetID(), first_mesh.GetAssetID());
+  ASSERT_EQ(added_first_mesh.GetVertexData(), first_mesh.GetVertexData());
+  ASSERT_EQ(added_first_mesh.GetIndexes(), first_mesh.GetIndexes());
+
+  // Adding the file again returns the meshes that have been added.
+  MM::Result<std::vector<MM::AssetSystem::AssetManager::HandlerType>>
+      handlers_again =
+          asset_manager
+              ->AddMeshes(path, BoundingBox::BoundingBoxType::CAPSULE, false)
+              .Exception()
+              .Move();
+  ASSERT_EQ(handlers_again.IsSuccess(), true);
+  ASSERT_EQ(handlers_again.GetResult().size(), handlers.GetResult().size());
+  for (std::size_t i = 0; i != handlers.GetResult().size(); ++i) {
+    ASSERT_EQ(handlers_again.GetResult()[i].GetAssetPtr(),
+              handlers.GetResult()[i].GetAssetPtr());
+    ASSERT_EQ(handlers.GetResult()[i].GetUseCount(), 2);
+  }
+
+  ASSERT_EQ(asset_manager
+                ->AddMeshes(MM::FileSystem::Path(
+                    std::string(MM_TEST_FILE_DIR_TEST) +
+                    "/asset_system/not_exist.fbx"))
+                .IsError(),
+            true);
+}
@@ -1,10 +1,15 @@
 //
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <assimp/Exporter.hpp>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <random>
 #include <string>
+#include <vector>
 
 #include "glm/fwd.hpp"
 #include "rapidjson/document.h"
@@ -16,6 +21,9 @@
 #include "runtime/resource/asset_system/asset_type/Mesh.h"
 #include "runtime/resource/asset_system/asset_type/base/asset_type_define.h"
 #include "runtime/resource/asset_system/asset_type/base/bounding_box.h"
+#include "runtime/resource/asset_system/asset_type/base/bounding_volume.h"
+#include "runtime/resource/asset_system/asset_type/base/cooked_mesh.h"
+#include "runtime/resource/asset_system/asset_type/base/mesh_optimizer.h"
 #include "utils/error.h"
 
 TEST(asset_system, asset_base) {
@@ -523,6 +531,357 @@ TEST(asset_system, mesh) {
   ASSERT_EQ(mesh3_3.IsValid(), false);
 }
 
+TEST(asset_system, vertex_layout) {
+  using MM::AssetSystem::AssetType::VertexAttribute;
+  using MM::AssetSystem::AssetType::VertexFormat;
+  using MM::AssetSystem::AssetType::VertexLayout;
+
+  const VertexLayout position_layout{VertexAttribute::POSITION,
+                                     VertexFormat::PACKED},
+      fp32_layout{VertexAttribute::ALL, VertexFormat::FP32},
+      packed_layout{VertexAttribute::ALL, VertexFormat::PACKED},
+      no_normal_layout{VertexAttribute::TEXTURE_COORD | VertexAttribute::TANGENT,
+                       VertexFormat::FP32};
+  ASSERT_EQ(VertexLayout{}.IsValid(), false);
+  ASSERT_EQ(position_layout.GetStride(), 12);
+  ASSERT_EQ(fp32_layout.GetStride(), 48);
+  ASSERT_EQ(packed_layout.GetStride(), 28);
+  ASSERT_EQ(packed_layout.GetOffset(VertexAttribute::TEXTURE_COORD), 12);
+  ASSERT_EQ(packed_layout.GetOffset(VertexAttribute::NORMAL), 16);
+  ASSERT_EQ(packed_layout.GetOffset(VertexAttribute::TANGENT), 20);
+  // The bitangent can not be derived without the normal.
+  ASSERT_EQ(no_normal_layout.HaveAttribute(VertexAttribute::POSITION), true);
+  ASSERT_EQ(no_normal_layout.HaveAttribute(VertexAttribute::TANGENT), false);
+  ASSERT_EQ(no_normal_layout.GetStride(), 20);
+
+  MM::AssetSystem::AssetType::Vertex vertex;
+  vertex.SetPosition(MM::Math::vec3{1.5f, -2.0f, 3.25f});
+  vertex.GetTextureCoord() = MM::Math::vec2{0.25f, 0.75f};
+  vertex.SetNormal(MM::Math::vec3{0.3f, -0.5f, -0.8f});
+  vertex.SetTangent(MM::Math::vec3{0.8f, 0.6f, 0.0f});
+  vertex.SetBiTangent(
+      -MM::Math::cross(vertex.GetNormal(), vertex.GetTangent()));
+  for (const VertexLayout& layout : {fp32_layout, packed_layout}) {
+    std::vector<char> vertex_data(layout.GetStride());
+    layout.Encode(vertex, vertex_data.data());
+    const MM::AssetSystem::AssetType::Vertex decoded_vertex =
+        layout.Decode(vertex_data.data());
+    ASSERT_EQ(layout.DecodePosition(vertex_data.data()), vertex.GetPosition());
+    ASSERT_EQ(decoded_vertex.GetPosition(), vertex.GetPosition());
+    for (int i = 0; i != 2; ++i) {
+      ASSERT_NEAR(decoded_vertex.GetTextureCoord()[i],
+                  vertex.GetTextureCoord()[i], 1e-3);
+    }
+    for (int i = 0; i != 3; ++i) {
+      ASSERT_NEAR(decoded_vertex.GetNormal()[i], vertex.GetNormal()[i], 1e-3);
+      ASSERT_NEAR(decoded_vertex.GetTangent()[i], vertex.GetTangent()[i], 1e-3);
+      ASSERT_NEAR(decoded_vertex.GetBiTangent()[i], vertex.GetBiTangent()[i],
+                  1e-3);
+    }
+  }
+
+  // Meshes store only the attributes they have.
+  MM::FileSystem::Path path(std::string(MM_TEST_FILE_DIR_TEST) +
+                            "/asset_system/monkey.obj");
+  MM::AssetSystem::AssetType::Mesh packed_mesh(
+      path, 0, MM::AssetSystem::AssetType::BoundingBox::BoundingBoxType::AABB),
+      fp32_mesh(path, 0,
+                MM::AssetSystem::AssetType::BoundingBox::BoundingBoxType::AABB,
+                VertexFormat::FP32);
+  ASSERT_EQ(packed_mesh.IsValid(), true);
+  ASSERT_EQ(fp32_mesh.IsValid(), true);
+  const VertexLayout& mesh_layout = packed_mesh.GetVertexLayout();
+  ASSERT_EQ(mesh_layout.GetFormat(), VertexFormat::PACKED);
+  ASSERT_EQ(mesh_layout.HaveAttribute(VertexAttribute::NORMAL), true);
+  ASSERT_EQ(fp32_mesh.GetVertexLayout().GetAttributes(),
+            mesh_layout.GetAttributes());
+  ASSERT_EQ(packed_mesh.GetVertexData().size(),
+            static_cast<std::size_t>(packed_mesh.GetVerticesCount()) *
+                mesh_layout.GetStride());
+  ASSERT_EQ(packed_mesh.GetVerticesCount(), fp32_mesh.GetVerticesCount());
+  ASSERT_LT(packed_mesh.GetVertexData().size(),
+            fp32_mesh.GetVertexData().size());
+  for (std::uint32_t i = 0; i != packed_mesh.GetVerticesCount(); ++i) {
+    ASSERT_EQ(packed_mesh.GetVertexPosition(i), fp32_mesh.GetVertexPosition(i));
+    const MM::Math::vec3 packed_normal = packed_mesh.GetVertex(i).GetNormal(),
+                         fp32_normal = fp32_mesh.GetVertex(i).GetNormal();
+    ASSERT_GT(MM::Math::dot(packed_normal, fp32_normal), 0.999f);
+  }
+}
+
+TEST(asset_system, cooked_mesh) {
+  using MM::AssetSystem::AssetType::BoundingBox;
+  using MM::AssetSystem::AssetType::CapsuleBox;
+  using MM::AssetSystem::AssetType::CookedMesh;
+  using MM::AssetSystem::AssetType::Mesh;
+  using MM::AssetSystem::AssetType::RectangleBox;
+
+  MM::FileSystem::Path path(std::string(MM_TEST_FILE_DIR_TEST) +
+                            "/asset_system/monkey.obj");
+  MM::Result<MM::FileSystem::Path, MM::ErrorResult> cooked_path =
+      CookedMesh::GetCookedPath(path, Mesh::kDefaultVertexFormat);
+  ASSERT_EQ(cooked_path.IsSuccess(), true);
+  if (cooked_path.GetResult().IsExists()) {
+    MM::FileSystem::FileSystem::GetInstance()->Delete(cooked_path.GetResult());
+  }
+  ASSERT_EQ(CookedMesh::Open(path, Mesh::kDefaultVertexFormat).IsError(),
+            true);
+
+  // The first load imports the model and cooks it.
+  Mesh imported_mesh(path, 0, BoundingBox::BoundingBoxType::AABB);
+  ASSERT_EQ(imported_mesh.IsValid(), true);
+  ASSERT_EQ(cooked_path.GetResult().IsExists(), true);
+  MM::Result<CookedMesh, MM::ErrorResult> cooked_mesh =
+      CookedMesh::Open(path, Mesh::kDefaultVertexFormat);
+  ASSERT_EQ(cooked_mesh.IsSuccess(), true);
+  ASSERT_EQ(cooked_mesh.GetResult().GetSubMeshCount(), 1);
+  ASSERT_EQ(cooked_mesh.GetResult().GetSubMesh(1).IsError(), true);
+
+  // The next loads read the cooked file.
+  Mesh cooked_aabb_mesh(path, 0, BoundingBox::BoundingBoxType::AABB),
+      cooked_capsule_mesh(path, 0, BoundingBox::BoundingBoxType::CAPSULE);
+  ASSERT_EQ(cooked_aabb_mesh.IsValid(), true);
+  ASSERT_EQ(cooked_capsule_mesh.IsValid(), true);
+  ASSERT_EQ(cooked_aabb_mesh.GetAssetID(), imported_mesh.GetAssetID());
+  ASSERT_EQ(cooked_aabb_mesh.GetVertexLayout(),
+            imported_mesh.GetVertexLayout());
+  ASSERT_EQ(cooked_aabb_mesh.GetVertexData(), imported_mesh.GetVertexData());
+  ASSERT_EQ(cooked_aabb_mesh.GetIndexes(), imported_mesh.GetIndexes());
+  ASSERT_EQ(cooked_capsule_mesh.GetVertexData(),
+            imported_mesh.GetVertexData());
+
+  const RectangleBox& imported_box =
+      static_cast<const RectangleBox&>(imported_mesh.GetBoundingBox());
+  const RectangleBox& cooked_box =
+      static_cast<const RectangleBox&>(cooked_aabb_mesh.GetBoundingBox());
+  ASSERT_EQ(cooked_box.GetLeftBottomForward(),
+            imported_box.GetLeftBottomForward());
+  ASSERT_EQ(cooked_box.GetRightTopBack(), imported_box.GetRightTopBack());
+  const CapsuleBox& capsule_box =
+      static_cast<const CapsuleBox&>(cooked_capsule_mesh.GetBoundingBox());
+  ASSERT_GT(capsule_box.GetRadius(), 0.0f);
+  ASSERT_GE(capsule_box.GetTop(), imported_box.GetTop());
+  ASSERT_LE(capsule_box.GetBottom(), imported_box.GetBottom());
+
+  // A cooked file with an index past the vertex data is rejected.
+  cooked_mesh.GetResult() = CookedMesh{};
+  {
+    std::fstream patched_file(cooked_path.GetResult().CStr(),
+                              std::ios::in | std::ios::out | std::ios::binary);
+    MM::AssetSystem::AssetType::CookedSubMeshHeader sub_mesh_header;
+    patched_file.seekg(sizeof(MM::AssetSystem::AssetType::CookedMeshHeader));
+    patched_file.read(reinterpret_cast<char*>(&sub_mesh_header),
+                      sizeof(sub_mesh_header));
+    ASSERT_GT(sub_mesh_header.index_count_, 0);
+    patched_file.seekp(static_cast<std::streamoff>(
+        sub_mesh_header.index_data_offset_ +
+        (sub_mesh_header.index_count_ - 1) * sizeof(std::uint32_t)));
+    patched_file.write(
+        reinterpret_cast<const char*>(&sub_mesh_header.vertex_count_),
+        sizeof(sub_mesh_header.vertex_count_));
+  }
+  // Opening does not parse the indexes, copying the sub-mesh checks them.
+  {
+    MM::Result<CookedMesh, MM::ErrorResult> patched_mesh =
+        CookedMesh::Open(path, Mesh::kDefaultVertexFormat);
+    ASSERT_EQ(patched_mesh.IsSuccess(), true);
+    ASSERT_EQ(
+        patched_mesh.GetResult().GetSubMesh(0).GetError().GetErrorCode(),
+        MM::ErrorCode::OBJECT_IS_INVALID);
+  }
+  // Loading the mesh imports the model again and replaces the cooked file.
+  Mesh repaired_mesh(path, 0, BoundingBox::BoundingBoxType::AABB);
+  ASSERT_EQ(repaired_mesh.IsValid(), true);
+  ASSERT_EQ(repaired_mesh.GetIndexes(), imported_mesh.GetIndexes());
+  {
+    MM::Result<CookedMesh, MM::ErrorResult> repaired_cooked_mesh =
+        CookedMesh::Open(path, Mesh::kDefaultVertexFormat);
+    ASSERT_EQ(repaired_cooked_mesh.IsSuccess(), true);
+    ASSERT_EQ(repaired_cooked_mesh.GetResult().GetSubMesh(0).IsSuccess(),
+              true);
+  }
+
+  // A corrupted cooked file is ignored and cooked again.
+  MM::FileSystem::FileSystem::GetInstance()->Delete(cooked_path.GetResult());
+  {
+    std::ofstream corrupted_file(cooked_path.GetResult().CStr(),
+                                 std::ios::out | std::ios::binary);
+    corrupted_file << "MMMESH";
+  }
+  ASSERT_EQ(CookedMesh::Open(path, Mesh::kDefaultVertexFormat).IsError(),
+            true);
+  Mesh reimported_mesh(path, 0, BoundingBox::BoundingBoxType::AABB);
+  ASSERT_EQ(reimported_mesh.IsValid(), true);
+  ASSERT_EQ(reimported_mesh.GetVertexData(), imported_mesh.GetVertexData());
+  ASSERT_EQ(CookedMesh::Open(path, Mesh::kDefaultVertexFormat).IsSuccess(),
+            true);
+}
+
+TEST(asset_system, position_bounds) {
+  using MM::AssetSystem::AssetType::CapsuleBox;
+  using MM::AssetSystem::AssetType::PositionBounds;
+  using MM::AssetSystem::AssetType::PositionStream;
+  using MM::AssetSystem::AssetType::RectangleBox;
+
+  // Streams of every size around the vector widths, and one that is chunked.
+  const std::size_t stride = 28;
+  const std::vector<std::size_t> vertex_counts{
+      0, 1, 3, 4, 5, 8, 9, 1000,
+      MM::AssetSystem::AssetType::kParallelBoundsVertexCount + 13};
+  std::vector<std::vector<char>> datas;
+  std::vector<PositionStream> streams;
+  std::vector<RectangleBox> expected_aabb_boxes(vertex_counts.size());
+  std::vector<CapsuleBox> expected_capsule_boxes(vertex_counts.size());
+  for (std::size_t i = 0; i != vertex_counts.size(); ++i) {
+    datas.emplace_back(vertex_counts[i] * stride);
+    for (std::size_t j = 0; j != vertex_counts[i]; ++j) {
+      MM::AssetSystem::AssetType::Vertex vertex;
+      vertex.SetPosition(
+          MM::Math::vec3{std::sin(j * 0.37f + i) * 100.0f,
+                         std::cos(j * 0.11f) * 50.0f + i,
+                         std::sin(j * 0.05f + 1.0f) * 25.0f});
+      const float position[3]{vertex.GetPosition().x, vertex.GetPosition().y,
+                              vertex.GetPosition().z};
+      std::memcpy(datas[i].data() + j * stride, position, sizeof(position));
+      expected_aabb_boxes[i].UpdateBoundingBoxWithOneVertex(vertex);
+      expected_capsule_boxes[i].UpdateBoundingBoxWithOneVertex(vertex);
+    }
+    streams.push_back(PositionStream{datas[i].data(), vertex_counts[i], stride});
+  }
+
+  const std::vector<PositionBounds> batch_bounds =
+      MM::AssetSystem::AssetType::ComputePositionBounds(streams);
+  ASSERT_EQ(batch_bounds.size(), streams.size());
+  for (std::size_t i = 0; i != streams.size(); ++i) {
+    for (const PositionBounds& bounds :
+         {batch_bounds[i],
+          MM::AssetSystem::AssetType::ComputePositionBounds(streams[i], false),
+          MM::AssetSystem::AssetType::ComputePositionBounds(streams[i],
+                                                            true)}) {
+      ASSERT_EQ(bounds.IsEmpty(), vertex_counts[i] == 0);
+      RectangleBox aabb_box;
+      CapsuleBox capsule_box;
+      aabb_box.UpdateBoundingBox(bounds);
+      capsule_box.UpdateBoundingBox(bounds);
+      ASSERT_EQ(aabb_box.GetLeftBottomForward(),
+                expected_aabb_boxes[i].GetLeftBottomForward());
+      ASSERT_EQ(aabb_box.GetRightTopBack(),
+                expected_aabb_boxes[i].GetRightTopBack());
+      ASSERT_FLOAT_EQ(capsule_box.GetRadius(),
+                      expected_capsule_boxes[i].GetRadius());
+      ASSERT_EQ(capsule_box.GetTop(), expected_capsule_boxes[i].GetTop());
+      ASSERT_EQ(capsule_box.GetBottom(), expected_capsule_boxes[i].GetBottom());
+    }
+  }
+
+  // The box of a mesh is the box of its positions.
+  MM::FileSystem::Path path(std::string(MM_TEST_FILE_DIR_TEST) +
+                            "/asset_system/monkey.obj");
+  MM::AssetSystem::AssetType::Mesh mesh(
+      path, 0, MM::AssetSystem::AssetType::BoundingBox::BoundingBoxType::AABB);
+  ASSERT_EQ(mesh.IsValid(), true);
+  RectangleBox mesh_box;
+  ASSERT_EQ(mesh_box.UpdateBoundingBox(mesh).IsSuccess(), true);
+  const RectangleBox& loaded_box =
+      static_cast<const RectangleBox&>(mesh.GetBoundingBox());
+  ASSERT_EQ(mesh_box.GetLeftBottomForward(), loaded_box.GetLeftBottomForward());
+  ASSERT_EQ(mesh_box.GetRightTopBack(), loaded_box.GetRightTopBack());
+}
+
+TEST(asset_system, mesh_optimizer) {
+  using MM::AssetSystem::AssetType::CookedSubMesh;
+  using MM::AssetSystem::AssetType::VertexAttribute;
+  using MM::AssetSystem::AssetType::VertexFormat;
+  using MM::AssetSystem::AssetType::VertexLayout;
+
+  // A grid of 40 * 40 quads whose triangles do not share vertices and are
+  // shuffled, the worst case for the vertex cache.
+  const int grid_size = 40;
+  CookedSubMesh sub_mesh;
+  sub_mesh.vertex_layout_ =
+      VertexLayout{VertexAttribute::POSITION, VertexFormat::FP32};
+  std::vector<std::vector<MM::Math::vec3>> triangles;
+  for (int x = 0; x != grid_size; ++x) {
+    for (int z = 0; z != grid_size; ++z) {
+      const float left = static_cast<float>(x), forward = static_cast<float>(z);
+      const MM::Math::vec3 p00{left, 0.0f, forward},
+          p10{left + 1.0f, 0.0f, forward}, p01{left, 0.0f, forward + 1.0f},
+          p11{left + 1.0f, 0.0f, forward + 1.0f};
+      triangles.push_back({p00, p10, p01});
+      triangles.push_back({p10, p11, p01});
+    }
+  }
+  std::shuffle(triangles.begin(), triangles.end(), std::mt19937{7});
+  for (const std::vector<MM::Math::vec3>& triangle : triangles) {
+    for (const MM::Math::vec3& position : triangle) {
+      const std::size_t vertex_offset = sub_mesh.vertex_data_.size();
+      sub_mesh.indexes_.push_back(
+          static_cast<std::uint32_t>(vertex_offset / 12));
+      sub_mesh.vertex_data_.resize(vertex_offset + 12);
+      sub_mesh.vertex_layout_.EncodePosition(
+          position, sub_mesh.vertex_data_.data() + vertex_offset);
+    }
+  }
+
+  // Every triangle is a sorted list of positions, rotated to start with the
+  // smallest one so the winding is compared too.
+  auto get_triangles = [](const CookedSubMesh& mesh) {
+    std::vector<std::vector<float>> result;
+    for (std::size_t i = 0; i != mesh.indexes_.size(); i += 3) {
+      std::vector<std::vector<float>> corners;
+      for (std::size_t j = 0; j != 3; ++j) {
+        const MM::Math::vec3 position = mesh.vertex_layout_.DecodePosition(
+            mesh.vertex_data_.data() + mesh.indexes_[i + j] * 12);
+        corners.push_back({position.x, position.y, position.z});
+      }
+      std::rotate(corners.begin(),
+                  std::min_element(corners.begin(), corners.end()),
+                  corners.end());
+      std::vector<float> triangle;
+      for (const std::vector<float>& corner : corners) {
+        triangle.insert(triangle.end(), corner.begin(), corner.end());
+      }
+      result.push_back(triangle);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+  const std::vector<std::vector<float>> source_triangles =
+      get_triangles(sub_mesh);
+  const float source_miss_ratio =
+      MM::AssetSystem::AssetType::GetAverageCacheMissRatio(
+          sub_mesh.indexes_, sub_mesh.vertex_data_.size() / 12);
+  ASSERT_FLOAT_EQ(source_miss_ratio, 3.0f);
+
+  ASSERT_EQ(MM::AssetSystem::AssetType::OptimizeSubMesh(sub_mesh).IsSuccess(),
+            true);
+  // The shared vertices are merged and fetched in order.
+  const std::size_t vertex_count = sub_mesh.vertex_data_.size() / 12;
+  ASSERT_EQ(vertex_count, (grid_size + 1) * (grid_size + 1));
+  std::uint32_t next_vertex = 0;
+  for (std::uint32_t index : sub_mesh.indexes_) {
+    ASSERT_LE(index, next_vertex);
+    if (index == next_vertex) {
+      ++next_vertex;
+    }
+  }
+  ASSERT_EQ(next_vertex, vertex_count);
+  ASSERT_EQ(get_triangles(sub_mesh), source_triangles);
+  ASSERT_LT(MM::AssetSystem::AssetType::GetAverageCacheMissRatio(
+                sub_mesh.indexes_, vertex_count),
+            1.0f);
+
+  // Invalid meshes are left as they are.
+  CookedSubMesh invalid_sub_mesh;
+  invalid_sub_mesh.vertex_layout_ = sub_mesh.vertex_layout_;
+  invalid_sub_mesh.vertex_data_.resize(24);
+  invalid_sub_mesh.indexes_ = {0, 1, 2};
+  ASSERT_EQ(
+      MM::AssetSystem::AssetType::OptimizeSubMesh(invalid_sub_mesh).IsError(),
+      true);
+  ASSERT_EQ(invalid_sub_mesh.indexes_, (std::vector<std::uint32_t>{0, 1, 2}));
+}
+
 TEST(asset_system, combination) {
   struct ImageImageMeshMesh : public MM::AssetSystem::AssetType::Combination {
     explicit ImageImageMeshMesh(const MM::FileSystem::Path& json_path)
@@ -2,9 +2,14 @@
 // Created by beimingxianyu on 23-6-6.
 //
 #include "utils/hash_table.h"
+#include "utils/ID.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
 #include <thread>
 
 TEST(Utils, HashTable_set) {
@@ -686,3 +691,505 @@ TEST(Utils, ConcurrentHashTable_thread) {
   ASSERT_EQ(concurrent_multi_map1.Size(), 0);
   ASSERT_EQ(concurrent_multi_map2.Size(), 0);
 }
+
+TEST(Utils, ConcurrentHashTable_lock_free_read) {
+  MM::Utils::ConcurrentMap<std::uint64_t, std::uint64_t> concurrent_map;
+  // Keys below 1000 are never erased, readers must always find them while
+  // writers insert, erase and rehash around them.
+  for (std::uint64_t i = 0; i != 1000; ++i) {
+    concurrent_map.Emplace(i, i * 2);
+  }
+
+  std::atomic_bool stop{false};
+  std::atomic_uint64_t missing_count{0};
+  std::vector<std::thread> readers;
+  for (std::uint64_t t = 0; t != 4; ++t) {
+    readers.emplace_back([&concurrent_map, &stop, &missing_count]() {
+      while (!stop.load(std::memory_order_relaxed)) {
+        for (std::uint64_t i = 0; i != 1000; ++i) {
+          const std::uint64_t* value = &(concurrent_map.Find(i)->second);
+          if (concurrent_map.Count(i) != 1 || *value != i * 2) {
+            missing_count.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> writers;
+  for (std::uint64_t t = 0; t != 2; ++t) {
+    writers.emplace_back([&concurrent_map, t]() {
+      const std::uint64_t start = 1000 + t * 20000;
+      for (std::uint64_t i = start; i != start + 20000; ++i) {
+        concurrent_map.Emplace(i, i * 2);
+        if (i % 2 == 0) {
+          concurrent_map.Erase(i);
+        }
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  ASSERT_EQ(missing_count.load(), 0);
+  ASSERT_EQ(concurrent_map.Size(), 1000 + 20000);
+  for (std::uint64_t i = 1000; i != 41000; ++i) {
+    ASSERT_EQ(concurrent_map.Contains(i), i % 2 != 0);
+  }
+
+  concurrent_map.Clear();
+  MM::Utils::EpochDomain::GetInstance()->Reclaim();
+  ASSERT_EQ(MM::Utils::EpochDomain::GetInstance()->Reclaim(), 0);
+}
+
+TEST(Utils, ConcurrentHashTable_stripe_count) {
+  ASSERT_EQ(MM::Utils::StripedMutex<>().StripeCount(), 16);
+  ASSERT_EQ(MM::Utils::StripedMutex<>(48).StripeCount(), 64);
+  MM::Utils::StripedMutex<> striped_mutex(4);
+  ASSERT_NE(&striped_mutex.ChooseMutex(0), &striped_mutex.ChooseMutex(1));
+  ASSERT_EQ(&striped_mutex.ChooseMutex(1), &striped_mutex.ChooseMutex(5));
+  ASSERT_GE(reinterpret_cast<std::uintptr_t>(&striped_mutex.ChooseMutex(1)) -
+                reinterpret_cast<std::uintptr_t>(&striped_mutex.ChooseMutex(0)),
+            64);
+
+  MM::Utils::ConcurrentMultiMap<std::string, TestClass> concurrent_multi_map(
+      131, 64);
+  ASSERT_EQ(concurrent_multi_map.StripeCount(), 64);
+  std::vector<std::thread> threads;
+  for (std::uint64_t i = 0; i != 8; ++i) {
+    threads.emplace_back(InsertElementThread, std::ref(concurrent_multi_map),
+                         i * 1000, 1000, 2);
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  ASSERT_EQ(concurrent_multi_map.Size(), 16000);
+
+  auto copied_multi_map = concurrent_multi_map;
+  ASSERT_EQ(copied_multi_map.StripeCount(), 64);
+  MM::Utils::ConcurrentMultiMap<std::string, TestClass> moved_multi_map;
+  moved_multi_map = std::move(concurrent_multi_map);
+  ASSERT_EQ(moved_multi_map.StripeCount(), 16);
+  for (std::uint64_t i = 0; i != 8000; ++i) {
+    ASSERT_EQ(moved_multi_map.Count(std::to_string(i)), 2);
+    ASSERT_EQ(copied_multi_map.Count(std::to_string(i)), 2);
+  }
+}
+
+TEST(Utils, ConcurrentHashTable_incremental_rehash) {
+  using IncrementalMultiMap = MM::Utils::ConcurrentMultiMap<
+      std::uint64_t, std::uint64_t, std::hash<std::uint64_t>, std::equal_to<>,
+      std::allocator<std::pair<const std::uint64_t, std::uint64_t>>,
+      MM::Utils::PowerOfTwoBucket>;
+  IncrementalMultiMap concurrent_map;
+  for (std::uint64_t i = 0; i != 1000; ++i) {
+    concurrent_map.Emplace(i, 0);
+    concurrent_map.Emplace(i, 1);
+  }
+
+  // No bucket has been moved yet, every lookup goes to the old buckets.
+  concurrent_map.ReHash(8192);
+  ASSERT_EQ(concurrent_map.BucketCount(), 8192);
+  for (std::uint64_t i = 0; i != 1000; ++i) {
+    std::vector<std::pair<const std::uint64_t, std::uint64_t>*> range =
+        concurrent_map.EqualRange(i);
+    ASSERT_EQ(range.size(), 2);
+    ASSERT_EQ(range[0]->second, 1);
+    ASSERT_EQ(range[1]->second, 0);
+  }
+
+  // Every write moves a few buckets, lookups see both bucket arrays.
+  for (std::uint64_t i = 0; i != 1000; i += 2) {
+    ASSERT_EQ(concurrent_map.Erase(i), 2);
+    ASSERT_EQ(concurrent_map.Count(i + 1), 2);
+  }
+  IncrementalMultiMap copied_map{concurrent_map};
+  IncrementalMultiMap moved_map{std::move(concurrent_map)};
+  for (std::uint64_t i = 0; i != 1000; ++i) {
+    ASSERT_EQ(copied_map.Count(i), i % 2 == 0 ? 0 : 2);
+    ASSERT_EQ(moved_map.Count(i), i % 2 == 0 ? 0 : 2);
+  }
+
+  std::atomic_bool stop{false};
+  std::atomic_uint64_t missing_count{0};
+  std::vector<std::thread> readers;
+  for (std::uint64_t t = 0; t != 4; ++t) {
+    readers.emplace_back([&moved_map, &stop, &missing_count]() {
+      while (!stop.load(std::memory_order_relaxed)) {
+        for (std::uint64_t i = 1; i < 1000; i += 2) {
+          if (moved_map.Count(i) != 2) {
+            missing_count.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (std::uint64_t t = 0; t != 2; ++t) {
+    writers.emplace_back([&moved_map, t]() {
+      const std::uint64_t start = 1000 + t * 50000;
+      for (std::uint64_t i = start; i != start + 50000; ++i) {
+        moved_map.Emplace(i, i);
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  ASSERT_EQ(missing_count.load(), 0);
+  ASSERT_EQ(moved_map.Size(), 1000 + 100000);
+  for (std::uint64_t i = 1000; i != 101000; ++i) {
+    ASSERT_EQ(moved_map.Count(i), 1);
+  }
+
+  moved_map.Clear();
+  copied_map.Clear();
+  MM::Utils::EpochDomain::GetInstance()->Reclaim();
+  ASSERT_EQ(MM::Utils::EpochDomain::GetInstance()->Reclaim(), 0);
+}
+
+TEST(Utils, FlatHashTable_set) {
+  MM::Utils::FlatHashSet<std::string> flat_set, flat_set2;
+  ASSERT_EQ(flat_set.Empty(), true);
+  ASSERT_EQ(flat_set.BucketCount(), 16);
+  ASSERT_EQ(flat_set.GetLoadFactor(), 0.875);
+  ASSERT_EQ(flat_set.Emplace("Asset1").first, std::string("Asset1"));
+  ASSERT_EQ(flat_set.Size(), 1);
+  ASSERT_EQ(flat_set.Insert(std::string("Assert3")).first,
+            std::string("Assert3"));
+  std::string s1 = "Assert5";
+  ASSERT_EQ(flat_set.Insert(s1).first, s1);
+  ASSERT_EQ(flat_set.Insert(s1).second, false);
+  ASSERT_EQ(flat_set.Size(), 3);
+  ASSERT_EQ(flat_set.Contains("Assert2"), false);
+  ASSERT_EQ(flat_set.Contains("Assert3"), true);
+  ASSERT_EQ(flat_set.Count("Assert5"), 1);
+  ASSERT_EQ(flat_set.Find("Assert2"), nullptr);
+  ASSERT_EQ(*flat_set.Find("Assert5"), std::string("Assert5"));
+  ASSERT_EQ(flat_set.EqualRange("Assert5").size(), 1);
+  ASSERT_EQ(flat_set.Erase("Assert5"), 1);
+  ASSERT_EQ(flat_set.Erase("Assert5"), 0);
+  ASSERT_EQ(flat_set.Size(), 2);
+
+  for (int i = 0; i != 1000; ++i) {
+    ASSERT_EQ(flat_set.Emplace(std::to_string(i)).second, true);
+  }
+  ASSERT_EQ(flat_set.Size(), 1002);
+  ASSERT_EQ(flat_set.BucketCount(), 2048);
+  for (int i = 0; i != 1000; i += 2) {
+    ASSERT_EQ(flat_set.Erase(std::to_string(i)), 1);
+  }
+  ASSERT_EQ(flat_set.Size(), 502);
+  for (int i = 0; i != 1000; ++i) {
+    ASSERT_EQ(flat_set.Contains(std::to_string(i)), i % 2 == 1);
+  }
+
+  flat_set2 = flat_set;
+  MM::Utils::FlatHashSet<std::string> flat_set3(std::move(flat_set));
+  ASSERT_EQ(flat_set.Size(), 0);
+  ASSERT_EQ(flat_set.BucketCount(), 0);
+  ASSERT_EQ(flat_set.Contains("1"), false);
+  ASSERT_EQ(flat_set.Erase("1"), 0);
+  ASSERT_EQ(flat_set.Emplace("moved").second, true);
+  ASSERT_EQ(flat_set.BucketCount(), 16);
+  ASSERT_EQ(flat_set.Contains("moved"), true);
+  flat_set = std::move(flat_set2);
+  flat_set2 = flat_set;
+  ASSERT_EQ(flat_set2.Size(), 502);
+  ASSERT_EQ(flat_set3.Size(), 502);
+  for (int i = 0; i != 1000; ++i) {
+    ASSERT_EQ(flat_set2.Contains(std::to_string(i)), i % 2 == 1);
+    ASSERT_EQ(flat_set3.Contains(std::to_string(i)), i % 2 == 1);
+  }
+  flat_set3.Clear();
+  ASSERT_EQ(flat_set3.Size(), 0);
+  ASSERT_EQ(flat_set3.Find("1"), nullptr);
+}
+
+TEST(Utils, FlatHashTable_multi_map) {
+  MM::Utils::FlatMultiHashMap<std::string, TestClass> flat_multi_map;
+
+  for (std::uint64_t i = 0; i != 100; ++i) {
+    for (std::uint64_t j = 0; j <= i; ++j) {
+      auto insert_result =
+          flat_multi_map.Emplace(std::to_string(i), TestClass{i, j, 1});
+      ASSERT_EQ(insert_result.first.first, std::to_string(i));
+      ASSERT_EQ(insert_result.first.second, TestClass(i, j, 1));
+      ASSERT_EQ(insert_result.second, true);
+    }
+  }
+  ASSERT_EQ(flat_multi_map.Size(), 5050);
+
+  for (std::uint64_t i = 0; i != 100; ++i) {
+    ASSERT_EQ(flat_multi_map.Count(std::to_string(i)), i + 1);
+    ASSERT_EQ(flat_multi_map.EqualRange(std::to_string(i)).size(), i + 1);
+  }
+
+  ASSERT_EQ(flat_multi_map.Erase("fffffff"), 0);
+  auto insert_result = flat_multi_map.Emplace("ffff", TestClass{1, 1, 1});
+  ASSERT_EQ(
+      flat_multi_map.Erase(&(insert_result.first)).Exception().IsSuccess(),
+      true);
+  std::pair<const std::string, TestClass>* null_ptr = nullptr;
+  ASSERT_EQ(flat_multi_map.Erase(null_ptr).Exception().GetError(),
+            MM::ErrorResult(MM::ErrorCode::INPUT_PARAMETERS_ARE_NOT_SUITABLE));
+
+  for (std::uint64_t i = 0; i != 100; ++i) {
+    ASSERT_EQ(flat_multi_map.Erase(std::to_string(i)), i + 1);
+  }
+  ASSERT_EQ(flat_multi_map.Size(), 0);
+}
+
+TEST(Utils, FlatHashTable_map) {
+  MM::Utils::FlatHashMap<int, std::string> flat_map;
+
+  // Insert and erase repeatedly so that the table is filled with tombstones.
+  for (int round = 0; round != 20; ++round) {
+    for (int i = 0; i != 1000; ++i) {
+      ASSERT_EQ(flat_map.Emplace(round * 1000 + i, std::to_string(i)).second,
+                true);
+    }
+    for (int i = 0; i != 1000; ++i) {
+      ASSERT_EQ(flat_map.Erase(round * 1000 + i), 1);
+    }
+  }
+  ASSERT_EQ(flat_map.Size(), 0);
+  ASSERT_LE(flat_map.BucketCount(), 4096);
+
+  ASSERT_EQ(flat_map.Emplace(1, "insert1").second, true);
+  ASSERT_EQ(flat_map.Emplace(1, "insert2").second, false);
+  ASSERT_EQ(flat_map.Find(1)->second, std::string("insert1"));
+  flat_map.ReHash(10000);
+  ASSERT_EQ(flat_map.BucketCount(), 16384);
+  ASSERT_EQ(flat_map.Find(1)->second, std::string("insert1"));
+}
+
+TEST(Utils, HashTable_batch) {
+  MM::Utils::HashMap<std::string, int> hash_map;
+  std::vector<std::pair<const std::string, int>> objects;
+  for (int i = 0; i != 1000; ++i) {
+    objects.emplace_back(std::to_string(i), i);
+  }
+  objects.emplace_back("7", -7);
+
+  hash_map.Reserve(2000);
+  const std::uint64_t bucket_count = hash_map.BucketCount();
+  ASSERT_GE(bucket_count * hash_map.GetLoadFactor(), 2000);
+  auto insert_results = hash_map.InsertBatch(std::move(objects));
+  ASSERT_EQ(hash_map.BucketCount(), bucket_count);
+  ASSERT_EQ(insert_results.size(), 1001);
+  ASSERT_EQ(hash_map.Size(), 1000);
+  for (int i = 0; i != 1000; ++i) {
+    ASSERT_EQ(insert_results[i].second, true);
+    ASSERT_EQ(insert_results[i].first->second, i);
+  }
+  ASSERT_EQ(insert_results[1000].second, false);
+  ASSERT_EQ(insert_results[1000].first, insert_results[7].first);
+
+  std::vector<std::string> keys{"999", "1000", "0"};
+  auto find_results = hash_map.FindBatch(keys);
+  ASSERT_EQ(find_results[0]->second, 999);
+  ASSERT_EQ(find_results[1], nullptr);
+  ASSERT_EQ(find_results[2]->second, 0);
+  ASSERT_EQ(hash_map.EraseBatch(keys), 2);
+  ASSERT_EQ(hash_map.Size(), 998);
+  ASSERT_EQ(hash_map.Contains("999"), false);
+
+  MM::Utils::MultiHashMap<int, int> multi_hash_map;
+  std::vector<std::pair<const int, int>> multi_objects;
+  for (int i = 0; i != 1000; ++i) {
+    multi_objects.emplace_back(i % 100, i);
+  }
+  // Without a Reserve the batch grows the table once, to fit every object.
+  const std::uint64_t multi_bucket_count = multi_hash_map.BucketCount();
+  ASSERT_LT(multi_bucket_count * multi_hash_map.GetLoadFactor(), 1000);
+  multi_hash_map.InsertBatch(std::move(multi_objects));
+  ASSERT_GT(multi_hash_map.BucketCount(), multi_bucket_count);
+  ASSERT_GE(multi_hash_map.BucketCount() * multi_hash_map.GetLoadFactor(),
+            1000);
+  ASSERT_EQ(multi_hash_map.Size(), 1000);
+  ASSERT_EQ(multi_hash_map.Count(42), 10);
+  ASSERT_EQ(multi_hash_map.EraseBatch(std::vector<int>{42, 43}), 20);
+  ASSERT_EQ(multi_hash_map.Size(), 980);
+}
+
+TEST(Utils, HashTable_power_of_two_bucket) {
+  MM::Utils::HashMap<int, std::string, std::hash<int>, std::equal_to<>,
+                     std::allocator<std::pair<const int, std::string>>,
+                     MM::Utils::PowerOfTwoBucket>
+      pow2_map;
+  ASSERT_EQ(pow2_map.BucketCount(), 128);
+  for (int i = 0; i != 1000; ++i) {
+    ASSERT_EQ(pow2_map.Emplace(i * 1024, std::to_string(i)).second, true);
+  }
+  ASSERT_EQ(pow2_map.Size(), 1000);
+  ASSERT_EQ(pow2_map.BucketCount() & (pow2_map.BucketCount() - 1), 0);
+  for (int i = 0; i != 1000; ++i) {
+    ASSERT_EQ(pow2_map.Find(i * 1024)->second, std::to_string(i));
+  }
+  pow2_map.ReHash(5000);
+  ASSERT_EQ(pow2_map.BucketCount(), 8192);
+  for (int i = 0; i != 1000; i += 2) {
+    ASSERT_EQ(pow2_map.Erase(i * 1024), 1);
+  }
+  ASSERT_EQ(pow2_map.Size(), 500);
+  ASSERT_EQ(pow2_map.Contains(1024), true);
+  ASSERT_EQ(pow2_map.Contains(0), false);
+
+  MM::Utils::ConcurrentMultiMap<
+      int, int, std::hash<int>, std::equal_to<>,
+      std::allocator<std::pair<const int, int>>, MM::Utils::PowerOfTwoBucket>
+      concurrent_map(100);
+  ASSERT_EQ(concurrent_map.BucketCount(), 128);
+  std::vector<std::thread> threads;
+  for (int t = 0; t != 4; ++t) {
+    threads.emplace_back([&concurrent_map, t]() {
+      for (int i = 0; i != 1000; ++i) {
+        concurrent_map.Emplace(i << 8, t);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(concurrent_map.Size(), 4000);
+  for (int i = 0; i != 1000; ++i) {
+    ASSERT_EQ(concurrent_map.Count(i << 8), 4);
+  }
+}
+
+namespace {
+// Same layout and hash as MM::RenderSystem::RenderResourceDataID: an asset ID
+// combined with the XOR of the sub IDs of a resource attribute.
+struct RenderResourceDataIDHash {
+  std::uint64_t operator()(const MM::Utils::ID3& key) const {
+    return key.GetSubID1() ^ (key.GetSubID2() ^ key.GetSubID3());
+  }
+};
+
+using RenderResourceIDAllocator =
+    std::allocator<std::pair<const MM::Utils::ID3, int>>;
+
+template <typename BucketTrait>
+using RenderResourceIDMap =
+    MM::Utils::HashMap<MM::Utils::ID3, int, RenderResourceDataIDHash,
+                       std::equal_to<>, RenderResourceIDAllocator, BucketTrait>;
+
+// Asset IDs are hashes of the asset path and last editing time, offset by the
+// mesh index; attribute IDs come from a small set of resource layouts. The
+// XOR of such keys only differs in a few low bits.
+std::vector<MM::Utils::ID3> MakeRenderResourceIDs(
+    std::mt19937_64& random_engine) {
+  std::vector<MM::Utils::ID3> keys;
+  for (std::uint64_t asset = 0; asset != 256; ++asset) {
+    const std::uint64_t asset_ID = random_engine();
+    for (std::uint64_t mesh_index = 0; mesh_index != 4; ++mesh_index) {
+      for (std::uint64_t attribute = 0; attribute != 16; ++attribute) {
+        keys.emplace_back(asset_ID + mesh_index, attribute << 8, attribute);
+      }
+    }
+  }
+  return keys;
+}
+
+template <typename MapType>
+std::chrono::nanoseconds FindAllIDs(const MapType& map,
+                                    const std::vector<MM::Utils::ID3>& keys,
+                                    std::uint64_t& found) {
+  auto start = std::chrono::steady_clock::now();
+  for (std::uint64_t round = 0; round != 8; ++round) {
+    for (const auto& key : keys) {
+      found += map.Count(key);
+    }
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+}  // namespace
+
+TEST(Utils, HashTable_render_resource_ID_benchmark) {
+  RenderResourceIDMap<MM::Utils::PrimeBucket> prime_map;
+  RenderResourceIDMap<MM::Utils::PowerOfTwoBucket> pow2_map;
+
+  std::mt19937_64 random_engine(20230606);
+  std::vector<MM::Utils::ID3> keys = MakeRenderResourceIDs(random_engine);
+  for (std::uint64_t i = 0; i != keys.size(); ++i) {
+    prime_map.Emplace(keys[i], static_cast<int>(i));
+    pow2_map.Emplace(keys[i], static_cast<int>(i));
+  }
+
+  std::shuffle(keys.begin(), keys.end(), random_engine);
+  std::uint64_t prime_found = 0, pow2_found = 0;
+  auto prime_time = FindAllIDs(prime_map, keys, prime_found);
+  auto pow2_time = FindAllIDs(pow2_map, keys, pow2_found);
+  std::cout << "prime bucket lookup: " << prime_time.count() / 1000
+            << " us, power of two bucket lookup: " << pow2_time.count() / 1000
+            << " us" << std::endl;
+
+  ASSERT_EQ(prime_found, pow2_found);
+  ASSERT_EQ(prime_found, keys.size() * 8);
+  for (std::uint64_t i = 0; i != keys.size(); ++i) {
+    ASSERT_EQ(pow2_map.Find(keys[i])->second, prime_map.Find(keys[i])->second);
+  }
+}
+
+TEST(Utils, HashTable_render_resource_ID_bucket_distribution) {
+  RenderResourceIDMap<MM::Utils::PowerOfTwoBucket> pow2_map;
+
+  std::mt19937_64 random_engine(20230606);
+  const std::vector<MM::Utils::ID3> keys = MakeRenderResourceIDs(random_engine);
+  for (std::uint64_t i = 0; i != keys.size(); ++i) {
+    pow2_map.Emplace(keys[i], static_cast<int>(i));
+  }
+  ASSERT_EQ(pow2_map.Size(), keys.size());
+
+  const std::uint64_t bucket_count = pow2_map.BucketCount();
+  ASSERT_EQ(bucket_count & (bucket_count - 1), 0);
+
+  // Walk the chains the table actually built. A lookup of the k-th element of
+  // a chain compares k keys.
+  const auto* buckets = pow2_map.Data();
+  std::uint64_t element_count = 0, used_bucket_count = 0, max_chain_length = 0,
+                probe_count = 0;
+  for (std::uint64_t i = 0; i != bucket_count; ++i) {
+    std::uint64_t chain_length = 0;
+    if (buckets[i].object_) {
+      for (const auto* node = &buckets[i]; node != nullptr;
+           node = node->next_node_) {
+        ++chain_length;
+        probe_count += chain_length;
+      }
+    }
+    element_count += chain_length;
+    used_bucket_count += chain_length != 0;
+    max_chain_length = std::max(max_chain_length, chain_length);
+  }
+  ASSERT_EQ(element_count, keys.size());
+
+  // A uniform hash puts n keys into about m * (1 - e^(-n/m)) of m buckets, and
+  // a successful lookup compares about 1 + n / 2m keys on average.
+  const double load = static_cast<double>(keys.size()) /
+                      static_cast<double>(bucket_count);
+  const double expected_used_bucket_count =
+      static_cast<double>(bucket_count) * (1.0 - std::exp(-load));
+  ASSERT_GE(static_cast<double>(used_bucket_count),
+            0.9 * expected_used_bucket_count);
+  ASSERT_LE(static_cast<double>(probe_count) /
+                static_cast<double>(keys.size()),
+            1.2 * (1.0 + load / 2.0));
+  ASSERT_LE(max_chain_length, 8);
+
+  for (std::uint64_t i = 0; i != keys.size(); ++i) {
+    ASSERT_EQ(pow2_map.Find(keys[i])->second, static_cast<int>(i));
+  }
+}
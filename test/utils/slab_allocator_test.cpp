@@ -0,0 +1,159 @@
+//
+// Created by beimingxianyu on 23-6-6.
+//
+#include "utils/slab_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <map>
+#include <thread>
+#include <vector>
+
+TEST(Utils, SlabAllocator) {
+  struct TestTag {};
+  struct TestObject {
+    std::uint64_t value_[3];
+  };
+  using AllocatorType = MM::Utils::SlabAllocator<TestObject, TestTag>;
+
+  AllocatorType allocator;
+  MM::Utils::SlabPool& pool = AllocatorType::GetPool();
+  EXPECT_EQ(pool.BlockSize(), sizeof(TestObject));
+  EXPECT_EQ(pool.GetStats().slab_count_, 0);
+
+  std::vector<TestObject*> objects;
+  for (std::uint64_t i = 0; i != 1000; ++i) {
+    TestObject* object = allocator.allocate(1);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(object) % alignof(TestObject),
+              0);
+    object->value_[0] = i;
+    objects.push_back(object);
+  }
+  for (std::uint64_t i = 0; i != 1000; ++i) {
+    EXPECT_EQ(objects[i]->value_[0], i);
+  }
+
+  MM::Utils::SlabPoolStats stats = pool.GetStats();
+  EXPECT_EQ(stats.allocate_count_, 1000);
+  EXPECT_EQ(stats.used_block_count_, 1000);
+  EXPECT_EQ(stats.peak_used_block_count_, 1000);
+  EXPECT_GE(stats.capacity_block_count_, 1000);
+  EXPECT_GE(stats.slab_count_, 1);
+
+  for (std::uint64_t i = 0; i != 1000; i += 2) {
+    allocator.deallocate(objects[i], 1);
+  }
+  stats = pool.GetStats();
+  EXPECT_EQ(stats.used_block_count_, 500);
+  EXPECT_NEAR(stats.Fragmentation(),
+              1.0 - 500.0 / static_cast<double>(stats.capacity_block_count_),
+              1e-9);
+
+  // Freed blocks are reused before another slab is carved.
+  std::uint64_t slab_count = stats.slab_count_;
+  for (std::uint64_t i = 0; i != 1000; i += 2) {
+    objects[i] = allocator.allocate(1);
+  }
+  EXPECT_EQ(pool.GetStats().slab_count_, slab_count);
+
+  for (TestObject* object : objects) {
+    allocator.deallocate(object, 1);
+  }
+  pool.ReleaseThreadCache();
+  stats = pool.GetStats();
+  EXPECT_EQ(stats.used_block_count_, 0);
+  EXPECT_EQ(stats.Fragmentation(), 1.0);
+  EXPECT_EQ(stats.shared_free_block_count_, stats.capacity_block_count_);
+
+  // Array allocations do not use the pool.
+  TestObject* array = allocator.allocate(16);
+  allocator.deallocate(array, 16);
+  EXPECT_EQ(pool.GetStats().allocate_count_, stats.allocate_count_);
+}
+
+TEST(Utils, SlabAllocator_container) {
+  struct ListTag {};
+  struct MapTag {};
+
+  {
+    std::list<std::uint64_t, MM::Utils::SlabAllocator<std::uint64_t, ListTag>>
+        list;
+    std::map<std::uint64_t, std::uint64_t, std::less<>,
+             MM::Utils::SlabAllocator<
+                 std::pair<const std::uint64_t, std::uint64_t>, MapTag>>
+        map;
+    for (std::uint64_t i = 0; i != 10000; ++i) {
+      list.push_back(i);
+      map.emplace(i, i * 2);
+    }
+    for (std::uint64_t i = 0; i != 10000; ++i) {
+      EXPECT_EQ(map[i], i * 2);
+    }
+    EXPECT_EQ(list.size(), 10000);
+    EXPECT_EQ(list.back(), 9999);
+
+    list.clear();
+    map.clear();
+    EXPECT_EQ(list.empty(), true);
+    EXPECT_EQ(map.empty(), true);
+  }
+}
+
+TEST(Utils, SlabAllocator_multi_thread) {
+  struct ThreadTag {};
+  struct TestObject {
+    std::uint64_t thread_index_;
+    std::uint64_t value_;
+  };
+  using AllocatorType = MM::Utils::SlabAllocator<TestObject, ThreadTag>;
+  const std::uint64_t thread_count = 8;
+  const std::uint64_t object_count = 10000;
+
+  // Objects allocated by one thread are freed by another one.
+  std::vector<std::vector<TestObject*>> objects_vector(thread_count);
+  std::vector<std::thread> threads;
+  for (std::uint64_t i = 0; i != thread_count; ++i) {
+    threads.emplace_back([i, object_count, &objects = objects_vector[i]]() {
+      AllocatorType allocator;
+      for (std::uint64_t j = 0; j != object_count; ++j) {
+        TestObject* object = allocator.allocate(1);
+        object->thread_index_ = i;
+        object->value_ = j;
+        objects.push_back(object);
+        if (j % 3 == 0) {
+          allocator.deallocate(objects.back(), 1);
+          objects.pop_back();
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+
+  for (std::uint64_t i = 0; i != thread_count; ++i) {
+    threads.emplace_back(
+        [i, thread_count,
+         &objects = objects_vector[(i + 1) % thread_count]]() {
+          AllocatorType allocator;
+          std::uint64_t index = (i + 1) % thread_count;
+          for (TestObject* object : objects) {
+            EXPECT_EQ(object->thread_index_, index);
+            allocator.deallocate(object, 1);
+          }
+          objects.clear();
+        });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  MM::Utils::SlabPoolStats stats = AllocatorType::GetPool().GetStats();
+  EXPECT_EQ(stats.allocate_count_, thread_count * object_count);
+  EXPECT_EQ(stats.deallocate_count_, thread_count * object_count);
+  EXPECT_EQ(stats.used_block_count_, 0);
+  // Exited threads return their cached blocks.
+  EXPECT_EQ(stats.shared_free_block_count_, stats.capacity_block_count_);
+}
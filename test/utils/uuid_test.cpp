@@ -31,6 +31,20 @@ TEST(Utils, UUID) {
   EXPECT_EQ(uuid4.ToString(),
             std::string("89fedcba-4567-1123-0004-999999999999"));
 
+  MM::Utils::UUID parsed_uuid(MM::Utils::UUID::UUIDEmptyInit{});
+  EXPECT_EQ(MM::Utils::UUID::FromString(uuid3.ToString(), parsed_uuid), true);
+  EXPECT_EQ(parsed_uuid, uuid3);
+  EXPECT_EQ(MM::Utils::UUID::FromString(uuid4.ToString(), parsed_uuid), true);
+  EXPECT_EQ(parsed_uuid, uuid4);
+  EXPECT_EQ(MM::Utils::UUID::FromString("TestName", parsed_uuid), false);
+  EXPECT_EQ(MM::Utils::UUID::FromString(
+                "89fedcba-4567-1123-0004_999999999999", parsed_uuid),
+            false);
+  EXPECT_EQ(MM::Utils::UUID::FromString(
+                "89fedcbg-4567-1123-0004-999999999999", parsed_uuid),
+            false);
+  EXPECT_EQ(parsed_uuid, uuid4);
+
   // Uniqueness testing
   std::unordered_set<MM::Utils::UUID> all_uuid;
   for (std::uint32_t i = 0; i < 10000000; ++i) {